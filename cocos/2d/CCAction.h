@@ -177,11 +177,14 @@ protected:
     int     _tag;
     /** The action flag field. To categorize action into certain groups.*/
     unsigned int _flags;
+    /** Index of the tween of the action in the ActionManager stepping it in bulk, -1 if it is stepped by step(). */
+    int     _tweenIndex;
 
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
 private:
+    friend class ActionManager;
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
 
@@ -32,6 +32,9 @@ THE SOFTWARE.
  */
 
 #include "2d/CCActionEase.h"
+
+#include <typeinfo>
+
 #include "2d/CCTweenFunction.h"
 
 NS_CC_BEGIN
@@ -99,6 +102,19 @@ ActionInterval* ActionEase::getInnerAction()
     return _inner;
 }
 
+bool ActionEase::getEasedTween(Tween* tween, tweenfunc::TweenType easing, float easingParam) const
+{
+    // an ease of an ease isn't a tween
+    if (_inner == nullptr || ! _inner->getTween(tween) || tween->easing != tweenfunc::Linear)
+    {
+        return false;
+    }
+
+    tween->easing = easing;
+    tween->easingParam = easingParam;
+    return true;
+}
+
 //
 // EaseRateAction
 //
@@ -133,7 +149,7 @@ bool EaseRateAction::initWithAction(ActionInterval *action, float rate)
 // NOTE: Converting these macros into Templates is desirable, but please see
 // issue #16159 [https://github.com/cocos2d/cocos2d-x/pull/16159] for further info
 //
-#define EASE_TEMPLATE_IMPL(CLASSNAME, TWEEN_FUNC, REVERSE_CLASSNAME) \
+#define EASE_TEMPLATE_IMPL(CLASSNAME, TWEEN_FUNC, TWEEN_TYPE, REVERSE_CLASSNAME) \
 CLASSNAME* CLASSNAME::create(cocos2d::ActionInterval *action) \
 { \
     CLASSNAME *ease = new (std::nothrow) CLASSNAME(); \
@@ -154,43 +170,46 @@ CLASSNAME* CLASSNAME::clone() const \
 void CLASSNAME::update(float time) { \
     _inner->update(TWEEN_FUNC(time)); \
 } \
+bool CLASSNAME::getTween(Tween* tween) const { \
+    return typeid(*this) == typeid(CLASSNAME) && getEasedTween(tween, TWEEN_TYPE, 0); \
+} \
 ActionEase* CLASSNAME::reverse() const { \
     return REVERSE_CLASSNAME::create(_inner->reverse()); \
 }
 
-EASE_TEMPLATE_IMPL(EaseExponentialIn, tweenfunc::expoEaseIn, EaseExponentialOut);
-EASE_TEMPLATE_IMPL(EaseExponentialOut, tweenfunc::expoEaseOut, EaseExponentialIn);
-EASE_TEMPLATE_IMPL(EaseExponentialInOut, tweenfunc::expoEaseInOut, EaseExponentialInOut);
-EASE_TEMPLATE_IMPL(EaseSineIn, tweenfunc::sineEaseIn, EaseSineOut);
-EASE_TEMPLATE_IMPL(EaseSineOut, tweenfunc::sineEaseOut, EaseSineIn);
-EASE_TEMPLATE_IMPL(EaseSineInOut, tweenfunc::sineEaseInOut, EaseSineInOut);
-EASE_TEMPLATE_IMPL(EaseBounceIn, tweenfunc::bounceEaseIn, EaseBounceOut);
-EASE_TEMPLATE_IMPL(EaseBounceOut, tweenfunc::bounceEaseOut, EaseBounceIn);
-EASE_TEMPLATE_IMPL(EaseBounceInOut, tweenfunc::bounceEaseInOut, EaseBounceInOut);
-EASE_TEMPLATE_IMPL(EaseBackIn, tweenfunc::backEaseIn, EaseBackOut);
-EASE_TEMPLATE_IMPL(EaseBackOut, tweenfunc::backEaseOut, EaseBackIn);
-EASE_TEMPLATE_IMPL(EaseBackInOut, tweenfunc::backEaseInOut, EaseBackInOut);
-EASE_TEMPLATE_IMPL(EaseQuadraticActionIn, tweenfunc::quadraticIn, EaseQuadraticActionIn);
-EASE_TEMPLATE_IMPL(EaseQuadraticActionOut, tweenfunc::quadraticOut, EaseQuadraticActionOut);
-EASE_TEMPLATE_IMPL(EaseQuadraticActionInOut, tweenfunc::quadraticInOut, EaseQuadraticActionInOut);
-EASE_TEMPLATE_IMPL(EaseQuarticActionIn, tweenfunc::quartEaseIn, EaseQuarticActionIn);
-EASE_TEMPLATE_IMPL(EaseQuarticActionOut, tweenfunc::quartEaseOut, EaseQuarticActionOut);
-EASE_TEMPLATE_IMPL(EaseQuarticActionInOut, tweenfunc::quartEaseInOut, EaseQuarticActionInOut);
-EASE_TEMPLATE_IMPL(EaseQuinticActionIn, tweenfunc::quintEaseIn, EaseQuinticActionIn);
-EASE_TEMPLATE_IMPL(EaseQuinticActionOut, tweenfunc::quintEaseOut, EaseQuinticActionOut);
-EASE_TEMPLATE_IMPL(EaseQuinticActionInOut, tweenfunc::quintEaseInOut, EaseQuinticActionInOut);
-EASE_TEMPLATE_IMPL(EaseCircleActionIn, tweenfunc::circEaseIn, EaseCircleActionIn);
-EASE_TEMPLATE_IMPL(EaseCircleActionOut, tweenfunc::circEaseOut, EaseCircleActionOut);
-EASE_TEMPLATE_IMPL(EaseCircleActionInOut, tweenfunc::circEaseInOut, EaseCircleActionInOut);
-EASE_TEMPLATE_IMPL(EaseCubicActionIn, tweenfunc::cubicEaseIn, EaseCubicActionIn);
-EASE_TEMPLATE_IMPL(EaseCubicActionOut, tweenfunc::cubicEaseOut, EaseCubicActionOut);
-EASE_TEMPLATE_IMPL(EaseCubicActionInOut, tweenfunc::cubicEaseInOut, EaseCubicActionInOut);
+EASE_TEMPLATE_IMPL(EaseExponentialIn, tweenfunc::expoEaseIn, tweenfunc::Expo_EaseIn, EaseExponentialOut);
+EASE_TEMPLATE_IMPL(EaseExponentialOut, tweenfunc::expoEaseOut, tweenfunc::Expo_EaseOut, EaseExponentialIn);
+EASE_TEMPLATE_IMPL(EaseExponentialInOut, tweenfunc::expoEaseInOut, tweenfunc::Expo_EaseInOut, EaseExponentialInOut);
+EASE_TEMPLATE_IMPL(EaseSineIn, tweenfunc::sineEaseIn, tweenfunc::Sine_EaseIn, EaseSineOut);
+EASE_TEMPLATE_IMPL(EaseSineOut, tweenfunc::sineEaseOut, tweenfunc::Sine_EaseOut, EaseSineIn);
+EASE_TEMPLATE_IMPL(EaseSineInOut, tweenfunc::sineEaseInOut, tweenfunc::Sine_EaseInOut, EaseSineInOut);
+EASE_TEMPLATE_IMPL(EaseBounceIn, tweenfunc::bounceEaseIn, tweenfunc::Bounce_EaseIn, EaseBounceOut);
+EASE_TEMPLATE_IMPL(EaseBounceOut, tweenfunc::bounceEaseOut, tweenfunc::Bounce_EaseOut, EaseBounceIn);
+EASE_TEMPLATE_IMPL(EaseBounceInOut, tweenfunc::bounceEaseInOut, tweenfunc::Bounce_EaseInOut, EaseBounceInOut);
+EASE_TEMPLATE_IMPL(EaseBackIn, tweenfunc::backEaseIn, tweenfunc::Back_EaseIn, EaseBackOut);
+EASE_TEMPLATE_IMPL(EaseBackOut, tweenfunc::backEaseOut, tweenfunc::Back_EaseOut, EaseBackIn);
+EASE_TEMPLATE_IMPL(EaseBackInOut, tweenfunc::backEaseInOut, tweenfunc::Back_EaseInOut, EaseBackInOut);
+EASE_TEMPLATE_IMPL(EaseQuadraticActionIn, tweenfunc::quadraticIn, tweenfunc::Quad_EaseIn, EaseQuadraticActionIn);
+EASE_TEMPLATE_IMPL(EaseQuadraticActionOut, tweenfunc::quadraticOut, tweenfunc::Quad_EaseOut, EaseQuadraticActionOut);
+EASE_TEMPLATE_IMPL(EaseQuadraticActionInOut, tweenfunc::quadraticInOut, tweenfunc::Quad_EaseInOut, EaseQuadraticActionInOut);
+EASE_TEMPLATE_IMPL(EaseQuarticActionIn, tweenfunc::quartEaseIn, tweenfunc::Quart_EaseIn, EaseQuarticActionIn);
+EASE_TEMPLATE_IMPL(EaseQuarticActionOut, tweenfunc::quartEaseOut, tweenfunc::Quart_EaseOut, EaseQuarticActionOut);
+EASE_TEMPLATE_IMPL(EaseQuarticActionInOut, tweenfunc::quartEaseInOut, tweenfunc::Quart_EaseInOut, EaseQuarticActionInOut);
+EASE_TEMPLATE_IMPL(EaseQuinticActionIn, tweenfunc::quintEaseIn, tweenfunc::Quint_EaseIn, EaseQuinticActionIn);
+EASE_TEMPLATE_IMPL(EaseQuinticActionOut, tweenfunc::quintEaseOut, tweenfunc::Quint_EaseOut, EaseQuinticActionOut);
+EASE_TEMPLATE_IMPL(EaseQuinticActionInOut, tweenfunc::quintEaseInOut, tweenfunc::Quint_EaseInOut, EaseQuinticActionInOut);
+EASE_TEMPLATE_IMPL(EaseCircleActionIn, tweenfunc::circEaseIn, tweenfunc::Circ_EaseIn, EaseCircleActionIn);
+EASE_TEMPLATE_IMPL(EaseCircleActionOut, tweenfunc::circEaseOut, tweenfunc::Circ_EaseOut, EaseCircleActionOut);
+EASE_TEMPLATE_IMPL(EaseCircleActionInOut, tweenfunc::circEaseInOut, tweenfunc::Circ_EaseInOut, EaseCircleActionInOut);
+EASE_TEMPLATE_IMPL(EaseCubicActionIn, tweenfunc::cubicEaseIn, tweenfunc::Cubic_EaseIn, EaseCubicActionIn);
+EASE_TEMPLATE_IMPL(EaseCubicActionOut, tweenfunc::cubicEaseOut, tweenfunc::Cubic_EaseOut, EaseCubicActionOut);
+EASE_TEMPLATE_IMPL(EaseCubicActionInOut, tweenfunc::cubicEaseInOut, tweenfunc::Cubic_EaseInOut, EaseCubicActionInOut);
 
 //
 // NOTE: Converting these macros into Templates is desirable, but please see
 // issue #16159 [https://github.com/cocos2d/cocos2d-x/pull/16159] for further info
 //
-#define EASERATE_TEMPLATE_IMPL(CLASSNAME, TWEEN_FUNC) \
+#define EASERATE_TEMPLATE_IMPL(CLASSNAME, TWEEN_FUNC, TWEEN_TYPE) \
 CLASSNAME* CLASSNAME::create(cocos2d::ActionInterval *action, float rate) \
 { \
     CLASSNAME *ease = new (std::nothrow) CLASSNAME(); \
@@ -211,14 +230,17 @@ CLASSNAME* CLASSNAME::clone() const \
 void CLASSNAME::update(float time) { \
     _inner->update(TWEEN_FUNC(time, _rate)); \
 } \
+bool CLASSNAME::getTween(Tween* tween) const { \
+    return typeid(*this) == typeid(CLASSNAME) && getEasedTween(tween, TWEEN_TYPE, _rate); \
+} \
 EaseRateAction* CLASSNAME::reverse() const { \
     return CLASSNAME::create(_inner->reverse(), 1.f / _rate); \
 }
 
 // NOTE: the original code used the same class for the `reverse()` method
-EASERATE_TEMPLATE_IMPL(EaseIn, tweenfunc::easeIn);
-EASERATE_TEMPLATE_IMPL(EaseOut, tweenfunc::easeOut);
-EASERATE_TEMPLATE_IMPL(EaseInOut, tweenfunc::easeInOut);
+EASERATE_TEMPLATE_IMPL(EaseIn, tweenfunc::easeIn, tweenfunc::Rate_EaseIn);
+EASERATE_TEMPLATE_IMPL(EaseOut, tweenfunc::easeOut, tweenfunc::Rate_EaseOut);
+EASERATE_TEMPLATE_IMPL(EaseInOut, tweenfunc::easeInOut, tweenfunc::Rate_EaseInOut);
 
 //
 // EaseElastic
@@ -239,7 +261,7 @@ bool EaseElastic::initWithAction(ActionInterval *action, float period /* = 0.3f*
 // NOTE: Converting these macros into Templates is desirable, but please see
 // issue #16159 [https://github.com/cocos2d/cocos2d-x/pull/16159] for further info
 //
-#define EASEELASTIC_TEMPLATE_IMPL(CLASSNAME, TWEEN_FUNC, REVERSE_CLASSNAME) \
+#define EASEELASTIC_TEMPLATE_IMPL(CLASSNAME, TWEEN_FUNC, TWEEN_TYPE, REVERSE_CLASSNAME) \
 CLASSNAME* CLASSNAME::create(cocos2d::ActionInterval *action, float period /* = 0.3f*/) \
 { \
     CLASSNAME *ease = new (std::nothrow) CLASSNAME(); \
@@ -260,13 +282,16 @@ CLASSNAME* CLASSNAME::clone() const \
 void CLASSNAME::update(float time) { \
     _inner->update(TWEEN_FUNC(time, _period)); \
 } \
+bool CLASSNAME::getTween(Tween* tween) const { \
+    return typeid(*this) == typeid(CLASSNAME) && getEasedTween(tween, TWEEN_TYPE, _period); \
+} \
 EaseElastic* CLASSNAME::reverse() const { \
     return REVERSE_CLASSNAME::create(_inner->reverse(), _period); \
 }
 
-EASEELASTIC_TEMPLATE_IMPL(EaseElasticIn, tweenfunc::elasticEaseIn, EaseElasticOut);
-EASEELASTIC_TEMPLATE_IMPL(EaseElasticOut, tweenfunc::elasticEaseOut, EaseElasticIn);
-EASEELASTIC_TEMPLATE_IMPL(EaseElasticInOut, tweenfunc::elasticEaseInOut, EaseElasticInOut);
+EASEELASTIC_TEMPLATE_IMPL(EaseElasticIn, tweenfunc::elasticEaseIn, tweenfunc::Elastic_EaseIn, EaseElasticOut);
+EASEELASTIC_TEMPLATE_IMPL(EaseElasticOut, tweenfunc::elasticEaseOut, tweenfunc::Elastic_EaseOut, EaseElasticIn);
+EASEELASTIC_TEMPLATE_IMPL(EaseElasticInOut, tweenfunc::elasticEaseInOut, tweenfunc::Elastic_EaseInOut, EaseElasticInOut);
 
 //
 // EaseBezierAction
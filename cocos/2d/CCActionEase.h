@@ -73,6 +73,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithAction(ActionInterval *action);
 
 protected:
+    /** Describes the action as the tween of the inner action eased by an easing, if the inner action is a linear tween. */
+    bool getEasedTween(Tween* tween, tweenfunc::TweenType easing, float easingParam) const;
+
     /** The inner action */
     ActionInterval *_inner;
 private:
@@ -132,6 +135,7 @@ public: \
     static CLASSNAME* create(ActionInterval* action); \
     virtual CLASSNAME* clone() const override; \
     virtual void update(float time) override; \
+    virtual bool getTween(Tween* tween) const override; \
     virtual ActionEase* reverse() const override; \
 private: \
     CC_DISALLOW_COPY_AND_ASSIGN(CLASSNAME); \
@@ -381,6 +385,7 @@ public: \
     static CLASSNAME* create(ActionInterval* action, float rate); \
     virtual CLASSNAME* clone() const override; \
     virtual void update(float time) override; \
+    virtual bool getTween(Tween* tween) const override; \
     virtual EaseRateAction* reverse() const override; \
 private: \
     CC_DISALLOW_COPY_AND_ASSIGN(CLASSNAME); \
@@ -468,6 +473,7 @@ public: \
     static CLASSNAME* create(ActionInterval* action, float rate = 0.3f); \
     virtual CLASSNAME* clone() const override; \
     virtual void update(float time) override; \
+    virtual bool getTween(Tween* tween) const override; \
     virtual EaseElastic* reverse() const override; \
 private: \
     CC_DISALLOW_COPY_AND_ASSIGN(CLASSNAME); \
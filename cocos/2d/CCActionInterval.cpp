@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "2d/CCActionInterval.h"
 
 #include <stdarg.h>
+#include <typeinfo>
 
 #include "2d/CCSprite.h"
 #include "2d/CCNode.h"
@@ -998,6 +999,21 @@ void RotateTo::update(float time)
     }
 }
 
+bool RotateTo::getTween(Tween* tween) const
+{
+    if (typeid(*this) != typeid(RotateTo))
+    {
+        return false;
+    }
+
+    tween->property = _is3D ? Tween::Property::ROTATION_3D : Tween::Property::ROTATION;
+    tween->from = _startAngle;
+    tween->delta = _diffAngle;
+    tween->easing = tweenfunc::Linear;
+    tween->easingParam = 0;
+    return true;
+}
+
 RotateTo *RotateTo::reverse() const
 {
     CCASSERT(false, "RotateTo doesn't support the 'reverse' method");
@@ -1147,6 +1163,21 @@ void RotateBy::update(float time)
     }
 }
 
+bool RotateBy::getTween(Tween* tween) const
+{
+    if (typeid(*this) != typeid(RotateBy))
+    {
+        return false;
+    }
+
+    tween->property = _is3D ? Tween::Property::ROTATION_3D : Tween::Property::ROTATION;
+    tween->from = _startAngle;
+    tween->delta = _deltaAngle;
+    tween->easing = tweenfunc::Linear;
+    tween->easingParam = 0;
+    return true;
+}
+
 RotateBy* RotateBy::reverse() const
 {
     if(_is3D)
@@ -1239,6 +1270,22 @@ void MoveBy::update(float t)
     }
 }
 
+bool MoveBy::getTween(Tween* tween) const
+{
+    // MoveTo only differs by its startWithTarget()
+    if (typeid(*this) != typeid(MoveBy) && typeid(*this) != typeid(MoveTo))
+    {
+        return false;
+    }
+
+    tween->property = Tween::Property::POSITION;
+    tween->from = _startPosition;
+    tween->delta = _positionDelta;
+    tween->easing = tweenfunc::Linear;
+    tween->easingParam = 0;
+    return true;
+}
+
 //
 // MoveTo
 //
@@ -1981,6 +2028,22 @@ void ScaleTo::update(float time)
     }
 }
 
+bool ScaleTo::getTween(Tween* tween) const
+{
+    // ScaleBy only differs by its startWithTarget()
+    if (typeid(*this) != typeid(ScaleTo) && typeid(*this) != typeid(ScaleBy))
+    {
+        return false;
+    }
+
+    tween->property = Tween::Property::SCALE;
+    tween->from.set(_startScaleX, _startScaleY, _startScaleZ);
+    tween->delta.set(_deltaX, _deltaY, _deltaZ);
+    tween->easing = tweenfunc::Linear;
+    tween->easingParam = 0;
+    return true;
+}
+
 //
 // ScaleBy
 //
@@ -2269,6 +2332,22 @@ void FadeTo::update(float time)
     }
 }
 
+bool FadeTo::getTween(Tween* tween) const
+{
+    // FadeIn and FadeOut only differ by their startWithTarget()
+    if (typeid(*this) != typeid(FadeTo) && typeid(*this) != typeid(FadeIn) && typeid(*this) != typeid(FadeOut))
+    {
+        return false;
+    }
+
+    tween->property = Tween::Property::OPACITY;
+    tween->from.set(_fromOpacity, 0, 0);
+    tween->delta.set(_toOpacity - _fromOpacity, 0, 0);
+    tween->easing = tweenfunc::Linear;
+    tween->easingParam = 0;
+    return true;
+}
+
 //
 // TintTo
 //
@@ -2332,6 +2411,21 @@ void TintTo::update(float time)
     }
 }
 
+bool TintTo::getTween(Tween* tween) const
+{
+    if (typeid(*this) != typeid(TintTo))
+    {
+        return false;
+    }
+
+    tween->property = Tween::Property::COLOR;
+    tween->from.set(_from.r, _from.g, _from.b);
+    tween->delta.set(_to.r - _from.r, _to.g - _from.g, _to.b - _from.b);
+    tween->easing = tweenfunc::Linear;
+    tween->easingParam = 0;
+    return true;
+}
+
 //
 // TintBy
 //
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "2d/CCAction.h"
 #include "2d/CCAnimation.h"
+#include "2d/CCTweenFunction.h"
 #include "base/CCProtocols.h"
 #include "base/CCVector.h"
 
@@ -69,6 +70,31 @@ auto pingPongAction = Sequence::create(action, action->reverse(), nullptr);
 class CC_DLL ActionInterval : public FiniteTimeAction
 {
 public:
+    /** @struct Tween
+     * @brief An action changing a property of its target from a value by a delta, along an easing of its time.
+     * The ActionManager steps such actions in bulk instead of calling their step() method.
+     * @js NA
+     * @lua NA
+     */
+    struct Tween
+    {
+        enum class Property
+        {
+            POSITION,
+            SCALE,
+            ROTATION,
+            ROTATION_3D,
+            OPACITY,
+            COLOR
+        };
+
+        Property property;
+        Vec3 from;
+        Vec3 delta;
+        tweenfunc::TweenType easing;
+        float easingParam;
+    };
+
     /** How many seconds had elapsed since the actions started to run.
      *
      * @return The seconds had elapsed since the actions started to run.
@@ -108,6 +134,16 @@ public:
         return nullptr;
     }
 
+    /** Describes the action started on its target as a tween.
+     * Only the actions whose update() is exactly a tween override it, subclasses of them are stepped as usual.
+     *
+     * @param tween The tween to fill, with a linear easing.
+     * @return False if the action isn't a tween, the default.
+     * @js NA
+     * @lua NA
+     */
+    virtual bool getTween(Tween* /*tween*/) const { return false; }
+
 CC_CONSTRUCTOR_ACCESS:
     /** initializes the action */
     bool initWithDuration(float d);
@@ -118,6 +154,8 @@ protected:
 
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
+
+    friend class ActionManager;
 };
 
 /** @class Sequence
@@ -475,6 +513,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(Tween* tween) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     RotateTo();
@@ -551,6 +590,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(Tween* tween) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     RotateBy();
@@ -612,6 +652,7 @@ public:
      * @param time in seconds
      */
     virtual void update(float time) override;
+    virtual bool getTween(Tween* tween) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     MoveBy():_is3D(false) {}
@@ -1087,6 +1128,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(Tween* tween) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     ScaleTo() {}
@@ -1245,6 +1287,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(Tween* tween) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     FadeTo() {}
@@ -1368,6 +1411,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(Tween* tween) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     TintTo() {}
@@ -27,8 +27,13 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCActionManager.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -46,15 +51,101 @@ typedef struct _hashElement
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
+    int                 tweenCount;
     UT_hash_handle      hh;
 } tHashElement;
 
+//
+// the tweens stepped in bulk, indexed by Action::_tweenIndex
+//
+typedef struct _tweenArrays
+{
+    std::vector<ActionInterval*>    actions;    // nullptr once removed
+    std::vector<Node*>              targets;
+    std::vector<ActionInterval::Tween::Property> properties;
+    std::vector<tweenfunc::TweenType> easings;
+    std::vector<float>              easingParams;
+    std::vector<float>              durations;
+    std::vector<float>              elapsed;
+    std::vector<float>              times;
+    std::vector<unsigned char>      firstTicks;
+    std::vector<unsigned char>      running;    // neither paused nor removed
+    std::vector<Vec3>               from;
+    std::vector<Vec3>               deltas;
+    std::vector<Vec3>               values;
+    std::vector<Vec3>               previous;   // last position set, for the stackable moves
+    size_t                          removed;
+    bool                            stepping;
+
+    // scratch of the easing in bulk
+    std::vector<unsigned int>       easingOrder;
+    std::vector<float>              easedTimes;
+
+    void push(ActionInterval *action, Node *target, const ActionInterval::Tween& tween, bool paused)
+    {
+        actions.push_back(action);
+        targets.push_back(target);
+        properties.push_back(tween.property);
+        easings.push_back(tween.easing);
+        easingParams.push_back(tween.easingParam);
+        durations.push_back(action->getDuration());
+        elapsed.push_back(action->getElapsed());
+        times.push_back(0);
+        firstTicks.push_back(1);
+        running.push_back(paused ? 0 : 1);
+        from.push_back(tween.from);
+        deltas.push_back(tween.delta);
+        values.push_back(tween.from);
+        previous.push_back(tween.from);
+    }
+
+    void move(size_t src, size_t dst)
+    {
+        actions[dst] = actions[src];
+        targets[dst] = targets[src];
+        properties[dst] = properties[src];
+        easings[dst] = easings[src];
+        easingParams[dst] = easingParams[src];
+        durations[dst] = durations[src];
+        elapsed[dst] = elapsed[src];
+        times[dst] = times[src];
+        firstTicks[dst] = firstTicks[src];
+        running[dst] = running[src];
+        from[dst] = from[src];
+        deltas[dst] = deltas[src];
+        values[dst] = values[src];
+        previous[dst] = previous[src];
+    }
+
+    void resize(size_t size)
+    {
+        actions.resize(size);
+        targets.resize(size);
+        properties.resize(size);
+        easings.resize(size);
+        easingParams.resize(size);
+        durations.resize(size);
+        elapsed.resize(size);
+        times.resize(size);
+        firstTicks.resize(size);
+        running.resize(size);
+        from.resize(size);
+        deltas.resize(size);
+        values.resize(size);
+        previous.resize(size);
+    }
+} tTweenArrays;
+
+static bool s_tweenBatchingEnabled = false;
+
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _tweens(new (std::nothrow) tTweenArrays())
 {
-
+    _tweens->removed = 0;
+    _tweens->stepping = false;
 }
 
 ActionManager::~ActionManager()
@@ -62,12 +153,24 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    CC_SAFE_DELETE(_tweens);
+}
+
+void ActionManager::setTweenBatchingEnabled(bool enabled)
+{
+    s_tweenBatchingEnabled = enabled;
+}
+
+bool ActionManager::isTweenBatchingEnabled()
+{
+    return s_tweenBatchingEnabled;
 }
 
 // private
 
 void ActionManager::deleteHashElement(tHashElement *element)
 {
+    removeTweens(element);
     ccArrayFree(element->actions);
     HASH_DEL(_targets, element);
     element->target->release();
@@ -98,6 +201,7 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
+    removeTween(action, element);
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -128,6 +232,7 @@ void ActionManager::pauseTarget(Node *target)
     if (element)
     {
         element->paused = true;
+        pauseTweens(element, true);
     }
 }
 
@@ -138,6 +243,7 @@ void ActionManager::resumeTarget(Node *target)
     if (element)
     {
         element->paused = false;
+        pauseTweens(element, false);
     }
 }
 
@@ -150,6 +256,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         if (! element->paused) 
         {
             element->paused = true;
+            pauseTweens(element, true);
             idsWithActions.pushBack(element->target);
         }
     }    
@@ -193,6 +300,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     if (s_tweenBatchingEnabled)
+     {
+         addTween(action, element);
+     }
 }
 
 // remove
@@ -225,6 +337,7 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        removeTweens(element);
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -424,15 +537,283 @@ size_t ActionManager::getNumberOfRunningActionsInTargetByTag(const Node *target,
 }
 
 
+// tweens
+
+void ActionManager::addTween(Action *action, tHashElement *element)
+{
+#if CC_ENABLE_SCRIPT_BINDING
+    // the update of the JavaScript actions is sent to the script by step()
+    if (action->_scriptType == kScriptTypeJavascript)
+    {
+        return;
+    }
+#endif
+
+    // already stepped in bulk for another target
+    if (action->_tweenIndex >= 0)
+    {
+        return;
+    }
+
+    auto interval = dynamic_cast<ActionInterval*>(action);
+    ActionInterval::Tween tween;
+    if (interval == nullptr || ! interval->getTween(&tween))
+    {
+        return;
+    }
+
+    // the indices can only change between two updates
+    if (! _tweens->stepping && _tweens->removed > _tweens->actions.size() / 2)
+    {
+        compactTweens();
+    }
+
+    action->_tweenIndex = (int)_tweens->actions.size();
+    _tweens->push(interval, element->target, tween, element->paused);
+    element->tweenCount++;
+}
+
+void ActionManager::removeTween(Action *action, tHashElement *element)
+{
+    auto index = action->_tweenIndex;
+    if (index < 0)
+    {
+        return;
+    }
+
+    _tweens->actions[index] = nullptr;
+    _tweens->targets[index] = nullptr;
+    _tweens->running[index] = 0;
+    _tweens->removed++;
+    action->_tweenIndex = -1;
+    element->tweenCount--;
+}
+
+void ActionManager::removeTweens(tHashElement *element)
+{
+    for (int i = 0; i < element->actions->num && element->tweenCount > 0; ++i)
+    {
+        removeTween(static_cast<Action*>(element->actions->arr[i]), element);
+    }
+}
+
+void ActionManager::pauseTweens(tHashElement *element, bool paused)
+{
+    if (element->tweenCount == 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < element->actions->num; ++i)
+    {
+        auto index = static_cast<Action*>(element->actions->arr[i])->_tweenIndex;
+        if (index >= 0)
+        {
+            _tweens->running[index] = paused ? 0 : 1;
+        }
+    }
+}
+
+void ActionManager::stepTweens(float dt, size_t begin, size_t end)
+{
+    auto& tweens = *_tweens;
+
+    // the times, as ActionInterval::step() computes them
+    {
+        const unsigned char *running = tweens.running.data();
+        const float *durations = tweens.durations.data();
+        unsigned char *firstTicks = tweens.firstTicks.data();
+        float *elapsed = tweens.elapsed.data();
+        float *times = tweens.times.data();
+        for (size_t i = begin; i < end; ++i)
+        {
+            float step = firstTicks[i] ? 0.0f : dt;
+            elapsed[i] += running[i] ? step : 0.0f;
+            firstTicks[i] &= running[i] ^ 1;
+            times[i] = std::max(0.0f, std::min(1.0f, elapsed[i] / durations[i]));
+        }
+    }
+
+    // the easings. The exact ones one by one, the approximated ones in bulk for the tweens sharing a curve
+    if (tweenfunc::getEasingPrecision() == tweenfunc::EasingPrecision::EXACT)
+    {
+        const tweenfunc::TweenType *easings = tweens.easings.data();
+        float *easingParams = tweens.easingParams.data();
+        float *times = tweens.times.data();
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (easings[i] != tweenfunc::Linear)
+            {
+                times[i] = tweenfunc::tweenTo(times[i], easings[i], &easingParams[i]);
+            }
+        }
+    }
+    else
+    {
+        const tweenfunc::TweenType *easings = tweens.easings.data();
+        const float *easingParams = tweens.easingParams.data();
+        float *times = tweens.times.data();
+        auto& order = tweens.easingOrder;
+        order.clear();
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (easings[i] != tweenfunc::Linear)
+            {
+                order.push_back((unsigned int)i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [=](unsigned int a, unsigned int b) {
+            return easings[a] < easings[b] || (easings[a] == easings[b] && easingParams[a] < easingParams[b]);
+        });
+
+        auto& eased = tweens.easedTimes;
+        for (size_t first = 0, last = 0; first < order.size(); first = last)
+        {
+            auto easing = easings[order[first]];
+            float easingParam = easingParams[order[first]];
+            last = first + 1;
+            while (last < order.size() && easings[order[last]] == easing && easingParams[order[last]] == easingParam)
+            {
+                ++last;
+            }
+
+            eased.resize(last - first);
+            for (size_t k = first; k < last; ++k)
+            {
+                eased[k - first] = times[order[k]];
+            }
+            tweenfunc::tweenTo(eased.data(), eased.data(), eased.size(), easing, &easingParam);
+            for (size_t k = first; k < last; ++k)
+            {
+                times[order[k]] = eased[k - first];
+            }
+        }
+    }
+
+    // the values
+    {
+        const Vec3 *from = tweens.from.data();
+        const Vec3 *deltas = tweens.deltas.data();
+        const float *times = tweens.times.data();
+        Vec3 *values = tweens.values.data();
+        for (size_t i = begin; i < end; ++i)
+        {
+            values[i].x = from[i].x + deltas[i].x * times[i];
+            values[i].y = from[i].y + deltas[i].y * times[i];
+            values[i].z = from[i].z + deltas[i].z * times[i];
+        }
+    }
+
+    // the targets, as the update() of the actions sets them. The setters may add and remove actions,
+    // so the arrays are indexed again after each of them
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (! tweens.running[i])
+        {
+            continue;
+        }
+
+        auto action = tweens.actions[i];
+        action->_elapsed = tweens.elapsed[i];
+        action->_firstTick = false;
+
+        auto target = tweens.targets[i];
+        Vec3 value = tweens.values[i];
+        switch (tweens.properties[i])
+        {
+        case ActionInterval::Tween::Property::POSITION:
+#if CC_ENABLE_STACKABLE_ACTIONS
+            {
+                // the moves of the target since the last step are kept, as in MoveBy::update()
+                Vec3 currentPosition = target->getPosition3D();
+                if (currentPosition != tweens.previous[i])
+                {
+                    tweens.from[i] = tweens.from[i] + (currentPosition - tweens.previous[i]);
+                    value = tweens.from[i] + (tweens.deltas[i] * tweens.times[i]);
+                }
+                tweens.previous[i] = value;
+            }
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+            target->setPosition3D(value);
+            break;
+        case ActionInterval::Tween::Property::SCALE:
+            target->setScaleX(value.x);
+            target->setScaleY(value.y);
+            target->setScaleZ(value.z);
+            break;
+        case ActionInterval::Tween::Property::ROTATION:
+#if CC_USE_PHYSICS
+            if (tweens.from[i].x == tweens.from[i].y && tweens.deltas[i].x == tweens.deltas[i].y)
+            {
+                target->setRotation(value.x);
+                break;
+            }
+#endif // CC_USE_PHYSICS
+            target->setRotationSkewX(value.x);
+            target->setRotationSkewY(value.y);
+            break;
+        case ActionInterval::Tween::Property::ROTATION_3D:
+            target->setRotation3D(value);
+            break;
+        case ActionInterval::Tween::Property::OPACITY:
+            target->setOpacity((GLubyte)value.x);
+            break;
+        case ActionInterval::Tween::Property::COLOR:
+            target->setColor(Color3B((GLubyte)value.x, (GLubyte)value.y, (GLubyte)value.z));
+            break;
+        }
+    }
+
+    // the finished actions, as update() stops and removes them after their step()
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (tweens.running[i] && tweens.elapsed[i] + FLT_EPSILON >= tweens.durations[i])
+        {
+            auto action = tweens.actions[i];
+            action->stop();
+            removeAction(action);
+        }
+    }
+}
+
+void ActionManager::compactTweens()
+{
+    auto& tweens = *_tweens;
+    size_t count = 0;
+    for (size_t i = 0, size = tweens.actions.size(); i < size; ++i)
+    {
+        auto action = tweens.actions[i];
+        if (action == nullptr)
+        {
+            continue;
+        }
+
+        if (count != i)
+        {
+            tweens.move(i, count);
+            action->_tweenIndex = (int)count;
+        }
+        ++count;
+    }
+
+    tweens.resize(count);
+    tweens.removed = 0;
+}
+
 // main loop
 void ActionManager::update(float dt)
 {
+    // the tweens are stepped first, the ones added during the update get their first step at its end
+    _tweens->stepping = true;
+    size_t tweenCount = _tweens->actions.size();
+    stepTweens(dt, 0, tweenCount);
+
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        if (! _currentTarget->paused && _currentTarget->tweenCount < _currentTarget->actions->num)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
@@ -444,6 +825,13 @@ void ActionManager::update(float dt)
                     continue;
                 }
 
+                // stepped by stepTweens()
+                if (_currentTarget->currentAction->_tweenIndex >= 0)
+                {
+                    _currentTarget->currentAction = nullptr;
+                    continue;
+                }
+
                 _currentTarget->currentActionSalvaged = false;
 
                 _currentTarget->currentAction->step(dt);
@@ -487,6 +875,17 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    if (_tweens->actions.size() > tweenCount)
+    {
+        stepTweens(dt, tweenCount, _tweens->actions.size());
+    }
+    _tweens->stepping = false;
+
+    if (_tweens->removed > 0 && _tweens->removed * 4 >= _tweens->actions.size())
+    {
+        compactTweens();
+    }
 }
 
 NS_CC_END
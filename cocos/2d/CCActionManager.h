@@ -38,6 +38,7 @@ NS_CC_BEGIN
 class Action;
 
 struct _hashElement;
+struct _tweenArrays;
 
 /**
  * @addtogroup actions
@@ -191,6 +192,20 @@ public:
      * @param dt    In seconds.
      */
     void update(float dt);
+
+    /** Sets whether the actions that are tweens are stepped in bulk.
+     *
+     * When enabled, the MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo, FadeIn, FadeOut and TintTo actions
+     * added afterwards, bare or wrapped in one of the eases of CCActionEase.h, aren't stepped one by one by step().
+     * Their elapsed times, easings and values are kept in arrays that are stepped together, before the other actions.
+     * Actions that aren't tweens, see ActionInterval::getTween(), and the ones of the JavaScript bindings are stepped as usual.
+     *
+     * @param enabled True to step the tweens in bulk.
+     */
+    static void setTweenBatchingEnabled(bool enabled);
+
+    /** Whether the actions that are tweens are stepped in bulk. */
+    static bool isTweenBatchingEnabled();
     
 protected:
     // declared in ActionManager.m
@@ -199,10 +214,18 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    void addTween(Action *action, struct _hashElement *element);
+    void removeTween(Action *action, struct _hashElement *element);
+    void removeTweens(struct _hashElement *element);
+    void pauseTweens(struct _hashElement *element, bool paused);
+    void stepTweens(float dt, size_t begin, size_t end);
+    void compactTweens();
+
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+    struct _tweenArrays    *_tweens;
 };
 
 // end of actions group
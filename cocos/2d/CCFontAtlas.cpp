@@ -30,11 +30,13 @@
 #include "platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
 #endif
 #include "2d/CCFontFreeType.h"
+#include "2d/CCFontGlyphCache.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCJobSystem.h"
 
 NS_CC_BEGIN
 
@@ -42,12 +44,168 @@ const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+const char* FontAtlas::CMD_UPDATE_FONTATLAS = "__cc_UPDATE_FONTATLAS";
+bool FontAtlas::s_asyncRasterization = false;
+
+const int FontLetterDefinitionTable::INVALID_INDEX;
+
+FontLetterDefinitionTable::FontLetterDefinitionTable()
+: _hashCount(0)
+, _version(0)
+{
+    std::fill(std::begin(_pages), std::end(_pages), INVALID_INDEX);
+    // Latin-1 is always direct-mapped
+    _pageSlots.assign(256, INVALID_INDEX);
+    _pages[0] = 0;
+}
+
+FontLetterDefinition& FontLetterDefinitionTable::operator[](char32_t utf32Char)
+{
+    int* slot = nullptr;
+    if (utf32Char < 0x10000)
+    {
+        int& page = _pages[utf32Char >> 8];
+        if (page < 0)
+        {
+            page = static_cast<int>(_pageSlots.size());
+            _pageSlots.resize(_pageSlots.size() + 256, INVALID_INDEX);
+        }
+        slot = &_pageSlots[page + (utf32Char & 0xFF)];
+        if (*slot != INVALID_INDEX)
+        {
+            ++_version;
+            return _definitions[*slot];
+        }
+        *slot = static_cast<int>(_definitions.size());
+    }
+    else
+    {
+        int index = findHashedIndex(utf32Char);
+        if (index != INVALID_INDEX)
+        {
+            ++_version;
+            return _definitions[index];
+        }
+        insertHashed(utf32Char, static_cast<int>(_definitions.size()));
+    }
+
+    FontLetterDefinition definition;
+    memset(&definition, 0, sizeof(definition));
+    _definitions.push_back(definition);
+    return _definitions.back();
+}
+
+void FontLetterDefinitionTable::findIndices(const char32_t* utf32Chars, int count, int* outIndices) const
+{
+    for (int i = 0; i < count; ++i)
+    {
+        outIndices[i] = findIndex(utf32Chars[i]);
+    }
+}
+
+void FontLetterDefinitionTable::clear()
+{
+    _definitions.clear();
+    std::fill(std::begin(_pages), std::end(_pages), INVALID_INDEX);
+    _pageSlots.assign(256, INVALID_INDEX);
+    _pages[0] = 0;
+    _hashKeys.clear();
+    _hashIndices.clear();
+    _hashCount = 0;
+    ++_version;
+}
+
+int FontLetterDefinitionTable::findHashedIndex(char32_t utf32Char) const
+{
+    if (_hashKeys.empty())
+    {
+        return INVALID_INDEX;
+    }
+
+    size_t mask = _hashKeys.size() - 1;
+    for (size_t i = (utf32Char * 2654435761u) & mask; ; i = (i + 1) & mask)
+    {
+        if (_hashIndices[i] == INVALID_INDEX)
+            return INVALID_INDEX;
+        if (_hashKeys[i] == utf32Char)
+            return _hashIndices[i];
+    }
+}
+
+void FontLetterDefinitionTable::insertHashed(char32_t utf32Char, int index)
+{
+    // keep the load factor under 1/2
+    if ((_hashCount + 1) * 2 > _hashKeys.size())
+    {
+        std::vector<char32_t> keys;
+        std::vector<int> indices;
+        keys.swap(_hashKeys);
+        indices.swap(_hashIndices);
+        size_t capacity = keys.empty() ? 16 : keys.size() * 2;
+        _hashKeys.assign(capacity, 0);
+        _hashIndices.assign(capacity, INVALID_INDEX);
+        _hashCount = 0;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            if (indices[i] != INVALID_INDEX)
+            {
+                insertHashed(keys[i], indices[i]);
+            }
+        }
+    }
+
+    size_t mask = _hashKeys.size() - 1;
+    size_t i = (utf32Char * 2654435761u) & mask;
+    while (_hashIndices[i] != INVALID_INDEX)
+    {
+        i = (i + 1) & mask;
+    }
+    _hashKeys[i] = utf32Char;
+    _hashIndices[i] = index;
+    ++_hashCount;
+}
+
+struct FontAtlas::GlyphBatch
+{
+    std::vector<char32_t> utf32Chars;
+    std::vector<unsigned int> charCodes;
+    std::vector<GlyphBitmap> glyphs;
+};
+
+static Texture2D::PixelFormat getPixelFormat(int bytesPerPixel)
+{
+    switch (bytesPerPixel)
+    {
+    case 3:
+        return Texture2D::PixelFormat::RGB888;
+    case 2:
+        return Texture2D::PixelFormat::AI88;
+    default:
+        return Texture2D::PixelFormat::A8;
+    }
+}
+
+void FontAtlas::setAsyncRasterizationEnabled(bool enabled)
+{
+    s_asyncRasterization = enabled;
+}
+
+bool FontAtlas::isAsyncRasterizationEnabled()
+{
+    return s_asyncRasterization;
+}
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _fontFreeType(nullptr)
 , _iconv(nullptr)
 , _currentPageData(nullptr)
+, _bytesPerPixel(1)
+, _rasterizer(nullptr)
+, _glyphCache(nullptr)
+, _rasterizing(false)
+, _generation(0)
+, _alive(std::make_shared<bool>(true))
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
@@ -71,24 +229,26 @@ FontAtlas::FontAtlas(Font &theFont)
         {
             _letterPadding += 2 * FontFreeType::DistanceMapSpread;    
         }
-        _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
+        _bytesPerPixel = _fontFreeType->getBytesPerPixel();
+        _currentPageDataSize = CacheTextureWidth * CacheTextureHeight * _bytesPerPixel;
         auto outlineSize = _fontFreeType->getOutlineSize();
         if(outlineSize > 0)
         {
             _lineHeight += 2 * outlineSize;
-            _currentPageDataSize *= 2;
         }
 
         _currentPageData = new (std::nothrow) unsigned char[_currentPageDataSize];
         memset(_currentPageData, 0, _currentPageDataSize);
 
-        auto  pixelFormat = outlineSize > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
+        auto  pixelFormat = getPixelFormat(_bytesPerPixel);
         texture->initWithData(_currentPageData, _currentPageDataSize, 
             pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
 
         addTexture(texture,0);
         texture->release();
 
+        _glyphCache = FontGlyphCache::create(_fontFreeType);
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
 
@@ -113,6 +273,10 @@ FontAtlas::~FontAtlas()
     releaseTextures();
 
     delete []_currentPageData;
+    delete _glyphCache;
+    CC_SAFE_RELEASE(_rasterizer);
+    // a batch in flight is dropped when it comes back
+    *_alive = false;
 
 #if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
     if (_iconv)
@@ -132,6 +296,10 @@ void FontAtlas::reset()
     _currentPageOrigX = 0;
     _currentPageOrigY = 0;
     _letterDefinitions.clear();
+
+    // glyphs being rendered belong to the previous textures
+    _pendingGlyphs.clear();
+    ++_generation;
 }
 
 void FontAtlas::releaseTextures()
@@ -166,8 +334,7 @@ void FontAtlas::addLetterDefinition(char32_t utf32Char, const FontLetterDefiniti
 
 void FontAtlas::scaleFontLetterDefinition(float scaleFactor)
 {
-    for (auto&& fontDefinition : _letterDefinitions) {
-        auto& letterDefinition = fontDefinition.second;
+    for (auto&& letterDefinition : _letterDefinitions) {
         letterDefinition.width *= scaleFactor;
         letterDefinition.height *= scaleFactor;
         letterDefinition.offsetX *= scaleFactor;
@@ -178,11 +345,11 @@ void FontAtlas::scaleFontLetterDefinition(float scaleFactor)
 
 bool FontAtlas::getLetterDefinitionForChar(char32_t utf32Char, FontLetterDefinition &letterDefinition)
 {
-    auto outIterator = _letterDefinitions.find(utf32Char);
+    auto definition = _letterDefinitions.find(utf32Char);
 
-    if (outIterator != _letterDefinitions.end())
+    if (definition)
     {
-        letterDefinition = (*outIterator).second;
+        letterDefinition = *definition;
         return letterDefinition.validDefinition;
     }
     else
@@ -288,8 +455,7 @@ void FontAtlas::findNewCharacters(const std::u32string& u32Text, std::unordered_
         newChars.reserve(length);
         for (size_t i = 0; i < length; ++i)
         {
-            auto outIterator = _letterDefinitions.find(u32Text[i]);
-            if (outIterator == _letterDefinitions.end())
+            if (_letterDefinitions.findIndex(u32Text[i]) == FontLetterDefinitionTable::INVALID_INDEX)
             {
                 newChars.push_back(u32Text[i]);
             }
@@ -334,117 +500,239 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     }
 
-    int adjustForDistanceMap = _letterPadding / 2;
-    int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
-    int glyphHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
-
-    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
-
+    bool async = s_asyncRasterization;
+    bool packed = false;
     float startY = _currentPageOrigY;
+    GlyphBitmap glyph;
 
     for (auto&& it : codeMapOfNewChar)
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        if (_glyphCache && _glyphCache->getGlyph(it.first, glyph))
         {
-            tempDef.validDefinition = true;
-            tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+            packGlyph(it.first, glyph, startY);
+            packed = true;
+        }
+        else if (async)
+        {
+            // placeholder until the glyph is rendered
+            FontLetterDefinition tempDef;
+            memset(&tempDef, 0, sizeof(tempDef));
+            tempDef.xAdvance = _fontFreeType->getGlyphAdvance(it.second);
+            tempDef.validDefinition = tempDef.xAdvance != 0;
+            _letterDefinitions[it.first] = tempDef;
+            _pendingGlyphs[it.first] = it.second;
+        }
+        else
+        {
+            _fontFreeType->renderGlyph(it.second, glyph);
+            if (_glyphCache)
+            {
+                _glyphCache->addGlyph(it.first, glyph);
+            }
+            packGlyph(it.first, glyph, startY);
+            packed = true;
+        }
+    }
+
+    if (packed)
+    {
+        updateTextureContent(startY);
+    }
+    if (_glyphCache)
+    {
+        _glyphCache->flush();
+    }
+    if (!_pendingGlyphs.empty())
+    {
+        rasterizePendingGlyphs();
+    }
+
+    return true;
+}
+
+void FontAtlas::packGlyph(char32_t utf32Char, const GlyphBitmap& glyph, float& startY)
+{
+    int adjustForDistanceMap = _letterPadding / 2;
+    int adjustForExtend = _letterEdgeExtend / 2;
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    FontLetterDefinition tempDef;
+    tempDef.xAdvance = glyph.xAdvance;
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+    if (glyph.width > 0 && glyph.height > 0 && !glyph.pixels.empty())
+    {
+        tempDef.validDefinition = true;
+        tempDef.width = glyph.rect.size.width + _letterPadding + _letterEdgeExtend;
+        tempDef.height = glyph.rect.size.height + _letterPadding + _letterEdgeExtend;
+        tempDef.offsetX = glyph.rect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY = _fontAscender + glyph.rect.origin.y - adjustForDistanceMap - adjustForExtend;
+
+        if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+        {
+            _currentPageOrigY += _currLineHeight;
+            _currLineHeight = 0;
+            _currentPageOrigX = 0;
+            if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
+                auto data = _currentPageData + CacheTextureWidth * (int)startY * _bytesPerPixel;
+                _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
+                    CacheTextureWidth, CacheTextureHeight - startY);
+
+                startY = 0.0f;
+
+                _currentPageOrigY = 0;
+                memset(_currentPageData, 0, _currentPageDataSize);
+                _currentPage++;
+                auto tex = new (std::nothrow) Texture2D;
+                if (_antialiasEnabled)
                 {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
+                    tex->setAntiAliasTexParameters();
                 }
+                else
+                {
+                    tex->setAliasTexParameters();
+                }
+                tex->initWithData(_currentPageData, _currentPageDataSize,
+                    getPixelFormat(_bytesPerPixel), CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
+                addTexture(tex, _currentPage);
+                tex->release();
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
-            {
-                _currLineHeight = glyphHeight;
-            }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
-
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width = tempDef.width / scaleFactor;
-            tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
         }
-        else{
-            if (tempDef.xAdvance)
-                tempDef.validDefinition = true;
-            else
-                tempDef.validDefinition = false;
-
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            _currentPageOrigX += 1;
+        int glyphHeight = static_cast<int>(glyph.height) + _letterEdgeExtend;
+        if (glyphHeight > _currLineHeight)
+        {
+            _currLineHeight = glyphHeight;
         }
 
-        _letterDefinitions[it.first] = tempDef;
+        auto rowSize = glyph.width * _bytesPerPixel;
+        auto src = glyph.pixels.data();
+        auto dest = _currentPageData + ((int)_currentPageOrigY + adjustForExtend) * CacheTextureWidth * _bytesPerPixel
+            + ((int)_currentPageOrigX + adjustForExtend) * _bytesPerPixel;
+        for (long y = 0; y < glyph.height; ++y)
+        {
+            memcpy(dest, src, rowSize);
+            src += rowSize;
+            dest += CacheTextureWidth * _bytesPerPixel;
+        }
+
+        tempDef.U = _currentPageOrigX;
+        tempDef.V = _currentPageOrigY;
+        tempDef.textureID = _currentPage;
+        _currentPageOrigX += tempDef.width + 1;
+        // take from pixels to points
+        tempDef.width = tempDef.width / scaleFactor;
+        tempDef.height = tempDef.height / scaleFactor;
+        tempDef.U = tempDef.U / scaleFactor;
+        tempDef.V = tempDef.V / scaleFactor;
+    }
+    else{
+        if (tempDef.xAdvance)
+            tempDef.validDefinition = true;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width = 0;
+        tempDef.height = 0;
+        tempDef.U = 0;
+        tempDef.V = 0;
+        tempDef.offsetX = 0;
+        tempDef.offsetY = 0;
+        tempDef.textureID = 0;
+        _currentPageOrigX += 1;
+    }
+
+    _letterDefinitions[utf32Char] = tempDef;
+}
+
+void FontAtlas::updateTextureContent(float startY)
+{
+    auto data = _currentPageData + CacheTextureWidth * (int)startY * _bytesPerPixel;
+    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
+}
+
+void FontAtlas::rasterizePendingGlyphs()
+{
+    // a single batch at a time, the rasterizer isn't thread-safe
+    if (_rasterizing || _pendingGlyphs.empty())
+    {
+        return;
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    if (_rasterizer == nullptr)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        _rasterizer = _fontFreeType->createRasterizer();
+        if (_rasterizer == nullptr)
+        {
+            CCLOG("FontAtlas: can't create a rasterizer for %s, rendering on the cocos thread", _fontFreeType->getFontName().c_str());
+            auto pendingGlyphs = std::move(_pendingGlyphs);
+            _pendingGlyphs.clear();
+            float startY = _currentPageOrigY;
+            GlyphBitmap glyph;
+            for (auto&& it : pendingGlyphs)
+            {
+                _fontFreeType->renderGlyph(it.second, glyph);
+                packGlyph(it.first, glyph, startY);
+            }
+            updateTextureContent(startY);
+            return;
+        }
     }
-    else
+
+    auto batch = std::make_shared<GlyphBatch>();
+    batch->utf32Chars.reserve(_pendingGlyphs.size());
+    batch->charCodes.reserve(_pendingGlyphs.size());
+    for (auto&& it : _pendingGlyphs)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        batch->utf32Chars.push_back(it.first);
+        batch->charCodes.push_back(it.second);
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
+    _pendingGlyphs.clear();
+
+    // the rasterizer stays alive until the batch comes back, the atlas may not:
+    // it isn't retained, so that FontAtlasCache sees the last release of the labels
+    _rasterizer->retain();
+    _rasterizing = true;
+    auto rasterizer = _rasterizer;
+    auto generation = _generation;
+    auto alive = _alive;
+    JobSystem::getInstance()->schedule([rasterizer, batch]{
+        batch->glyphs.resize(batch->charCodes.size());
+        for (size_t i = 0; i < batch->charCodes.size(); ++i)
+        {
+            rasterizer->renderGlyph(batch->charCodes[i], batch->glyphs[i]);
+        }
+    }, JobSystem::Priority::NORMAL, [this, rasterizer, batch, generation, alive]{
+        if (*alive)
+        {
+            onGlyphsRasterized(batch, generation);
+        }
+        rasterizer->release();
+    });
+}
 
-    return true;
+void FontAtlas::onGlyphsRasterized(const std::shared_ptr<GlyphBatch>& batch, unsigned int generation)
+{
+    _rasterizing = false;
+    if (generation == _generation && !_atlasTextures.empty())
+    {
+        float startY = _currentPageOrigY;
+        for (size_t i = 0; i < batch->glyphs.size(); ++i)
+        {
+            packGlyph(batch->utf32Chars[i], batch->glyphs[i], startY);
+            if (_glyphCache)
+            {
+                _glyphCache->addGlyph(batch->utf32Chars[i], batch->glyphs[i]);
+            }
+        }
+        updateTextureContent(startY);
+        if (_glyphCache)
+        {
+            _glyphCache->flush();
+        }
+
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+    }
+
+    rasterizePendingGlyphs();
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
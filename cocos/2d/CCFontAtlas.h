@@ -28,8 +28,10 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
@@ -42,6 +44,8 @@ class Texture2D;
 class EventCustom;
 class EventListenerCustom;
 class FontFreeType;
+class FontGlyphCache;
+struct GlyphBitmap;
 
 struct FontLetterDefinition
 {
@@ -56,6 +60,73 @@ struct FontLetterDefinition
     int xAdvance;
 };
 
+/**
+ * Letter definitions of a FontAtlas, indexed by character.
+ *
+ * Characters of the Basic Multilingual Plane are direct-mapped through pages of 256 slots allocated on demand,
+ * the Latin-1 page being the first one. Other characters go through an open-addressing hash table.
+ * The definitions are stored contiguously and keep their index until clear(), so a label can resolve the
+ * indices of its characters once per layout and read the definitions with at().
+ */
+class CC_DLL FontLetterDefinitionTable
+{
+public:
+    static const int INVALID_INDEX = -1;
+
+    FontLetterDefinitionTable();
+
+    /** Returns the index of the definition of a character, or INVALID_INDEX. */
+    int findIndex(char32_t utf32Char) const
+    {
+        if (utf32Char < 0x10000)
+        {
+            int page = _pages[utf32Char >> 8];
+            return page < 0 ? INVALID_INDEX : _pageSlots[page + (utf32Char & 0xFF)];
+        }
+        return findHashedIndex(utf32Char);
+    }
+
+    const FontLetterDefinition* find(char32_t utf32Char) const
+    {
+        int index = findIndex(utf32Char);
+        return index == INVALID_INDEX ? nullptr : &_definitions[index];
+    }
+
+    const FontLetterDefinition& at(int index) const { return _definitions[index]; }
+
+    /** Returns the definition of a character, inserting an empty one if it has none. */
+    FontLetterDefinition& operator[](char32_t utf32Char);
+
+    /** Resolves the definition indices of count characters in one pass. */
+    void findIndices(const char32_t* utf32Chars, int count, int* outIndices) const;
+
+    void clear();
+
+    bool empty() const { return _definitions.empty(); }
+    size_t size() const { return _definitions.size(); }
+
+    /** Incremented when existing definitions change, so that layouts depending on them can be invalidated. */
+    unsigned int getVersion() const { return _version; }
+
+    std::vector<FontLetterDefinition>::iterator begin() { ++_version; return _definitions.begin(); }
+    std::vector<FontLetterDefinition>::iterator end() { return _definitions.end(); }
+
+protected:
+    int findHashedIndex(char32_t utf32Char) const;
+    void insertHashed(char32_t utf32Char, int index);
+
+    std::vector<FontLetterDefinition> _definitions;
+    // slots of the allocated BMP pages, each one is an index in _definitions or INVALID_INDEX
+    std::vector<int> _pageSlots;
+    // offset of each BMP page in _pageSlots, or INVALID_INDEX
+    int _pages[256];
+    // characters outside the BMP, linear probing with a power of two capacity
+    std::vector<char32_t> _hashKeys;
+    std::vector<int> _hashIndices;
+    size_t _hashCount;
+    unsigned int _version;
+};
+
 class CC_DLL FontAtlas : public Ref
 {
 public:
@@ -63,6 +134,17 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    static const char* CMD_UPDATE_FONTATLAS;
+
+    /**
+     * Renders the glyphs of new characters on a thread of the JobSystem instead of the cocos thread.
+     * Until they are ready the characters have empty letter definitions with an estimated advance, then
+     * the atlas dispatches CMD_UPDATE_FONTATLAS so that the labels using it update their content.
+     * Disabled by default.
+     */
+    static void setAsyncRasterizationEnabled(bool enabled);
+    static bool isAsyncRasterizationEnabled();
+
     /**
      * @js ctor
      */
@@ -78,6 +160,9 @@ public:
     
     bool prepareLetterDefinitions(const std::u32string& utf16String);
 
+    /** Returns true if glyphs are being rendered asynchronously. */
+    bool hasPendingGlyphs() const { return _rasterizing || !_pendingGlyphs.empty(); }
+
     const std::unordered_map<ssize_t, Texture2D*>& getTextures() const { return _atlasTextures; }
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -109,6 +194,8 @@ public:
      void setAliasTexParameters();
 
 protected:
+    struct GlyphBatch;
+
     void reset();
     
     void releaseTextures();
@@ -124,8 +211,17 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
 
+    /** Copies a rendered glyph into the current page, starting a new page if it is full. */
+    void packGlyph(char32_t utf32Char, const GlyphBitmap& glyph, float& startY);
+
+    /** Uploads the rows of the current page changed since startY. */
+    void updateTextureContent(float startY);
+
+    void rasterizePendingGlyphs();
+    void onGlyphsRasterized(const std::shared_ptr<GlyphBatch>& batch, unsigned int generation);
+
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
-    std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
+    FontLetterDefinitionTable _letterDefinitions;
     float _lineHeight;
     Font* _font;
     FontFreeType* _fontFreeType;
@@ -139,12 +235,24 @@ protected:
     float _currentPageOrigY;
     int _letterPadding;
     int _letterEdgeExtend;
+    int _bytesPerPixel;
+
+    // Asynchronous rasterization and disk cache
+    FontFreeType* _rasterizer;
+    FontGlyphCache* _glyphCache;
+    std::unordered_map<char32_t, unsigned int> _pendingGlyphs;
+    bool _rasterizing;
+    unsigned int _generation;
+    // false once the atlas is destroyed, checked by the batch in flight
+    std::shared_ptr<bool> _alive;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
     bool _antialiasEnabled;
     int _currLineHeight;
 
+    static bool s_asyncRasterization;
+
     friend class Label;
 };
 
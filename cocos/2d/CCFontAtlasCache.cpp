@@ -25,6 +25,7 @@
 #include "2d/CCFontAtlasCache.h"
 
 #include "base/CCDirector.h"
+#include "2d/CCFontBaked.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCFontAtlas.h"
@@ -50,6 +51,11 @@ void FontAtlasCache::purgeCachedData()
 FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 {
     auto realFontFilename = FileUtils::getInstance()->getNewFilename(config->fontFilePath);  // resolves real file path, to prevent storing multiple atlases for the same file.
+    if (FontBaked::isBakedFontFile(realFontFilename))
+    {
+        return getFontAtlasBaked(realFontFilename);
+    }
+
     bool useDistanceField = config->distanceFieldEnabled;
     if(config->outlineSize > 0)
     {
@@ -57,7 +63,10 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
     }
 
     char tmp[ATLAS_MAP_KEY_BUFFER];
-    if (useDistanceField) {
+    if (useDistanceField && FontFreeType::isMultiChannelDistanceFieldEnabled()) {
+        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "msdf %.2f %d %s", config->fontSize, config->outlineSize,
+                 realFontFilename.c_str());
+    } else if (useDistanceField) {
         snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "df %.2f %d %s", config->fontSize, config->outlineSize,
                  realFontFilename.c_str());
     } else {
@@ -94,6 +103,11 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName, const Vec2& imageOffset /* = Vec2::ZERO */)
 {
     auto realFontFilename = FileUtils::getInstance()->getNewFilename(fontFileName);  // resolves real file path, to prevent storing multiple atlases for the same file.
+    if (FontBaked::isBakedFontFile(realFontFilename))
+    {
+        return getFontAtlasBaked(realFontFilename);
+    }
+
     char tmp[ATLAS_MAP_KEY_BUFFER];
     snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "%.2f %.2f %s", imageOffset.x, imageOffset.y, realFontFilename.c_str());
     std::string atlasName = tmp;
@@ -122,6 +136,35 @@ FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName, cons
     return nullptr;
 }
 
+FontAtlas* FontAtlasCache::getFontAtlasBaked(const std::string& realFontFilename)
+{
+    // the baked file sets the size, outline and distance field of the font
+    std::string atlasName = "baked " + realFontFilename;
+
+    auto it = _atlasMap.find(atlasName);
+    if ( it == _atlasMap.end() )
+    {
+        auto font = FontBaked::create(realFontFilename);
+
+        if(font)
+        {
+            auto tempAtlas = font->createFontAtlas();
+            if (tempAtlas)
+            {
+                _atlasMap[atlasName] = tempAtlas;
+                return _atlasMap[atlasName];
+            }
+        }
+    }
+    else
+    {
+        _atlasMap[atlasName]->retain();
+        return _atlasMap[atlasName];
+    }
+
+    return nullptr;
+}
+
 FontAtlas* FontAtlasCache::getFontAtlasCharMap(const std::string& plistFile)
 {
     std::string atlasName = plistFile;
@@ -67,6 +67,8 @@ public:
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
 private:
+    static FontAtlas* getFontAtlasBaked(const std::string& realFontFilename);
+
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
 };
 
@@ -0,0 +1,582 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCFontBaked.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <string.h>
+
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontFNT.h"
+#include "2d/CCFontFreeType.h"
+#include "base/ccUTF8.h"
+#include "base/CCDirector.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+const char* FontBaked::FILE_EXTENSION = ".cfa";
+const uint32_t FontBaked::FILE_VERSION = 1;
+
+static const char FILE_MAGIC[4] = { 'C', 'C', 'F', 'A' };
+
+namespace
+{
+    struct PageFormatInfo
+    {
+        uint32_t format;
+        Texture2D::PixelFormat pixelFormat;
+        int bytesPerPixel;
+    };
+
+    const PageFormatInfo PAGE_FORMATS[] = {
+        { FontBaked::PAGE_A8, Texture2D::PixelFormat::A8, 1 },
+        { FontBaked::PAGE_I8, Texture2D::PixelFormat::I8, 1 },
+        { FontBaked::PAGE_AI88, Texture2D::PixelFormat::AI88, 2 },
+        { FontBaked::PAGE_RGB888, Texture2D::PixelFormat::RGB888, 3 },
+        { FontBaked::PAGE_RGBA8888, Texture2D::PixelFormat::RGBA8888, 4 },
+    };
+
+    const PageFormatInfo* findPageFormat(uint32_t format)
+    {
+        for (auto&& info : PAGE_FORMATS)
+        {
+            if (info.format == format)
+                return &info;
+        }
+        return nullptr;
+    }
+
+    const PageFormatInfo* findPageFormat(Texture2D::PixelFormat pixelFormat)
+    {
+        for (auto&& info : PAGE_FORMATS)
+        {
+            if (info.pixelFormat == pixelFormat)
+                return &info;
+        }
+        return nullptr;
+    }
+
+    size_t alignSize(size_t size)
+    {
+        return (size + 3) & ~(size_t)3;
+    }
+
+    // Kerning of every pair of characters, asked to the font one first character at a time.
+    void collectKernings(const Font* font, const std::u32string& chars, bool onFirstLetter, std::vector<FontBaked::KerningRecord>& kernings)
+    {
+        std::u32string text;
+        text.reserve(chars.size() * 2);
+        for (auto first : chars)
+        {
+            text.clear();
+            for (auto second : chars)
+            {
+                text.push_back(first);
+                text.push_back(second);
+            }
+
+            int letterCount = 0;
+            int* sizes = font->getHorizontalKerningForTextUTF32(text, letterCount);
+            if (!sizes)
+                continue;
+
+            for (size_t i = 0; i < chars.size(); ++i)
+            {
+                int amount = sizes[onFirstLetter ? 2 * i : 2 * i + 1];
+                if (amount != 0)
+                {
+                    FontBaked::KerningRecord record = { first, chars[i], amount };
+                    kernings.push_back(record);
+                }
+            }
+            delete [] sizes;
+        }
+    }
+
+    bool writeBakedFile(const std::string& outputPath, const FontBaked::FileHeader& header,
+        const std::vector<FontBaked::GlyphRecord>& glyphs, const std::vector<FontBaked::KerningRecord>& kernings,
+        std::vector<FontBaked::PageRecord>& pages, const std::vector<const unsigned char*>& pagePixels)
+    {
+        size_t size = sizeof(header) + glyphs.size() * sizeof(glyphs[0]) + kernings.size() * sizeof(kernings[0])
+            + pages.size() * sizeof(pages[0]);
+        for (auto&& page : pages)
+        {
+            page.dataOffset = static_cast<uint32_t>(size);
+            size = alignSize(size + page.dataSize);
+        }
+
+        std::vector<unsigned char> bytes(size, 0);
+        auto dest = bytes.data();
+        memcpy(dest, &header, sizeof(header));
+        dest += sizeof(header);
+        if (!glyphs.empty())
+        {
+            memcpy(dest, glyphs.data(), glyphs.size() * sizeof(glyphs[0]));
+            dest += glyphs.size() * sizeof(glyphs[0]);
+        }
+        if (!kernings.empty())
+        {
+            memcpy(dest, kernings.data(), kernings.size() * sizeof(kernings[0]));
+            dest += kernings.size() * sizeof(kernings[0]);
+        }
+        memcpy(dest, pages.data(), pages.size() * sizeof(pages[0]));
+        for (size_t i = 0; i < pages.size(); ++i)
+        {
+            memcpy(bytes.data() + pages[i].dataOffset, pagePixels[i], pages[i].dataSize);
+        }
+
+        Data data;
+        data.copy(bytes.data(), static_cast<ssize_t>(bytes.size()));
+        if (!FileUtils::getInstance()->writeDataToFile(data, outputPath))
+        {
+            CCLOG("FontBaked: can't write %s", outputPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    FontBaked::FileHeader createFileHeader()
+    {
+        FontBaked::FileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FontBaked::FILE_VERSION;
+        header.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+        return header;
+    }
+}
+
+bool FontBaked::isBakedFontFile(const std::string& filePath)
+{
+    size_t extensionLength = strlen(FILE_EXTENSION);
+    return filePath.size() > extensionLength
+        && FileUtils::getInstance()->getFileExtension(filePath) == FILE_EXTENSION;
+}
+
+FontBaked* FontBaked::create(const std::string& bakedFilePath)
+{
+    auto fullPath = FileUtils::getInstance()->fullPathForFilename(bakedFilePath);
+    if (fullPath.empty())
+        return nullptr;
+
+    auto font = new (std::nothrow) FontBaked();
+    if (font && font->initWithFile(fullPath))
+    {
+        font->autorelease();
+        return font;
+    }
+    delete font;
+    return nullptr;
+}
+
+FontBaked::FontBaked()
+: _header(nullptr)
+, _glyphs(nullptr)
+, _kernings(nullptr)
+, _pages(nullptr)
+{
+}
+
+FontBaked::~FontBaked()
+{
+}
+
+bool FontBaked::initWithFile(const std::string& fullPath)
+{
+    if (!_file.open(fullPath))
+        return false;
+
+    auto bytes = _file.getBytes();
+    size_t size = _file.getSize();
+    if (reinterpret_cast<uintptr_t>(bytes) % 4 != 0)
+    {
+        _alignedData.copy(bytes, static_cast<ssize_t>(size));
+        _file.close();
+        bytes = _alignedData.getBytes();
+    }
+
+    auto header = reinterpret_cast<const FileHeader*>(bytes);
+    if (size < sizeof(FileHeader) || memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || header->version != FILE_VERSION)
+    {
+        CCLOG("FontBaked: %s isn't a baked font of version %u", fullPath.c_str(), FILE_VERSION);
+        return false;
+    }
+
+    size_t kerningsOffset = sizeof(FileHeader) + (size_t)header->glyphCount * sizeof(GlyphRecord);
+    size_t pagesOffset = kerningsOffset + (size_t)header->kerningCount * sizeof(KerningRecord);
+    if (pagesOffset + (size_t)header->pageCount * sizeof(PageRecord) > size || header->pageCount == 0)
+    {
+        CCLOG("FontBaked: %s is truncated", fullPath.c_str());
+        return false;
+    }
+
+    _header = header;
+    _glyphs = reinterpret_cast<const GlyphRecord*>(bytes + sizeof(FileHeader));
+    _kernings = reinterpret_cast<const KerningRecord*>(bytes + kerningsOffset);
+    _pages = reinterpret_cast<const PageRecord*>(bytes + pagesOffset);
+
+    for (uint32_t i = 0; i < header->pageCount; ++i)
+    {
+        auto& page = _pages[i];
+        auto formatInfo = findPageFormat(page.format);
+        if (!formatInfo || (size_t)page.dataOffset + page.dataSize > size
+            || page.dataSize < (size_t)page.width * page.height * formatInfo->bytesPerPixel)
+        {
+            CCLOG("FontBaked: page %u of %s is invalid", i, fullPath.c_str());
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->glyphCount; ++i)
+    {
+        auto textureID = _glyphs[i].textureID;
+        if (textureID < 0 || (uint32_t)textureID >= header->pageCount)
+        {
+            CCLOG("FontBaked: glyph %u of %s is on missing page %d", i, fullPath.c_str(), (int)textureID);
+            return false;
+        }
+    }
+    return true;
+}
+
+FontAtlas* FontBaked::createFontAtlas()
+{
+    auto atlas = new (std::nothrow) FontAtlas(*this);
+    if (atlas == nullptr)
+        return nullptr;
+
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    if (std::abs(scaleFactor - _header->contentScaleFactor) > FLT_EPSILON)
+    {
+        CCLOG("FontBaked: the font was baked for a content scale factor of %.2f instead of %.2f",
+            _header->contentScaleFactor, scaleFactor);
+    }
+
+    atlas->setLineHeight(_header->lineHeight);
+
+    FontLetterDefinition definition;
+    for (uint32_t i = 0; i < _header->glyphCount; ++i)
+    {
+        auto& glyph = _glyphs[i];
+        // take from pixels to points
+        definition.U = glyph.u / scaleFactor;
+        definition.V = glyph.v / scaleFactor;
+        definition.width = glyph.width / scaleFactor;
+        definition.height = glyph.height / scaleFactor;
+        definition.offsetX = glyph.offsetX;
+        definition.offsetY = glyph.offsetY;
+        definition.textureID = glyph.textureID;
+        definition.xAdvance = glyph.xAdvance;
+        definition.validDefinition = glyph.valid != 0;
+        atlas->addLetterDefinition(glyph.utf32Char, definition);
+    }
+
+    auto bytes = reinterpret_cast<const unsigned char*>(_header);
+    for (uint32_t i = 0; i < _header->pageCount; ++i)
+    {
+        auto& page = _pages[i];
+        auto texture = new (std::nothrow) Texture2D;
+        if (texture == nullptr || !texture->initWithData(bytes + page.dataOffset, page.dataSize, findPageFormat(page.format)->pixelFormat,
+            page.width, page.height, Size(page.width, page.height)))
+        {
+            CC_SAFE_RELEASE(texture);
+            CC_SAFE_RELEASE(atlas);
+            return nullptr;
+        }
+        texture->_hasPremultipliedAlpha = (page.flags & PREMULTIPLIED_ALPHA) != 0;
+        atlas->addTexture(texture, i);
+        texture->release();
+    }
+
+    return atlas;
+}
+
+int* FontBaked::getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const
+{
+    outNumLetters = static_cast<int>(text.length());
+
+    if (!outNumLetters)
+        return nullptr;
+
+    int *sizes = new (std::nothrow) int[outNumLetters];
+    if (!sizes)
+        return nullptr;
+    memset(sizes, 0, outNumLetters * sizeof(int));
+
+    if (_header->kerningCount > 0)
+    {
+        int shift = (_header->flags & KERNING_ON_FIRST_LETTER) ? 1 : 0;
+        for (int c = 1; c < outNumLetters; ++c)
+        {
+            sizes[c - shift] = getHorizontalKerningForChars(text[c - 1], text[c]);
+        }
+    }
+
+    return sizes;
+}
+
+int FontBaked::getHorizontalKerningForChars(char32_t firstChar, char32_t secondChar) const
+{
+    auto end = _kernings + _header->kerningCount;
+    auto it = std::lower_bound(_kernings, end, std::make_pair(firstChar, secondChar),
+        [](const KerningRecord& record, const std::pair<char32_t, char32_t>& pair) {
+            return record.first < pair.first || (record.first == pair.first && record.second < pair.second);
+        });
+    if (it != end && it->first == firstChar && it->second == secondChar)
+        return it->amount;
+    return 0;
+}
+
+int FontBaked::getFontMaxHeight() const
+{
+    return static_cast<int>(_header->lineHeight);
+}
+
+int FontBaked::getOriginalFontSize() const
+{
+    return static_cast<int>(_header->fontSize);
+}
+
+bool FontBaked::bakeFontFreeType(const std::string& fontFilePath, float fontSize, const std::string& glyphs,
+    bool distanceFieldEnabled, int outline, const std::string& outputPath, int pageSize)
+{
+    if (outline > 0)
+    {
+        distanceFieldEnabled = false;
+    }
+
+    std::u32string chars;
+    if (!StringUtils::UTF8ToUTF32(glyphs, chars) || chars.empty())
+    {
+        CCLOG("FontBaked: no glyph to bake");
+        return false;
+    }
+    std::sort(chars.begin(), chars.end());
+    chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+    auto fullPath = FileUtils::getInstance()->fullPathForFilename(fontFilePath);
+    auto font = FontFreeType::create(fullPath, fontSize, GlyphCollection::DYNAMIC, nullptr, distanceFieldEnabled, outline);
+    if (font == nullptr)
+    {
+        CCLOG("FontBaked: can't open %s", fontFilePath.c_str());
+        return false;
+    }
+    if (font->getEncoding() != FT_ENCODING_UNICODE)
+    {
+        CCLOG("FontBaked: %s has no unicode character map", fontFilePath.c_str());
+        font->release();
+        return false;
+    }
+
+    // same metrics as the glyphs packed by FontAtlas
+    int bytesPerPixel = font->getBytesPerPixel();
+    int letterPadding = distanceFieldEnabled ? 2 * FontFreeType::DistanceMapSpread : 0;
+    int letterEdgeExtend = 2;
+    int adjustForPadding = letterPadding / 2 + letterEdgeExtend / 2;
+    float lineHeight = font->getFontMaxHeight();
+    if (font->getOutlineSize() > 0)
+    {
+        lineHeight += 2 * font->getOutlineSize();
+    }
+    int fontAscender = font->getFontAscender();
+    size_t pageDataSize = (size_t)pageSize * pageSize * bytesPerPixel;
+
+    std::vector<std::vector<unsigned char>> pages(1, std::vector<unsigned char>(pageDataSize, 0));
+    std::vector<GlyphRecord> glyphRecords;
+    glyphRecords.reserve(chars.size());
+    float originX = 0.f;
+    float originY = 0.f;
+    int rowHeight = 0;
+    GlyphBitmap glyph;
+    for (auto utf32Char : chars)
+    {
+        font->renderGlyph(utf32Char, glyph);
+
+        GlyphRecord record;
+        memset(&record, 0, sizeof(record));
+        record.utf32Char = utf32Char;
+        record.xAdvance = glyph.xAdvance;
+        if (glyph.width > 0 && glyph.height > 0 && !glyph.pixels.empty())
+        {
+            record.valid = 1;
+            record.width = glyph.rect.size.width + letterPadding + letterEdgeExtend;
+            record.height = glyph.rect.size.height + letterPadding + letterEdgeExtend;
+            record.offsetX = glyph.rect.origin.x - adjustForPadding;
+            record.offsetY = fontAscender + glyph.rect.origin.y - adjustForPadding;
+
+            if (originX + record.width > pageSize)
+            {
+                originY += rowHeight;
+                rowHeight = 0;
+                originX = 0.f;
+            }
+            if (originY + record.height > pageSize)
+            {
+                originY = 0.f;
+                originX = 0.f;
+                rowHeight = 0;
+                pages.emplace_back(pageDataSize, 0);
+            }
+            if (record.width > pageSize || record.height > pageSize)
+            {
+                CCLOG("FontBaked: the glyph of U+%04X is larger than a page", (unsigned)utf32Char);
+                font->release();
+                return false;
+            }
+            int glyphHeight = static_cast<int>(glyph.height) + letterEdgeExtend;
+            rowHeight = std::max(rowHeight, glyphHeight);
+
+            auto rowSize = glyph.width * bytesPerPixel;
+            auto src = glyph.pixels.data();
+            auto dest = pages.back().data() + ((int)originY + letterEdgeExtend / 2) * pageSize * bytesPerPixel
+                + ((int)originX + letterEdgeExtend / 2) * bytesPerPixel;
+            for (long y = 0; y < glyph.height; ++y)
+            {
+                memcpy(dest, src, rowSize);
+                src += rowSize;
+                dest += pageSize * bytesPerPixel;
+            }
+
+            record.u = originX;
+            record.v = originY;
+            record.textureID = static_cast<int32_t>(pages.size() - 1);
+            originX += record.width + 1;
+        }
+        else
+        {
+            record.valid = glyph.xAdvance != 0;
+            originX += 1;
+        }
+        glyphRecords.push_back(record);
+    }
+
+    std::vector<KerningRecord> kernings;
+    collectKernings(font, chars, false, kernings);
+
+    auto header = createFileHeader();
+    if (distanceFieldEnabled)
+        header.flags |= DISTANCE_FIELD;
+    if (font->isMultiChannelDistanceField())
+        header.flags |= MULTI_CHANNEL_DISTANCE_FIELD;
+    header.fontSize = font->getFontSize() * CC_CONTENT_SCALE_FACTOR();
+    header.lineHeight = lineHeight;
+    header.outlineSize = static_cast<float>(outline);
+    header.glyphCount = static_cast<uint32_t>(glyphRecords.size());
+    header.kerningCount = static_cast<uint32_t>(kernings.size());
+    header.pageCount = static_cast<uint32_t>(pages.size());
+    font->release();
+
+    uint32_t format = bytesPerPixel == 3 ? PAGE_RGB888 : (bytesPerPixel == 2 ? PAGE_AI88 : PAGE_A8);
+    std::vector<PageRecord> pageRecords;
+    std::vector<const unsigned char*> pagePixels;
+    for (auto&& page : pages)
+    {
+        PageRecord record = { (uint32_t)pageSize, (uint32_t)pageSize, format, 0, 0, (uint32_t)pageDataSize };
+        pageRecords.push_back(record);
+        pagePixels.push_back(page.data());
+    }
+
+    return writeBakedFile(outputPath, header, glyphRecords, kernings, pageRecords, pagePixels);
+}
+
+bool FontBaked::bakeFontFNT(const std::string& fntFilePath, const std::string& outputPath)
+{
+    auto font = FontFNT::create(fntFilePath);
+    if (font == nullptr)
+    {
+        CCLOG("FontBaked: can't open %s", fntFilePath.c_str());
+        return false;
+    }
+
+    // the letter definitions are read back from the atlas built by FontFNT
+    auto atlas = font->createFontAtlas();
+    if (atlas == nullptr)
+        return false;
+
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    std::u32string chars;
+    std::vector<GlyphRecord> glyphRecords;
+    FontLetterDefinition definition;
+    for (char32_t utf32Char = 0; utf32Char <= 0xFFFF; ++utf32Char)
+    {
+        if (!atlas->getLetterDefinitionForChar(utf32Char, definition))
+            continue;
+
+        GlyphRecord record;
+        memset(&record, 0, sizeof(record));
+        record.utf32Char = utf32Char;
+        record.u = definition.U * scaleFactor;
+        record.v = definition.V * scaleFactor;
+        record.width = definition.width * scaleFactor;
+        record.height = definition.height * scaleFactor;
+        record.offsetX = definition.offsetX;
+        record.offsetY = definition.offsetY;
+        record.textureID = definition.textureID;
+        record.xAdvance = definition.xAdvance;
+        record.valid = 1;
+        glyphRecords.push_back(record);
+        chars.push_back(utf32Char);
+    }
+    float lineHeight = atlas->getLineHeight();
+    atlas->release();
+
+    Image image;
+    if (!image.initWithImageFile(font->getAtlasName()))
+    {
+        CCLOG("FontBaked: can't read the texture of %s", fntFilePath.c_str());
+        return false;
+    }
+    auto formatInfo = findPageFormat(image.getRenderFormat());
+    if (image.isCompressed() || formatInfo == nullptr)
+    {
+        CCLOG("FontBaked: the texture format of %s isn't supported", fntFilePath.c_str());
+        return false;
+    }
+
+    std::vector<KerningRecord> kernings;
+    collectKernings(font, chars, true, kernings);
+
+    auto header = createFileHeader();
+    header.flags = KERNING_ON_FIRST_LETTER;
+    header.fontSize = static_cast<float>(font->getOriginalFontSize());
+    header.lineHeight = lineHeight;
+    header.glyphCount = static_cast<uint32_t>(glyphRecords.size());
+    header.kerningCount = static_cast<uint32_t>(kernings.size());
+    header.pageCount = 1;
+
+    PageRecord page = { (uint32_t)image.getWidth(), (uint32_t)image.getHeight(), formatInfo->format,
+        image.hasPremultipliedAlpha() ? (uint32_t)PREMULTIPLIED_ALPHA : 0u, 0, (uint32_t)image.getDataLen() };
+    std::vector<PageRecord> pageRecords(1, page);
+    std::vector<const unsigned char*> pagePixels(1, image.getData());
+
+    return writeBakedFile(outputPath, header, glyphRecords, kernings, pageRecords, pagePixels);
+}
+
+NS_CC_END
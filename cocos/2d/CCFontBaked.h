@@ -0,0 +1,181 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef _CCFontBaked_h_
+#define _CCFontBaked_h_
+
+/// @cond DO_NOT_SHOW
+
+#include <cstdint>
+#include "2d/CCFont.h"
+#include "base/CCMappedFile.h"
+
+NS_CC_BEGIN
+
+/**
+ * A font read from a pre-baked font atlas file (".cfa"), made offline by bakeFontFreeType() or bakeFontFNT().
+ *
+ * The file holds the letter definitions, the kerning pairs and the pages of the atlas with their pixels ready to
+ * be uploaded. It is mapped in memory and read in place, so creating the font atlas only costs the texture uploads.
+ * The glyph set is fixed when baking: the characters that weren't baked aren't rendered.
+ * Labels use a font baked from a TrueType font as a TTF font whose file path is the baked file, the distance field
+ * and outline settings of the file replacing the ones of the TTFConfig. A font baked from a BMFont is used as a
+ * BMFont (Label::createWithBMFont()).
+ * The pages are baked for the content scale factor in use when baking, a mismatch is logged.
+ *
+ * Layout of the file, little endian, 4-byte aligned:
+ * FileHeader, GlyphRecord[glyphCount] sorted by character, KerningRecord[kerningCount] sorted by pair,
+ * PageRecord[pageCount], then the pixels of the pages.
+ */
+class CC_DLL FontBaked : public Font
+{
+public:
+    static const char* FILE_EXTENSION;
+    static const uint32_t FILE_VERSION;
+
+    enum FileFlags
+    {
+        DISTANCE_FIELD = 1,
+        MULTI_CHANNEL_DISTANCE_FIELD = 2,
+        // the kerning of a pair applies before the first letter, like with FontFNT
+        KERNING_ON_FIRST_LETTER = 4
+    };
+
+    enum PageFormat
+    {
+        PAGE_A8 = 1,
+        PAGE_I8,
+        PAGE_AI88,
+        PAGE_RGB888,
+        PAGE_RGBA8888
+    };
+
+    enum PageFlags
+    {
+        PREMULTIPLIED_ALPHA = 1
+    };
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t flags;
+        // size in pixels of the font, used to scale BMFont labels
+        float fontSize;
+        float lineHeight;
+        float contentScaleFactor;
+        float outlineSize;
+        uint32_t glyphCount;
+        uint32_t kerningCount;
+        uint32_t pageCount;
+    };
+
+    // metrics in pixels
+    struct GlyphRecord
+    {
+        uint32_t utf32Char;
+        float u;
+        float v;
+        float width;
+        float height;
+        float offsetX;
+        float offsetY;
+        int32_t textureID;
+        int32_t xAdvance;
+        uint32_t valid;
+    };
+
+    struct KerningRecord
+    {
+        uint32_t first;
+        uint32_t second;
+        int32_t amount;
+    };
+
+    struct PageRecord
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t format;
+        uint32_t flags;
+        // from the start of the file
+        uint32_t dataOffset;
+        uint32_t dataSize;
+    };
+
+    /** Returns whether a file path has the extension of the baked font files. */
+    static bool isBakedFontFile(const std::string& filePath);
+
+    static FontBaked* create(const std::string& bakedFilePath);
+
+    /**
+     * Renders glyphs of a TrueType font and writes them as a baked font file.
+     *
+     * @param fontFilePath The TrueType font.
+     * @param fontSize The size of the font in points.
+     * @param glyphs The characters to bake, in UTF-8.
+     * @param distanceFieldEnabled Whether to bake distance fields, multi-channel ones if
+     *        FontFreeType::isMultiChannelDistanceFieldEnabled(). Ignored with an outline.
+     * @param outline The outline size, or 0.
+     * @param outputPath The full path of the file to write.
+     * @param pageSize The width and height of the pages.
+     * @return True if the file was written.
+     */
+    static bool bakeFontFreeType(const std::string& fontFilePath, float fontSize, const std::string& glyphs,
+        bool distanceFieldEnabled, int outline, const std::string& outputPath, int pageSize = 1024);
+
+    /** Writes a BMFont and its texture as a baked font file. */
+    static bool bakeFontFNT(const std::string& fntFilePath, const std::string& outputPath);
+
+    virtual FontAtlas* createFontAtlas() override;
+    virtual int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
+    virtual int getFontMaxHeight() const override;
+
+    int getOriginalFontSize() const;
+    bool isDistanceFieldEnabled() const { return (_header->flags & DISTANCE_FIELD) != 0; }
+    bool isMultiChannelDistanceField() const { return (_header->flags & MULTI_CHANNEL_DISTANCE_FIELD) != 0; }
+    float getOutlineSize() const { return _header->outlineSize; }
+
+protected:
+    FontBaked();
+    virtual ~FontBaked();
+
+    bool initWithFile(const std::string& fullPath);
+    int getHorizontalKerningForChars(char32_t firstChar, char32_t secondChar) const;
+
+    MappedFile _file;
+    // a copy of the file when its bytes aren't aligned, e.g. in an archive
+    Data _alignedData;
+    const FileHeader* _header;
+    const GlyphRecord* _glyphs;
+    const KerningRecord* _kernings;
+    const PageRecord* _pages;
+};
+
+/// @endcond
+
+NS_CC_END
+
+#endif /* defined(_CCFontBaked_h_) */
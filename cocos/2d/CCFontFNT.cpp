@@ -693,6 +693,11 @@ int FontFNT::getOriginalFontSize()const
     return _configuration->_fontSize;
 }
 
+const std::string& FontFNT::getAtlasName() const
+{
+    return _configuration->getAtlasName();
+}
+
 FontAtlas * FontFNT::createFontAtlas()
 {
     // check that everything is fine with the BMFontCofniguration
@@ -48,6 +48,8 @@ public:
     virtual FontAtlas *createFontAtlas() override;
     void setFontSize(float fontSize);
     int getOriginalFontSize()const;
+    /** Full path of the texture of the font. */
+    const std::string& getAtlasName() const;
 
     static void reloadBMFontResource(const std::string& fntFilePath);
 
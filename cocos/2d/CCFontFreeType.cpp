@@ -25,8 +25,10 @@ THE SOFTWARE.
 
 #include "2d/CCFontFreeType.h"
 #include FT_BBOX_H
+#include FT_ADVANCES_H
 #include "edtaa3func.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCFontMSDF.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
@@ -36,6 +38,7 @@ NS_CC_BEGIN
 
 FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
+bool       FontFreeType::s_multiChannelDistanceField = false;
 const int  FontFreeType::DistanceMapSpread = 3;
 
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
@@ -96,20 +99,39 @@ FT_Library FontFreeType::getFTLibrary()
     return _FTlibrary;
 }
 
-FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outline /* = 0 */)
-: _fontRef(nullptr)
+void FontFreeType::setMultiChannelDistanceFieldEnabled(bool enabled)
+{
+    s_multiChannelDistanceField = enabled;
+}
+
+bool FontFreeType::isMultiChannelDistanceFieldEnabled()
+{
+    return s_multiChannelDistanceField;
+}
+
+FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outline /* = 0 */, FT_Library library /* = nullptr */)
+: _library(library)
+, _ownsLibrary(library != nullptr)
+, _fontRef(nullptr)
 , _stroker(nullptr)
 , _distanceFieldEnabled(distanceFieldEnabled)
+, _multiChannelDistanceField(distanceFieldEnabled && s_multiChannelDistanceField)
 , _outlineSize(0.0f)
+, _fontSize(0.0f)
 , _lineHeight(0)
 , _fontAtlas(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
 , _usedGlyphs(GlyphCollection::ASCII)
 {
+    if (_library == nullptr)
+    {
+        _library = getFTLibrary();
+    }
+
     if (outline > 0.0f)
     {
         _outlineSize = outline * CC_CONTENT_SCALE_FACTOR();
-        FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
+        FT_Stroker_New(_library, &_stroker);
         FT_Stroker_Set(_stroker,
             (int)(_outlineSize * 64),
             FT_STROKER_LINECAP_ROUND,
@@ -123,6 +145,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     FT_Face face;
     // save font name locally
     _fontName = fontName;
+    _fontSize = fontSize;
 
     auto it = s_cacheFontData.find(fontName);
     if (it != s_cacheFontData.end())
@@ -140,7 +163,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
         }
     }
 
-    if (FT_New_Memory_Face(getFTLibrary(), s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
+    if (FT_New_Memory_Face(_library, s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
         return false;
 
     if (FT_Select_Charmap(face, FT_ENCODING_UNICODE))
@@ -183,7 +206,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
-    if (_FTInitialized)
+    if (_FTInitialized || _ownsLibrary)
     {
         if (_stroker)
         {
@@ -194,6 +217,10 @@ FontFreeType::~FontFreeType()
             FT_Done_Face(_fontRef);
         }
     }
+    if (_ownsLibrary)
+    {
+        FT_Done_FreeType(_library);
+    }
 
     auto iter = s_cacheFontData.find(_fontName);
     if (iter != s_cacheFontData.end())
@@ -206,6 +233,30 @@ FontFreeType::~FontFreeType()
     }
 }
 
+FontFreeType* FontFreeType::createRasterizer() const
+{
+    FT_Library library;
+    if (FT_Init_FreeType(&library))
+    {
+        return nullptr;
+    }
+
+    auto rasterizer = new (std::nothrow) FontFreeType(_distanceFieldEnabled, _outlineSize / CC_CONTENT_SCALE_FACTOR(), library);
+    if (rasterizer == nullptr)
+    {
+        FT_Done_FreeType(library);
+        return nullptr;
+    }
+
+    rasterizer->_multiChannelDistanceField = _multiChannelDistanceField;
+    if (!rasterizer->createFontObject(_fontName, _fontSize))
+    {
+        delete rasterizer;
+        return nullptr;
+    }
+    return rasterizer;
+}
+
 FontAtlas * FontFreeType::createFontAtlas()
 {
     if (_fontAtlas == nullptr)
@@ -446,7 +497,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBo
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(_library, outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -539,7 +590,104 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
     return out;
 }
 
+int FontFreeType::getBytesPerPixel() const
+{
+    if (_multiChannelDistanceField)
+        return 3;
+    return _outlineSize > 0 ? 2 : 1;
+}
+
+int FontFreeType::getGlyphAdvance(uint64_t theChar) const
+{
+    if (_fontRef == nullptr)
+        return 0;
+
+    FT_Int32 loadFlags = _distanceFieldEnabled ? FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT : FT_LOAD_NO_AUTOHINT;
+    FT_Fixed advance;
+    if (FT_Get_Advance(_fontRef, FT_Get_Char_Index(_fontRef, static_cast<FT_ULong>(theChar)), loadFlags, &advance))
+        return 0;
+
+    return static_cast<int>(advance >> 16);
+}
+
+bool FontFreeType::renderGlyph(uint64_t theChar, GlyphBitmap& glyph)
+{
+    glyph.width = 0;
+    glyph.height = 0;
+    glyph.pixels.clear();
+
+    if (_multiChannelDistanceField)
+    {
+        return renderGlyphMultiChannel(theChar, glyph);
+    }
+
+    long bitmapWidth;
+    long bitmapHeight;
+    auto bitmap = getGlyphBitmap(theChar, bitmapWidth, bitmapHeight, glyph.rect, glyph.xAdvance);
+    if (bitmap == nullptr || bitmapWidth <= 0 || bitmapHeight <= 0)
+    {
+        return glyph.xAdvance != 0;
+    }
+
+    int padding = _distanceFieldEnabled ? 2 * DistanceMapSpread : 0;
+    glyph.width = bitmapWidth + padding;
+    glyph.height = bitmapHeight + padding;
+    glyph.pixels.assign(glyph.width * glyph.height * getBytesPerPixel(), 0);
+    renderCharAt(glyph.pixels.data(), static_cast<int>(glyph.width), 0, 0, bitmap, bitmapWidth, bitmapHeight);
+    return true;
+}
+
+bool FontFreeType::renderGlyphMultiChannel(uint64_t theChar, GlyphBitmap& glyph)
+{
+    if (_fontRef == nullptr || FT_Load_Char(_fontRef, theChar, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
+    {
+        glyph.rect = Rect::ZERO;
+        glyph.xAdvance = 0;
+        return false;
+    }
+
+    auto slot = _fontRef->glyph;
+    glyph.xAdvance = static_cast<int>(slot->metrics.horiAdvance >> 6);
+    glyph.rect = Rect::ZERO;
+    if (slot->format != FT_GLYPH_FORMAT_OUTLINE || slot->outline.n_contours <= 0)
+    {
+        return true;
+    }
+
+    FT_BBox bbox;
+    FT_Outline_Get_CBox(&slot->outline, &bbox);
+    long left = bbox.xMin >> 6;
+    long top = (bbox.yMax + 63) >> 6;
+    long bitmapWidth = ((bbox.xMax + 63) >> 6) - left;
+    long bitmapHeight = top - (bbox.yMin >> 6);
+    if (bitmapWidth <= 0 || bitmapHeight <= 0)
+    {
+        return true;
+    }
+
+    glyph.rect.setRect(left, -top, bitmapWidth, bitmapHeight);
+    glyph.width = bitmapWidth + 2 * DistanceMapSpread;
+    glyph.height = bitmapHeight + 2 * DistanceMapSpread;
+
+    auto field = FontMSDF::generate(&slot->outline, glyph.width, glyph.height,
+                                    left - DistanceMapSpread, top + DistanceMapSpread);
+    if (field == nullptr)
+    {
+        glyph.width = 0;
+        glyph.height = 0;
+        return true;
+    }
+    glyph.pixels.assign(field, field + glyph.width * glyph.height * 3);
+    delete [] field;
+    return true;
+}
+
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+{
+    renderCharAt(dest, FontAtlas::CacheTextureWidth, posX, posY, bitmap, bitmapWidth, bitmapHeight);
+}
+
+void FontFreeType::renderCharAt(unsigned char *dest, int destWidth, int posX, int posY, unsigned char* bitmap, long bitmapWidth, long bitmapHeight)
 {
     int iX = posX;
     int iY = posY;
@@ -565,7 +713,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output 
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -585,9 +733,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -608,7 +756,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -31,6 +31,7 @@
 #include "2d/CCFont.h"
 
 #include <string>
+#include <vector>
 #include <ft2build.h>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -48,6 +49,16 @@
 
 NS_CC_BEGIN
 
+/** A glyph rendered in the pixel format of the font atlas, distance map spread included. */
+struct GlyphBitmap
+{
+    Rect rect;
+    int xAdvance;
+    long width;
+    long height;
+    std::vector<unsigned char> pixels;
+};
+
 class CC_DLL FontFreeType : public Font
 {
 public:
@@ -58,12 +69,41 @@ public:
 
     static void shutdownFreeType();
 
+    /** Makes the distance field fonts created afterwards use multi-channel distance fields. Disabled by default. */
+    static void setMultiChannelDistanceFieldEnabled(bool enabled);
+    static bool isMultiChannelDistanceFieldEnabled();
+
     bool isDistanceFieldEnabled() const { return _distanceFieldEnabled;}
 
+    bool isMultiChannelDistanceField() const { return _multiChannelDistanceField; }
+
     float getOutlineSize() const { return _outlineSize; }
 
+    float getFontSize() const { return _fontSize; }
+
+    const std::string& getFontName() const { return _fontName; }
+
+    /** Returns the bytes per pixel of the glyphs: 3 for multi-channel distance fields, 2 with outline, 1 otherwise. */
+    int getBytesPerPixel() const;
+
     void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight); 
 
+    /**
+     * Renders a glyph into a tight bitmap, computing its distance field if enabled.
+     *
+     * @return False if the font has no glyph for the character.
+     */
+    bool renderGlyph(uint64_t theChar, GlyphBitmap& glyph);
+
+    /** Returns the advance of a glyph without rendering it. */
+    int getGlyphAdvance(uint64_t theChar) const;
+
+    /**
+     * Creates a copy of the font with its own FreeType library, so that it can render glyphs on another thread
+     * while this font is in use. It must be created and released on the cocos thread.
+     */
+    FontFreeType* createRasterizer() const;
+
     FT_Encoding getEncoding() const { return _encoding; }
 
     int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
@@ -83,8 +123,9 @@ private:
     static const char* _glyphNEHE;
     static FT_Library _FTlibrary;
     static bool _FTInitialized;
+    static bool s_multiChannelDistanceField;
 
-    FontFreeType(bool distanceFieldEnabled = false, float outline = 0);
+    FontFreeType(bool distanceFieldEnabled = false, float outline = 0, FT_Library library = nullptr);
     virtual ~FontFreeType();
 
     bool createFontObject(const std::string &fontName, float fontSize);
@@ -94,17 +135,23 @@ private:
     
     int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
     unsigned char* getGlyphBitmapWithOutline(uint64_t code, FT_BBox &bbox);
+    bool renderGlyphMultiChannel(uint64_t theChar, GlyphBitmap& glyph);
+    void renderCharAt(unsigned char *dest, int destWidth, int posX, int posY, unsigned char* bitmap, long bitmapWidth, long bitmapHeight);
 
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
     const char* getGlyphCollection() const;
     
+    FT_Library _library;
+    bool _ownsLibrary;
     FT_Face _fontRef;
     FT_Stroker _stroker;
     FT_Encoding _encoding;
 
     std::string _fontName;
     bool _distanceFieldEnabled;
+    bool _multiChannelDistanceField;
     float _outlineSize;
+    float _fontSize;
     int _lineHeight;
     FontAtlas* _fontAtlas;
 
@@ -0,0 +1,289 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCFontGlyphCache.h"
+
+#include <cstring>
+
+#include "2d/CCFontFreeType.h"
+#include "base/CCDirector.h"
+#include "base/ccUTF8.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const char CACHE_MAGIC[4] = { 'C', 'C', 'G', 'C' };
+    const uint32_t CACHE_VERSION = 1;
+
+    struct RecordHeader
+    {
+        uint32_t utf32Char;
+        int32_t xAdvance;
+        float rect[4];
+        int32_t width;
+        int32_t height;
+        uint32_t pixelBytes;
+    };
+
+    uint64_t hashKey(const std::string& key)
+    {
+        // FNV-1a, stable across runs and platforms
+        uint64_t hash = 14695981039346656037ULL;
+        for (auto c : key)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+bool FontGlyphCache::s_enabled = false;
+std::string FontGlyphCache::s_cacheDirectory;
+
+void FontGlyphCache::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+bool FontGlyphCache::isEnabled()
+{
+    return s_enabled;
+}
+
+void FontGlyphCache::setCacheDirectory(const std::string& directory)
+{
+    s_cacheDirectory = directory;
+    if (!s_cacheDirectory.empty() && s_cacheDirectory.back() != '/')
+    {
+        s_cacheDirectory += '/';
+    }
+}
+
+std::string FontGlyphCache::getCacheDirectory()
+{
+    if (s_cacheDirectory.empty())
+    {
+        return FileUtils::getInstance()->getWritablePath() + "glyphcache/";
+    }
+    return s_cacheDirectory;
+}
+
+void FontGlyphCache::removeCacheFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    auto directory = getCacheDirectory();
+    if (fileUtils->isDirectoryExist(directory))
+    {
+        fileUtils->removeDirectory(directory);
+    }
+}
+
+FontGlyphCache* FontGlyphCache::create(const FontFreeType* font)
+{
+    if (!s_enabled || font == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    auto fontPath = fileUtils->fullPathForFilename(font->getFontName());
+    if (fontPath.empty())
+    {
+        return nullptr;
+    }
+
+    const char* mode = font->isMultiChannelDistanceField() ? "msdf" : (font->isDistanceFieldEnabled() ? "df" : "bitmap");
+    auto key = StringUtils::format("%u|%s|%ld|%.2f|%.2f|%s|%.2f", CACHE_VERSION, fontPath.c_str(),
+                                   fileUtils->getFileSize(fontPath), font->getFontSize(), font->getOutlineSize(),
+                                   mode, CC_CONTENT_SCALE_FACTOR());
+
+    auto directory = getCacheDirectory();
+    if (!fileUtils->isDirectoryExist(directory) && !fileUtils->createDirectory(directory))
+    {
+        CCLOG("FontGlyphCache: can't create %s", directory.c_str());
+        return nullptr;
+    }
+
+    auto path = StringUtils::format("%s%016llx.glyphs", directory.c_str(), static_cast<unsigned long long>(hashKey(key)));
+    auto cache = new (std::nothrow) FontGlyphCache(path, key);
+    if (cache)
+    {
+        cache->load();
+    }
+    return cache;
+}
+
+FontGlyphCache::FontGlyphCache(const std::string& path, const std::string& key)
+: _path(path)
+, _key(key)
+, _validSize(0)
+, _file(nullptr)
+{
+}
+
+FontGlyphCache::~FontGlyphCache()
+{
+    if (_file)
+    {
+        fclose(_file);
+    }
+}
+
+bool FontGlyphCache::load()
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(_path))
+    {
+        return false;
+    }
+
+    _data = fileUtils->getDataFromFile(_path);
+    auto bytes = _data.getBytes();
+    auto size = _data.getSize();
+
+    ssize_t headerSize = sizeof(CACHE_MAGIC) + 2 * sizeof(uint32_t) + _key.size();
+    if (size < headerSize || memcmp(bytes, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+    {
+        _data.clear();
+        return false;
+    }
+
+    uint32_t version;
+    uint32_t keyLength;
+    memcpy(&version, bytes + sizeof(CACHE_MAGIC), sizeof(uint32_t));
+    memcpy(&keyLength, bytes + sizeof(CACHE_MAGIC) + sizeof(uint32_t), sizeof(uint32_t));
+    if (version != CACHE_VERSION || keyLength != _key.size()
+        || memcmp(bytes + sizeof(CACHE_MAGIC) + 2 * sizeof(uint32_t), _key.data(), keyLength) != 0)
+    {
+        // hash collision or stale file, it is rewritten on the first added glyph
+        _data.clear();
+        return false;
+    }
+
+    ssize_t offset = headerSize;
+    while (offset + static_cast<ssize_t>(sizeof(RecordHeader)) <= size)
+    {
+        RecordHeader record;
+        memcpy(&record, bytes + offset, sizeof(record));
+        ssize_t recordSize = sizeof(RecordHeader) + record.pixelBytes;
+        if (offset + recordSize > size)
+        {
+            // the application was stopped while appending, drop the incomplete record
+            break;
+        }
+        _offsets[record.utf32Char] = offset;
+        offset += recordSize;
+    }
+    _validSize = offset;
+    return true;
+}
+
+bool FontGlyphCache::getGlyph(char32_t utf32Char, GlyphBitmap& glyph) const
+{
+    auto it = _offsets.find(utf32Char);
+    if (it == _offsets.end())
+    {
+        return false;
+    }
+
+    auto bytes = _data.getBytes() + it->second;
+    RecordHeader record;
+    memcpy(&record, bytes, sizeof(record));
+    glyph.xAdvance = record.xAdvance;
+    glyph.rect.setRect(record.rect[0], record.rect[1], record.rect[2], record.rect[3]);
+    glyph.width = record.width;
+    glyph.height = record.height;
+    glyph.pixels.assign(bytes + sizeof(record), bytes + sizeof(record) + record.pixelBytes);
+    return true;
+}
+
+void FontGlyphCache::addGlyph(char32_t utf32Char, const GlyphBitmap& glyph)
+{
+    if (_offsets.find(utf32Char) != _offsets.end() || !_addedGlyphs.insert(utf32Char).second)
+    {
+        return;
+    }
+
+    if (_file == nullptr)
+    {
+        auto fileUtils = FileUtils::getInstance();
+        if (_validSize > 0 && _validSize == _data.getSize())
+        {
+            _file = fopen(fileUtils->getSuitableFOpen(_path).c_str(), "ab");
+        }
+        else
+        {
+            // new, stale or truncated file, rewrite its valid part
+            _file = fopen(fileUtils->getSuitableFOpen(_path).c_str(), "wb");
+            if (_file && _validSize > 0)
+            {
+                fwrite(_data.getBytes(), 1, _validSize, _file);
+            }
+            else if (_file)
+            {
+                uint32_t keyLength = static_cast<uint32_t>(_key.size());
+                fwrite(CACHE_MAGIC, 1, sizeof(CACHE_MAGIC), _file);
+                fwrite(&CACHE_VERSION, sizeof(CACHE_VERSION), 1, _file);
+                fwrite(&keyLength, sizeof(keyLength), 1, _file);
+                fwrite(_key.data(), 1, keyLength, _file);
+            }
+        }
+
+        if (_file == nullptr)
+        {
+            CCLOG("FontGlyphCache: can't write %s", _path.c_str());
+            return;
+        }
+    }
+
+    RecordHeader record;
+    record.utf32Char = static_cast<uint32_t>(utf32Char);
+    record.xAdvance = glyph.xAdvance;
+    record.rect[0] = glyph.rect.origin.x;
+    record.rect[1] = glyph.rect.origin.y;
+    record.rect[2] = glyph.rect.size.width;
+    record.rect[3] = glyph.rect.size.height;
+    record.width = static_cast<int32_t>(glyph.width);
+    record.height = static_cast<int32_t>(glyph.height);
+    record.pixelBytes = static_cast<uint32_t>(glyph.pixels.size());
+    fwrite(&record, sizeof(record), 1, _file);
+    if (!glyph.pixels.empty())
+    {
+        fwrite(glyph.pixels.data(), 1, glyph.pixels.size(), _file);
+    }
+}
+
+void FontGlyphCache::flush()
+{
+    if (_file)
+    {
+        fflush(_file);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,102 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef _CCFontGlyphCache_h_
+#define _CCFontGlyphCache_h_
+
+/// @cond DO_NOT_SHOW
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class FontFreeType;
+struct GlyphBitmap;
+
+/**
+ * Persistent cache of the glyphs rendered by a FontFreeType.
+ *
+ * Each font file, size, outline and distance field mode has its own cache file in the cache directory.
+ * The file is an append-only log of rendered glyphs: it is read once when the font atlas is created, and
+ * the glyphs rendered afterwards are appended to it, so warm starts don't use FreeType for cached glyphs.
+ * A file written by another font file, format version or content scale factor is discarded.
+ */
+class CC_DLL FontGlyphCache
+{
+public:
+    /** Enables the cache for the font atlases created afterwards. Disabled by default. */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /** Sets the directory of the cache files. Defaults to "glyphcache/" in the writable path. */
+    static void setCacheDirectory(const std::string& directory);
+    static std::string getCacheDirectory();
+
+    /** Removes all the cache files. The caches in use keep working in memory. */
+    static void removeCacheFiles();
+
+    /** Opens the cache of a font, or returns nullptr if the cache is disabled. */
+    static FontGlyphCache* create(const FontFreeType* font);
+
+    ~FontGlyphCache();
+
+    /** Returns the cached glyph of a character, if any. */
+    bool getGlyph(char32_t utf32Char, GlyphBitmap& glyph) const;
+
+    /** Appends a glyph to the cache file. */
+    void addGlyph(char32_t utf32Char, const GlyphBitmap& glyph);
+
+    /** Writes the appended glyphs to the disk. */
+    void flush();
+
+    ssize_t getGlyphCount() const { return static_cast<ssize_t>(_offsets.size()); }
+
+protected:
+    FontGlyphCache(const std::string& path, const std::string& key);
+
+    bool load();
+
+    std::string _path;
+    std::string _key;
+    Data _data;
+    ssize_t _validSize;
+    std::unordered_map<char32_t, ssize_t> _offsets;
+    std::unordered_set<char32_t> _addedGlyphs;
+    FILE* _file;
+
+    static bool s_enabled;
+    static std::string s_cacheDirectory;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif /* defined(_CCFontGlyphCache_h_) */
@@ -0,0 +1,470 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCFontMSDF.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "math/Vec2.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    enum EdgeColor
+    {
+        EDGE_RED = 1,
+        EDGE_GREEN = 2,
+        EDGE_BLUE = 4,
+        EDGE_YELLOW = EDGE_RED | EDGE_GREEN,
+        EDGE_MAGENTA = EDGE_RED | EDGE_BLUE,
+        EDGE_CYAN = EDGE_GREEN | EDGE_BLUE,
+        EDGE_WHITE = EDGE_RED | EDGE_GREEN | EDGE_BLUE
+    };
+
+    // a curve of the outline, before flattening
+    struct Segment
+    {
+        Vec2 points[4];
+        int degree;
+    };
+
+    // a straight piece of a flattened contour
+    struct Edge
+    {
+        Vec2 a;
+        Vec2 b;
+        Vec2 direction;
+        float length;
+        int color;
+        bool corner;      // a corner of the contour is at a
+        bool startsSpan;  // the previous edge has another color
+        bool endsSpan;    // the next edge has another color
+    };
+
+    struct OutlineDecomposer
+    {
+        std::vector<std::vector<Segment>> contours;
+        Vec2 current;
+    };
+
+    // sin(3 rad), the same corner threshold as msdfgen
+    const float CORNER_CROSS_THRESHOLD = 0.14112f;
+    const float DISTANCE_EPSILON = 1e-4f;
+
+    inline Vec2 toVec2(const FT_Vector* v)
+    {
+        return Vec2(v->x / 64.0f, v->y / 64.0f);
+    }
+
+    int moveTo(const FT_Vector* to, void* user)
+    {
+        auto decomposer = static_cast<OutlineDecomposer*>(user);
+        decomposer->contours.emplace_back();
+        decomposer->current = toVec2(to);
+        return 0;
+    }
+
+    int lineTo(const FT_Vector* to, void* user)
+    {
+        auto decomposer = static_cast<OutlineDecomposer*>(user);
+        auto end = toVec2(to);
+        if (end != decomposer->current && !decomposer->contours.empty())
+        {
+            Segment segment;
+            segment.points[0] = decomposer->current;
+            segment.points[1] = end;
+            segment.degree = 1;
+            decomposer->contours.back().push_back(segment);
+        }
+        decomposer->current = end;
+        return 0;
+    }
+
+    int conicTo(const FT_Vector* control, const FT_Vector* to, void* user)
+    {
+        auto decomposer = static_cast<OutlineDecomposer*>(user);
+        if (!decomposer->contours.empty())
+        {
+            Segment segment;
+            segment.points[0] = decomposer->current;
+            segment.points[1] = toVec2(control);
+            segment.points[2] = toVec2(to);
+            segment.degree = 2;
+            decomposer->contours.back().push_back(segment);
+        }
+        decomposer->current = toVec2(to);
+        return 0;
+    }
+
+    int cubicTo(const FT_Vector* control1, const FT_Vector* control2, const FT_Vector* to, void* user)
+    {
+        auto decomposer = static_cast<OutlineDecomposer*>(user);
+        if (!decomposer->contours.empty())
+        {
+            Segment segment;
+            segment.points[0] = decomposer->current;
+            segment.points[1] = toVec2(control1);
+            segment.points[2] = toVec2(control2);
+            segment.points[3] = toVec2(to);
+            segment.degree = 3;
+            decomposer->contours.back().push_back(segment);
+        }
+        decomposer->current = toVec2(to);
+        return 0;
+    }
+
+    Vec2 pointAt(const Segment& segment, float t)
+    {
+        float s = 1.0f - t;
+        const Vec2* p = segment.points;
+        switch (segment.degree)
+        {
+        case 2:
+            return p[0] * (s * s) + p[1] * (2.0f * s * t) + p[2] * (t * t);
+        case 3:
+            return p[0] * (s * s * s) + p[1] * (3.0f * s * s * t) + p[2] * (3.0f * s * t * t) + p[3] * (t * t * t);
+        default:
+            return p[0] * s + p[1] * t;
+        }
+    }
+
+    void flattenSegment(const Segment& segment, std::vector<Edge>& edges)
+    {
+        int steps = 1;
+        if (segment.degree > 1)
+        {
+            // the control polygon bounds the length of the curve
+            float length = 0.0f;
+            for (int i = 0; i < segment.degree; ++i)
+            {
+                length += segment.points[i].distance(segment.points[i + 1]);
+            }
+            steps = std::max(2, std::min(16, static_cast<int>(std::ceil(length / 2.0f))));
+        }
+
+        Vec2 previous = segment.points[0];
+        for (int i = 1; i <= steps; ++i)
+        {
+            Vec2 next = pointAt(segment, static_cast<float>(i) / steps);
+            float length = previous.distance(next);
+            if (length > DISTANCE_EPSILON)
+            {
+                Edge edge;
+                edge.a = previous;
+                edge.b = next;
+                edge.length = length;
+                edge.direction = (next - previous) / length;
+                edge.color = EDGE_WHITE;
+                edge.corner = false;
+                edge.startsSpan = false;
+                edge.endsSpan = false;
+                edges.push_back(edge);
+                previous = next;
+            }
+        }
+    }
+
+    int switchColor(int color)
+    {
+        // cycles through cyan, magenta and yellow
+        return ((color << 1) | (color >> 2)) & EDGE_WHITE;
+    }
+
+    void colorContour(std::vector<Edge>& edges)
+    {
+        auto count = edges.size();
+        std::vector<size_t> corners;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vec2& incoming = edges[(i + count - 1) % count].direction;
+            const Vec2& outgoing = edges[i].direction;
+            if (incoming.dot(outgoing) <= 0.0f || std::abs(incoming.cross(outgoing)) > CORNER_CROSS_THRESHOLD)
+            {
+                edges[i].corner = true;
+                corners.push_back(i);
+            }
+        }
+
+        if (corners.empty())
+        {
+            // smooth contour, the single channel field is enough
+            return;
+        }
+
+        if (corners.size() == 1)
+        {
+            // teardrop, split the contour in three parts around the corner
+            static const int colors[3] = { EDGE_MAGENTA, EDGE_WHITE, EDGE_YELLOW };
+            for (size_t i = 0; i < count; ++i)
+            {
+                edges[(corners[0] + i) % count].color = colors[std::min<size_t>(2, 3 * i / count)];
+            }
+        }
+        else
+        {
+            auto spanCount = corners.size();
+            int color = EDGE_CYAN;
+            int firstColor = color;
+            for (size_t span = 0; span < spanCount; ++span)
+            {
+                if (span > 0)
+                {
+                    color = switchColor(color);
+                    if (span == spanCount - 1 && color == firstColor)
+                    {
+                        // the last span touches the first one
+                        color = switchColor(color);
+                    }
+                }
+                auto begin = corners[span];
+                auto end = span + 1 < spanCount ? corners[span + 1] : corners[0] + count;
+                for (auto i = begin; i < end; ++i)
+                {
+                    edges[i % count].color = color;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            edges[i].startsSpan = edges[(i + count - 1) % count].color != edges[i].color;
+            edges[i].endsSpan = edges[(i + 1) % count].color != edges[i].color;
+        }
+    }
+
+    struct EdgeDistance
+    {
+        const Edge* edge;
+        float distance;
+        float orthogonality;
+        float t;
+    };
+
+    inline void updateNearest(EdgeDistance& nearest, const Edge* edge, float distance, float orthogonality, float t)
+    {
+        if (distance < nearest.distance - DISTANCE_EPSILON
+            || (distance <= nearest.distance + DISTANCE_EPSILON && orthogonality < nearest.orthogonality))
+        {
+            nearest.edge = edge;
+            nearest.distance = distance;
+            nearest.orthogonality = orthogonality;
+            nearest.t = t;
+        }
+    }
+
+    // distance to the nearest edge having a channel, extended past the ends of its color span
+    float signedPseudoDistance(const EdgeDistance& nearest, const Vec2& p, float orientation)
+    {
+        const Edge* edge = nearest.edge;
+        Vec2 ap = p - edge->a;
+        float cross = edge->direction.cross(ap);
+        float distance = nearest.distance;
+        if ((nearest.t < 0.0f && edge->startsSpan) || (nearest.t > 1.0f && edge->endsSpan))
+        {
+            float lineDistance = std::abs(cross);
+            if (lineDistance <= distance)
+            {
+                distance = lineDistance;
+            }
+        }
+        return (cross >= 0.0f ? orientation : -orientation) * distance;
+    }
+
+    inline unsigned char encodeDistance(float distance)
+    {
+        float value = 128.0f + distance * 16.0f;
+        return static_cast<unsigned char>(std::max(0.0f, std::min(255.0f, value)));
+    }
+
+    inline float median(float a, float b, float c)
+    {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+}
+
+unsigned char* FontMSDF::generate(const FT_Outline* outline, long width, long height, float originX, float originY)
+{
+    if (outline == nullptr || outline->n_contours <= 0 || width <= 0 || height <= 0)
+    {
+        return nullptr;
+    }
+
+    OutlineDecomposer decomposer;
+    FT_Outline_Funcs funcs;
+    funcs.move_to = moveTo;
+    funcs.line_to = lineTo;
+    funcs.conic_to = conicTo;
+    funcs.cubic_to = cubicTo;
+    funcs.shift = 0;
+    funcs.delta = 0;
+    if (FT_Outline_Decompose(const_cast<FT_Outline*>(outline), &funcs, &decomposer))
+    {
+        return nullptr;
+    }
+
+    std::vector<Edge> edges;
+    for (auto&& contour : decomposer.contours)
+    {
+        if (contour.empty())
+        {
+            continue;
+        }
+
+        // close the contour, the decomposer doesn't emit the closing line
+        const Vec2& first = contour.front().points[0];
+        const Segment& last = contour.back();
+        if (last.points[last.degree] != first)
+        {
+            Segment segment;
+            segment.points[0] = last.points[last.degree];
+            segment.points[1] = first;
+            segment.degree = 1;
+            contour.push_back(segment);
+        }
+
+        std::vector<Edge> contourEdges;
+        for (auto&& segment : contour)
+        {
+            flattenSegment(segment, contourEdges);
+        }
+        if (contourEdges.size() < 2)
+        {
+            continue;
+        }
+        colorContour(contourEdges);
+        edges.insert(edges.end(), contourEdges.begin(), contourEdges.end());
+    }
+
+    if (edges.empty())
+    {
+        return nullptr;
+    }
+
+    // TrueType fills on the right of the contours, PostScript on the left
+    float orientation = FT_Outline_Get_Orientation(const_cast<FT_Outline*>(outline)) == FT_ORIENTATION_POSTSCRIPT ? 1.0f : -1.0f;
+    bool evenOddFill = (outline->flags & FT_OUTLINE_EVEN_ODD_FILL) != 0;
+
+    auto field = new (std::nothrow) unsigned char[width * height * 3];
+    if (field == nullptr)
+    {
+        return nullptr;
+    }
+
+    static const int channels[3] = { EDGE_RED, EDGE_GREEN, EDGE_BLUE };
+    for (long y = 0; y < height; ++y)
+    {
+        for (long x = 0; x < width; ++x)
+        {
+            Vec2 p(originX + x + 0.5f, originY - y - 0.5f);
+
+            EdgeDistance nearest[3];
+            for (auto&& n : nearest)
+            {
+                n.edge = nullptr;
+                n.distance = FLT_MAX;
+                n.orthogonality = 1.0f;
+                n.t = 0.0f;
+            }
+            float trueDistance = FLT_MAX;
+            int winding = 0;
+
+            for (auto&& edge : edges)
+            {
+                Vec2 ap = p - edge.a;
+                float t = ap.dot(edge.direction) / edge.length;
+                float distance;
+                float orthogonality = 0.0f;
+                if (t < 0.0f)
+                {
+                    distance = ap.length();
+                    if (distance > 0.0f)
+                    {
+                        orthogonality = std::abs(edge.direction.dot(ap) / distance);
+                    }
+                }
+                else if (t > 1.0f)
+                {
+                    Vec2 bp = p - edge.b;
+                    distance = bp.length();
+                    if (distance > 0.0f)
+                    {
+                        orthogonality = std::abs(edge.direction.dot(bp) / distance);
+                    }
+                }
+                else
+                {
+                    distance = std::abs(edge.direction.cross(ap));
+                }
+
+                trueDistance = std::min(trueDistance, distance);
+                for (int c = 0; c < 3; ++c)
+                {
+                    if (edge.color & channels[c])
+                    {
+                        updateNearest(nearest[c], &edge, distance, orthogonality, t);
+                    }
+                }
+
+                if (edge.a.y <= p.y)
+                {
+                    if (edge.b.y > p.y && (edge.b - edge.a).cross(ap) > 0.0f)
+                        ++winding;
+                }
+                else if (edge.b.y <= p.y && (edge.b - edge.a).cross(ap) < 0.0f)
+                {
+                    --winding;
+                }
+            }
+
+            bool inside = evenOddFill ? (winding & 1) != 0 : winding != 0;
+            float signedDistance = inside ? trueDistance : -trueDistance;
+
+            float values[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                values[c] = nearest[c].edge ? signedPseudoDistance(nearest[c], p, orientation) : signedDistance;
+            }
+
+            // the median must agree with the real inside/outside state, or the edge selection went wrong
+            if ((median(values[0], values[1], values[2]) > 0.0f) != inside)
+            {
+                values[0] = values[1] = values[2] = signedDistance;
+            }
+
+            auto pixel = field + (y * width + x) * 3;
+            pixel[0] = encodeDistance(values[0]);
+            pixel[1] = encodeDistance(values[1]);
+            pixel[2] = encodeDistance(values[2]);
+        }
+    }
+
+    return field;
+}
+
+NS_CC_END
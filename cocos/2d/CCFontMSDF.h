@@ -0,0 +1,80 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef _CCFontMSDF_h_
+#define _CCFontMSDF_h_
+
+/// @cond DO_NOT_SHOW
+
+#include "platform/CCPlatformMacros.h"
+
+#include <ft2build.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#define generic GenericFromFreeTypeLibrary
+#define internal InternalFromFreeTypeLibrary
+#endif
+
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#undef generic
+#undef internal
+#endif
+
+NS_CC_BEGIN
+
+/**
+ * Generates multi-channel signed distance fields from glyph outlines.
+ *
+ * The edges of each contour get one of three colors so that every corner sits between two edges of different
+ * colors. Each of the R, G and B channels stores the signed distance to the nearest edge having that channel,
+ * and the median of the three channels rebuilds the sharp corners that a single channel field rounds off.
+ * Pixels where the median disagrees with the true inside/outside state fall back to the true distance.
+ *
+ * Distances are encoded like the single channel distance maps of FontFreeType: 128 on the edge, 16 levels
+ * per pixel, higher values inside the glyph.
+ */
+class CC_DLL FontMSDF
+{
+public:
+    /**
+     * Generates the field of an outline.
+     *
+     * @param outline The outline, in 26.6 pixel units.
+     * @param width The width of the field, in pixels.
+     * @param height The height of the field, in pixels.
+     * @param originX The x coordinate, in outline pixels, of the left border of the field.
+     * @param originY The y coordinate, in outline pixels, of the top border of the field.
+     * @return A buffer of width * height RGB pixels to delete[], or nullptr if the outline is empty.
+     */
+    static unsigned char* generate(const FT_Outline* outline, long width, long height, float originX, float originY);
+};
+
+NS_CC_END
+
+/// @endcond
+#endif /* defined(_CCFontMSDF_h_) */
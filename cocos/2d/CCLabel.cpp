@@ -42,7 +42,9 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
+#include "2d/CCFontBaked.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontFreeType.h"
 
 NS_CC_BEGIN
 
@@ -379,7 +381,7 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
 : _textSprite(nullptr)
 , _shadowNode(nullptr)
 , _fontAtlas(nullptr)
-, _reusedLetter(nullptr)
+, _kerningFont(nullptr)
 , _horizontalKernings(nullptr)
 , _boldEnabled(false)
 , _underlineNode(nullptr)
@@ -424,6 +426,15 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    _updateTextureListener = EventListenerCustom::create(FontAtlas::CMD_UPDATE_FONTATLAS, [this](EventCustom* event){
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
+        {
+            // glyphs rendered asynchronously replaced their placeholders
+            _contentDirty = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_updateTextureListener, 3);
 }
 
 Label::~Label()
@@ -433,12 +444,12 @@ Label::~Label()
     if (_fontAtlas)
     {
         Node::removeAllChildrenWithCleanup(true);
-        CC_SAFE_RELEASE_NULL(_reusedLetter);
         _batchNodes.clear();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
     }
     _eventDispatcher->removeEventListener(_purgeTextureListener);
     _eventDispatcher->removeEventListener(_resetTextureListener);
+    _eventDispatcher->removeEventListener(_updateTextureListener);
 
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
@@ -449,7 +460,6 @@ void Label::reset()
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
     Node::removeAllChildrenWithCleanup(true);
-    CC_SAFE_RELEASE_NULL(_reusedLetter);
     _letters.clear();
     _batchNodes.clear();
     _lettersInfo.clear();
@@ -480,6 +490,9 @@ void Label::reset()
         delete[] _horizontalKernings;
         _horizontalKernings = nullptr;
     }
+    _kerningText.clear();
+    _kerningFont = nullptr;
+    invalidateLayout();
     _additionalKerning = 0.f;
     _lineHeight = 0.f;
     _lineSpacing = 0.f;
@@ -541,12 +554,36 @@ static Texture2D* _getTexture(Label* label)
     return texture;
 }
 
+bool Label::isMultiChannelDistanceField() const
+{
+    if (_fontAtlas == nullptr)
+        return false;
+
+    if (auto bakedFont = dynamic_cast<const FontBaked*>(_fontAtlas->getFont()))
+        return bakedFont->isMultiChannelDistanceField();
+
+    auto font = dynamic_cast<const FontFreeType*>(_fontAtlas->getFont());
+    return font && font->isMultiChannelDistanceField();
+}
+
+float Label::getBMFontOriginalSize() const
+{
+    auto font = _fontAtlas ? _fontAtlas->getFont() : nullptr;
+    if (auto bakedFont = dynamic_cast<const FontBaked*>(font))
+        return bakedFont->getOriginalFontSize();
+    if (auto bmFont = dynamic_cast<const FontFNT*>(font))
+        return bmFont->getOriginalFontSize();
+    return 0.f;
+}
+
 void Label::updateShaderProgram()
 {
     switch (_currLabelEffect)
     {
     case cocos2d::LabelEffect::NORMAL:
-        if (_useDistanceField)
+        if (_useDistanceField && isMultiChannelDistanceField())
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_MSDF_NORMAL));
+        else if (_useDistanceField)
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL));
         else if (_useA8Shader)
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_NORMAL));
@@ -564,7 +601,8 @@ void Label::updateShaderProgram()
     case cocos2d::LabelEffect::GLOW:
         if (_useDistanceField)
         {
-            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW));
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(isMultiChannelDistanceField() ?
+                GLProgram::SHADER_NAME_LABEL_MSDF_GLOW : GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW));
             _uniformEffectColor = glGetUniformLocation(getGLProgram()->getProgram(), "u_effectColor");
         }
         break;
@@ -595,13 +633,8 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     }
 
     _fontAtlas = atlas;
-    if (_reusedLetter == nullptr)
-    {
-        _reusedLetter = Sprite::create();
-        _reusedLetter->setOpacityModifyRGB(_isOpacityModifyRGB);            
-        _reusedLetter->retain();
-        _reusedLetter->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
-    }
+    _kerningFont = nullptr;
+    invalidateLayout();
 
     if (_fontAtlas)
     {
@@ -635,11 +668,15 @@ bool Label::setBMFontFilePath(const std::string& bmfontFilePath, const Vec2& ima
         return false;
     }
 
+    _bmFontPath = bmfontFilePath;
+
+    _currentLabelType = LabelType::BMFONT;
+    setFontAtlas(newAtlas);
+
     //assign the default fontSize
     if (std::abs(fontSize) < FLT_EPSILON) {
-        FontFNT *bmFont = (FontFNT*)newAtlas->getFont();
-        if (bmFont) {
-            float originalFontSize = bmFont->getOriginalFontSize();
+        float originalFontSize = getBMFontOriginalSize();
+        if (originalFontSize > 0.0f) {
             _bmFontSize = originalFontSize / CC_CONTENT_SCALE_FACTOR();
         }
     }
@@ -648,11 +685,6 @@ bool Label::setBMFontFilePath(const std::string& bmfontFilePath, const Vec2& ima
         _bmFontSize = fontSize;
     }
 
-    _bmFontPath = bmfontFilePath;
-
-    _currentLabelType = LabelType::BMFONT;
-    setFontAtlas(newAtlas);
-
     return true;
 }
 
@@ -757,7 +789,15 @@ void Label::updateLabelLetters()
             else
             {
                 auto& letterInfo = _lettersInfo[letterIndex];
-                auto& letterDef = _fontAtlas->_letterDefinitions[letterInfo.utf32Char];
+                auto definition = getLetterDefinition(letterIndex);
+                if (!letterInfo.valid || definition == nullptr)
+                {
+                    letterSprite->setTextureAtlas(nullptr);
+                    ++it;
+                    continue;
+                }
+
+                auto& letterDef = *definition;
                 uvRect.size.height = letterDef.height;
                 uvRect.size.width = letterDef.width;
                 uvRect.origin.x = letterDef.U;
@@ -820,24 +860,17 @@ bool Label::alignText()
         {
             return true;
         }
-        // optimize for one-texture-only scenario
-        // if multiple textures, then we should count how many chars
-        // are per texture
-        if (_batchNodes.size()==1)
-            _batchNodes.at(0)->reserveCapacity(_utf32Text.size());
-
-        _reusedLetter->setBatchNode(_batchNodes.at(0));
-        
         _lengthOfString = 0;
         _textDesiredHeight = 0.f;
-        _linesWidth.clear();
-        if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
+        bool wrapByWord = _maxLineWidth > 0.f && !_lineBreakWithoutSpaces;
+        int startLine = prepareLayout(wrapByWord);
+        if (wrapByWord)
         {
-            multilineTextWrapByWord();
+            multilineTextWrapByWord(startLine);
         }
         else
         {
-            multilineTextWrapByChar();
+            multilineTextWrapByChar(startLine);
         }
         computeAlignmentOffset();
 
@@ -862,19 +895,138 @@ bool Label::alignText()
         updateColor();
     }while (0);
 
+    if (_overflow == Overflow::SHRINK)
+    {
+        // shrinking relayouts with scaled letter definitions
+        invalidateLayout();
+    }
+
     return ret;
 }
 
+bool Label::LayoutKey::operator==(const LayoutKey& other) const
+{
+    return fontAtlas == other.fontAtlas
+        && definitionsVersion == other.definitionsVersion
+        && maxLineWidth == other.maxLineWidth
+        && lineHeight == other.lineHeight
+        && lineSpacing == other.lineSpacing
+        && additionalKerning == other.additionalKerning
+        && bmfontScale == other.bmfontScale
+        && enableWrap == other.enableWrap
+        && wrapByWord == other.wrapByWord;
+}
+
+int Label::prepareLayout(bool wrapByWord)
+{
+    this->updateBMFontScale();
+
+    LayoutKey key;
+    key.fontAtlas = _fontAtlas;
+    key.definitionsVersion = _fontAtlas->_letterDefinitions.getVersion();
+    key.maxLineWidth = _maxLineWidth;
+    key.lineHeight = _lineHeight;
+    key.lineSpacing = _lineSpacing;
+    key.additionalKerning = _additionalKerning;
+    key.bmfontScale = _bmfontScale;
+    key.enableWrap = _enableWrap;
+    key.wrapByWord = wrapByWord;
+
+    // The lines before the first changed letter are kept. The line holding the letter before it is laid out
+    // again too, since its kerning and the length of its last word depend on the changed letter. When wrapping
+    // by word, so is the line before it, whose break depends on the width of the first word of the next line.
+    int startLine = 0;
+    if (_layoutKey.fontAtlas && key == _layoutKey && !_lineLayoutStates.empty())
+    {
+        auto mismatch = std::mismatch(_utf32Text.begin(), _utf32Text.begin() + std::min(_utf32Text.size(), _layoutText.size()), _layoutText.begin());
+        int firstChanged = static_cast<int>(mismatch.first - _utf32Text.begin());
+        int lastKept = std::max(firstChanged - 1, 0);
+        for (int line = static_cast<int>(_lineLayoutStates.size()) - 1; line > 0; --line)
+        {
+            if (_lineLayoutStates[line].letterIndex <= lastKept)
+            {
+                startLine = line;
+                break;
+            }
+        }
+        if (wrapByWord)
+        {
+            startLine = std::max(startLine - 1, 0);
+        }
+    }
+    _layoutKey = key;
+    _layoutText = _utf32Text;
+
+    return startLine;
+}
+
+void Label::invalidateLayout()
+{
+    _layoutKey.fontAtlas = nullptr;
+    _lineLayoutStates.clear();
+    _layoutText.clear();
+}
+
+const FontLetterDefinition* Label::getLetterDefinition(int letterIndex) const
+{
+    if (static_cast<size_t>(letterIndex) >= _letterDefinitionIndices.size())
+    {
+        return nullptr;
+    }
+
+    int definitionIndex = _letterDefinitionIndices[letterIndex];
+    if (definitionIndex == FontLetterDefinitionTable::INVALID_INDEX)
+    {
+        return nullptr;
+    }
+    return &_fontAtlas->_letterDefinitions.at(definitionIndex);
+}
+
 bool Label::computeHorizontalKernings(const std::u32string& stringToRender)
 {
-    if (_horizontalKernings)
+    auto font = _fontAtlas->getFont();
+    int textLen = static_cast<int>(stringToRender.size());
+
+    // only the kernings from the first changed letter on are computed again
+    int firstChanged = 0;
+    if (_horizontalKernings && font == _kerningFont)
     {
-        delete [] _horizontalKernings;
-        _horizontalKernings = nullptr;
+        if (stringToRender == _kerningText)
+        {
+            return true;
+        }
+        auto commonLen = std::min(stringToRender.size(), _kerningText.size());
+        firstChanged = static_cast<int>(std::mismatch(stringToRender.begin(), stringToRender.begin() + commonLen, _kerningText.begin()).first - stringToRender.begin());
     }
 
+    // a kerning depends on the letter before or after it depending on the font, so the one
+    // before the first changed letter is computed again too
     int letterCount = 0;
-    _horizontalKernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF32(stringToRender, letterCount);
+    int* kernings = nullptr;
+    if (firstChanged > 2)
+    {
+        int reused = firstChanged - 1;
+        int* changedKernings = font->getHorizontalKerningForTextUTF32(stringToRender.substr(reused - 1), letterCount);
+        if (changedKernings)
+        {
+            kernings = new (std::nothrow) int[textLen];
+            if (kernings)
+            {
+                memcpy(kernings, _horizontalKernings, reused * sizeof(int));
+                memcpy(kernings + reused, changedKernings + 1, (textLen - reused) * sizeof(int));
+            }
+            delete [] changedKernings;
+        }
+    }
+    if (!kernings)
+    {
+        kernings = font->getHorizontalKerningForTextUTF32(stringToRender, letterCount);
+    }
+
+    delete [] _horizontalKernings;
+    _horizontalKernings = kernings;
+    _kerningFont = font;
+    _kerningText = stringToRender;
 
     if(!_horizontalKernings)
         return false;
@@ -896,34 +1048,56 @@ bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
 bool Label::updateQuads()
 {
     bool ret = true;
-    for (auto&& batchNode : _batchNodes)
+
+    // the quads of all the letters are built first, then copied to each texture atlas at once
+    auto batchCount = static_cast<size_t>(_batchNodes.size());
+    if (_batchQuads.size() < batchCount)
     {
-        batchNode->getTextureAtlas()->removeAllQuads();
+        _batchQuads.resize(batchCount);
     }
-    
+    for (size_t i = 0; i < batchCount; ++i)
+    {
+        _batchQuads[i].clear();
+    }
+
+    float letterScale = 1.f;
+    if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
+    {
+        letterScale = _bmfontScale;
+    }
+    else if (std::abs(_bmFontSize) < FLT_EPSILON)
+    {
+        letterScale = 0.f;
+    }
+
+    auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    Rect letterRect;
+    V3F_C4B_T2F_Quad quad;
+    quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = Color4B::WHITE;
+
     for (int ctr = 0; ctr < _lengthOfString; ++ctr)
     {
         if (_lettersInfo[ctr].valid)
         {
-            auto& letterDef = _fontAtlas->_letterDefinitions[_lettersInfo[ctr].utf32Char];
-            
-            _reusedRect.size.height = letterDef.height;
-            _reusedRect.size.width  = letterDef.width;
-            _reusedRect.origin.x    = letterDef.U;
-            _reusedRect.origin.y    = letterDef.V;
+            auto& letterDef = *getLetterDefinition(ctr);
+
+            letterRect.size.height = letterDef.height;
+            letterRect.size.width  = letterDef.width;
+            letterRect.origin.x    = letterDef.U;
+            letterRect.origin.y    = letterDef.V;
 
             auto py = _lettersInfo[ctr].positionY + _letterOffsetY;
             if (_labelHeight > 0.f) {
                 if (py > _tailoredTopY)
                 {
                     auto clipTop = py - _tailoredTopY;
-                    _reusedRect.origin.y += clipTop;
-                    _reusedRect.size.height -= clipTop;
+                    letterRect.origin.y += clipTop;
+                    letterRect.size.height -= clipTop;
                     py -= clipTop;
                 }
                 if (py - letterDef.height * _bmfontScale < _tailoredBottomY)
                 {
-                    _reusedRect.size.height = (py < _tailoredBottomY) ? 0.f : (py - _tailoredBottomY);
+                    letterRect.size.height = (py < _tailoredBottomY) ? 0.f : (py - _tailoredBottomY);
                 }
             }
 
@@ -933,13 +1107,13 @@ bool Label::updateQuads()
             if(_labelWidth > 0.f){
                 if (this->isHorizontalClamped(px, lineIndex)) {
                     if(_overflow == Overflow::CLAMP){
-                        _reusedRect.size.width = 0;
+                        letterRect.size.width = 0;
                     }else if(_overflow == Overflow::SHRINK){
                         if (_contentSize.width > letterDef.width) {
                             ret = false;
                             break;
                         }else{
-                            _reusedRect.size.width = 0;
+                            letterRect.size.width = 0;
                         }
 
                     }
@@ -947,21 +1121,64 @@ bool Label::updateQuads()
             }
 
 
-            if (_reusedRect.size.height > 0.f && _reusedRect.size.width > 0.f)
+            if (letterRect.size.height > 0.f && letterRect.size.width > 0.f)
             {
-                _reusedLetter->setTextureRect(_reusedRect, false, _reusedRect.size);
-                float letterPositionX = _lettersInfo[ctr].positionX + _linesOffsetX[_lettersInfo[ctr].lineIndex];
-                _reusedLetter->setPosition(letterPositionX, py);
-                auto index = static_cast<int>(_batchNodes.at(letterDef.textureID)->getTextureAtlas()->getTotalQuads());
-                _lettersInfo[ctr].atlasIndex = index;
-
-                this->updateLetterSpriteScale(_reusedLetter);
-
-                _batchNodes.at(letterDef.textureID)->insertQuadFromSprite(_reusedLetter, index);
+                auto& quads = _batchQuads[letterDef.textureID];
+                _lettersInfo[ctr].atlasIndex = static_cast<int>(quads.size());
+
+                // same quad as a sprite anchored at its top left corner
+                float left = _lettersInfo[ctr].positionX + _linesOffsetX[lineIndex];
+                float right = left + letterRect.size.width * letterScale;
+                float bottom = py - letterRect.size.height * letterScale;
+                quad.bl.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(left), SPRITE_RENDER_IN_SUBPIXEL(bottom), 0.f);
+                quad.br.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(right), SPRITE_RENDER_IN_SUBPIXEL(bottom), 0.f);
+                quad.tl.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(left), SPRITE_RENDER_IN_SUBPIXEL(py), 0.f);
+                quad.tr.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(right), SPRITE_RENDER_IN_SUBPIXEL(py), 0.f);
+
+                auto texture = _batchNodes.at(letterDef.textureID)->getTexture();
+                float atlasWidth = (float)texture->getPixelsWide();
+                float atlasHeight = (float)texture->getPixelsHigh();
+                float rectX = letterRect.origin.x * contentScaleFactor;
+                float rectY = letterRect.origin.y * contentScaleFactor;
+                float rectWidth = letterRect.size.width * contentScaleFactor;
+                float rectHeight = letterRect.size.height * contentScaleFactor;
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+                float texLeft = (2 * rectX + 1) / (2 * atlasWidth);
+                float texRight = texLeft + (rectWidth * 2 - 2) / (2 * atlasWidth);
+                float texTop = (2 * rectY + 1) / (2 * atlasHeight);
+                float texBottom = texTop + (rectHeight * 2 - 2) / (2 * atlasHeight);
+#else
+                float texLeft = rectX / atlasWidth;
+                float texRight = (rectX + rectWidth) / atlasWidth;
+                float texTop = rectY / atlasHeight;
+                float texBottom = (rectY + rectHeight) / atlasHeight;
+#endif
+                quad.bl.texCoords.u = texLeft;
+                quad.bl.texCoords.v = texBottom;
+                quad.br.texCoords.u = texRight;
+                quad.br.texCoords.v = texBottom;
+                quad.tl.texCoords.u = texLeft;
+                quad.tl.texCoords.v = texTop;
+                quad.tr.texCoords.u = texRight;
+                quad.tr.texCoords.v = texTop;
+
+                quads.push_back(quad);
             }
         }     
     }
 
+    for (size_t i = 0; i < batchCount; ++i)
+    {
+        auto batchNode = _batchNodes.at(i);
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto& quads = _batchQuads[i];
+        textureAtlas->removeAllQuads();
+        if (!quads.empty())
+        {
+            batchNode->reserveCapacity(quads.size());
+            textureAtlas->insertQuads(quads.data(), 0, quads.size());
+        }
+    }
 
     return ret;
 }
@@ -976,10 +1193,16 @@ bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
         return false;
     }
 
-    _currentLabelType = LabelType::TTF;
-    setFontAtlas(newAtlas,ttfConfig.distanceFieldEnabled,true);
-
     _fontConfig = ttfConfig;
+    // a baked font was rendered with its own distance field and outline settings
+    if (auto bakedFont = dynamic_cast<const FontBaked*>(newAtlas->getFont()))
+    {
+        _fontConfig.distanceFieldEnabled = bakedFont->isDistanceFieldEnabled();
+        _fontConfig.outlineSize = static_cast<int>(bakedFont->getOutlineSize());
+    }
+
+    _currentLabelType = LabelType::TTF;
+    setFontAtlas(newAtlas,_fontConfig.distanceFieldEnabled,true);
 
     if (_fontConfig.outlineSize > 0)
     {
@@ -1658,8 +1881,12 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    const bool pushMatrix = _director->isMatrixStackPushedOnVisit();
+    if (pushMatrix)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     if (!_children.empty())
     {
@@ -1690,7 +1917,8 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         this->drawSelf(visibleByCamera, renderer, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (pushMatrix)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
 void Label::drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags)
@@ -1762,7 +1990,7 @@ Sprite* Label::getLetter(int letterIndex)
 
             if (letter == nullptr)
             {
-                auto& letterDef = _fontAtlas->_letterDefinitions[letterInfo.utf32Char];
+                auto& letterDef = *getLetterDefinition(letterIndex);
                 auto textureID = letterDef.textureID;
                 Rect uvRect;
                 uvRect.size.height = letterDef.height;
@@ -631,6 +631,33 @@ protected:
         int lineIndex;
     };
 
+    // state of the line wrapping at the start of a line, a relayout resumes from the line of the first changed letter
+    struct LineLayoutState
+    {
+        int letterIndex;
+        float nextTokenY;
+        float highestY;
+        float lowestY;
+        float longestLine;
+        bool nextChangeSize;
+    };
+
+    // everything besides the text that the line wrapping depends on
+    struct LayoutKey
+    {
+        FontAtlas* fontAtlas;
+        unsigned int definitionsVersion;
+        float maxLineWidth;
+        float lineHeight;
+        float lineSpacing;
+        float additionalKerning;
+        float bmfontScale;
+        bool enableWrap;
+        bool wrapByWord;
+
+        bool operator==(const LayoutKey& other) const;
+    };
+
     enum class LabelType {
         TTF,
         BMFONT,
@@ -646,9 +673,11 @@ protected:
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
     void drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags);
 
-    bool multilineTextWrapByChar();
-    bool multilineTextWrapByWord();
-    bool multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& lambda);
+    bool multilineTextWrapByChar(int startLine = 0);
+    bool multilineTextWrapByWord(int startLine = 0);
+    bool multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& lambda, int startLine = 0);
+    int prepareLayout(bool wrapByWord);
+    void invalidateLayout();
     void shrinkLabelToContentSize(const std::function<bool(void)>& lambda);
     bool isHorizontalClamp();
     bool isVerticalClamp();
@@ -659,6 +688,7 @@ protected:
     virtual bool alignText();
     void computeAlignmentOffset();
     bool computeHorizontalKernings(const std::u32string& stringToRender);
+    const FontLetterDefinition* getLetterDefinition(int letterIndex) const;
 
     void recordLetterInfo(const cocos2d::Vec2& point, char32_t utf32Char, int letterIndex, int lineIndex);
     void recordPlaceholderInfo(int letterIndex, char32_t utf16Char);
@@ -669,6 +699,9 @@ protected:
     void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
 
     virtual void updateShaderProgram();
+    bool isMultiChannelDistanceField() const;
+    /** Size in pixels of the BMFont, or of the baked font, used by the label. */
+    float getBMFontOriginalSize() const;
     void updateBMFontScale();
     void scaleFontSizeDown(float fontSize);
     bool setTTFConfigInternal(const TTFConfig& ttfConfig);
@@ -704,11 +737,16 @@ protected:
     FontAtlas* _fontAtlas;
     Vector<SpriteBatchNode*> _batchNodes;
     std::vector<LetterInfo> _lettersInfo;
+    int _lengthOfString;
 
     //! used for optimization
-    Sprite *_reusedLetter;
-    Rect _reusedRect;
-    int _lengthOfString;
+    std::vector<int> _letterDefinitionIndices;
+    std::vector<LineLayoutState> _lineLayoutStates;
+    LayoutKey _layoutKey;
+    std::u32string _layoutText;
+    std::u32string _kerningText;
+    const Font* _kerningFont;
+    std::vector<std::vector<V3F_C4B_T2F_Quad>> _batchQuads;
 
     //layout relevant properties.
     float _lineHeight;
@@ -766,6 +804,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _updateTextureListener;
 
 #if CC_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
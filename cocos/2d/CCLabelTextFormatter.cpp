@@ -86,29 +86,31 @@ int Label::getFirstWordLen(const std::u32string& utf32Text, int startIndex, int
     }
 
     int len = 1;
-    FontLetterDefinition letterDef;
-    if(!_fontAtlas->getLetterDefinitionForChar(character, letterDef)) {
+    auto& letterDefinitions = _fontAtlas->_letterDefinitions;
+    auto letterDef = letterDefinitions.find(character);
+    if (!letterDef || !letterDef->validDefinition) {
         return len;
     }
-    auto nextLetterX = letterDef.xAdvance * _bmfontScale + _additionalKerning;
+    auto nextLetterX = letterDef->xAdvance * _bmfontScale + _additionalKerning;
 
     auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
     for (int index = startIndex + 1; index < textLen; ++index)
     {
         character = utf32Text[index];
-        if (!_fontAtlas->getLetterDefinitionForChar(character, letterDef))
+        letterDef = letterDefinitions.find(character);
+        if (!letterDef || !letterDef->validDefinition)
         {
             break;
         }
 
-        auto letterX = (nextLetterX + letterDef.offsetX * _bmfontScale) / contentScaleFactor;
-        if (_maxLineWidth > 0.f && letterX + letterDef.width * _bmfontScale > _maxLineWidth
+        auto letterX = (nextLetterX + letterDef->offsetX * _bmfontScale) / contentScaleFactor;
+        if (_maxLineWidth > 0.f && letterX + letterDef->width * _bmfontScale > _maxLineWidth
             && !StringUtils::isUnicodeSpace(character))
         {
             return len;
         }
 
-        nextLetterX += letterDef.xAdvance * _bmfontScale + _additionalKerning;
+        nextLetterX += letterDef->xAdvance * _bmfontScale + _additionalKerning;
 
         if (character == (char16_t)TextFormatter::NewLine
             || StringUtils::isUnicodeSpace(character)
@@ -124,36 +126,56 @@ int Label::getFirstWordLen(const std::u32string& utf32Text, int startIndex, int
 
 void Label::updateBMFontScale()
 {
-    auto font = _fontAtlas->getFont();
     if (_currentLabelType == LabelType::BMFONT) {
-        FontFNT *bmFont = (FontFNT*)font;
-        float originalFontSize = bmFont->getOriginalFontSize();
+        float originalFontSize = getBMFontOriginalSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
     }else{
         _bmfontScale = 1.0f;
     }
 }
 
-bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& nextTokenLen)
+bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& nextTokenLen, int startLine)
 {
     int textLen = getStringLength();
     int lineIndex = 0;
     float nextTokenX = 0.f;
-    float nextTokenY = 0.f;
-    float longestLine = 0.f;
     float letterRight = 0.f;
 
     auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
     float lineSpacing = _lineSpacing * contentScaleFactor;
-    float highestY = 0.f;
-    float lowestY = 0.f;
-    FontLetterDefinition letterDef;
     Vec2 letterPosition;
-    bool nextChangeSize = true;
 
     this->updateBMFontScale();
 
-    for (int index = 0; index < textLen; )
+    // resume at the start of a line laid out previously
+    if (startLine > 0 && startLine < static_cast<int>(_lineLayoutStates.size()))
+    {
+        lineIndex = startLine;
+        _lineLayoutStates.resize(startLine + 1);
+        _linesWidth.resize(startLine);
+    }
+    else
+    {
+        LineLayoutState firstLine = { 0, 0.f, 0.f, 0.f, 0.f, true };
+        _lineLayoutStates.assign(1, firstLine);
+        _linesWidth.clear();
+    }
+    auto startState = _lineLayoutStates.back();
+    float nextTokenY = startState.nextTokenY;
+    float highestY = startState.highestY;
+    float lowestY = startState.lowestY;
+    float longestLine = startState.longestLine;
+    bool nextChangeSize = startState.nextChangeSize;
+
+    // the definitions of the letters are looked up in one pass, the ones before the start line are unchanged
+    _letterDefinitionIndices.resize(textLen);
+    if (startState.letterIndex < textLen)
+    {
+        _fontAtlas->_letterDefinitions.findIndices(_utf32Text.data() + startState.letterIndex, textLen - startState.letterIndex,
+            _letterDefinitionIndices.data() + startState.letterIndex);
+    }
+
+    for (int index = startState.letterIndex; index < textLen; )
     {
         auto character = _utf32Text[index];
         if (character == (char32_t)TextFormatter::NewLine)
@@ -165,6 +187,8 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             nextTokenY -= _lineHeight*_bmfontScale + lineSpacing;
             recordPlaceholderInfo(index, character);
             index++;
+            LineLayoutState lineState = { index, nextTokenY, highestY, lowestY, longestLine, nextChangeSize };
+            _lineLayoutStates.push_back(lineState);
             continue;
         }
 
@@ -190,12 +214,14 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
                 recordPlaceholderInfo(letterIndex, character);
                 continue;
             }
-            if (!_fontAtlas->getLetterDefinitionForChar(character, letterDef))
+            auto definition = getLetterDefinition(letterIndex);
+            if (!definition || !definition->validDefinition)
             {
                 recordPlaceholderInfo(letterIndex, character);
                 CCLOG("LabelTextFormatter error:can't find letter definition in font file for letter: %c", character);
                 continue;
             }
+            auto& letterDef = *definition;
 
             auto letterX = (nextLetterX + letterDef.offsetX * _bmfontScale) / contentScaleFactor;
             if (_enableWrap && _maxLineWidth > 0.f && nextTokenX > 0.f && letterX + letterDef.width * _bmfontScale > _maxLineWidth
@@ -207,6 +233,8 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
                 nextTokenX = 0.f;
                 nextTokenY -= (_lineHeight*_bmfontScale + lineSpacing);
                 newLine = true;
+                LineLayoutState lineState = { index, nextTokenY, highestY, lowestY, longestLine, nextChangeSize };
+                _lineLayoutStates.push_back(lineState);
                 break;
             }
             else
@@ -272,14 +300,14 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
     return true;
 }
 
-bool Label::multilineTextWrapByWord()
+bool Label::multilineTextWrapByWord(int startLine)
 {
-    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this));
+    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this), startLine);
 }
 
-bool Label::multilineTextWrapByChar()
+bool Label::multilineTextWrapByChar(int startLine)
 {
-    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstCharLen, this));
+    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstCharLen, this), startLine);
 }
 
 bool Label::isVerticalClamp()
@@ -301,7 +329,7 @@ bool Label::isHorizontalClamp()
     {
         if (_lettersInfo[ctr].valid)
         {
-            auto& letterDef = _fontAtlas->_letterDefinitions[_lettersInfo[ctr].utf32Char];
+            auto& letterDef = *getLetterDefinition(ctr);
 
             auto px = _lettersInfo[ctr].positionX + letterDef.width/2 * _bmfontScale;
             auto lineIndex = _lettersInfo[ctr].lineIndex;
@@ -379,7 +407,7 @@ void Label::recordLetterInfo(const cocos2d::Vec2& point, char32_t utf32Char, int
     }
     _lettersInfo[letterIndex].lineIndex = lineIndex;
     _lettersInfo[letterIndex].utf32Char = utf32Char;
-    _lettersInfo[letterIndex].valid = _fontAtlas->_letterDefinitions[utf32Char].validDefinition;
+    _lettersInfo[letterIndex].valid = true;
     _lettersInfo[letterIndex].positionX = point.x;
     _lettersInfo[letterIndex].positionY = point.y;
 }
@@ -40,9 +40,12 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCSpatialIndex.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
+#include "math/MathUtil.h"
 #include "math/TransformUtils.h"
 
 
@@ -80,6 +83,7 @@ Node::Node()
 , _additionalTransform(nullptr)
 , _additionalTransformDirty(false)
 , _transformUpdated(true)
+, _modelViewTransformBatched(false)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrderAndArrival(0)
@@ -110,6 +114,10 @@ Node::Node()
 , _cascadeColorEnabled(false)
 , _cascadeOpacityEnabled(false)
 , _cameraMask(1)
+, _parallelVisitEnabled(false)
+, _spatialIndex(nullptr)
+, _spatialIndexSlot(-1)
+, _hitTestBoundsDirty(true)
 #if CC_USE_PHYSICS
 , _physicsBody(nullptr)
 #endif
@@ -162,6 +170,8 @@ Node::~Node()
     // attributes
     CC_SAFE_RELEASE_NULL(_glProgramState);
 
+    CC_SAFE_DELETE(_spatialIndex);
+
     for (auto& child : _children)
     {
         child->_parent = nullptr;
@@ -235,6 +245,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 float Node::getSkewY() const
@@ -249,6 +260,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 void Node::setLocalZOrder(int z)
@@ -302,6 +314,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
     
     updateRotationQuat();
 }
@@ -319,6 +332,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -370,6 +384,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -384,6 +399,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
     
     updateRotationQuat();
 }
@@ -400,6 +416,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
     
     updateRotationQuat();
 }
@@ -419,6 +436,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 /// scaleX getter
@@ -436,6 +454,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 /// scaleX setter
@@ -446,6 +465,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 /// scaleY getter
@@ -462,6 +482,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 /// scaleY getter
@@ -478,6 +499,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 
@@ -508,6 +530,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
     _usingNormalizedPosition = false;
 }
 
@@ -553,6 +576,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 
     _positionZ = positionZ;
 }
@@ -573,6 +597,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -594,6 +619,8 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        // the hidden subtree wasn't visited, so its bounds may be stale
+        _hitTestBoundsDirty = true;
     }
 }
 
@@ -615,6 +642,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markSpatialIndexDirty();
     }
 }
 
@@ -632,6 +660,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        markSpatialIndexDirty();
     }
 }
 
@@ -644,8 +673,38 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    if (_spatialIndexSlot >= 0)
+        _parent->_spatialIndex->remove(this);
+
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+
+    if (_parent && _parent->_spatialIndex)
+        _parent->_spatialIndex->insert(this);
+}
+
+void Node::markSpatialIndexDirty()
+{
+    _hitTestBoundsDirty = true;
+    if (_spatialIndexSlot >= 0)
+        _parent->_spatialIndex->markDirty(this);
+}
+
+void Node::setSpatialIndexEnabled(bool enabled, float cellSize)
+{
+    if (_spatialIndex)
+    {
+        if (enabled && _spatialIndex->getCellSize() == cellSize)
+            return;
+        CC_SAFE_DELETE(_spatialIndex);
+    }
+
+    if (enabled)
+    {
+        _spatialIndex = new (std::nothrow) SpatialIndex(cellSize);
+        for (const auto& child : _children)
+            _spatialIndex->insert(child);
+    }
 }
 
 /// isRelativeAnchorPoint getter
@@ -661,6 +720,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markSpatialIndexDirty();
     }
 }
 
@@ -1212,10 +1272,14 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
     
+    if (flags & FLAGS_DIRTY_MASK)
+        _hitTestBoundsDirty = true;
 
-    if(flags & FLAGS_DIRTY_MASK)
+    // the parent may have computed it already, unless the transform changed since
+    if((flags & FLAGS_DIRTY_MASK) && (!_modelViewTransformBatched || _transformDirty || _additionalTransformDirty))
         _modelViewTransform = this->transform(parentTransform);
     
+    _modelViewTransformBatched = false;
     _transformUpdated = false;
     _contentSizeDirty = false;
 
@@ -1242,16 +1306,32 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    const bool pushMatrix = _director->isMatrixStackPushedOnVisit();
+    if (pushMatrix)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
     int i = 0;
 
-    if(!_children.empty())
+    if(!_children.empty() && _spatialIndex)
+    {
+        sortAllChildren();
+        visitSpatiallyIndexedChildren(renderer, flags, visibleByCamera);
+    }
+    else if(!_children.empty() && _parallelVisitEnabled && !Renderer::getCurrentRecording())
+    {
+        sortAllChildren();
+        updateChildrenTransforms(flags);
+        visitChildrenInParallel(renderer, flags, visibleByCamera);
+    }
+    else if(!_children.empty())
     {
         sortAllChildren();
+        updateChildrenTransforms(flags);
         // draw children zOrder < 0
         for(auto size = _children.size(); i < size; ++i)
         {
@@ -1274,7 +1354,8 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (pushMatrix)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1282,6 +1363,91 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildrenInParallel(Renderer* renderer, uint32_t flags, bool visibleByCamera)
+{
+    int childrenCount = (int)_children.size();
+    renderer->recordInParallel(childrenCount, [&](int index) {
+        _children.at(index)->visit(renderer, _modelViewTransform, flags);
+    });
+
+    // merge in the order of the serial visit: children zOrder < 0, self draw, then the other children
+    int i = 0;
+    while (i < childrenCount && _children.at(i)->_localZOrder < 0)
+        ++i;
+
+    renderer->mergeRecordings(0, i);
+    if (visibleByCamera)
+        this->draw(renderer, _modelViewTransform, flags);
+    renderer->mergeRecordings(i, childrenCount);
+}
+
+void Node::visitSpatiallyIndexedChildren(Renderer* renderer, uint32_t flags, bool visibleByCamera)
+{
+    // the children skipped while this node's transform changed must update theirs when visited again
+    if (flags & FLAGS_DIRTY_MASK)
+        ++_spatialIndex->_transformEpoch;
+
+    _spatialIndex->collectVisibleNodes(_modelViewTransform, _children);
+
+    // the vector is reused by the next visit of this node
+    auto& nodes = _spatialIndex->_visibleNodes;
+    size_t i = 0;
+    for (size_t size = nodes.size(); i < size && nodes[i]->_localZOrder < 0; ++i)
+    {
+        auto node = nodes[i];
+        node->visit(renderer, _modelViewTransform, _spatialIndex->isTransformStale(node) ? flags | FLAGS_DIRTY_MASK : flags);
+    }
+
+    if (visibleByCamera)
+        this->draw(renderer, _modelViewTransform, flags);
+
+    for (size_t size = nodes.size(); i < size; ++i)
+    {
+        auto node = nodes[i];
+        node->visit(renderer, _modelViewTransform, _spatialIndex->isTransformStale(node) ? flags | FLAGS_DIRTY_MASK : flags);
+    }
+}
+
+void Node::updateChildrenTransforms(uint32_t flags)
+{
+    // When this node's transform didn't change, only the children whose transform changed need to
+    // compute theirs, which they do while being visited.
+    static const ssize_t MIN_BATCHED_CHILDREN = 4;
+    if (!(flags & FLAGS_DIRTY_MASK) || _children.size() < MIN_BATCHED_CHILDREN)
+        return;
+
+    // The local transforms and the products are kept contiguous so that the products are computed in one pass.
+    // thread_local since subtrees may be visited in parallel, the buffers are free again once the children are updated.
+    static thread_local std::vector<Node*> s_batchedChildren;
+    static thread_local std::vector<Mat4> s_localTransforms;
+    static thread_local std::vector<Mat4> s_modelViewTransforms;
+
+    s_batchedChildren.clear();
+    s_localTransforms.clear();
+    for (auto child : _children)
+    {
+        // skip the children which return before computing their transform, or which move with the parent's content size
+        if (!child->_visible || child->_usingNormalizedPosition || !child->isVisitableByVisitingCamera())
+            continue;
+
+        s_batchedChildren.push_back(child);
+        s_localTransforms.push_back(child->getNodeToParentTransform());
+    }
+
+    const size_t count = s_batchedChildren.size();
+    if (count == 0)
+        return;
+
+    s_modelViewTransforms.resize(count);
+    MathUtil::multiplyMatrixArray(_modelViewTransform.m, s_localTransforms[0].m, count, s_modelViewTransforms[0].m);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        s_batchedChildren[i]->_modelViewTransform = s_modelViewTransforms[i];
+        s_batchedChildren[i]->_modelViewTransformBatched = true;
+    }
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -1785,6 +1951,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    _hitTestBoundsDirty = true;
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1817,6 +1984,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    markSpatialIndexDirty();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -62,6 +62,7 @@ class GLProgramState;
 class Material;
 class Camera;
 class PhysicsBody;
+class SpatialIndex;
 
 /**
  * @addtogroup _2d
@@ -1173,6 +1174,46 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the children of this node are visited in parallel on the WorkerPool.
+     * The render commands of each child subtree are recorded apart and merged in the order of the children,
+     * so the result is the same as the serial visit.
+     * Only enable it for subtrees whose visit() and draw() don't touch shared state: no GL calls,
+     * no autoreleased objects, no changes to the scene graph. Defaults to false.
+     *
+     * @param enabled True to visit the children in parallel.
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    /**
+     * Returns whether the children of this node are visited in parallel.
+     *
+     * @return True if the children of this node are visited in parallel.
+     */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Sets whether the children of this node are kept in a grid of their bounding boxes, so that the
+     * children outside of the screen are skipped by visit() without visiting their subtrees.
+     * Useful for big maps whose children are mostly offscreen. See SpatialIndex for its limits.
+     * It takes precedence over the parallel visit. Defaults to false.
+     *
+     * @param enabled True to index the children.
+     * @param cellSize The size of a cell of the grid, in points. Defaults to 256.
+     */
+    void setSpatialIndexEnabled(bool enabled, float cellSize = 256.0f);
+    /**
+     * Returns whether the children of this node are kept in a spatial index.
+     *
+     * @return True if the children of this node are kept in a spatial index.
+     */
+    bool isSpatialIndexEnabled() const { return _spatialIndex != nullptr; }
+    /**
+     * Returns the spatial index of the children, with the count of visited and culled children of the last visit.
+     *
+     * @return The spatial index, or nullptr if it isn't enabled.
+     */
+    SpatialIndex* getSpatialIndex() const { return _spatialIndex; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1879,6 +1920,18 @@ protected:
     virtual void disableCascadeColor();
     virtual void updateColor() {}
     
+    /// computes the modelview transforms of the children in one pass when this node's one changed, see MathUtil::multiplyMatrixArray()
+    void updateChildrenTransforms(uint32_t flags);
+
+    /// visits the children subtrees in parallel, then draws the node between the children with zOrder < 0 and the others
+    void visitChildrenInParallel(Renderer* renderer, uint32_t flags, bool visibleByCamera);
+
+    /// visits the children seen by the camera according to the spatial index, then draws the node between them like visit()
+    void visitSpatiallyIndexedChildren(Renderer* renderer, uint32_t flags, bool visibleByCamera);
+
+    /// tells the spatial index of the parent, if any, and the touch hit-test index that the bounding box of this node changed
+    void markSpatialIndexDirty();
+
     bool doEnumerate(std::string name, std::function<bool (Node *)> callback) const;
     bool doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const;
     
@@ -1933,6 +1986,7 @@ protected:
     mutable Mat4* _additionalTransform; ///< two transforms needed by additional transforms
     mutable bool _additionalTransformDirty; ///< transform dirty ?
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
+    bool _modelViewTransformBatched;    ///< Whether or not the parent computed _modelViewTransform for this visit, see updateChildrenTransforms()
 
     std::int64_t _localZOrderAndArrival; /// cache, for 64bits compress optimize.
     int _localZOrder; /// < Local order (relative to its siblings) used to sort the node
@@ -1988,6 +2042,12 @@ protected:
 
     // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
     unsigned short _cameraMask;
+
+    bool _parallelVisitEnabled;
+
+    SpatialIndex* _spatialIndex;    ///< index of the children, nullptr if disabled
+    int _spatialIndexSlot;          ///< slot of this node in the spatial index of the parent, -1 if none
+    bool _hitTestBoundsDirty;       ///< whether the world bounding box changed since the touch hit-test index read it
     
     std::function<void()> _onEnterCallback;
     std::function<void()> _onExitCallback;
@@ -2012,6 +2072,9 @@ public:
     friend class PhysicsBody;
 #endif
 
+    friend class SpatialIndex;
+    friend class EventDispatcher;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
@@ -0,0 +1,596 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCParticleKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define USE_NEON
+#include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+static std::atomic<bool> s_simdEnabled(true);
+
+static const float FOUR_OVER_PI = 1.27323954473516f;
+static const float DEGREES_TO_RADIANS = 0.01745329252f;
+
+//
+// Scalar kernels, they are the reference and handle the particles left over by the SIMD kernels.
+//
+
+static int updateTimeToLiveScalar(float* timeToLive, int begin, int end, float dt)
+{
+    int dead = 0;
+    for (int i = begin; i < end; ++i)
+    {
+        timeToLive[i] -= dt;
+        dead += timeToLive[i] <= 0.0f;
+    }
+    return dead;
+}
+
+static void updateGravityModeScalar(ParticleData& data, int begin, int end, const Vec2& gravity, float yCoordFlipped, float dt)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        float x = data.posx[i];
+        float y = data.posy[i];
+
+        // radial acceleration
+        float radialX = 0.0f;
+        float radialY = 0.0f;
+        float n = x * x + y * y;
+        if (n > FLT_MIN)
+        {
+            n = 1.0f / sqrtf(n);
+            radialX = x * n;
+            radialY = y * n;
+        }
+
+        // (gravity + radial + tangential) * dt
+        float radialAccel = data.modeA.radialAccel[i];
+        float tangentialAccel = data.modeA.tangentialAccel[i];
+        data.modeA.dirX[i] += (radialX * radialAccel - radialY * tangentialAccel + gravity.x) * dt;
+        data.modeA.dirY[i] += (radialY * radialAccel + radialX * tangentialAccel + gravity.y) * dt;
+
+        data.posx[i] = x + data.modeA.dirX[i] * dt * yCoordFlipped;
+        data.posy[i] = y + data.modeA.dirY[i] * dt * yCoordFlipped;
+    }
+}
+
+static void updateRadiusModeScalar(ParticleData& data, int begin, int end, float yCoordFlipped, float dt)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        float angle = data.modeB.angle[i] + data.modeB.degreesPerSecond[i] * dt;
+        float radius = data.modeB.radius[i] + data.modeB.deltaRadius[i] * dt;
+        data.modeB.angle[i] = angle;
+        data.modeB.radius[i] = radius;
+        data.posx[i] = - cosf(angle) * radius;
+        data.posy[i] = - sinf(angle) * radius * yCoordFlipped;
+    }
+}
+
+static void addScaledScalar(float* values, const float* deltas, int begin, int end, float dt)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        values[i] += deltas[i] * dt;
+    }
+}
+
+static void addScaledClampedScalar(float* values, const float* deltas, int begin, int end, float dt)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        values[i] = MAX(0.0f, values[i] + deltas[i] * dt);
+    }
+}
+
+static void setQuadVertices(V3F_C4B_T2F_Quad* quad, float x, float y, float halfCos, float halfSin)
+{
+    quad->bl.vertices.x = x - halfCos + halfSin;
+    quad->bl.vertices.y = y - halfSin - halfCos;
+    quad->br.vertices.x = x + halfCos + halfSin;
+    quad->br.vertices.y = y + halfSin - halfCos;
+    quad->tl.vertices.x = x - halfCos - halfSin;
+    quad->tl.vertices.y = y - halfSin + halfCos;
+    quad->tr.vertices.x = x + halfCos - halfSin;
+    quad->tr.vertices.y = y + halfSin + halfCos;
+}
+
+static void updateQuadVerticesScalar(const ParticleData& data, int begin, int end, const float transform[6], V3F_C4B_T2F_Quad* quads)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        float startX = data.startPosX[i];
+        float startY = data.startPosY[i];
+        float x = data.posx[i] + transform[0] * startX + transform[2] * startY + transform[4];
+        float y = data.posy[i] + transform[1] * startX + transform[3] * startY + transform[5];
+
+        float halfSize = data.size[i] * 0.5f;
+        float r = -data.rotation[i] * DEGREES_TO_RADIANS;
+        setQuadVertices(&quads[i], x, y, halfSize * cosf(r), halfSize * sinf(r));
+    }
+}
+
+static void setQuadColor(V3F_C4B_T2F_Quad* quad, uint32_t color)
+{
+    memcpy((void*)&quad->bl.colors, &color, sizeof(color));
+    memcpy((void*)&quad->br.colors, &color, sizeof(color));
+    memcpy((void*)&quad->tl.colors, &color, sizeof(color));
+    memcpy((void*)&quad->tr.colors, &color, sizeof(color));
+}
+
+static void updateQuadColorsScalar(const ParticleData& data, int begin, int end, bool premultiplyAlpha, V3F_C4B_T2F_Quad* quads)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        float a = data.colorA[i];
+        float scale = premultiplyAlpha ? a * 255 : 255;
+        GLubyte color[4] = {
+            (GLubyte)(int)(data.colorR[i] * scale),
+            (GLubyte)(int)(data.colorG[i] * scale),
+            (GLubyte)(int)(data.colorB[i] * scale),
+            (GLubyte)(int)(a * 255)
+        };
+        uint32_t packed;
+        memcpy(&packed, color, sizeof(packed));
+        setQuadColor(&quads[i], packed);
+    }
+}
+
+#if defined(USE_SSE2) || defined(USE_NEON)
+
+//
+// Four wide operations, the SIMD kernels are written once on top of them.
+//
+
+#ifdef USE_SSE2
+
+typedef __m128 float4;
+typedef __m128i int4;
+
+static inline float4 vload(const float* p) { return _mm_loadu_ps(p); }
+static inline void vstore(float* p, float4 v) { _mm_storeu_ps(p, v); }
+static inline float4 vset(float f) { return _mm_set1_ps(f); }
+static inline float4 vadd(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 vsub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 vmul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 vmax(float4 a, float4 b) { return _mm_max_ps(a, b); }
+static inline float4 vrsqrt(float4 a) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a)); }
+static inline float4 vgreater(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+static inline float4 vlessequal(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+static inline float4 vand(float4 a, float4 b) { return _mm_and_ps(a, b); }
+static inline float4 vxor(float4 a, float4 b) { return _mm_xor_ps(a, b); }
+static inline float4 vselect(float4 mask, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline float4 vabs(float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline float4 vsign(float4 a) { return _mm_and_ps(_mm_set1_ps(-0.0f), a); }
+
+static inline int4 ivset(int i) { return _mm_set1_epi32(i); }
+static inline int4 ivtrunc(float4 a) { return _mm_cvttps_epi32(a); }
+static inline float4 ivtofloat(int4 a) { return _mm_cvtepi32_ps(a); }
+static inline float4 ivbits(int4 a) { return _mm_castsi128_ps(a); }
+static inline int4 ivadd(int4 a, int4 b) { return _mm_add_epi32(a, b); }
+static inline int4 ivsub(int4 a, int4 b) { return _mm_sub_epi32(a, b); }
+static inline int4 ivand(int4 a, int4 b) { return _mm_and_si128(a, b); }
+static inline int4 ivandnot(int4 a, int4 b) { return _mm_andnot_si128(a, b); }
+static inline int4 ivor(int4 a, int4 b) { return _mm_or_si128(a, b); }
+static inline float4 ivequalzero(int4 a) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, _mm_setzero_si128())); }
+template <int N> static inline int4 ivshl(int4 a) { return _mm_slli_epi32(a, N); }
+static inline void ivstore(uint32_t* p, int4 v) { _mm_storeu_si128((__m128i*)p, v); }
+// counts the lanes set in a mask
+static inline int vcount(float4 mask)
+{
+    int bits = _mm_movemask_ps(mask);
+    return (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+}
+
+#else // USE_NEON
+
+typedef float32x4_t float4;
+typedef int32x4_t int4;
+
+static inline float4 vload(const float* p) { return vld1q_f32(p); }
+static inline void vstore(float* p, float4 v) { vst1q_f32(p, v); }
+static inline float4 vset(float f) { return vdupq_n_f32(f); }
+static inline float4 vadd(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 vsub(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 vmul(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 vmax(float4 a, float4 b) { return vmaxq_f32(a, b); }
+static inline float4 vrsqrt(float4 a)
+{
+    // estimate refined by two Newton-Raphson steps
+    float4 e = vrsqrteq_f32(a);
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+    return vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+}
+static inline float4 vgreater(float4 a, float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+static inline float4 vlessequal(float4 a, float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+static inline float4 vand(float4 a, float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+static inline float4 vxor(float4 a, float4 b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+static inline float4 vselect(float4 mask, float4 a, float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+static inline float4 vabs(float4 a) { return vabsq_f32(a); }
+static inline float4 vsign(float4 a) { return vand(vset(-0.0f), a); }
+
+static inline int4 ivset(int i) { return vdupq_n_s32(i); }
+static inline int4 ivtrunc(float4 a) { return vcvtq_s32_f32(a); }
+static inline float4 ivtofloat(int4 a) { return vcvtq_f32_s32(a); }
+static inline float4 ivbits(int4 a) { return vreinterpretq_f32_s32(a); }
+static inline int4 ivadd(int4 a, int4 b) { return vaddq_s32(a, b); }
+static inline int4 ivsub(int4 a, int4 b) { return vsubq_s32(a, b); }
+static inline int4 ivand(int4 a, int4 b) { return vandq_s32(a, b); }
+static inline int4 ivandnot(int4 a, int4 b) { return vbicq_s32(b, a); }
+static inline int4 ivor(int4 a, int4 b) { return vorrq_s32(a, b); }
+static inline float4 ivequalzero(int4 a) { return vreinterpretq_f32_u32(vceqq_s32(a, vdupq_n_s32(0))); }
+template <int N> static inline int4 ivshl(int4 a) { return vshlq_n_s32(a, N); }
+static inline void ivstore(uint32_t* p, int4 v) { vst1q_u32(p, vreinterpretq_u32_s32(v)); }
+// counts the lanes set in a mask
+static inline int vcount(float4 mask)
+{
+    uint32x4_t ones = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+    uint32x2_t sum = vadd_u32(vget_low_u32(ones), vget_high_u32(ones));
+    return (int)(vget_lane_u32(sum, 0) + vget_lane_u32(sum, 1));
+}
+
+#endif
+
+// sine and cosine with the Cephes polynomials, accurate for |x| < 8192
+static inline void vsincos(float4 x, float4* s, float4* c)
+{
+    float4 signSin = vsign(x);
+    x = vabs(x);
+
+    // octant of x, rounded up to an even one
+    int4 j = ivtrunc(vmul(x, vset(FOUR_OVER_PI)));
+    j = ivand(ivadd(j, ivset(1)), ivset(~1));
+    float4 y = ivtofloat(j);
+
+    float4 swapSignSin = ivbits(ivshl<29>(ivand(j, ivset(4))));
+    float4 signCos = ivbits(ivshl<29>(ivandnot(ivsub(j, ivset(2)), ivset(4))));
+    float4 polyMask = ivequalzero(ivand(j, ivset(2)));
+    signSin = vxor(signSin, swapSignSin);
+
+    // extended precision modular arithmetic
+    x = vadd(x, vmul(y, vset(-0.78515625f)));
+    x = vadd(x, vmul(y, vset(-2.4187564849853515625e-4f)));
+    x = vadd(x, vmul(y, vset(-3.77489497744594108e-8f)));
+    float4 z = vmul(x, x);
+
+    float4 cosPoly = vset(2.443315711809948e-5f);
+    cosPoly = vadd(vmul(cosPoly, z), vset(-1.388731625493765e-3f));
+    cosPoly = vadd(vmul(cosPoly, z), vset(4.166664568298827e-2f));
+    cosPoly = vmul(vmul(cosPoly, z), z);
+    cosPoly = vadd(vsub(cosPoly, vmul(z, vset(0.5f))), vset(1.0f));
+
+    float4 sinPoly = vset(-1.9515295891e-4f);
+    sinPoly = vadd(vmul(sinPoly, z), vset(8.3321608736e-3f));
+    sinPoly = vadd(vmul(sinPoly, z), vset(-1.6666654611e-1f));
+    sinPoly = vadd(vmul(vmul(sinPoly, z), x), x);
+
+    *s = vxor(vselect(polyMask, sinPoly, cosPoly), signSin);
+    *c = vxor(vselect(polyMask, cosPoly, sinPoly), signCos);
+}
+
+//
+// SIMD kernels, they process the first (count & ~3) particles.
+//
+
+static int updateTimeToLiveSimd(float* timeToLive, int count, float dt)
+{
+    float4 vdt = vset(dt);
+    float4 zero = vset(0.0f);
+    int dead = 0;
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        float4 ttl = vsub(vload(timeToLive + i), vdt);
+        vstore(timeToLive + i, ttl);
+        dead += vcount(vlessequal(ttl, zero));
+    }
+    return dead;
+}
+
+static void updateGravityModeSimd(ParticleData& data, int count, const Vec2& gravity, float yCoordFlipped, float dt)
+{
+    float4 vdt = vset(dt);
+    float4 gravityX = vset(gravity.x);
+    float4 gravityY = vset(gravity.y);
+    float4 posScale = vset(dt * yCoordFlipped);
+    float4 minLength = vset(FLT_MIN);
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        float4 x = vload(data.posx + i);
+        float4 y = vload(data.posy + i);
+
+        // radial acceleration, zero at the origin
+        float4 n = vadd(vmul(x, x), vmul(y, y));
+        float4 invLength = vand(vgreater(n, minLength), vrsqrt(n));
+        float4 radialX = vmul(x, invLength);
+        float4 radialY = vmul(y, invLength);
+
+        float4 radialAccel = vload(data.modeA.radialAccel + i);
+        float4 tangentialAccel = vload(data.modeA.tangentialAccel + i);
+        float4 accelX = vadd(vsub(vmul(radialX, radialAccel), vmul(radialY, tangentialAccel)), gravityX);
+        float4 accelY = vadd(vadd(vmul(radialY, radialAccel), vmul(radialX, tangentialAccel)), gravityY);
+
+        float4 dirX = vadd(vload(data.modeA.dirX + i), vmul(accelX, vdt));
+        float4 dirY = vadd(vload(data.modeA.dirY + i), vmul(accelY, vdt));
+        vstore(data.modeA.dirX + i, dirX);
+        vstore(data.modeA.dirY + i, dirY);
+
+        vstore(data.posx + i, vadd(x, vmul(dirX, posScale)));
+        vstore(data.posy + i, vadd(y, vmul(dirY, posScale)));
+    }
+}
+
+static void updateRadiusModeSimd(ParticleData& data, int count, float yCoordFlipped, float dt)
+{
+    float4 vdt = vset(dt);
+    float4 minusOne = vset(-1.0f);
+    float4 minusFlipped = vset(-yCoordFlipped);
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        float4 angle = vadd(vload(data.modeB.angle + i), vmul(vload(data.modeB.degreesPerSecond + i), vdt));
+        float4 radius = vadd(vload(data.modeB.radius + i), vmul(vload(data.modeB.deltaRadius + i), vdt));
+        vstore(data.modeB.angle + i, angle);
+        vstore(data.modeB.radius + i, radius);
+
+        float4 s, c;
+        vsincos(angle, &s, &c);
+        vstore(data.posx + i, vmul(vmul(c, radius), minusOne));
+        vstore(data.posy + i, vmul(vmul(s, radius), minusFlipped));
+    }
+}
+
+static void addScaledSimd(float* values, const float* deltas, int count, float dt)
+{
+    float4 vdt = vset(dt);
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        vstore(values + i, vadd(vload(values + i), vmul(vload(deltas + i), vdt)));
+    }
+}
+
+static void addScaledClampedSimd(float* values, const float* deltas, int count, float dt)
+{
+    float4 vdt = vset(dt);
+    float4 zero = vset(0.0f);
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        vstore(values + i, vmax(zero, vadd(vload(values + i), vmul(vload(deltas + i), vdt))));
+    }
+}
+
+static void updateQuadVerticesSimd(const ParticleData& data, int count, const float transform[6], V3F_C4B_T2F_Quad* quads)
+{
+    float4 a = vset(transform[0]);
+    float4 b = vset(transform[1]);
+    float4 c = vset(transform[2]);
+    float4 d = vset(transform[3]);
+    float4 tx = vset(transform[4]);
+    float4 ty = vset(transform[5]);
+    float4 half = vset(0.5f);
+    float4 toRadians = vset(-DEGREES_TO_RADIANS);
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        float4 startX = vload(data.startPosX + i);
+        float4 startY = vload(data.startPosY + i);
+        float4 x = vadd(vadd(vload(data.posx + i), vmul(a, startX)), vadd(vmul(c, startY), tx));
+        float4 y = vadd(vadd(vload(data.posy + i), vmul(b, startX)), vadd(vmul(d, startY), ty));
+
+        float4 halfSize = vmul(vload(data.size + i), half);
+        float4 s, co;
+        vsincos(vmul(vload(data.rotation + i), toRadians), &s, &co);
+
+        float values[4][4];
+        vstore(values[0], x);
+        vstore(values[1], y);
+        vstore(values[2], vmul(halfSize, co));
+        vstore(values[3], vmul(halfSize, s));
+        for (int k = 0; k < 4; ++k)
+        {
+            setQuadVertices(&quads[i + k], values[0][k], values[1][k], values[2][k], values[3][k]);
+        }
+    }
+}
+
+static void updateQuadColorsSimd(const ParticleData& data, int count, bool premultiplyAlpha, V3F_C4B_T2F_Quad* quads)
+{
+    float4 scale255 = vset(255.0f);
+    int4 byteMask = ivset(0xff);
+    for (int i = 0; i + 4 <= count; i += 4)
+    {
+        float4 alpha = vmul(vload(data.colorA + i), scale255);
+        float4 scale = premultiplyAlpha ? alpha : scale255;
+
+        // truncated to int and wrapped to a byte like the scalar conversion, then packed as r, g, b, a bytes
+        int4 r = ivand(ivtrunc(vmul(vload(data.colorR + i), scale)), byteMask);
+        int4 g = ivand(ivtrunc(vmul(vload(data.colorG + i), scale)), byteMask);
+        int4 b = ivand(ivtrunc(vmul(vload(data.colorB + i), scale)), byteMask);
+        int4 a = ivand(ivtrunc(alpha), byteMask);
+        int4 packed = ivor(ivor(r, ivshl<8>(g)), ivor(ivshl<16>(b), ivshl<24>(a)));
+
+        uint32_t colors[4];
+        ivstore(colors, packed);
+        for (int k = 0; k < 4; ++k)
+        {
+            setQuadColor(&quads[i + k], colors[k]);
+        }
+    }
+}
+
+#define SIMD_COUNT(count) (s_simdEnabled.load(std::memory_order_relaxed) ? ((count) & ~3) : 0)
+
+#else
+
+#define SIMD_COUNT(count) 0
+
+static int updateTimeToLiveSimd(float*, int, float) { return 0; }
+static void updateGravityModeSimd(ParticleData&, int, const Vec2&, float, float) {}
+static void updateRadiusModeSimd(ParticleData&, int, float, float) {}
+static void addScaledSimd(float*, const float*, int, float) {}
+static void addScaledClampedSimd(float*, const float*, int, float) {}
+static void updateQuadVerticesSimd(const ParticleData&, int, const float[6], V3F_C4B_T2F_Quad*) {}
+static void updateQuadColorsSimd(const ParticleData&, int, bool, V3F_C4B_T2F_Quad*) {}
+
+#endif
+
+int ParticleKernels::updateTimeToLive(ParticleData& data, int count, float dt)
+{
+    int simdCount = SIMD_COUNT(count);
+    int dead = updateTimeToLiveSimd(data.timeToLive, simdCount, dt);
+    return dead + updateTimeToLiveScalar(data.timeToLive, simdCount, count, dt);
+}
+
+template <typename T>
+static void applyMoves(T* values, const int* moves, int moveCount)
+{
+    for (int m = 0; m < moveCount; ++m)
+    {
+        values[moves[2 * m]] = values[moves[2 * m + 1]];
+    }
+}
+
+int ParticleKernels::compactDeadParticles(ParticleData& data, int count)
+{
+    // find the moves first so each array is then compacted in a single pass.
+    // A move consumes a dead and an alive particle, so there are at most count / 2 of them.
+    int* moves = data.compactionMoves;
+    int moveCount = 0;
+    int last = count;
+    for (int i = 0; i < last; ++i)
+    {
+        if (data.timeToLive[i] > 0.0f)
+            continue;
+
+        do {
+            --last;
+        } while (last > i && data.timeToLive[last] <= 0.0f);
+
+        if (last > i)
+        {
+            moves[2 * moveCount] = i;
+            moves[2 * moveCount + 1] = last;
+            ++moveCount;
+        }
+    }
+
+    if (moveCount == 0)
+        return last;
+
+    float* arrays[] = {
+        data.posx, data.posy, data.startPosX, data.startPosY,
+        data.colorR, data.colorG, data.colorB, data.colorA,
+        data.deltaColorR, data.deltaColorG, data.deltaColorB, data.deltaColorA,
+        data.size, data.deltaSize, data.rotation, data.deltaRotation, data.timeToLive,
+        data.modeA.dirX, data.modeA.dirY, data.modeA.radialAccel, data.modeA.tangentialAccel,
+        data.modeB.angle, data.modeB.degreesPerSecond, data.modeB.radius, data.modeB.deltaRadius
+    };
+    for (auto values : arrays)
+    {
+        applyMoves(values, moves, moveCount);
+    }
+
+    for (int m = 0; m < moveCount; ++m)
+    {
+        std::swap(data.atlasIndex[moves[2 * m]], data.atlasIndex[moves[2 * m + 1]]);
+    }
+    return last;
+}
+
+void ParticleKernels::updateGravityMode(ParticleData& data, int count, const Vec2& gravity, float yCoordFlipped, float dt)
+{
+    int simdCount = SIMD_COUNT(count);
+    updateGravityModeSimd(data, simdCount, gravity, yCoordFlipped, dt);
+    updateGravityModeScalar(data, simdCount, count, gravity, yCoordFlipped, dt);
+}
+
+void ParticleKernels::updateRadiusMode(ParticleData& data, int count, float yCoordFlipped, float dt)
+{
+    int simdCount = SIMD_COUNT(count);
+    updateRadiusModeSimd(data, simdCount, yCoordFlipped, dt);
+    updateRadiusModeScalar(data, simdCount, count, yCoordFlipped, dt);
+}
+
+void ParticleKernels::updateDeltas(ParticleData& data, int count, float dt)
+{
+    int simdCount = SIMD_COUNT(count);
+
+    float* values[] = { data.colorR, data.colorG, data.colorB, data.colorA, data.rotation };
+    const float* deltas[] = { data.deltaColorR, data.deltaColorG, data.deltaColorB, data.deltaColorA, data.deltaRotation };
+    for (int k = 0; k < 5; ++k)
+    {
+        addScaledSimd(values[k], deltas[k], simdCount, dt);
+        addScaledScalar(values[k], deltas[k], simdCount, count, dt);
+    }
+
+    addScaledClampedSimd(data.size, data.deltaSize, simdCount, dt);
+    addScaledClampedScalar(data.size, data.deltaSize, simdCount, count, dt);
+}
+
+void ParticleKernels::updateQuadVertices(const ParticleData& data, int count, const float transform[6], V3F_C4B_T2F_Quad* quads)
+{
+    int simdCount = SIMD_COUNT(count);
+    updateQuadVerticesSimd(data, simdCount, transform, quads);
+    updateQuadVerticesScalar(data, simdCount, count, transform, quads);
+}
+
+void ParticleKernels::updateQuadColors(const ParticleData& data, int count, bool premultiplyAlpha, V3F_C4B_T2F_Quad* quads)
+{
+    int simdCount = SIMD_COUNT(count);
+    updateQuadColorsSimd(data, simdCount, premultiplyAlpha, quads);
+    updateQuadColorsScalar(data, simdCount, count, premultiplyAlpha, quads);
+}
+
+bool ParticleKernels::isSimdSupported()
+{
+#if defined(USE_SSE2) || defined(USE_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ParticleKernels::setSimdEnabled(bool enabled)
+{
+    s_simdEnabled = enabled;
+}
+
+bool ParticleKernels::isSimdEnabled()
+{
+    return isSimdSupported() && s_simdEnabled;
+}
+
+NS_CC_END
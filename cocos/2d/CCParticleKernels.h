@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_PARTICLE_KERNELS_H__
+#define __CC_PARTICLE_KERNELS_H__
+
+#include "2d/CCParticleSystem.h"
+#include "base/ccTypes.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * Kernels that update the particles of a ParticleData in bulk.
+ *
+ * Each kernel walks the structure-of-arrays of ParticleData four particles at a time with SSE2 or NEON,
+ * and falls back to a scalar loop for the remaining particles or when no SIMD instruction set is available.
+ * ParticleSystem and ParticleSystemQuad use them in update() and updateParticleQuads().
+ */
+class CC_DLL ParticleKernels
+{
+public:
+    /**
+     * Decreases the time to live of the particles.
+     *
+     * @return The number of particles whose time to live is over.
+     */
+    static int updateTimeToLive(ParticleData& data, int count, float dt);
+
+    /**
+     * Removes the dead particles, moving the last alive particles into their slots.
+     * The atlas indices of the moved particles are swapped with the ones of the dead particles
+     * so they stay a permutation.
+     *
+     * @return The number of alive particles.
+     */
+    static int compactDeadParticles(ParticleData& data, int count);
+
+    /** Moves the particles of a gravity mode emitter. */
+    static void updateGravityMode(ParticleData& data, int count, const Vec2& gravity, float yCoordFlipped, float dt);
+
+    /** Moves the particles of a radius mode emitter. */
+    static void updateRadiusMode(ParticleData& data, int count, float yCoordFlipped, float dt);
+
+    /** Applies the color, size and rotation deltas of the particles. */
+    static void updateDeltas(ParticleData& data, int count, float dt);
+
+    /**
+     * Writes the vertex positions of the particle quads.
+     *
+     * The position of a quad is (posx + a * startPosX + c * startPosY + tx, posy + b * startPosX + d * startPosY + ty),
+     * which covers the free, relative and grouped position types.
+     *
+     * @param transform The affine transform {a, b, c, d, tx, ty} applied to the start position.
+     */
+    static void updateQuadVertices(const ParticleData& data, int count, const float transform[6], V3F_C4B_T2F_Quad* quads);
+
+    /** Writes the vertex colors of the particle quads, premultiplying them by alpha if needed. */
+    static void updateQuadColors(const ParticleData& data, int count, bool premultiplyAlpha, V3F_C4B_T2F_Quad* quads);
+
+    /** Whether the kernels use SIMD instructions on this platform. */
+    static bool isSimdSupported();
+
+    /**
+     * Enables or disables the SIMD kernels, they are enabled by default.
+     * The scalar kernels are the reference implementation, this is mainly useful for testing and benchmarking.
+     */
+    static void setSimdEnabled(bool enabled);
+
+    /** Whether the SIMD kernels are used. */
+    static bool isSimdEnabled();
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_PARTICLE_KERNELS_H__
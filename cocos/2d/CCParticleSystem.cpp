@@ -47,11 +47,13 @@ THE SOFTWARE.
 #include <string>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
 #include "base/CCDirector.h"
 #include "base/CCProfiling.h"
+#include "base/CCWorkerPool.h"
 #include "base/ccUTF8.h"
 #include "renderer/CCTextureCache.h"
 #include "platform/CCFileUtils.h"
@@ -78,22 +80,9 @@ NS_CC_BEGIN
 //
 
 
-inline void normalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-    
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-    
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
+static bool s_parallelUpdateEnabled = false;
+// the systems queued by update() for runParallelUpdates()
+static std::vector<ParticleSystem*> s_pendingSystems;
 
 /**
  A more effect random number getter function, get from ejoy2d.
@@ -135,6 +124,7 @@ bool ParticleData::init(int count)
     deltaRotation= (float*)malloc(count * sizeof(float));
     timeToLive= (float*)malloc(count * sizeof(float));
     atlasIndex= (unsigned int*)malloc(count * sizeof(unsigned int));
+    compactionMoves= (int*)malloc(count * sizeof(int));
     
     modeA.dirX= (float*)malloc(count * sizeof(float));
     modeA.dirY= (float*)malloc(count * sizeof(float));
@@ -148,7 +138,7 @@ bool ParticleData::init(int count)
     
     return posx && posy && startPosY && startPosX && colorR && colorG && colorB && colorA &&
     deltaColorR && deltaColorG && deltaColorB && deltaColorA && size && deltaSize &&
-    rotation && deltaRotation && timeToLive && atlasIndex && modeA.dirX && modeA.dirY &&
+    rotation && deltaRotation && timeToLive && atlasIndex && compactionMoves && modeA.dirX && modeA.dirY &&
     modeA.radialAccel && modeA.tangentialAccel && modeB.angle && modeB.degreesPerSecond &&
     modeB.deltaRadius && modeB.radius;
 }
@@ -173,6 +163,7 @@ void ParticleData::release()
     CC_SAFE_FREE(deltaRotation);
     CC_SAFE_FREE(timeToLive);
     CC_SAFE_FREE(atlasIndex);
+    CC_SAFE_FREE(compactionMoves);
     
     CC_SAFE_FREE(modeA.dirX);
     CC_SAFE_FREE(modeA.dirY);
@@ -220,6 +211,9 @@ ParticleSystem::ParticleSystem()
 , _yCoordFlipped(1)
 , _positionType(PositionType::FREE)
 , _paused(false)
+, _randomSeed(rand())
+, _isUpdatePending(false)
+, _pendingUpdateTime(0)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -591,7 +585,7 @@ void ParticleSystem::addParticles(int count)
 {
     if (_paused)
         return;
-    uint32_t RANDSEED = rand();
+    uint32_t RANDSEED = _randomSeed;
 
     int start = _particleCount;
     _particleCount += count;
@@ -777,6 +771,8 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
             }
         }
     }
+
+    _randomSeed = RANDSEED;
 }
 
 void ParticleSystem::onEnter()
@@ -834,8 +830,29 @@ bool ParticleSystem::isFull()
 // ParticleSystem - MainLoop
 void ParticleSystem::update(float dt)
 {
+    if (s_parallelUpdateEnabled && !_batchNode)
+    {
+        //simulated with the other systems by runParallelUpdates()
+        if (!_isUpdatePending)
+        {
+            _isUpdatePending = true;
+            _pendingUpdateTime = 0;
+            this->retain();
+            s_pendingSystems.push_back(this);
+        }
+        _pendingUpdateTime += dt;
+        return;
+    }
+
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    finishUpdate(updateParticles(dt));
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+bool ParticleSystem::updateParticles(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -861,150 +878,106 @@ void ParticleSystem::update(float dt)
     }
     
     {
-        for (int i = 0; i < _particleCount; ++i)
+        int deadCount = ParticleKernels::updateTimeToLive(_particleData, _particleCount, dt);
+        if (deadCount > 0)
         {
-            _particleData.timeToLive[i] -= dt;
-        }
-        
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            if (_particleData.timeToLive[i] <= 0.0f)
+            if (_batchNode)
             {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
+                //disable the dead particles, compacting swaps their atlas indexes with the moved ones
+                for (int i = 0; i < _particleCount; ++i)
                 {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
+                    if (_particleData.timeToLive[i] <= 0.0f)
+                        _batchNode->disableParticle(_atlasIndex + _particleData.atlasIndex[i]);
                 }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        }
-        
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
             }
-        }
-        else
-        {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
+
+            _particleCount = ParticleKernels::compactDeadParticles(_particleData, _particleCount);
+            if( _particleCount == 0 && _isAutoRemoveOnFinish )
             {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+                return true;
             }
         }
         
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+        //Each kernel processes one property in one loop as much as possible,
+        //every property's memory of the particle system is continuous so this improves the cache hit rate.
+        if (_emitterMode == Mode::GRAVITY)
         {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
+            ParticleKernels::updateGravityMode(_particleData, _particleCount, modeA.gravity, _yCoordFlipped, dt);
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+        else
         {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
+            ParticleKernels::updateRadiusMode(_particleData, _particleCount, _yCoordFlipped, dt);
         }
         
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
+        //color r,g,b,a, size and angle
+        ParticleKernels::updateDeltas(_particleData, _particleCount, dt);
         
         updateParticleQuads();
         _transformSystemDirty = false;
     }
+    return false;
+}
+
+void ParticleSystem::finishUpdate(bool finished)
+{
+    if (finished)
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        return;
+    }
 
     // only update gl buffer when visible
     if (_visible && ! _batchNode)
     {
         postStep();
     }
+}
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+void ParticleSystem::setParallelUpdateEnabled(bool enabled)
+{
+    s_parallelUpdateEnabled = enabled;
+}
+
+bool ParticleSystem::isParallelUpdateEnabled()
+{
+    return s_parallelUpdateEnabled;
+}
+
+void ParticleSystem::runParallelUpdates()
+{
+    if (s_pendingSystems.empty())
+        return;
+
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - parallel update");
+
+    std::vector<ParticleSystem*> systems;
+    systems.swap(s_pendingSystems);
+
+    // the systems read their world transform, computing it here leaves the cached transforms untouched by the workers
+    for (auto system : systems)
+    {
+        system->getNodeToWorldTransform();
+    }
+
+    std::vector<char> finished(systems.size(), false);
+    WorkerPool::getInstance()->parallelFor((int)systems.size(), [&systems, &finished](int index) {
+        auto system = systems[index];
+        // it may have been removed since it was queued
+        if (system->isRunning())
+            finished[index] = system->updateParticles(system->_pendingUpdateTime);
+    });
+
+    for (size_t i = 0; i < systems.size(); ++i)
+    {
+        auto system = systems[i];
+        system->_isUpdatePending = false;
+        if (system->isRunning())
+            system->finishUpdate(finished[i] != 0);
+        system->release();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - parallel update");
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -74,6 +74,8 @@ public:
     float* deltaRotation;
     float* timeToLive;
     unsigned int* atlasIndex;
+    //! scratch space of ParticleKernels::compactDeadParticles
+    int* compactionMoves;
     
     //! Mode A: gravity, direction, radial accel, tangential accel
     struct{
@@ -275,6 +277,42 @@ public:
      */
     virtual void updateWithNoTime();
 
+    /** Enables or disables the parallel update of the particle systems, it is disabled by default.
+     *
+     * When enabled, update() only queues the system. Once the Scheduler has updated everything, the Director
+     * calls runParallelUpdates() which simulates all the queued systems at the same time on the WorkerPool,
+     * before the scene is visited. The systems in a ParticleBatchNode are still updated serially.
+     *
+     * @note A subclass overriding update() sees the particles of the previous frame after calling ParticleSystem::update().
+     * @param enabled True to update the particle systems in parallel.
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+
+    /** Whether the particle systems are updated in parallel.
+     *
+     * @return True if the particle systems are updated in parallel.
+     */
+    static bool isParallelUpdateEnabled();
+
+    /** Simulates the particle systems queued by update() in parallel and waits for them.
+     * It is called by the Director after the Scheduler update.
+     */
+    static void runParallelUpdates();
+
+    /** Sets the seed of the random numbers used to emit the particles.
+     * Emission only depends on the seed and the properties of the system, so it is the same whether
+     * the systems are updated serially or in parallel. By default the seed is taken from rand().
+     *
+     * @param seed The seed of the random numbers.
+     */
+    void setRandomSeed(unsigned int seed) { _randomSeed = seed; }
+
+    /** Gets the current seed of the random numbers used to emit the particles.
+     *
+     * @return The seed of the random numbers.
+     */
+    unsigned int getRandomSeed() const { return _randomSeed; }
+
     /** Whether or not the particle system removed self on finish.
      *
      * @return True if the particle system removed self on finish.
@@ -816,6 +854,19 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    /** Emits, moves and kills the particles and updates the quads.
+     * It only touches this system, so different systems can be simulated at the same time.
+     *
+     * @return True if the last particles died and the system removes itself on finish.
+     */
+    bool updateParticles(float dt);
+
+    /** Does the part of update() that must run on the cocos thread once the particles are updated.
+     *
+     * @param finished The value returned by updateParticles().
+     */
+    void finishUpdate(bool finished);
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -971,6 +1022,14 @@ protected:
     /** is the emitter paused */
     bool _paused;
 
+    /** seed of the random numbers used to emit the particles */
+    unsigned int _randomSeed;
+
+    /** whether the system is queued for runParallelUpdates() */
+    bool _isUpdatePending;
+    /** the time the queued system is updated by */
+    float _pendingUpdateTime;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
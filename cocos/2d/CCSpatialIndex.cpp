@@ -0,0 +1,391 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCSpatialIndex.h"
+#include <algorithm>
+#include <cfloat>
+#include "2d/CCNode.h"
+#include "2d/CCScene.h"
+#include "2d/CCCamera.h"
+#include "base/CCDirector.h"
+
+NS_CC_BEGIN
+
+const float SpatialIndex::DEFAULT_CELL_SIZE = 256.0f;
+
+// nodes covering more cells than this are always visited: they are big enough to be seen most of the time
+static const int MAX_CELLS_PER_NODE = 64;
+// keeps the cell coordinates far from the limits of int
+static const float MAX_CELL_COORD = 1 << 30;
+
+SpatialIndex::SpatialIndex(float cellSize)
+: _cellSize(cellSize)
+, _margin(0)
+, _nodeCount(0)
+, _queryStamp(0)
+, _transformEpoch(0)
+, _visitedCount(0)
+, _culledCount(0)
+{
+    CCASSERT(cellSize > 0, "SpatialIndex: the cell size must be positive");
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    clear();
+}
+
+void SpatialIndex::insert(Node* node)
+{
+    CCASSERT(node->_spatialIndexSlot < 0, "SpatialIndex: the node is already indexed");
+
+    int slot;
+    if (_freeSlots.empty())
+    {
+        slot = (int)_entries.size();
+        _entries.emplace_back();
+    }
+    else
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+
+    auto& entry = _entries[slot];
+    entry.node = node;
+    entry.minX = entry.minY = entry.maxX = entry.maxY = 0;
+    entry.queryStamp = _queryStamp;
+    // the first visit gets a dirty transform
+    entry.transformEpoch = _transformEpoch - 1;
+    entry.unboundedIndex = -1;
+    entry.inGrid = false;
+    entry.dirty = true;
+    _dirtySlots.push_back(slot);
+
+    node->_spatialIndexSlot = slot;
+    ++_nodeCount;
+}
+
+void SpatialIndex::remove(Node* node)
+{
+    int slot = node->_spatialIndexSlot;
+    if (slot < 0)
+        return;
+
+    removeFromGrid(slot);
+    removeFromUnbounded(slot);
+
+    auto& entry = _entries[slot];
+    entry.node = nullptr;
+    entry.dirty = false;
+    _freeSlots.push_back(slot);
+
+    node->_spatialIndexSlot = -1;
+    --_nodeCount;
+}
+
+void SpatialIndex::clear()
+{
+    for (auto& entry : _entries)
+    {
+        if (entry.node)
+            entry.node->_spatialIndexSlot = -1;
+    }
+
+    _entries.clear();
+    _freeSlots.clear();
+    _dirtySlots.clear();
+    _unbounded.clear();
+    _cells.clear();
+    _visibleNodes.clear();
+    _nodeCount = 0;
+    _visitedCount = 0;
+    _culledCount = 0;
+}
+
+void SpatialIndex::markDirty(Node* node)
+{
+    auto& entry = _entries[node->_spatialIndexSlot];
+    if (!entry.dirty)
+    {
+        entry.dirty = true;
+        _dirtySlots.push_back(node->_spatialIndexSlot);
+    }
+}
+
+void SpatialIndex::setMargin(float margin)
+{
+    if (margin == _margin)
+        return;
+
+    _margin = margin;
+    for (int slot = 0, count = (int)_entries.size(); slot < count; ++slot)
+    {
+        if (_entries[slot].node && !_entries[slot].dirty)
+        {
+            _entries[slot].dirty = true;
+            _dirtySlots.push_back(slot);
+        }
+    }
+}
+
+int SpatialIndex::cellCoord(float value) const
+{
+    return (int)floorf(clampf(value / _cellSize, -MAX_CELL_COORD, MAX_CELL_COORD));
+}
+
+void SpatialIndex::update()
+{
+    // a slot can be listed twice when it was removed and reused before the update
+    for (int slot : _dirtySlots)
+    {
+        auto& entry = _entries[slot];
+        if (!entry.node || !entry.dirty)
+            continue;
+
+        entry.dirty = false;
+        removeFromGrid(slot);
+        removeFromUnbounded(slot);
+
+        Node* node = entry.node;
+        auto& size = node->getContentSize();
+        if (size.width <= 0 || size.height <= 0 || node->_usingNormalizedPosition)
+        {
+            // empty containers and particles draw outside of their content size,
+            // normalized positions depend on the content size of the parent
+            addToUnbounded(slot);
+        }
+        else
+        {
+            entry.bounds = node->getBoundingBox();
+            entry.bounds.origin.x -= _margin;
+            entry.bounds.origin.y -= _margin;
+            entry.bounds.size.width += _margin * 2;
+            entry.bounds.size.height += _margin * 2;
+            addToGrid(slot);
+        }
+    }
+    _dirtySlots.clear();
+}
+
+void SpatialIndex::addToGrid(int slot)
+{
+    auto& entry = _entries[slot];
+    entry.minX = cellCoord(entry.bounds.getMinX());
+    entry.minY = cellCoord(entry.bounds.getMinY());
+    entry.maxX = cellCoord(entry.bounds.getMaxX());
+    entry.maxY = cellCoord(entry.bounds.getMaxY());
+
+    if ((int64_t)(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) > MAX_CELLS_PER_NODE)
+    {
+        addToUnbounded(slot);
+        return;
+    }
+
+    for (int y = entry.minY; y <= entry.maxY; ++y)
+    {
+        for (int x = entry.minX; x <= entry.maxX; ++x)
+            _cells[cellKey(x, y)].push_back(slot);
+    }
+    entry.inGrid = true;
+}
+
+void SpatialIndex::removeFromGrid(int slot)
+{
+    auto& entry = _entries[slot];
+    if (!entry.inGrid)
+        return;
+
+    for (int y = entry.minY; y <= entry.maxY; ++y)
+    {
+        for (int x = entry.minX; x <= entry.maxX; ++x)
+        {
+            auto cell = _cells.find(cellKey(x, y));
+            CCASSERT(cell != _cells.end(), "SpatialIndex: missing cell");
+            auto& slots = cell->second;
+            auto it = std::find(slots.begin(), slots.end(), slot);
+            *it = slots.back();
+            slots.pop_back();
+            if (slots.empty())
+                _cells.erase(cell);
+        }
+    }
+    entry.inGrid = false;
+}
+
+void SpatialIndex::addToUnbounded(int slot)
+{
+    _entries[slot].unboundedIndex = (int)_unbounded.size();
+    _unbounded.push_back(slot);
+}
+
+void SpatialIndex::removeFromUnbounded(int slot)
+{
+    int index = _entries[slot].unboundedIndex;
+    if (index < 0)
+        return;
+
+    int last = _unbounded.back();
+    _unbounded[index] = last;
+    _entries[last].unboundedIndex = index;
+    _unbounded.pop_back();
+    _entries[slot].unboundedIndex = -1;
+}
+
+void SpatialIndex::query(const Rect& rect, std::vector<Node*>& result)
+{
+    ++_queryStamp;
+
+    auto test = [&](int slot) {
+        auto& entry = _entries[slot];
+        if (entry.queryStamp != _queryStamp)
+        {
+            entry.queryStamp = _queryStamp;
+            if (entry.bounds.intersectsRect(rect))
+                result.push_back(entry.node);
+        }
+    };
+
+    int minX = cellCoord(rect.getMinX());
+    int minY = cellCoord(rect.getMinY());
+    int maxX = cellCoord(rect.getMaxX());
+    int maxY = cellCoord(rect.getMaxY());
+
+    if ((int64_t)(maxX - minX + 1) * (maxY - minY + 1) > (int64_t)_cells.size())
+    {
+        // zoomed out: cheaper to go through the cells that exist
+        for (auto& cell : _cells)
+        {
+            for (int slot : cell.second)
+                test(slot);
+        }
+    }
+    else
+    {
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                auto cell = _cells.find(cellKey(x, y));
+                if (cell == _cells.end())
+                    continue;
+                for (int slot : cell->second)
+                    test(slot);
+            }
+        }
+    }
+
+    for (int slot : _unbounded)
+        result.push_back(_entries[slot].node);
+}
+
+bool SpatialIndex::getVisibleRect(const Mat4& modelViewTransform, Rect* rect)
+{
+    // only cull the default camera, like Renderer::checkVisibility
+    auto director = Director::getInstance();
+    auto scene = director->getRunningScene();
+    auto camera = Camera::getVisitingCamera();
+    if (!scene || !camera || scene->getDefaultCamera() != camera)
+        return false;
+
+    Mat4 clipToNode = camera->getViewProjectionMatrix() * modelViewTransform;
+    if (!clipToNode.inverse())
+        return false;
+
+    auto& winSize = director->getWinSize();
+    Rect visibleRect(director->getVisibleOrigin(), director->getVisibleSize());
+    const float screenX[4] = { visibleRect.getMinX(), visibleRect.getMaxX(), visibleRect.getMinX(), visibleRect.getMaxX() };
+    const float screenY[4] = { visibleRect.getMinY(), visibleRect.getMinY(), visibleRect.getMaxY(), visibleRect.getMaxY() };
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int i = 0; i < 4; ++i)
+    {
+        // intersect the ray of the corner, from the near plane to the far plane, with z = 0
+        float ndcX = screenX[i] / winSize.width * 2 - 1;
+        float ndcY = screenY[i] / winSize.height * 2 - 1;
+        Vec4 nearPoint, farPoint;
+        clipToNode.transformVector(Vec4(ndcX, ndcY, -1, 1), &nearPoint);
+        clipToNode.transformVector(Vec4(ndcX, ndcY, 1, 1), &farPoint);
+        if (nearPoint.w == 0 || farPoint.w == 0)
+            return false;
+
+        Vec3 from(nearPoint.x / nearPoint.w, nearPoint.y / nearPoint.w, nearPoint.z / nearPoint.w);
+        Vec3 to(farPoint.x / farPoint.w, farPoint.y / farPoint.w, farPoint.z / farPoint.w);
+        float dz = from.z - to.z;
+        if (fabsf(dz) < FLT_EPSILON)
+            return false;
+        float t = from.z / dz;
+        if (t < 0 || t > 1)
+            return false;
+
+        float x = from.x + (to.x - from.x) * t;
+        float y = from.y + (to.y - from.y) * t;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    rect->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
+void SpatialIndex::collectVisibleNodes(const Mat4& modelViewTransform, const Vector<Node*>& children)
+{
+    update();
+
+    _visibleNodes.clear();
+    Rect rect;
+    if (getVisibleRect(modelViewTransform, &rect))
+    {
+        query(rect, _visibleNodes);
+        std::sort(_visibleNodes.begin(), _visibleNodes.end(), [](Node* n1, Node* n2) {
+            return n1->_localZOrderAndArrival < n2->_localZOrderAndArrival;
+        });
+    }
+    else
+    {
+        _visibleNodes.assign(children.begin(), children.end());
+    }
+
+    _visitedCount = (int)_visibleNodes.size();
+    _culledCount = _nodeCount - _visitedCount;
+}
+
+bool SpatialIndex::isTransformStale(Node* node)
+{
+    // nodes which aren't indexed are never culled, so their transform is never stale
+    if (node->_spatialIndexSlot < 0)
+        return false;
+
+    auto& entry = _entries[node->_spatialIndexSlot];
+    if (entry.transformEpoch == _transformEpoch)
+        return false;
+
+    entry.transformEpoch = _transformEpoch;
+    return true;
+}
+
+NS_CC_END
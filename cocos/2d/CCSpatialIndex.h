@@ -0,0 +1,165 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_SPATIAL_INDEX_H__
+#define __CC_SPATIAL_INDEX_H__
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+#include "math/Mat4.h"
+#include "base/CCVector.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * @brief A uniform grid of the bounding boxes of the children of a node.
+ *
+ * A node with a spatial index (see Node::setSpatialIndexEnabled) only visits the children whose
+ * bounding box overlaps the area seen by the camera; the other subtrees aren't touched at all.
+ * Meant for big scrolling maps where most of the children are offscreen.
+ *
+ * The bounding boxes are in the coordinates of the indexing node, and are only recomputed for the
+ * children whose position, rotation, scale, skew, anchor point or content size changed since the
+ * last visit. The content of a child (its drawing and its own children) is expected to lie inside
+ * its bounding box enlarged by the margin. Children with an empty content size or a normalized
+ * position aren't put in the grid and are always visited.
+ *
+ * Culling is only done for the default camera of the running scene, like Renderer::checkVisibility.
+ * Other cameras and RenderTexture visit all the children.
+ */
+class CC_DLL SpatialIndex
+{
+public:
+    /** The default size of a cell, in points. */
+    static const float DEFAULT_CELL_SIZE;
+
+    /**
+     * @param cellSize The size of a cell, in points. Cells of about the size of the screen divided by 4
+     * are a good start.
+     */
+    explicit SpatialIndex(float cellSize = DEFAULT_CELL_SIZE);
+    ~SpatialIndex();
+
+    /** Adds a node. It is done by Node when a child is added to the indexing node. */
+    void insert(Node* node);
+    /** Removes a node. It is done by Node when a child is removed from the indexing node. */
+    void remove(Node* node);
+    /** Removes all the nodes. */
+    void clear();
+    /** Tells the index that the bounding box of a node changed. */
+    void markDirty(Node* node);
+
+    /** Recomputes the bounding boxes that changed. */
+    void update();
+
+    /**
+     * Appends to result the nodes whose bounding box intersects rect, plus the nodes which aren't in
+     * the grid. The order is undefined.
+     *
+     * @param rect A rectangle, in the coordinates of the indexing node.
+     * @param result The vector receiving the nodes.
+     */
+    void query(const Rect& rect, std::vector<Node*>& result);
+
+    /**
+     * Computes the area of the plane z = 0 of a node seen by the visiting camera.
+     *
+     * @param modelViewTransform The model view transform of the node.
+     * @param rect The area, in the coordinates of the node.
+     * @return False if the area can't be computed, which means nothing must be culled.
+     */
+    static bool getVisibleRect(const Mat4& modelViewTransform, Rect* rect);
+
+    /** Sets how much the bounding boxes are enlarged, in points. Defaults to 0. */
+    void setMargin(float margin);
+    /** Returns how much the bounding boxes are enlarged, in points. */
+    float getMargin() const { return _margin; }
+    /** Returns the size of a cell, in points. */
+    float getCellSize() const { return _cellSize; }
+    /** Returns the number of indexed nodes. */
+    int getNodeCount() const { return _nodeCount; }
+
+    /** Returns the number of children visited during the last visit. */
+    int getVisitedCount() const { return _visitedCount; }
+    /** Returns the number of children skipped during the last visit. Their own children aren't counted. */
+    int getCulledCount() const { return _culledCount; }
+
+protected:
+    friend class Node;
+
+    struct Entry
+    {
+        Node* node;
+        Rect bounds;
+        int minX, minY, maxX, maxY;
+        uint32_t queryStamp;
+        uint32_t transformEpoch;
+        int unboundedIndex;
+        bool inGrid;
+        bool dirty;
+    };
+
+    static uint64_t cellKey(int x, int y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+    int cellCoord(float value) const;
+    void addToGrid(int slot);
+    void removeFromGrid(int slot);
+    void addToUnbounded(int slot);
+    void removeFromUnbounded(int slot);
+
+    /** Fills _visibleNodes with the children to visit, sorted like the children of the indexing node. */
+    void collectVisibleNodes(const Mat4& modelViewTransform, const Vector<Node*>& children);
+    /** Returns true the first time a node is visited after the transform of the indexing node changed. */
+    bool isTransformStale(Node* node);
+
+    float _cellSize;
+    float _margin;
+    std::vector<Entry> _entries;
+    std::vector<int> _freeSlots;
+    std::vector<int> _dirtySlots;
+    std::vector<int> _unbounded;
+    std::unordered_map<uint64_t, std::vector<int>> _cells;
+    std::vector<Node*> _visibleNodes;
+    int _nodeCount;
+    uint32_t _queryStamp;
+    uint32_t _transformEpoch;
+    int _visitedCount;
+    int _culledCount;
+};
+
+NS_CC_END
+
+/** @} */
+
+#endif // __CC_SPATIAL_INDEX_H__
@@ -27,6 +27,20 @@ THE SOFTWARE.
 #define _USE_MATH_DEFINES // needed for M_PI and M_PI2
 #include <math.h> // M_PI
 #undef _USE_MATH_DEFINES
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__) || defined(__arm64__)
+#include <arm_neon.h>
+#define USE_NEON
+#endif
 
 NS_CC_BEGIN
 
@@ -173,6 +187,16 @@ float tweenTo(float time, TweenType type, float *easingParam)
             delta = bounceEaseInOut(time);
             break;
             
+        case Rate_EaseIn:
+            delta = easeIn(time, nullptr != easingParam ? easingParam[0] : 1.0f);
+            break;
+        case Rate_EaseOut:
+            delta = easeOut(time, nullptr != easingParam ? easingParam[0] : 1.0f);
+            break;
+        case Rate_EaseInOut:
+            delta = easeInOut(time, nullptr != easingParam ? easingParam[0] : 1.0f);
+            break;
+            
         default:
             delta = sineEaseInOut(time);
             break;
@@ -542,6 +566,514 @@ float bezieratFunction( float a, float b, float c, float d, float t )
 {
     return (powf(1-t,3) * a + 3*t*(powf(1-t,2))*b + 3*powf(t,2)*(1-t)*c + powf(t,3)*d );
 }
+
+
+// Bulk easing
+
+static EasingPrecision s_easingPrecision = EasingPrecision::EXACT;
+
+void setEasingPrecision(EasingPrecision precision)
+{
+    s_easingPrecision = precision;
+}
+
+EasingPrecision getEasingPrecision()
+{
+    return s_easingPrecision;
+}
+
+namespace {
+
+// 4 floats at once
+#if defined(USE_SSE2)
+
+typedef __m128 Lanes;
+typedef __m128 Mask;
+
+inline Lanes load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, Lanes v) { _mm_storeu_ps(p, v); }
+inline Lanes splat(float f) { return _mm_set1_ps(f); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes minimum(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+inline Lanes maximum(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+inline Mask less(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+inline Mask equal(Lanes a, Lanes b) { return _mm_cmpeq_ps(a, b); }
+inline Lanes select(Mask m, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+inline Lanes roundDown(Lanes v)
+{
+    Lanes t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.0f)));
+}
+
+// 2^n for the integers n in [-126, 127]
+inline Lanes exp2Integer(Lanes n)
+{
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+}
+
+// the exponent and the mantissa in [1, 2) of positive normal floats
+inline Lanes exponent(Lanes v)
+{
+    return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(v), 23), _mm_set1_epi32(127)));
+}
+
+inline Lanes mantissa(Lanes v)
+{
+    return _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(_mm_castps_si128(v), _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+}
+
+#elif defined(USE_NEON)
+
+typedef float32x4_t Lanes;
+typedef uint32x4_t Mask;
+
+inline Lanes load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, Lanes v) { vst1q_f32(p, v); }
+inline Lanes splat(float f) { return vdupq_n_f32(f); }
+inline Lanes add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return vsubq_f32(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+inline Lanes minimum(Lanes a, Lanes b) { return vminq_f32(a, b); }
+inline Lanes maximum(Lanes a, Lanes b) { return vmaxq_f32(a, b); }
+inline Mask less(Lanes a, Lanes b) { return vcltq_f32(a, b); }
+inline Mask equal(Lanes a, Lanes b) { return vceqq_f32(a, b); }
+inline Lanes select(Mask m, Lanes a, Lanes b) { return vbslq_f32(m, a, b); }
+
+inline Lanes roundDown(Lanes v)
+{
+    Lanes t = vcvtq_f32_s32(vcvtq_s32_f32(v));
+    return vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(t, v), vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+}
+
+// 2^n for the integers n in [-126, 127]
+inline Lanes exp2Integer(Lanes n)
+{
+    return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23));
+}
+
+// the exponent and the mantissa in [1, 2) of positive normal floats
+inline Lanes exponent(Lanes v)
+{
+    return vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(v), 23)), vdupq_n_s32(127)));
+}
+
+inline Lanes mantissa(Lanes v)
+{
+    return vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+}
+
+#else
+
+struct Lanes { float v[4]; };
+struct Mask { bool m[4]; };
+
+inline Lanes load(const float *p) { Lanes r; memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void store(float *p, Lanes v) { memcpy(p, v.v, sizeof(v.v)); }
+inline Lanes splat(float f) { Lanes r = {{f, f, f, f}}; return r; }
+
+#define LANES_OP(__name__, __type__, __expr__) \
+inline __type__ __name__(Lanes a, Lanes b) { __type__ r; for (int i = 0; i < 4; ++i) r.__expr__; return r; }
+LANES_OP(add, Lanes, v[i] = a.v[i] + b.v[i])
+LANES_OP(sub, Lanes, v[i] = a.v[i] - b.v[i])
+LANES_OP(mul, Lanes, v[i] = a.v[i] * b.v[i])
+LANES_OP(minimum, Lanes, v[i] = std::min(a.v[i], b.v[i]))
+LANES_OP(maximum, Lanes, v[i] = std::max(a.v[i], b.v[i]))
+LANES_OP(less, Mask, m[i] = a.v[i] < b.v[i])
+LANES_OP(equal, Mask, m[i] = a.v[i] == b.v[i])
+#undef LANES_OP
+
+inline Lanes select(Mask m, Lanes a, Lanes b) { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = m.m[i] ? a.v[i] : b.v[i]; return r; }
+inline Lanes roundDown(Lanes v) { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = floorf(v.v[i]); return r; }
+
+// 2^n for the integers n in [-126, 127]
+inline Lanes exp2Integer(Lanes n)
+{
+    Lanes r;
+    for (int i = 0; i < 4; ++i)
+    {
+        int bits = ((int)n.v[i] + 127) << 23;
+        memcpy(&r.v[i], &bits, sizeof(bits));
+    }
+    return r;
+}
+
+// the exponent and the mantissa in [1, 2) of positive normal floats
+inline Lanes exponent(Lanes v)
+{
+    Lanes r;
+    for (int i = 0; i < 4; ++i)
+    {
+        unsigned int bits;
+        memcpy(&bits, &v.v[i], sizeof(bits));
+        r.v[i] = (float)((int)(bits >> 23) - 127);
+    }
+    return r;
+}
+
+inline Lanes mantissa(Lanes v)
+{
+    Lanes r;
+    for (int i = 0; i < 4; ++i)
+    {
+        unsigned int bits;
+        memcpy(&bits, &v.v[i], sizeof(bits));
+        bits = (bits & 0x007fffff) | 0x3f800000;
+        memcpy(&r.v[i], &bits, sizeof(bits));
+    }
+    return r;
+}
+
+#endif
+
+inline Mask greater(Lanes a, Lanes b) { return less(b, a); }
+
+// sin(x * pi / 2) for x in [-1, 1], absolute error below 1e-8
+inline Lanes sinHalfPi(Lanes x)
+{
+    Lanes x2 = mul(x, x);
+    Lanes p = add(splat(-0.00467414384f), mul(x2, splat(0.000151671704f)));
+    p = add(splat(0.0796899183f), mul(x2, p));
+    p = add(splat(-0.64596376f), mul(x2, p));
+    p = add(splat(1.57079632f), mul(x2, p));
+    return mul(x, p);
+}
+
+// sin(x * 2 * pi)
+inline Lanes sinTurns(Lanes x)
+{
+    Lanes quarters = mul(sub(x, roundDown(add(x, splat(0.5f)))), splat(4.0f));
+    quarters = select(greater(quarters, splat(1.0f)), sub(splat(2.0f), quarters), quarters);
+    quarters = select(less(quarters, splat(-1.0f)), sub(splat(-2.0f), quarters), quarters);
+    return sinHalfPi(quarters);
+}
+
+// 2^x, relative error below 2e-7
+inline Lanes fastExp2(Lanes x)
+{
+    x = maximum(splat(-126.0f), minimum(splat(127.0f), x));
+    Lanes n = roundDown(x);
+    Lanes f = sub(x, n);
+    Lanes p = add(splat(0.00894959042f), mul(f, splat(0.00189375406f)));
+    p = add(splat(0.0558603371f), mul(f, p));
+    p = add(splat(0.240141818f), mul(f, p));
+    p = add(splat(0.69315449f), mul(f, p));
+    p = add(splat(0.999999898f), mul(f, p));
+    return mul(p, exp2Integer(n));
+}
+
+// fastLog2(x) for positive normal x, absolute error below 1e-7
+inline Lanes fastLog2(Lanes x)
+{
+    Lanes m = sub(mantissa(x), splat(1.0f));
+    Lanes p = add(splat(0.0494333684f), mul(m, splat(-0.00866569931f)));
+    p = add(splat(-0.133146927f), mul(m, p));
+    p = add(splat(0.238041984f), mul(m, p));
+    p = add(splat(-0.345429337f), mul(m, p));
+    p = add(splat(0.478176442f), mul(m, p));
+    p = add(splat(-0.721095768f), mul(m, p));
+    p = add(splat(1.44268585f), mul(m, p));
+    return add(exponent(x), mul(m, p));
+}
+
+// x^rate for x in [0, 1]
+inline Lanes fastPow(Lanes x, float rate)
+{
+    Lanes r = fastExp2(mul(splat(rate), fastLog2(maximum(x, splat(1e-30f)))));
+    return select(equal(x, splat(0.0f)), splat(0.0f), r);
+}
+
+// the elastic curve of elasticEaseOut(), 2^(-10 x) * sin((x - period / 4) * 2 * pi / period)
+inline Lanes elastic(Lanes x, float period)
+{
+    return mul(fastExp2(mul(x, splat(-10.0f))), sinTurns(mul(sub(x, splat(period / 4)), splat(1 / period))));
+}
+
+// evaluates the kernel on 4 times at once, the ends of the curve are the exact ones
+template <typename Kernel>
+void easeLanes(const float *times, float *results, size_t count, TweenType type, float *easingParam, Kernel kernel)
+{
+    Lanes first = splat(tweenTo(0.0f, type, easingParam));
+    Lanes last = splat(tweenTo(1.0f, type, easingParam));
+    Lanes zero = splat(0.0f);
+    Lanes one = splat(1.0f);
+
+    float in[4] = {0, 0, 0, 0};
+    float out[4];
+    for (size_t i = 0; i < count; i += 4)
+    {
+        const float *src = times + i;
+        float *dst = results + i;
+        size_t n = std::min(count - i, (size_t)4);
+        if (n < 4)
+        {
+            memcpy(in, src, n * sizeof(float));
+            src = in;
+            dst = out;
+        }
+
+        Lanes t = load(src);
+        Lanes r = kernel(t);
+        r = select(equal(t, zero), first, select(equal(t, one), last, r));
+        store(dst, r);
+
+        if (n < 4)
+        {
+            memcpy(results + i, out, n * sizeof(float));
+        }
+    }
+}
+
+bool easePolynomial(const float *times, float *results, size_t count, TweenType type, float *easingParam)
+{
+    float param = easingParam != nullptr ? easingParam[0] : (type == Rate_EaseIn || type == Rate_EaseOut || type == Rate_EaseInOut ? 1.0f : 0.3f);
+    Lanes half = splat(0.5f);
+    Lanes one = splat(1.0f);
+    Lanes two = splat(2.0f);
+    switch (type)
+    {
+        case Sine_EaseIn:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return sub(one, sinHalfPi(sub(one, t)));
+            });
+            return true;
+        case Sine_EaseOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return sinHalfPi(t);
+            });
+            return true;
+        case Sine_EaseInOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return sub(half, mul(half, sinHalfPi(sub(one, add(t, t)))));
+            });
+            return true;
+            
+        case Expo_EaseIn:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return sub(fastExp2(mul(splat(10.0f), sub(t, one))), splat(0.001f));
+            });
+            return true;
+        case Expo_EaseOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return sub(one, fastExp2(mul(splat(-10.0f), t)));
+            });
+            return true;
+        case Expo_EaseInOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                Lanes x = mul(splat(10.0f), sub(add(t, t), one));
+                Lanes in = mul(half, fastExp2(x));
+                Lanes out = mul(half, sub(two, fastExp2(sub(splat(0.0f), x))));
+                return select(less(t, half), in, out);
+            });
+            return true;
+            
+        case Elastic_EaseIn:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                // -2^(10 (t - 1)) * sin((t - 1 - s) * 2 * pi / period), the elastic curve at 1 - t mirrored
+                Lanes x = sub(one, t);
+                return mul(fastExp2(mul(x, splat(-10.0f))), sinTurns(mul(add(x, splat(param / 4)), splat(1 / param))));
+            });
+            return true;
+        case Elastic_EaseOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return add(elastic(t, param), one);
+            });
+            return true;
+        case Elastic_EaseInOut:
+        {
+            float period = param != 0 ? param : 0.3f * 1.5f;
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                Lanes x = sub(add(t, t), one);
+                Lanes in = mul(splat(0.5f), mul(fastExp2(mul(x, splat(10.0f))), sinTurns(mul(add(sub(splat(0.0f), x), splat(period / 4)), splat(1 / period)))));
+                Lanes out = add(mul(elastic(x, period), half), one);
+                return select(less(x, splat(0.0f)), in, out);
+            });
+            return true;
+        }
+            
+        case Rate_EaseIn:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return fastPow(t, param);
+            });
+            return true;
+        case Rate_EaseOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                return fastPow(t, 1 / param);
+            });
+            return true;
+        case Rate_EaseInOut:
+            easeLanes(times, results, count, type, easingParam, [&](Lanes t) {
+                Lanes x = add(t, t);
+                Lanes in = mul(half, fastPow(x, param));
+                Lanes out = sub(one, mul(half, fastPow(sub(two, x), param)));
+                return select(less(x, one), in, out);
+            });
+            return true;
+            
+        default:
+            return false;
+    }
+}
+
+// the tables of the expensive easings, by type and parameter. The Circ and Rate easings aren't interpolated,
+// their slopes are infinite at the ends. The tables are immutable and shared, so one evicted from the cache stays
+// valid while a thread still interpolates it
+typedef std::shared_ptr<const std::vector<float>> EasingTable;
+const int EASING_TABLE_INTERVALS = 512;
+const size_t MAX_EASING_TABLES = 64;
+std::unordered_map<unsigned long long, EasingTable> s_easingTables;
+std::mutex s_easingTablesMutex;
+
+EasingTable getEasingTable(unsigned long long key, TweenType type, float *easingParam)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_easingTablesMutex);
+        auto iter = s_easingTables.find(key);
+        if (iter != s_easingTables.end())
+        {
+            return iter->second;
+        }
+    }
+
+    auto table = std::make_shared<std::vector<float>>(EASING_TABLE_INTERVALS + 1);
+    for (int i = 0; i <= EASING_TABLE_INTERVALS; ++i)
+    {
+        (*table)[i] = tweenTo(i / (float)EASING_TABLE_INTERVALS, type, easingParam);
+    }
+
+    std::lock_guard<std::mutex> lock(s_easingTablesMutex);
+    if (s_easingTables.size() >= MAX_EASING_TABLES)
+    {
+        s_easingTables.clear();
+    }
+    // another thread may have built the same table meanwhile, keep the first one
+    return s_easingTables.emplace(key, std::move(table)).first->second;
+}
+
+bool easeTable(const float *times, float *results, size_t count, TweenType type, float *easingParam)
+{
+    float param = 0;
+    switch (type)
+    {
+        case Sine_EaseIn: case Sine_EaseOut: case Sine_EaseInOut:
+        case Expo_EaseIn: case Expo_EaseOut: case Expo_EaseInOut:
+            break;
+        case Elastic_EaseIn: case Elastic_EaseOut: case Elastic_EaseInOut:
+            param = easingParam != nullptr ? easingParam[0] : 0;
+            break;
+        default:
+            return false;
+    }
+
+    unsigned int paramBits;
+    memcpy(&paramBits, &param, sizeof(paramBits));
+    unsigned long long key = ((unsigned long long)type << 32) | paramBits;
+    auto easingTable = getEasingTable(key, type, easingParam);
+    const float *table = easingTable->data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        float x = std::max(0.0f, std::min(1.0f, times[i])) * EASING_TABLE_INTERVALS;
+        int index = std::min((int)x, EASING_TABLE_INTERVALS - 1);
+        float r = table[index] + (table[index + 1] - table[index]) * (x - index);
+        results[i] = x >= EASING_TABLE_INTERVALS ? table[EASING_TABLE_INTERVALS] : r;
+    }
+    return true;
+}
+
+template <typename Function>
+inline void ease(const float *times, float *results, size_t count, Function function)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        results[i] = function(times[i]);
+    }
+}
+
+} // namespace
+
+void tweenTo(const float *times, float *results, size_t count, TweenType type, float *easingParam)
+{
+    if (s_easingPrecision == EasingPrecision::POLYNOMIAL && easePolynomial(times, results, count, type, easingParam))
+    {
+        return;
+    }
+    if (s_easingPrecision == EasingPrecision::TABLE && easeTable(times, results, count, type, easingParam))
+    {
+        return;
+    }
+
+    // the type is only switched on once, the loops of the polynomial easings can be vectorized
+    switch (type)
+    {
+        case Linear:
+            if (results != times)
+            {
+                memmove(results, times, count * sizeof(float));
+            }
+            break;
+        case Quad_EaseIn:
+            ease(times, results, count, quadEaseIn);
+            break;
+        case Quad_EaseOut:
+            ease(times, results, count, quadEaseOut);
+            break;
+        case Quad_EaseInOut:
+            ease(times, results, count, quadEaseInOut);
+            break;
+        case Cubic_EaseIn:
+            ease(times, results, count, cubicEaseIn);
+            break;
+        case Cubic_EaseOut:
+            ease(times, results, count, cubicEaseOut);
+            break;
+        case Cubic_EaseInOut:
+            ease(times, results, count, cubicEaseInOut);
+            break;
+        case Quart_EaseIn:
+            ease(times, results, count, quartEaseIn);
+            break;
+        case Quart_EaseOut:
+            ease(times, results, count, quartEaseOut);
+            break;
+        case Quart_EaseInOut:
+            ease(times, results, count, quartEaseInOut);
+            break;
+        case Quint_EaseIn:
+            ease(times, results, count, quintEaseIn);
+            break;
+        case Quint_EaseOut:
+            ease(times, results, count, quintEaseOut);
+            break;
+        case Quint_EaseInOut:
+            ease(times, results, count, quintEaseInOut);
+            break;
+        case Back_EaseIn:
+            ease(times, results, count, backEaseIn);
+            break;
+        case Back_EaseOut:
+            ease(times, results, count, backEaseOut);
+            break;
+        case Back_EaseInOut:
+            ease(times, results, count, backEaseInOut);
+            break;
+        case Bounce_EaseIn:
+            ease(times, results, count, bounceEaseIn);
+            break;
+        case Bounce_EaseOut:
+            ease(times, results, count, bounceEaseOut);
+            break;
+        case Bounce_EaseInOut:
+            ease(times, results, count, bounceEaseInOut);
+            break;
+        default:
+            ease(times, results, count, [=](float time) {
+                return tweenTo(time, type, easingParam);
+            });
+            break;
+    }
+}
     
 }
 
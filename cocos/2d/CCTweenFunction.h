@@ -79,6 +79,11 @@ namespace tweenfunc {
         Bounce_EaseOut,
         Bounce_EaseInOut,
         
+        // easeIn(), easeOut() and easeInOut(), with the rate in easingParam[0]
+        Rate_EaseIn,
+        Rate_EaseOut,
+        Rate_EaseInOut,
+        
         TWEEN_EASING_MAX = 10000
     };
     
@@ -129,6 +134,35 @@ namespace tweenfunc {
      */
     float CC_DLL tweenTo(float time, TweenType type, float *easingParam);
     
+    /** How the bulk tweenTo() evaluates the easings that call sinf(), powf() or sqrt(). */
+    enum class EasingPrecision
+    {
+        /** The easing functions, as tweenTo() for a single time. */
+        EXACT,
+        /** Polynomials evaluated 4 times at once with SSE2 or NEON for the Sine, Expo, Elastic and Rate easings.
+         The absolute error is below 1e-6 for times in [0, 1] and the ends of the curves are exact. */
+        POLYNOMIAL,
+        /** Linear interpolation in tables of 513 samples for the Sine, Expo and Elastic easings, built on first use
+         for each type and parameter. The absolute error is below 1e-3 for elastic periods from 0.2, mostly next to
+         the ends where the Expo and Elastic curves jump, and the ends of the curves are exact. */
+        TABLE
+    };
+    
+    /** Sets how the bulk tweenTo() evaluates the expensive easings, EasingPrecision::EXACT by default. */
+    void CC_DLL setEasingPrecision(EasingPrecision precision);
+    
+    /** How the bulk tweenTo() evaluates the expensive easings. */
+    EasingPrecision CC_DLL getEasingPrecision();
+    
+    /**
+     * Eases many times with the same easing, as tweenTo() does for each of them.
+     * @param times The normalized times, in [0, 1].
+     * @param results The eased times, can be times.
+     * @param count The number of times.
+     * @param easingParam The parameters of the easing, shared by all the times.
+     */
+    void CC_DLL tweenTo(const float *times, float *results, size_t count, TweenType type, float *easingParam);
+    
     /**
      * @param time in seconds.
      */
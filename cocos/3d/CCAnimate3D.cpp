@@ -151,7 +151,10 @@ void Animate3D::startWithTarget(Node *target)
     
     if (needReMap)
     {
-        _boneCurves.clear();
+        _boneTracks.clear();
+        _translateChannel.clear();
+        _rotChannel.clear();
+        _scaleChannel.clear();
         _nodeCurves.clear();
         
         bool hasCurve = false;
@@ -172,7 +175,9 @@ void Animate3D::startWithTarget(Node *target)
                         if (bone)
                         {
                             auto curve = _animation->getBoneCurveByName(boneName);
-                            _boneCurves[bone] = curve;
+                            BoneTrack track = { bone, _translateChannel.add(curve->translateCurve),
+                                _rotChannel.add(curve->rotCurve), _scaleChannel.add(curve->scaleCurve) };
+                            _boneTracks.push_back(track);
                             hasCurve = true;
                         }
                         else
@@ -334,7 +339,6 @@ void Animate3D::update(float t)
             if (_weight > 0.0f)
             {
                 float transDst[3], rotDst[4], scaleDst[3];
-                float* trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse){
                     t = 1 - t;
                     lastTime = 1.0f - lastTime;
@@ -343,25 +347,19 @@ void Animate3D::update(float t)
                 t = _start + t * _last;
                 lastTime = _start + lastTime * _last;
                 
-                for (const auto& it : _boneCurves) {
-                    auto bone = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
-                    {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
-                        trans = &transDst[0];
-                    }
-                    if (curve->rotCurve)
-                    {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
-                        rot = &rotDst[0];
-                    }
-                    if (curve->scaleCurve)
-                    {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
-                        scale = &scaleDst[0];
-                    }
-                    bone->setAnimationValue(trans, rot, scale, this, _weight);
+                // all the curves of a kind are evaluated at once
+                _translateChannel.evaluate(t, _translateEvaluate);
+                _rotChannel.evaluate(t, _roteEvaluate);
+                _scaleChannel.evaluate(t, _scaleEvaluate);
+                for (const auto& track : _boneTracks) {
+                    track.bone->setAnimationValue(_translateChannel.getValue(track.translateIndex),
+                        _rotChannel.getValue(track.rotIndex), _scaleChannel.getValue(track.scaleIndex), this, _weight);
+                }
+                if (!_boneTracks.empty())
+                {
+                    // the bone curves are only mapped for the skeleton of a Sprite3D
+                    auto skeleton = static_cast<Sprite3D*>(_target)->getSkeleton();
+                    skeleton->addPoseSource(_animation, t, _weight, static_cast<int>(_quality));
                 }
                 
                 for (const auto& it : _nodeCurves)
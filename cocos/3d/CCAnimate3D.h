@@ -172,7 +172,48 @@ protected:
     EvaluateType _scaleEvaluate;
     Animate3DQuality _quality;
     
-    std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves; //weak ref
+    /**
+     * The curves of a kind (translation, rotation or scale) of all the animated bones, evaluated together.
+     */
+    template <int componentSize>
+    struct CurveChannel
+    {
+        std::vector<const AnimationCurve<componentSize>*> curves; //weak ref
+        std::vector<int> cursors; // the key used last time by each curve
+        std::vector<float> values; // the evaluated values, componentSize per curve
+        
+        /** adds a curve, returns its index or -1 if there is none */
+        int add(const AnimationCurve<componentSize>* curve)
+        {
+            if (curve == nullptr)
+                return -1;
+            curves.push_back(curve);
+            cursors.push_back(-1);
+            values.resize(values.size() + componentSize);
+            return static_cast<int>(curves.size()) - 1;
+        }
+        void evaluate(float time, EvaluateType type)
+        {
+            if (!curves.empty())
+                AnimationCurve<componentSize>::evaluate(curves.data(), static_cast<int>(curves.size()), time, values.data(), type, cursors.data());
+        }
+        float* getValue(int index) { return index < 0 ? nullptr : &values[index * componentSize]; }
+        void clear() { curves.clear(); cursors.clear(); values.clear(); }
+    };
+    
+    /** a bone and the indices of its curves in the channels */
+    struct BoneTrack
+    {
+        Bone3D* bone; //weak ref
+        int translateIndex;
+        int rotIndex;
+        int scaleIndex;
+    };
+    
+    std::vector<BoneTrack> _boneTracks;
+    CurveChannel<3> _translateChannel;
+    CurveChannel<4> _rotChannel;
+    CurveChannel<3> _scaleChannel;
     std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
     
     std::unordered_map<int, ValueMap> _keyFrameUserInfos;
@@ -78,6 +78,25 @@ Animation3D::Curve* Animation3D::getBoneCurveByName(const std::string& name) con
     return nullptr;
 }
 
+void Animation3D::resample(float framesPerSecond)
+{
+    for (const auto& it : _boneCurves) {
+        auto curve = it.second;
+        for (auto animationCurve : { curve->translateCurve, curve->scaleCurve }) {
+            if (animationCurve)
+            {
+                float duration = (animationCurve->getEndTime() - animationCurve->getStartTime()) * _duration;
+                animationCurve->resample(static_cast<int>(std::ceil(duration * framesPerSecond)) + 1);
+            }
+        }
+        if (curve->rotCurve)
+        {
+            float duration = (curve->rotCurve->getEndTime() - curve->rotCurve->getStartTime()) * _duration;
+            curve->rotCurve->resample(static_cast<int>(std::ceil(duration * framesPerSecond)) + 1);
+        }
+    }
+}
+
 Animation3D::Animation3D()
 : _duration(0)
 {
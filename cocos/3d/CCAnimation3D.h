@@ -86,6 +86,15 @@ public:
     /**get the bone Curves set*/
     const std::unordered_map<std::string, Curve*>& getBoneCurves() const {return _boneCurves;}
     
+    /**
+     * Pre-samples the curves at a fixed rate: the keys of a time are then found by their index instead of a
+     * search. The curves use more memory and only approximate the original keys. The animation is shared by
+     * all its Animate3D, they all use the sampled curves.
+     *
+     * @param framesPerSecond The number of keys per second of animation.
+     */
+    void resample(float framesPerSecond);
+    
 CC_CONSTRUCTOR_ACCESS:
     Animation3D();
     virtual ~Animation3D();  
@@ -26,6 +26,7 @@
 
 #include <cmath>
 #include <functional>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
@@ -74,6 +75,35 @@ public:
      */
     void evaluate(float time, float* dst, EvaluateType type) const;
     
+    /**
+     * evaluate value of time, starting the search of the keys from the keys used last time
+     * @param time Time to be estimated
+     * @param dst Estimated value of that time
+     * @param type EvaluateType
+     * @param cursor The index of the key used last time, updated. -1 if there is no such key.
+     */
+    void evaluate(float time, float* dst, EvaluateType type, int* cursor) const;
+    
+    /**
+     * evaluate several curves at the same time, e.g. the curves of all the bones of an animation.
+     * The interpolations are done in one pass over contiguous arrays, so that they are vectorized.
+     * @param curves The curves
+     * @param count The number of curves
+     * @param time Time to be estimated
+     * @param dst Estimated values of that time, componentSize values per curve
+     * @param type EvaluateType
+     * @param cursors The index of the key used last time by each curve, updated
+     */
+    static void evaluate(const AnimationCurve* const* curves, int count, float time, float* dst, EvaluateType type, int* cursors);
+    
+    /**
+     * Replaces the keys by keys sampled at a fixed interval between the start time and the end time.
+     * The keys of a time are then found by their index instead of a search, but the curve uses more memory
+     * and the original keys are only approximated.
+     * @param sampleCount The number of keys, at least 2
+     */
+    void resample(int sampleCount);
+    
     /**set evaluate function, allow the user use own function*/
     void setEvaluateFun(std::function<void(float time, float* dst)> fun);
     
@@ -93,12 +123,18 @@ CC_CONSTRUCTOR_ACCESS:
      */
     int determineIndex(float time) const;
     
+    /**
+     * Determine index by time, checking the key used last time and the next one before searching.
+     */
+    int determineIndex(float time, int cursor) const;
+    
 protected:
     
     float* _value;   //
     float* _keytime; //key time(0 - 1), start time _keytime[0], end time _keytime[_count - 1]
     int _count;
     int _componentSizeByte; //component size in byte, position and scale 3 * sizeof(float), rotation 4 * sizeof(float)
+    float _sampleRate; //inverse of the interval between the keys once resampled, 0 otherwise
     
     std::function<void(float time, float* dst)> _evaluateFun; //user defined function
 };
@@ -1,8 +1,15 @@
 #include "3d/CCAnimationCurve.h"
+#include <algorithm>
 NS_CC_BEGIN
 
 template <int componentSize>
 void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateType type) const
+{
+    evaluate(time, dst, type, nullptr);
+}
+
+template <int componentSize>
+void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateType type, int* cursor) const
 {
     if (_count == 1 || time <= _keytime[0])
     {
@@ -15,7 +22,9 @@ void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateTyp
         return;
     }
     
-    unsigned int index = determineIndex(time);
+    unsigned int index = determineIndex(time, cursor ? *cursor : -1);
+    if (cursor)
+        *cursor = index;
     
     float scale = (_keytime[index + 1] - _keytime[index]);
     float t = (time - _keytime[index]) / scale;
@@ -61,6 +70,100 @@ void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateTyp
     }
 }
 
+template <int componentSize>
+void AnimationCurve<componentSize>::evaluate(const AnimationCurve* const* curves, int count, float time, float* dst, EvaluateType type, int* cursors)
+{
+    if (type != EvaluateType::INT_LINEAR && type != EvaluateType::INT_NEAR)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            curves[i]->evaluate(time, dst + i * componentSize, type, &cursors[i]);
+        }
+        return;
+    }
+    
+    // the curves are done by blocks: the keys of each curve are gathered, then all the values are interpolated at once
+    static const int BLOCK_SIZE = 64;
+    float fromValues[BLOCK_SIZE * componentSize];
+    float toValues[BLOCK_SIZE * componentSize];
+    float ratios[BLOCK_SIZE * componentSize];
+    for (int start = 0; start < count; start += BLOCK_SIZE)
+    {
+        int blockCount = std::min(BLOCK_SIZE, count - start);
+        for (int i = 0; i < blockCount; ++i)
+        {
+            auto curve = curves[start + i];
+            const float* fromValue;
+            const float* toValue;
+            float t = 0.f;
+            if (curve->_count == 1 || time <= curve->_keytime[0])
+            {
+                fromValue = toValue = curve->_value;
+            }
+            else if (time >= curve->_keytime[curve->_count - 1])
+            {
+                fromValue = toValue = &curve->_value[(curve->_count - 1) * componentSize];
+            }
+            else
+            {
+                int index = curve->determineIndex(time, cursors[start + i]);
+                cursors[start + i] = index;
+                fromValue = &curve->_value[index * componentSize];
+                toValue = fromValue + componentSize;
+                t = (time - curve->_keytime[index]) / (curve->_keytime[index + 1] - curve->_keytime[index]);
+                if (type == EvaluateType::INT_NEAR)
+                {
+                    fromValue = std::abs(t) > 0.5f ? toValue : fromValue;
+                    t = 0.f;
+                }
+            }
+            
+            for (int j = 0; j < componentSize; ++j)
+            {
+                fromValues[i * componentSize + j] = fromValue[j];
+                toValues[i * componentSize + j] = toValue[j];
+                ratios[i * componentSize + j] = t;
+            }
+        }
+        
+        float* values = dst + start * componentSize;
+        for (int j = 0, size = blockCount * componentSize; j < size; ++j)
+        {
+            values[j] = fromValues[j] + (toValues[j] - fromValues[j]) * ratios[j];
+        }
+    }
+}
+
+template <int componentSize>
+void AnimationCurve<componentSize>::resample(int sampleCount)
+{
+    if (_count < 2 || sampleCount < 2)
+        return;
+    
+    float startTime = _keytime[0];
+    float interval = (_keytime[_count - 1] - startTime) / (sampleCount - 1);
+    if (interval <= 0.f)
+        return;
+    
+    // rotations are sampled like QUALITY_HIGH evaluates them
+    EvaluateType type = componentSize == 4 ? EvaluateType::INT_QUAT_SLERP : EvaluateType::INT_LINEAR;
+    float* keytime = new float[sampleCount];
+    float* value = new float[sampleCount * componentSize];
+    int cursor = -1;
+    for (int i = 0; i < sampleCount; ++i)
+    {
+        keytime[i] = i == sampleCount - 1 ? _keytime[_count - 1] : startTime + i * interval;
+        evaluate(keytime[i], &value[i * componentSize], type, &cursor);
+    }
+    
+    CC_SAFE_DELETE_ARRAY(_keytime);
+    CC_SAFE_DELETE_ARRAY(_value);
+    _keytime = keytime;
+    _value = value;
+    _count = sampleCount;
+    _sampleRate = 1.f / interval;
+}
+
 template <int componentSize>
 void AnimationCurve<componentSize>::setEvaluateFun(std::function<void(float time, float* dst)> fun)
 {
@@ -107,6 +210,7 @@ AnimationCurve<componentSize>::AnimationCurve()
 , _keytime(nullptr)
 , _count(0)
 , _componentSizeByte(0)
+, _sampleRate(0.f)
 , _evaluateFun(nullptr)
 {
     
@@ -141,4 +245,25 @@ int AnimationCurve<componentSize>::determineIndex(float time) const
     return -1;
 }
 
+template <int componentSize>
+int AnimationCurve<componentSize>::determineIndex(float time, int cursor) const
+{
+    if (_sampleRate > 0.f)
+    {
+        int index = static_cast<int>((time - _keytime[0]) * _sampleRate);
+        return std::max(0, std::min(index, _count - 2));
+    }
+    
+    // the time usually moves forward a little between two evaluations
+    if (cursor >= 0 && cursor < _count - 1 && time >= _keytime[cursor])
+    {
+        if (time <= _keytime[cursor + 1])
+            return cursor;
+        if (cursor + 2 < _count && time <= _keytime[cursor + 2])
+            return cursor + 1;
+    }
+    
+    return determineIndex(time);
+}
+
 NS_CC_END
\ No newline at end of file
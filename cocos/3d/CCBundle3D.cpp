@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "3d/CCBundleReader.h"
 #include "base/CCData.h"
+#include "base/CCMappedFile.h"
+
+#include <atomic>
 
 #define BUNDLE_TYPE_SCENE               1
 #define BUNDLE_TYPE_NODE                2
@@ -90,6 +93,13 @@ static const char* AABBS = "aabb";
 
 NS_CC_BEGIN
 
+unsigned int generateBundle3DDataId()
+{
+    // the data may be loaded on several threads
+    static std::atomic<unsigned int> s_nextDataId(1);
+    return s_nextDataId++;
+}
+
 void getChildMap(std::map<int, std::vector<int> >& map, SkinData* skinData, const rapidjson::Value& val)
 {
     if (!skinData)
@@ -161,7 +171,7 @@ void Bundle3D::clear()
 {
     if (_isBinary)
     {
-        _binaryBuffer.clear();
+        _binaryFile.reset();
         CC_SAFE_DELETE_ARRAY(_references);
     }
     else
@@ -433,11 +443,25 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             goto FAILED;
         }
 
-        meshData->vertex.resize(vertexSizeInFloat);
-        if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+        meshData->vertexSizeInFloat = vertexSizeInFloat;
+        if (_meshDataViewsEnabled)
         {
-            CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
-            goto FAILED;
+            meshData->mappedFile = _binaryFile;
+            meshData->vertexView = _binaryReader.readView(4, vertexSizeInFloat);
+            if (meshData->vertexView == nullptr)
+            {
+                CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
+        }
+        else
+        {
+            meshData->vertex.resize(vertexSizeInFloat);
+            if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+            {
+                CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
         }
 
         // Read index data
@@ -455,14 +479,28 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
                 CCLOG("warning: Failed to read meshdata: nIndexCount '%s'.", _path.c_str());
                 goto FAILED;
             }
-            indexArray.resize(nIndexCount);
-            if (_binaryReader.read(&indexArray[0], 2, nIndexCount) != nIndexCount)
+            if (_meshDataViewsEnabled)
             {
-                CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
-                goto FAILED;
+                const void* indexView = _binaryReader.readView(2, nIndexCount);
+                if (indexView == nullptr)
+                {
+                    CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->subMeshIndexViews.push_back(indexView);
+                meshData->subMeshIndexViewCounts.push_back(nIndexCount);
             }
-            meshData->subMeshIndices.push_back(indexArray);
-            meshData->numIndex = (int)meshData->subMeshIndices.size();
+            else
+            {
+                indexArray.resize(nIndexCount);
+                if (_binaryReader.read(&indexArray[0], 2, nIndexCount) != nIndexCount)
+                {
+                    CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->subMeshIndices.push_back(indexArray);
+            }
+            meshData->numIndex = (int)meshData->getSubMeshCount();
             //meshData->subMeshAABB.push_back(calculateAABB(meshData->vertex, meshData->getPerVertexSize(), indexArray));
             if (_version != "0.3" && _version != "0.4" && _version != "0.5")
             {
@@ -477,7 +515,8 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             }
             else
             {
-                meshData->subMeshAABB.push_back(calculateAABB(meshData->vertex, meshData->getPerVertexSize(), indexArray));
+                meshData->subMeshAABB.push_back(calculateAABB(meshData->getVertexData(), meshData->getPerVertexSize(),
+                    meshData->getSubMeshIndexData(k), meshData->getSubMeshIndexCount(k)));
             }
         }
         meshdatas.meshDatas.push_back(meshData);
@@ -1078,10 +1117,9 @@ bool Bundle3D::loadBinary(const std::string& path)
 {
     clear();
     
-    // get file data
-    _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
-    if (_binaryBuffer.isNull())
+    // map the file, the mesh data views may keep it mapped after the bundle is cleared
+    _binaryFile = std::make_shared<MappedFile>();
+    if (!_binaryFile->open(FileUtils::getInstance()->fullPathForFilename(path)))
     {
         clear();
         CCLOG("warning: Failed to read file: %s", path.c_str());
@@ -1089,7 +1127,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     }
     
     // Initialise bundle reader
-    _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
+    _binaryReader.init( (char*)_binaryFile->getBytes(),  _binaryFile->getSize() );
     
     // Read identifier info
     char identifier[] = { 'C', '3', 'B', '\0'};
@@ -1135,6 +1173,17 @@ bool Bundle3D::loadBinary(const std::string& path)
             return false;
         }
     }
+
+    // validate the offsets once, the reads after a seek are bounds checked by the reader
+    for (unsigned int i = 0; i < _referenceCount; ++i)
+    {
+        if (_references[i].offset >= _binaryFile->getSize())
+        {
+            CCLOG("warning: Invalid offset of ref '%s' for bundle '%s'.", _references[i].id.c_str(), path.c_str());
+            clear();
+            return false;
+        }
+    }
     
     return true;
 }
@@ -2202,16 +2251,23 @@ std::vector<Vec3> Bundle3D::getTrianglesList(const std::string& path)
             return trianglesList;
         }
         
+        bundle->setMeshDataViewsEnabled(true);
         bundle->loadMeshDatas(meshs);
         
     }
     
     Bundle3D::destroyBundle(bundle);
     for (auto iter : meshs.meshDatas){
-        int preVertexSize = iter->getPerVertexSize() / sizeof(float);
-        for (auto indexArray : iter->subMeshIndices){
-            for (auto i : indexArray){
-                trianglesList.push_back(Vec3(iter->vertex[i * preVertexSize], iter->vertex[i * preVertexSize + 1], iter->vertex[i * preVertexSize + 2]));
+        int preVertexSize = iter->getPerVertexSize();
+        const char* vertex = (const char*)iter->getVertexData();
+        for (ssize_t k = 0, count = iter->getSubMeshCount(); k < count; ++k){
+            const char* index = (const char*)iter->getSubMeshIndexData(k);
+            for (ssize_t j = 0, indexCount = iter->getSubMeshIndexCount(k); j < indexCount; ++j){
+                unsigned short i;
+                memcpy(&i, index + j * sizeof(i), sizeof(i));
+                Vec3 point;
+                memcpy(&point, vertex + i * preVertexSize, sizeof(point));
+                trianglesList.push_back(point);
             }
         }
     }
@@ -2225,7 +2281,8 @@ _path(""),
 _version(""),
 _referenceCount(0),
 _references(nullptr),
-_isBinary(false)
+_isBinary(false),
+_meshDataViewsEnabled(false)
 {
 
 }
@@ -2247,4 +2304,18 @@ cocos2d::AABB Bundle3D::calculateAABB( const std::vector<float>& vertex, int str
     return aabb;
 }
 
+cocos2d::AABB Bundle3D::calculateAABB(const void* vertex, int stride, const void* index, ssize_t indexCount)
+{
+    AABB aabb;
+    for (ssize_t i = 0; i < indexCount; ++i)
+    {
+        unsigned short it;
+        memcpy(&it, (const char*)index + i * sizeof(it), sizeof(it));
+        Vec3 point;
+        memcpy(&point, (const char*)vertex + it * stride, sizeof(point));
+        aabb.updateMinMax(&point, 1);
+    }
+    return aabb;
+}
+
 NS_CC_END
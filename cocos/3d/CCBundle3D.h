@@ -80,6 +80,14 @@ public:
     
     //since 3.3, to support reskin
     virtual bool loadMeshDatas(MeshDatas& meshdatas);
+
+    /**
+     * Whether the mesh datas loaded from a .c3b are views of the mapped file instead of copies, see MeshData::vertexView.
+     * The views skip a copy of the geometry, and keep the file mapped until the mesh datas are deleted.
+     * Disabled by default, the mesh datas then own their vertices and indices.
+     */
+    void setMeshDataViewsEnabled(bool enabled) { _meshDataViewsEnabled = enabled; }
+    bool isMeshDataViewsEnabled() const { return _meshDataViewsEnabled; }
     //since 3.3, to support reskin
     virtual bool loadNodes(NodeDatas& nodedatas);
     //since 3.3, to support reskin
@@ -96,6 +104,8 @@ public:
     
     //calculate aabb
     static AABB calculateAABB(const std::vector<float>& vertex, int stride, const std::vector<unsigned short>& index);
+    //calculate aabb of unaligned vertices and indices, e.g. views of a mapped .c3b
+    static AABB calculateAABB(const void* vertex, int stride, const void* index, ssize_t indexCount);
   
 protected:
 
@@ -181,11 +191,12 @@ protected:
     rapidjson::Document _jsonReader;
 
     // for binary reading
-    Data _binaryBuffer;
+    std::shared_ptr<MappedFile> _binaryFile;
     BundleReader _binaryReader;
     unsigned int _referenceCount;
     Reference* _references;
     bool  _isBinary;
+    bool  _meshDataViewsEnabled;
 };
 
 // end of 3d group
@@ -32,9 +32,12 @@
 
 #include <vector>
 #include <map>
+#include <memory>
  
 NS_CC_BEGIN
 
+class MappedFile;
+
 /**mesh vertex attribute
 * @js NA
 * @lua NA
@@ -52,6 +55,10 @@ struct MeshVertexAttrib
 };
 
 
+/** Returns a number identifying loaded data, never returned twice while the application runs.
+ * The skeletons and skins created from the same data share their matrices in the same pose. */
+unsigned int CC_DLL generateBundle3DDataId();
+
 /** model node data, since 3.3
 * @js NA
 * @lua NA
@@ -62,7 +69,12 @@ struct ModelData
     std::string materialId;
     std::vector<std::string> bones;
     std::vector<Mat4>        invBindPose;
+    unsigned int             sourceId; // see generateBundle3DDataId()
     
+    ModelData()
+    : sourceId(generateBundle3DDataId())
+    {
+    }
     virtual ~ModelData()
     {
         resetData();
@@ -84,7 +96,12 @@ struct NodeData
     Mat4        transform;
     std::vector<ModelData*> modelNodeDatas;
     std::vector<NodeData*>  children;
+    unsigned int            sourceId; // see generateBundle3DDataId()
 
+    NodeData()
+    : sourceId(generateBundle3DDataId())
+    {
+    }
     virtual ~NodeData()
     {
         resetData();
@@ -152,6 +169,15 @@ struct MeshData
     int numIndex;
     std::vector<MeshVertexAttrib> attribs;
     int attribCount;
+    /**
+     * Views of the vertices and the indices inside a mapped .c3b file, used instead of `vertex` and
+     * `subMeshIndices` when the data is loaded with Bundle3D::setMeshDataViewsEnabled(). They aren't
+     * aligned, read them with memcpy. `mappedFile` keeps them valid.
+     */
+    std::shared_ptr<MappedFile> mappedFile;
+    const void* vertexView;
+    std::vector<const void*> subMeshIndexViews;
+    std::vector<unsigned int> subMeshIndexViewCounts;
 
 public:
     /**
@@ -168,6 +194,40 @@ public:
         return vertexsize;
     }
 
+    /** Get the vertices, from `vertex` or from the view. */
+    const void* getVertexData() const
+    {
+        if (vertexView)
+            return vertexView;
+        return vertex.empty() ? nullptr : &vertex[0];
+    }
+
+    /** Get the number of floats of the vertices. */
+    ssize_t getVertexDataSize() const
+    {
+        return vertexView ? vertexSizeInFloat : (ssize_t)vertex.size();
+    }
+
+    /** Get the number of sub meshes. */
+    ssize_t getSubMeshCount() const
+    {
+        return vertexView ? (ssize_t)subMeshIndexViews.size() : (ssize_t)subMeshIndices.size();
+    }
+
+    /** Get the indices of a sub mesh, from `subMeshIndices` or from the view. */
+    const void* getSubMeshIndexData(ssize_t index) const
+    {
+        if (vertexView)
+            return subMeshIndexViews[index];
+        return subMeshIndices[index].empty() ? nullptr : &subMeshIndices[index][0];
+    }
+
+    /** Get the number of indices of a sub mesh. */
+    ssize_t getSubMeshIndexCount(ssize_t index) const
+    {
+        return vertexView ? (ssize_t)subMeshIndexViewCounts[index] : (ssize_t)subMeshIndices[index].size();
+    }
+
     /**
      * Reset the data
      */
@@ -175,6 +235,10 @@ public:
     {
         vertex.clear();
         subMeshIndices.clear();
+        vertexView = nullptr;
+        subMeshIndexViews.clear();
+        subMeshIndexViewCounts.clear();
+        mappedFile.reset();
         subMeshAABB.clear();
         attribs.clear();
         vertexSizeInFloat = 0;
@@ -185,6 +249,7 @@ public:
     : vertexSizeInFloat(0)
     , numIndex(0)
     , attribCount(0)
+    , vertexView(nullptr)
     {
     }
     ~MeshData()
@@ -84,6 +84,19 @@ ssize_t BundleReader::read(void* ptr, ssize_t size, ssize_t count)
     return validCount;
 }
 
+const void* BundleReader::readView(ssize_t size, ssize_t count)
+{
+    if (!_buffer || size <= 0 || count < 0 || count > (_length - _position) / size)
+    {
+        CCLOG("warning: bundle reader out of range");
+        return nullptr;
+    }
+
+    const char* view = _buffer + _position;
+    _position += size * count;
+    return view;
+}
+
 char* BundleReader::readLine(int num,char* line)
 {
     if (!_buffer)
@@ -76,6 +76,16 @@ public:
      */
     ssize_t read(void* ptr, ssize_t size, ssize_t count);
 
+    /**
+     * Skips an array of elements without copying it.
+     *
+     * @param size  The size of each element, in bytes.
+     * @param count The number of elements.
+     *
+     * @return The address of the array in the buffer, or nullptr if the buffer is too short.
+     */
+    const void* readView(ssize_t size, ssize_t count);
+
     /**
      * Reads a line from the buffer.
      */
@@ -32,6 +32,7 @@
 #include "base/CCDirector.h"
 #include "base/CCConfiguration.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCTechnique.h"
@@ -422,6 +423,47 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
     renderer->addCommand(&_meshCommand);
 }
 
+bool Mesh::drawInstanced(Renderer* renderer, float globalZOrder, const Mat4& transform, uint32_t flags, const Vec4& color)
+{
+    if (! isVisible())
+        return true;
+
+    if (_skin || _isTransparent || color.w < 1.f || _force2DQueue || !_material || !_meshIndexData
+        || !Configuration::getInstance()->supportsInstancedArrays())
+        return false;
+
+    // only the unlit built-in programs have an instanced version
+    const auto& passes = _material->_currentTechnique->_passes;
+    if (passes.size() != 1)
+        return false;
+    auto pass = passes.at(0);
+    auto glProgram = pass->getGLProgramState()->getGLProgram();
+    auto glProgramCache = GLProgramCache::getInstance();
+    GLProgram* instancedGLProgram = nullptr;
+    if (glProgram == glProgramCache->getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE))
+        instancedGLProgram = glProgramCache->getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    else if (glProgram == glProgramCache->getGLProgram(GLProgram::SHADER_3D_POSITION))
+        instancedGLProgram = glProgramCache->getGLProgram(GLProgram::SHADER_3D_POSITION_INSTANCED);
+    if (!instancedGLProgram)
+        return false;
+
+    auto texture = pass->getTexture();
+    InstanceBuffer::BatchKey key;
+    key.program = instancedGLProgram->getProgram();
+    key.textureID = texture ? texture->getName() : 0;
+    key.vertexBuffer = getVertexBuffer();
+    key.indexBuffer = getIndexBuffer();
+    key.primitive = getPrimitiveType();
+    key.indexFormat = getIndexFormat();
+    key.indexCount = getIndexCount();
+
+    _material->getStateBlock()->setDepthWrite(true);
+    _material->getStateBlock()->setBlend(false);
+
+    renderer->addMeshInstance(key, _meshIndexData, instancedGLProgram, _material->getStateBlock(), transform, color, globalZOrder, flags);
+    return true;
+}
+
 void Mesh::setSkin(MeshSkin* skin)
 {
     if (_skin != skin)
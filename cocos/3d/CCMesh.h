@@ -202,6 +202,14 @@ public:
 
     void draw(Renderer* renderer, float globalZ, const Mat4& transform, uint32_t flags, unsigned int lightMask, const Vec4& color, bool forceDepthWrite);
 
+    /**
+     * Draws the mesh as an instance of an instanced draw call (see Renderer::addMeshInstance), if it can: it must be
+     * opaque, not skinned, and use a single pass of GLProgram::SHADER_3D_POSITION or GLProgram::SHADER_3D_POSITION_TEXTURE.
+     * The uniforms set on its material are not used.
+     * @return Whether the mesh is drawn, if not it must be drawn with draw().
+     */
+    bool drawInstanced(Renderer* renderer, float globalZ, const Mat4& transform, uint32_t flags, const Vec4& color);
+
     /** 
      * Get the MeshCommand.
      */
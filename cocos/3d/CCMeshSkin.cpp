@@ -26,6 +26,8 @@
 #include "3d/CCBundle3D.h"
 #include "3d/CCSkeleton3D.h"
 
+#include <algorithm>
+
 NS_CC_BEGIN
 
 static int PALETTE_ROWS = 3;
@@ -34,6 +36,8 @@ MeshSkin::MeshSkin()
 : _rootBone(nullptr)
 , _skeleton(nullptr)
 , _matrixPalette(nullptr)
+, _paletteVersion(0)
+, _sourceId(0)
 {
     
 }
@@ -41,6 +45,8 @@ MeshSkin::MeshSkin()
 MeshSkin::~MeshSkin()
 {
     removeAllBones();
+    if (_skeleton)
+        _skeleton->removeSkin(this);
     CC_SAFE_RELEASE(_skeleton);
 }
 
@@ -49,6 +55,7 @@ MeshSkin* MeshSkin::create(Skeleton3D* skeleton, const std::vector<std::string>&
     auto skin = new (std::nothrow) MeshSkin();
     skin->_skeleton = skeleton;
     skeleton->retain();
+    skeleton->addSkin(skin);
     
     CCASSERT(boneNames.size() == invBindPose.size(), "bone names' num should equals to invBindPose's num");
     for (const auto& it : boneNames) {
@@ -64,6 +71,13 @@ MeshSkin* MeshSkin::create(Skeleton3D* skeleton, const std::vector<std::string>&
     return skin;
 }
 
+MeshSkin* MeshSkin::create(Skeleton3D* skeleton, const ModelData& modelData)
+{
+    auto skin = create(skeleton, modelData.bones, modelData.invBindPose);
+    skin->_sourceId = modelData.sourceId;
+    return skin;
+}
+
 ssize_t MeshSkin::getBoneCount() const
 {
     return _skinBones.size();
@@ -99,13 +113,23 @@ int MeshSkin::getBoneIndex(Bone3D* bone) const
 
 //compute matrix palette used by gpu skin
 Vec4* MeshSkin::getMatrixPalette()
+{
+    if (_matrixPalette == nullptr || _paletteVersion != _skeleton->getPoseVersion())
+    {
+        updateMatrixPalette();
+    }
+    
+    return _matrixPalette;
+}
+
+void MeshSkin::updateMatrixPalette()
 {
     if (_matrixPalette == nullptr)
     {
         _matrixPalette = new (std::nothrow) Vec4[_skinBones.size() * PALETTE_ROWS];
     }
     int i = 0, paletteIndex = 0;
-    static Mat4 t;
+    Mat4 t;
     for (auto it : _skinBones )
     {
         Mat4::multiply(it->getWorldMat(), _invBindPoses[i++], &t);
@@ -113,8 +137,23 @@ Vec4* MeshSkin::getMatrixPalette()
         _matrixPalette[paletteIndex++].set(t.m[1], t.m[5], t.m[9], t.m[13]);
         _matrixPalette[paletteIndex++].set(t.m[2], t.m[6], t.m[10], t.m[14]);
     }
-    
-    return _matrixPalette;
+    _paletteVersion = _skeleton->getPoseVersion();
+}
+
+void MeshSkin::copyMatrixPalette(const MeshSkin* skin)
+{
+    if (_matrixPalette == nullptr)
+    {
+        _matrixPalette = new (std::nothrow) Vec4[_skinBones.size() * PALETTE_ROWS];
+    }
+    std::copy(skin->_matrixPalette, skin->_matrixPalette + _skinBones.size() * PALETTE_ROWS, _matrixPalette);
+    _paletteVersion = _skeleton->getPoseVersion();
+}
+
+bool MeshSkin::isSameSkin(const MeshSkin* skin) const
+{
+    return _sourceId && _sourceId == skin->_sourceId && _skinBones.size() == skin->_skinBones.size()
+        && skin->_matrixPalette != nullptr;
 }
 
 ssize_t MeshSkin::getMatrixPaletteSize() const
@@ -132,6 +171,8 @@ void MeshSkin::removeAllBones()
 void MeshSkin::addSkinBone(Bone3D* bone)
 {
     _skinBones.pushBack(bone);
+    // the palette is reallocated with the new size
+    CC_SAFE_DELETE_ARRAY(_matrixPalette);
 }
 
 Bone3D* MeshSkin::getRootBone() const
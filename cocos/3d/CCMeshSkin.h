@@ -50,6 +50,7 @@ class Skeleton3D;
 class CC_DLL MeshSkin: public Ref
 {
     friend class Mesh;
+    friend class Skeleton3D;
 public:
     
     /**create a new meshskin if do not want to share meshskin*/
@@ -57,6 +58,9 @@ public:
     
     static MeshSkin* create(Skeleton3D* skeleton, const std::vector<std::string>& boneNames, const std::vector<Mat4>& invBindPose);
     
+    /**create a skin from loaded model data, it shares its palette with the skins created from the same data*/
+    static MeshSkin* create(Skeleton3D* skeleton, const ModelData& modelData);
+    
     /**get total bone count, skin bone + node bone*/
     ssize_t getBoneCount() const;
     
@@ -67,7 +71,7 @@ public:
     /**get bone index*/
     int getBoneIndex(Bone3D* bone) const;
     
-    /**compute matrix palette used by gpu skin*/
+    /**compute matrix palette used by gpu skin, it is only computed again once the skeleton was updated*/
     Vec4* getMatrixPalette();
     
     /**getSkinBoneCount() * 3*/
@@ -93,6 +97,15 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
+    /** computes the matrix palette from the world matrices of the bones */
+    void updateMatrixPalette();
+    
+    /** copies the matrix palette of a skin created from the same data */
+    void copyMatrixPalette(const MeshSkin* skin);
+    
+    /** whether a skin was created from the same data, so that it has the same palette in the same pose */
+    bool isSameSkin(const MeshSkin* skin) const;
+    
     Vector<Bone3D*>    _skinBones; // bones with skin
     std::vector<Mat4>  _invBindPoses; //inverse bind pose of bone
 
@@ -104,6 +117,10 @@ protected:
     // Each 4x3 row-wise matrix is represented as 3 Vec4's.
     // The number of Vec4's is (_skinBones.size() * 3).
     Vec4* _matrixPalette;
+    // the pose version of the skeleton the palette was computed for
+    unsigned int _paletteVersion;
+    // the id of the model data the skin was created from, 0 if none
+    unsigned int _sourceId;
 };
 
 // end of 3d group
@@ -23,10 +23,24 @@
  ****************************************************************************/
 
 #include "3d/CCSkeleton3D.h"
+#include "3d/CCMeshSkin.h"
+#include "base/CCDirector.h"
+#include "base/CCWorkerPool.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 
 NS_CC_BEGIN
 
+unsigned int Bone3D::s_hierarchyVersion = 1;
+
+static bool s_parallelUpdateEnabled = false;
+static bool s_poseSharingEnabled = false;
+// the skeletons queued by addPoseSource() for runParallelUpdates()
+static std::vector<Skeleton3D*> s_pendingSkeletons;
+
 /**
  * Sets the inverse bind pose matrix.
  *
@@ -141,7 +155,7 @@ Bone3D* Bone3D::create(const std::string& id)
 void Bone3D::updateJointMatrix(Vec4* matrixPalette)
 {
     {
-        static Mat4 t;
+        Mat4 t;
         Mat4::multiply(_world, getInverseBindPose(), &t);
 
         matrixPalette[0].set(t.m[0], t.m[4], t.m[8], t.m[12]);
@@ -165,19 +179,25 @@ Bone3D* Bone3D::getChildBoneByIndex(int index) const
 void Bone3D::addChildBone(Bone3D* bone)
 {
     if (_children.find(bone) == _children.end())
+    {
        _children.pushBack(bone);
+       ++s_hierarchyVersion;
+    }
 }
 void Bone3D::removeChildBoneByIndex(int index)
 {
     _children.erase(index);
+    ++s_hierarchyVersion;
 }
 void Bone3D::removeChildBone(Bone3D* bone)
 {
     _children.eraseObject(bone);
+    ++s_hierarchyVersion;
 }
 void Bone3D::removeAllChildBone()
 {
     _children.clear();
+    ++s_hierarchyVersion;
 }
 
 Bone3D::Bone3D(const std::string& id)
@@ -235,9 +255,20 @@ void Bone3D::updateLocalMat()
             }
         }
         
-        Mat4::createTranslation(translate, &_local);
-        _local.rotate(quat);
-        _local.scale(scale);
+        // translate * rotate * scale, without the matrix multiplications
+        Mat4::createRotation(quat, &_local);
+        _local.m[0] *= scale.x;
+        _local.m[1] *= scale.x;
+        _local.m[2] *= scale.x;
+        _local.m[4] *= scale.y;
+        _local.m[5] *= scale.y;
+        _local.m[6] *= scale.y;
+        _local.m[8] *= scale.z;
+        _local.m[9] *= scale.z;
+        _local.m[10] *= scale.z;
+        _local.m[12] = translate.x;
+        _local.m[13] = translate.y;
+        _local.m[14] = translate.z;
         
         _blendStates.clear();
     }
@@ -246,6 +277,11 @@ void Bone3D::updateLocalMat()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Skeleton3D::Skeleton3D()
+: _sortedHierarchyVersion(0)
+, _sourceId(0)
+, _poseVersion(0)
+, _isUpdatePending(false)
+, _parallelUpdateFrame(static_cast<unsigned int>(-1))
 {
     
 }
@@ -258,6 +294,8 @@ Skeleton3D::~Skeleton3D()
 Skeleton3D* Skeleton3D::create(const std::vector<NodeData*>& skeletondata)
 {
     auto skeleton = new (std::nothrow) Skeleton3D();
+    // an id rather than the address of the data, which a later allocation may reuse
+    skeleton->_sourceId = !skeletondata.empty() && skeletondata[0] ? skeletondata[0]->sourceId : 0;
     for (const auto& it : skeletondata) {
         auto bone = skeleton->createBone3D(*it);
         bone->resetPose();
@@ -314,21 +352,211 @@ int Skeleton3D::getBoneIndex(Bone3D* bone) const
 //refresh bone world matrix
 void Skeleton3D::updateBoneMatrix()
 {
+    // already computed by runParallelUpdates() for this frame
+    if (_parallelUpdateFrame == Director::getInstance()->getTotalFrames())
+        return;
+
+    sortBones();
+    computeMatrices();
+}
+
+void Skeleton3D::addPoseSource(const void* animation, float time, float weight, int quality)
+{
+    if (!s_parallelUpdateEnabled)
+        return;
+
+    PoseSource source = { animation, time, weight, quality };
+    _poseSources.push_back(source);
+
+    if (!_isUpdatePending)
+    {
+        _isUpdatePending = true;
+        this->retain();
+        s_pendingSkeletons.push_back(this);
+    }
+}
+
+void Skeleton3D::setParallelUpdateEnabled(bool enabled)
+{
+    s_parallelUpdateEnabled = enabled;
+}
+
+bool Skeleton3D::isParallelUpdateEnabled()
+{
+    return s_parallelUpdateEnabled;
+}
+
+void Skeleton3D::setPoseSharingEnabled(bool enabled)
+{
+    s_poseSharingEnabled = enabled;
+}
+
+bool Skeleton3D::isPoseSharingEnabled()
+{
+    return s_poseSharingEnabled;
+}
+
+void Skeleton3D::runParallelUpdates()
+{
+    if (s_pendingSkeletons.empty())
+        return;
+
+    std::vector<Skeleton3D*> skeletons;
+    skeletons.swap(s_pendingSkeletons);
+
+    // the first skeleton of each pose computes its matrices, the others copy them
+    std::vector<Skeleton3D*> computed;
+    std::vector<std::pair<Skeleton3D*, const Skeleton3D*>> copied;
+    std::unordered_multimap<size_t, Skeleton3D*> poses;
+    for (auto skeleton : skeletons)
+    {
+        skeleton->sortBones();
+
+        const Skeleton3D* samePose = nullptr;
+        size_t poseHash = 0;
+        if (s_poseSharingEnabled && skeleton->_sourceId && !skeleton->_poseSources.empty())
+        {
+            poseHash = std::hash<unsigned int>()(skeleton->_sourceId);
+            for (const auto& source : skeleton->_poseSources)
+            {
+                poseHash = poseHash * 31 + std::hash<const void*>()(source.animation);
+                poseHash = poseHash * 31 + std::hash<float>()(source.time);
+            }
+
+            auto range = poses.equal_range(poseHash);
+            for (auto it = range.first; it != range.second && samePose == nullptr; ++it)
+            {
+                if (skeleton->isSamePose(it->second))
+                    samePose = it->second;
+            }
+            if (samePose == nullptr)
+                poses.insert(std::make_pair(poseHash, skeleton));
+        }
+
+        if (samePose)
+            copied.push_back(std::make_pair(skeleton, samePose));
+        else
+            computed.push_back(skeleton);
+    }
+
+    auto workerPool = WorkerPool::getInstance();
+    workerPool->parallelFor((int)computed.size(), [&computed](int index) {
+        computed[index]->computeMatrices();
+    });
+    workerPool->parallelFor((int)copied.size(), [&copied](int index) {
+        auto& pair = copied[index];
+        if (!pair.first->copyMatrices(pair.second))
+            pair.first->computeMatrices();
+    });
+
+    auto frame = Director::getInstance()->getTotalFrames();
+    for (auto skeleton : skeletons)
+    {
+        skeleton->_isUpdatePending = false;
+        skeleton->_parallelUpdateFrame = frame;
+        skeleton->release();
+    }
+}
+
+void Skeleton3D::sortBones()
+{
+    if (_sortedHierarchyVersion == Bone3D::s_hierarchyVersion)
+        return;
+
+    _sortedBones.clear();
+    _parentIndices.clear();
     for (const auto& it : _rootBones) {
-        it->setWorldMatDirty(true);
-        it->updateWorldMat();
+        _sortedBones.push_back(it);
+        _parentIndices.push_back(-1);
+    }
+    // breadth first, so the parents come before their children
+    for (size_t i = 0; i < _sortedBones.size(); ++i) {
+        auto bone = _sortedBones[i];
+        for (const auto& child : bone->_children) {
+            _sortedBones.push_back(child);
+            _parentIndices.push_back(child->_parent == bone ? static_cast<int>(i) : -1);
+        }
+    }
+    _sortedHierarchyVersion = Bone3D::s_hierarchyVersion;
+}
+
+void Skeleton3D::computeMatrices()
+{
+    for (size_t i = 0, count = _sortedBones.size(); i < count; ++i) {
+        auto bone = _sortedBones[i];
+        bone->updateLocalMat();
+
+        int parentIndex = _parentIndices[i];
+        if (parentIndex >= 0)
+            Mat4::multiply(_sortedBones[parentIndex]->_world, bone->_local, &bone->_world);
+        else if (bone->_parent)
+            bone->_world = bone->_parent->getWorldMat() * bone->_local;
+        else
+            bone->_world = bone->_local;
+        bone->_worldDirty = false;
     }
+    ++_poseVersion;
+    _poseSources.clear();
+
+    for (auto skin : _skins) {
+        skin->updateMatrixPalette();
+    }
+}
+
+bool Skeleton3D::copyMatrices(const Skeleton3D* skeleton)
+{
+    if (_sortedBones.size() != skeleton->_sortedBones.size() || _skins.size() != skeleton->_skins.size())
+        return false;
+    for (size_t i = 0, count = _skins.size(); i < count; ++i) {
+        if (!_skins[i]->isSameSkin(skeleton->_skins[i]))
+            return false;
+    }
+
+    for (size_t i = 0, count = _sortedBones.size(); i < count; ++i) {
+        auto bone = _sortedBones[i];
+        auto source = skeleton->_sortedBones[i];
+        bone->_local = source->_local;
+        bone->_world = source->_world;
+        bone->_worldDirty = false;
+        bone->_blendStates.clear();
+    }
+    ++_poseVersion;
+    _poseSources.clear();
+
+    for (size_t i = 0, count = _skins.size(); i < count; ++i) {
+        _skins[i]->copyMatrixPalette(skeleton->_skins[i]);
+    }
+    return true;
+}
+
+bool Skeleton3D::isSamePose(const Skeleton3D* skeleton) const
+{
+    return _sourceId == skeleton->_sourceId && _poseSources == skeleton->_poseSources;
+}
+
+void Skeleton3D::addSkin(MeshSkin* skin)
+{
+    _skins.push_back(skin);
+}
+
+void Skeleton3D::removeSkin(MeshSkin* skin)
+{
+    auto it = std::find(_skins.begin(), _skins.end(), skin);
+    if (it != _skins.end())
+        _skins.erase(it);
 }
 
 void Skeleton3D::removeAllBones()
 {
     _bones.clear();
     _rootBones.clear();
+    ++Bone3D::s_hierarchyVersion;
 }
 
 void Skeleton3D::addBone(Bone3D* bone)
 {
     _bones.pushBack(bone);
+    ++Bone3D::s_hierarchyVersion;
 }
 
 Bone3D* Skeleton3D::createBone3D(const NodeData& nodedata)
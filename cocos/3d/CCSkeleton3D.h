@@ -180,14 +180,21 @@ protected:
     
     std::vector<BoneBlendState> _blendStates;
     
+    // increased when a bone hierarchy changes, so that the skeletons sort their bones again
+    static unsigned int s_hierarchyVersion;
 };
 
+class MeshSkin;
+
 /**
  * Skeleton
  *
+ * The bones are kept in a flat array sorted from the roots to the leaves, so the world matrices of all the bones
+ * are computed in one linear pass, a parent always being computed before its children.
  */
 class CC_DLL Skeleton3D: public Ref
 {
+    friend class MeshSkin;
 public:
     /**
      * @lua NA
@@ -211,6 +218,51 @@ public:
     /**refresh bone world matrix*/
     void updateBoneMatrix();
     
+    /**
+     * Records an animation which set the values of the bones for this frame. It is called by Animate3D.
+     * Skeletons created from the same data and animated by the same animations at the same times are in the same pose.
+     *
+     * @param animation The animation.
+     * @param time The time of the animation, in the range of the animation.
+     * @param weight The blend weight of the animation.
+     * @param quality The quality used to evaluate the curves of the animation.
+     */
+    void addPoseSource(const void* animation, float time, float weight, int quality);
+    
+    /**
+     * Enables or disables the parallel update of the animated skeletons, it is disabled by default.
+     *
+     * When enabled, the skeletons animated by Animate3D are queued. Once the Scheduler has updated everything, the
+     * Director calls runParallelUpdates() which computes their bone matrices and the matrix palettes of their skins
+     * on the WorkerPool, before the scene is visited.
+     *
+     * @note The bone values set after the Scheduler update are applied the next frame.
+     * @param enabled True to update the skeletons in parallel.
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    
+    /** Whether the animated skeletons are updated in parallel. */
+    static bool isParallelUpdateEnabled();
+    
+    /**
+     * Enables or disables the sharing of the bone matrices and the matrix palettes between the skeletons in the same
+     * pose, see addPoseSource(). Only the first skeleton of a pose is computed by runParallelUpdates(), the others copy
+     * its matrices. It is disabled by default, and requires the parallel update.
+     *
+     * @note The bones must only be moved by Animate3D, or the skeletons of a pose may differ.
+     * @param enabled True to share the matrices of the skeletons in the same pose.
+     */
+    static void setPoseSharingEnabled(bool enabled);
+    
+    /** Whether the skeletons in the same pose share their matrices. */
+    static bool isPoseSharingEnabled();
+    
+    /**
+     * Computes the matrices of the skeletons queued by addPoseSource() in parallel and waits for them.
+     * It is called by the Director after the Scheduler update.
+     */
+    static void runParallelUpdates();
+    
 CC_CONSTRUCTOR_ACCESS:
     
     Skeleton3D();
@@ -228,9 +280,54 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
+    struct PoseSource
+    {
+        const void* animation;
+        float time;
+        float weight;
+        int quality;
+        
+        bool operator==(const PoseSource& other) const
+        {
+            return animation == other.animation && time == other.time && weight == other.weight && quality == other.quality;
+        }
+    };
+    
+    /** sorts the bones from the roots to the leaves if the bone hierarchy changed */
+    void sortBones();
+    
+    /** computes the local and world matrices of the bones, and the matrix palettes of the skins */
+    void computeMatrices();
+    
+    /** copies the matrices of a skeleton in the same pose, returns false if the skeletons don't match */
+    bool copyMatrices(const Skeleton3D* skeleton);
+    
+    /** whether the skeleton is in the same pose as another one */
+    bool isSamePose(const Skeleton3D* skeleton) const;
+    
+    /** called by MeshSkin */
+    void addSkin(MeshSkin* skin);
+    void removeSkin(MeshSkin* skin);
+    
+    /** the version of the world matrices, increased each time they are computed */
+    unsigned int getPoseVersion() const { return _poseVersion; }
+    
     Vector<Bone3D*> _bones; // bones
 
     Vector<Bone3D*> _rootBones;
+    
+    // the bones sorted from the roots to the leaves, and the index of their parent in it
+    std::vector<Bone3D*> _sortedBones;
+    std::vector<int> _parentIndices;
+    unsigned int _sortedHierarchyVersion;
+    
+    std::vector<MeshSkin*> _skins; // skins referring to the skeleton, not retained
+    
+    unsigned int _sourceId; // the id of the first root the skeleton was created from, 0 if none
+    std::vector<PoseSource> _poseSources;
+    unsigned int _poseVersion;
+    bool _isUpdatePending; // queued for runParallelUpdates()
+    unsigned int _parallelUpdateFrame; // the last frame runParallelUpdates() computed the matrices in
 };
 
 // end of 3d group
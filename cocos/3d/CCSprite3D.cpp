@@ -46,10 +46,30 @@
 #include "renderer/CCTechnique.h"
 #include "renderer/CCPass.h"
 
+#include <algorithm>
+#include <deque>
+
 NS_CC_BEGIN
 
 static Sprite3DMaterial* getSprite3DMaterialForAttribs(MeshVertexData* meshVertexData, bool usesLight);
 
+static bool s_instancedRenderingEnabled = false;
+
+// the async loaded sprites waiting for their meshes to be uploaded, in the order they finished loading
+static std::deque<Sprite3D*> s_asyncUploads;
+static size_t s_asyncUploadBudget = 0;
+static const char* ASYNC_UPLOAD_KEY = "sprite3d_async_upload";
+
+// loads a part of a .c3b with its own bundle, each bundle maps the file so that the parts are loaded in parallel
+static bool loadBundlePart(const std::string& path, const std::function<bool(Bundle3D*)>& load)
+{
+    auto bundle = Bundle3D::createBundle();
+    bundle->setMeshDataViewsEnabled(true);
+    bool ret = bundle->load(FileUtils::getInstance()->fullPathForFilename(path)) && load(bundle);
+    Bundle3D::destroyBundle(bundle);
+    return ret;
+}
+
 Sprite3D* Sprite3D::create()
 {
     //
@@ -105,18 +125,166 @@ void Sprite3D::createAsync(const std::string& modelPath, const std::string& text
         return;
     }
     
-    sprite->_asyncLoadParam.afterLoadCallback = callback;
-    sprite->_asyncLoadParam.texPath = texturePath;
-    sprite->_asyncLoadParam.modelPath = modelPath;
-    sprite->_asyncLoadParam.callbackParam = callbackparam;
-    sprite->_asyncLoadParam.materialdatas = new (std::nothrow) MaterialDatas();
-    sprite->_asyncLoadParam.meshdatas = new (std::nothrow) MeshDatas();
-    sprite->_asyncLoadParam.nodeDatas = new (std::nothrow) NodeDatas();
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, CC_CALLBACK_1(Sprite3D::afterAsyncLoad, sprite), (void*)(&sprite->_asyncLoadParam), [sprite]()
+    auto taskPool = AsyncTaskPool::getInstance();
+    auto& param = sprite->_asyncLoadParam;
+    param.afterLoadCallback = callback;
+    param.texPath = texturePath;
+    param.modelPath = modelPath;
+    param.callbackParam = callbackparam;
+    param.materialdatas = new (std::nothrow) MaterialDatas();
+    param.meshdatas = new (std::nothrow) MeshDatas();
+    param.nodeDatas = new (std::nothrow) NodeDatas();
+    param.result = false;
+    param.meshResult = true;
+    param.stopCount = taskPool->getStopCount(AsyncTaskPool::TaskType::TASK_IO);
+    param.uploadedMeshCount = 0;
+    param.meshVertexDatas.clear();
+
+    // a stopped task skips its callback, so each stage finishes in a continuation which runs anyway and
+    // onAsyncLoadStageFinished() releases the sprite once the last stage finished
+    auto jobSystem = JobSystem::getInstance();
+    auto finishStage = [sprite]{ sprite->onAsyncLoadStageFinished(); };
+    auto finishParse = [sprite]
     {
-        sprite->_asyncLoadParam.result = sprite->loadFromFile(sprite->_asyncLoadParam.modelPath, sprite->_asyncLoadParam.nodeDatas, sprite->_asyncLoadParam.meshdatas, sprite->_asyncLoadParam.materialdatas);
-    });
-    
+        if (AsyncTaskPool::getInstance()->getStopCount(AsyncTaskPool::TaskType::TASK_IO) == sprite->_asyncLoadParam.stopCount)
+            sprite->loadAsyncTextures();
+        sprite->onAsyncLoadStageFinished();
+    };
+    if (FileUtils::getInstance()->getFileExtension(modelPath) == ".c3b")
+    {
+        param.pendingStages = 2;
+        auto meshJob = taskPool->enqueue(AsyncTaskPool::TaskType::TASK_IO, nullptr, nullptr, [sprite]()
+        {
+            auto meshdatas = sprite->_asyncLoadParam.meshdatas;
+            sprite->_asyncLoadParam.meshResult = loadBundlePart(sprite->_asyncLoadParam.modelPath, [meshdatas](Bundle3D* bundle) {
+                return bundle->loadMeshDatas(*meshdatas);
+            });
+        });
+        jobSystem->then(meshJob, []{}, JobSystem::Priority::NORMAL, finishStage);
+        auto parseJob = taskPool->enqueue(AsyncTaskPool::TaskType::TASK_IO, nullptr, nullptr, [sprite]()
+        {
+            auto materialdatas = sprite->_asyncLoadParam.materialdatas;
+            auto nodeDatas = sprite->_asyncLoadParam.nodeDatas;
+            sprite->_asyncLoadParam.result = loadBundlePart(sprite->_asyncLoadParam.modelPath, [materialdatas, nodeDatas](Bundle3D* bundle) {
+                return bundle->loadMaterials(*materialdatas) && bundle->loadNodes(*nodeDatas);
+            });
+        });
+        jobSystem->then(parseJob, []{}, JobSystem::Priority::NORMAL, finishParse);
+    }
+    else
+    {
+        param.pendingStages = 1;
+        auto parseJob = taskPool->enqueue(AsyncTaskPool::TaskType::TASK_IO, nullptr, nullptr, [sprite]()
+        {
+            sprite->_asyncLoadParam.result = sprite->loadFromFile(sprite->_asyncLoadParam.modelPath, sprite->_asyncLoadParam.nodeDatas, sprite->_asyncLoadParam.meshdatas, sprite->_asyncLoadParam.materialdatas);
+        });
+        jobSystem->then(parseJob, []{}, JobSystem::Priority::NORMAL, finishParse);
+    }
+}
+
+void Sprite3D::loadAsyncTextures()
+{
+    if (!_asyncLoadParam.result)
+        return;
+
+    std::vector<std::string> filenames;
+    for (const auto& material : _asyncLoadParam.materialdatas->materials)
+    {
+        for (const auto& texture : material.textures)
+        {
+            filenames.push_back(texture.filename);
+        }
+    }
+    filenames.push_back(_asyncLoadParam.texPath);
+    std::sort(filenames.begin(), filenames.end());
+    filenames.erase(std::unique(filenames.begin(), filenames.end()), filenames.end());
+
+    // the textures are decoded in parallel and uploaded within the budget of TextureCache, the sprite then finds them in the cache
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (const auto& filename : filenames)
+    {
+        if (filename.empty())
+            continue;
+
+        ++_asyncLoadParam.pendingStages;
+        textureCache->addImageAsync(filename, [this](Texture2D*) { onAsyncLoadStageFinished(); });
+    }
+}
+
+void Sprite3D::onAsyncLoadStageFinished()
+{
+    if (--_asyncLoadParam.pendingStages > 0)
+        return;
+
+    if (AsyncTaskPool::getInstance()->getStopCount(AsyncTaskPool::TaskType::TASK_IO) != _asyncLoadParam.stopCount)
+    {
+        // stopped while parsing or while the textures were loading
+        CC_SAFE_DELETE(_asyncLoadParam.meshdatas);
+        CC_SAFE_DELETE(_asyncLoadParam.materialdatas);
+        CC_SAFE_DELETE(_asyncLoadParam.nodeDatas);
+        release();
+        return;
+    }
+
+    if (!_asyncLoadParam.result || !_asyncLoadParam.meshResult)
+    {
+        _asyncLoadParam.result = false;
+        afterAsyncLoad(&_asyncLoadParam);
+        return;
+    }
+
+    s_asyncUploads.push_back(this);
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (!scheduler->isScheduled(ASYNC_UPLOAD_KEY, &s_asyncUploads))
+    {
+        scheduler->schedule(&Sprite3D::uploadAsyncMeshes, &s_asyncUploads, 0, false, ASYNC_UPLOAD_KEY);
+    }
+}
+
+void Sprite3D::uploadAsyncMeshes(float /*dt*/)
+{
+    auto stopCount = AsyncTaskPool::getInstance()->getStopCount(AsyncTaskPool::TaskType::TASK_IO);
+    size_t uploadedBytes = 0;
+    while (!s_asyncUploads.empty() && (s_asyncUploadBudget == 0 || uploadedBytes < s_asyncUploadBudget))
+    {
+        auto sprite = s_asyncUploads.front();
+        auto& param = sprite->_asyncLoadParam;
+        if (param.stopCount != stopCount)
+        {
+            s_asyncUploads.pop_front();
+            param.meshVertexDatas.clear();
+            CC_SAFE_DELETE(param.meshdatas);
+            CC_SAFE_DELETE(param.materialdatas);
+            CC_SAFE_DELETE(param.nodeDatas);
+            sprite->release();
+            continue;
+        }
+
+        const auto& meshdatas = param.meshdatas->meshDatas;
+        if (param.uploadedMeshCount < meshdatas.size())
+        {
+            auto meshdata = meshdatas[param.uploadedMeshCount++];
+            if (meshdata)
+            {
+                param.meshVertexDatas.pushBack(MeshVertexData::create(*meshdata));
+                uploadedBytes += meshdata->getVertexDataSize() * sizeof(float);
+                for (ssize_t i = 0, count = meshdata->getSubMeshCount(); i < count; ++i)
+                {
+                    uploadedBytes += meshdata->getSubMeshIndexCount(i) * sizeof(unsigned short);
+                }
+            }
+            continue;
+        }
+
+        // the callback may load other sprites, pop the sprite first
+        s_asyncUploads.pop_front();
+        sprite->afterAsyncLoad(&param);
+    }
+
+    if (s_asyncUploads.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule(ASYNC_UPLOAD_KEY, &s_asyncUploads);
+    }
 }
 
 void Sprite3D::afterAsyncLoad(void* param)
@@ -132,11 +300,13 @@ void Sprite3D::afterAsyncLoad(void* param)
             CC_SAFE_RELEASE_NULL(_skeleton);
             removeAllAttachNode();
             
-            //create in the main thread
+            //create in the main thread, the mesh vertex datas were uploaded by uploadAsyncMeshes()
             auto& meshdatas = asyncParam->meshdatas;
             auto& materialdatas = asyncParam->materialdatas;
             auto&   nodeDatas = asyncParam->nodeDatas;
-            if (initFrom(*nodeDatas, *meshdatas, *materialdatas))
+            _meshVertexDatas = asyncParam->meshVertexDatas;
+            asyncParam->meshVertexDatas.clear();
+            if (initNodes(*nodeDatas, *materialdatas))
             {
                 auto spritedata = Sprite3DCache::getInstance()->getSpriteData(asyncParam->modelPath);
                 if (spritedata == nullptr)
@@ -246,6 +416,8 @@ bool Sprite3D::loadFromFile(const std::string& path, NodeDatas* nodedatas, MeshD
             return false;
         }
         
+        // the mesh datas only feed MeshVertexData::create, the views save a copy of the geometry
+        bundle->setMeshDataViewsEnabled(true);
         auto ret = bundle->loadMeshDatas(*meshdatas)
             && bundle->loadMaterials(*materialdatas) && bundle->loadNodes(*nodedatas);
         Bundle3D::destroyBundle(bundle);
@@ -335,6 +507,11 @@ bool Sprite3D::initFrom(const NodeDatas& nodeDatas, const MeshDatas& meshdatas,
             _meshVertexDatas.pushBack(meshvertex);
         }
     }
+    return initNodes(nodeDatas, materialdatas);
+}
+
+bool Sprite3D::initNodes(const NodeDatas& nodeDatas, const MaterialDatas& materialdatas)
+{
     _skeleton = Skeleton3D::create(nodeDatas.skeleton);
     CC_SAFE_RETAIN(_skeleton);
     
@@ -368,7 +545,7 @@ Sprite3D* Sprite3D::createSprite3DNode(NodeData* nodedata,ModelData* modeldata,c
         
         if (_skeleton && modeldata->bones.size())
         {
-            auto skin = MeshSkin::create(_skeleton, modeldata->bones, modeldata->invBindPose);
+            auto skin = MeshSkin::create(_skeleton, *modeldata);
             mesh->setSkin(skin);
         }
         
@@ -531,7 +708,7 @@ void Sprite3D::createNode(NodeData* nodedata, Node* root, const MaterialDatas& m
                     _meshes.pushBack(mesh);
                     if (_skeleton && it->bones.size())
                     {
-                        auto skin = MeshSkin::create(_skeleton, it->bones, it->invBindPose);
+                        auto skin = MeshSkin::create(_skeleton, *it);
                         mesh->setSkin(skin);
                     }
                     mesh->_visibleChanged = std::bind(&Sprite3D::onAABBDirty, this);
@@ -790,6 +967,9 @@ void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     
     for (auto mesh: _meshes)
     {
+        if (s_instancedRenderingEnabled && mesh->drawInstanced(renderer, _globalZOrder, transform, flags, Vec4(color.r, color.g, color.b, color.a)))
+            continue;
+
         mesh->draw(renderer,
                    _globalZOrder,
                    transform,
@@ -871,6 +1051,26 @@ Action* Sprite3D::runAction(Action *action)
     return Node::runAction(action);
 }
 
+void Sprite3D::setInstancedRenderingEnabled(bool enabled)
+{
+    s_instancedRenderingEnabled = enabled;
+}
+
+bool Sprite3D::isInstancedRenderingEnabled()
+{
+    return s_instancedRenderingEnabled;
+}
+
+void Sprite3D::setAsyncUploadBudget(size_t bytes)
+{
+    s_asyncUploadBudget = bytes;
+}
+
+size_t Sprite3D::getAsyncUploadBudget()
+{
+    return s_asyncUploadBudget;
+}
+
 Rect Sprite3D::getBoundingBox() const
 {
     AABB aabb = getAABB();
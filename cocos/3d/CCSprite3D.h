@@ -72,6 +72,9 @@ public:
      * If the 3d model was previously loaded, it will create a new 3d sprite and the callback will be called at once.
      * Otherwise it will load the model file in a new thread, and when the 3d sprite is loaded, the callback will be called with the created Sprite3D and a user-defined parameter.
      * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
+     * The meshes of a .c3b are parsed in parallel with its materials and nodes, then the textures are loaded with
+     * TextureCache::addImageAsync(), then the meshes are uploaded over several frames, see setAsyncUploadBudget().
+     * AsyncTaskPool::stopTasks(AsyncTaskPool::TaskType::TASK_IO) stops the loadings at any of these stages.
      * @param modelPath model to be loaded
      * @param callback callback after loading
      * @param callbackparam user defined parameter for the callback
@@ -177,6 +180,33 @@ public:
     /**draw*/
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
+    /**
+     * Enables or disables the instanced rendering of all the Sprite3Ds, disabled by default.
+     *
+     * When enabled, the opaque, unlit and not skinned meshes sharing their buffers, texture and program are drawn
+     * by a single instanced draw call, with a transform and a color per instance, instead of a MeshCommand each.
+     * The render state of such a batch is the one of its first mesh, and the uniforms set on the materials are not used.
+     * The other meshes, or all of them if Configuration::supportsInstancedArrays() is false, are drawn as usual.
+     *
+     * @param enabled True to draw the Sprite3Ds with instancing when possible.
+     */
+    static void setInstancedRenderingEnabled(bool enabled);
+
+    /** Whether the Sprite3Ds are drawn with instancing when possible. */
+    static bool isInstancedRenderingEnabled();
+
+    /**
+     * Sets how many bytes of vertices and indices of the Sprite3Ds loaded by createAsync() are uploaded to buffers
+     * per frame, shared by all the loadings, to keep the frames short while loading. At least one mesh is uploaded
+     * per frame. 0, the default, means no limit.
+     *
+     * @param bytes The number of bytes per frame.
+     */
+    static void setAsyncUploadBudget(size_t bytes);
+
+    /** Returns how many bytes of the Sprite3Ds loaded by createAsync() are uploaded per frame, 0 means no limit. */
+    static size_t getAsyncUploadBudget();
+
     /** Adds a new material to the sprite.
      The Material will be applied to all the meshes that belong to the sprite.
      Internally it will call `setMaterial(material,-1)`
@@ -215,6 +245,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithFile(const std::string &path);
     
     bool initFrom(const NodeDatas& nodedatas, const MeshDatas& meshdatas, const MaterialDatas& materialdatas);
+
+    /** creates the skeleton, the meshes and the attached nodes, once the mesh vertex datas are created */
+    bool initNodes(const NodeDatas& nodedatas, const MaterialDatas& materialdatas);
     
     /**load sprite3d from cache, return true if succeed, false otherwise*/
     bool loadFromCache(const std::string& path);
@@ -244,6 +277,13 @@ CC_CONSTRUCTOR_ACCESS:
     
     void afterAsyncLoad(void* param);
 
+    /** loads the textures of the async loaded materials with TextureCache::addImageAsync() */
+    void loadAsyncTextures();
+    /** called in the main thread when a stage of the async loading finished, queues the uploads after the last one */
+    void onAsyncLoadStageFinished();
+    /** uploads the meshes of the async loaded sprites, within the budget of the frame */
+    static void uploadAsyncMeshes(float dt);
+
     static AABB getAABBRecursivelyImp(Node *node);
     
 protected:
@@ -276,6 +316,11 @@ protected:
         MeshDatas* meshdatas;
         MaterialDatas* materialdatas;
         NodeDatas*   nodeDatas;
+        bool                            meshResult; // mesh parse result, when parsed apart from the materials
+        int                             pendingStages; // parses and texture loads which didn't finish
+        unsigned int                    stopCount; // AsyncTaskPool stop count of the io tasks when the load started
+        size_t                          uploadedMeshCount; // mesh datas uploaded so far
+        Vector<MeshVertexData*>         meshVertexDatas;
     };
     AsyncLoadParam             _asyncLoadParam;
 };
@@ -47,7 +47,10 @@ cocos2d.cpp \
 2d/CCFontAtlasCache.cpp \
 2d/CCFontCharMap.cpp \
 2d/CCFontFNT.cpp \
+2d/CCFontBaked.cpp \
 2d/CCFontFreeType.cpp \
+2d/CCFontGlyphCache.cpp \
+2d/CCFontMSDF.cpp \
 2d/CCGLBufferedNode.cpp \
 2d/CCGrabber.cpp \
 2d/CCGrid.cpp \
@@ -66,6 +69,7 @@ cocos2d.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
+2d/CCParticleKernels.cpp \
 2d/CCParticleSystem.cpp \
 2d/CCParticleSystemQuad.cpp \
 2d/CCProgressTimer.cpp \
@@ -73,6 +77,7 @@ cocos2d.cpp \
 2d/CCRenderTexture.cpp \
 2d/CCScene.cpp \
 2d/CCSprite.cpp \
+2d/CCSpatialIndex.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
@@ -107,6 +112,10 @@ math/Vec4.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
 base/CCAsyncTaskPool.cpp \
+base/CCWorkerPool.cpp \
+base/CCMappedZipFile.cpp \
+base/CCMappedFile.cpp \
+base/CCJobSystem.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -184,6 +193,8 @@ renderer/CCTextureCube.cpp \
 renderer/CCTrianglesCommand.cpp \
 renderer/CCVertexAttribBinding.cpp \
 renderer/CCVertexIndexBuffer.cpp \
+renderer/CCStreamBuffer.cpp \
+renderer/CCInstanceBuffer.cpp \
 renderer/CCVertexIndexData.cpp \
 renderer/ccGLStateCache.cpp \
 renderer/CCFrameBuffer.cpp \
@@ -25,8 +25,7 @@
 #include "platform/CCPlatformConfig.h"
 
 #include "audio/include/AudioEngine.h"
-#include <condition_variable>
-#include <queue>
+#include <algorithm>
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 
@@ -65,81 +64,18 @@ AudioEngine::ProfileHelper* AudioEngine::_defaultProfileHelper = nullptr;
 std::unordered_map<int, AudioEngine::AudioInfo> AudioEngine::_audioIDInfoMap;
 AudioEngineImpl* AudioEngine::_audioEngineImpl = nullptr;
 
-AudioEngine::AudioEngineThreadPool* AudioEngine::s_threadPool = nullptr;
-
-class AudioEngine::AudioEngineThreadPool
-{
-public:
-    AudioEngineThreadPool(int threads = 4)
-        : _stop(false)
-    {
-        for (int index = 0; index < threads; ++index)
-        {
-            _workers.emplace_back(std::thread(std::bind(&AudioEngineThreadPool::threadFunc, this)));
-        }
-    }
-
-    void addTask(const std::function<void()> &task){
-        std::unique_lock<std::mutex> lk(_queueMutex);
-        _taskQueue.emplace(task);
-        _taskCondition.notify_one();
-    }
-
-    ~AudioEngineThreadPool()
-    {
-        {
-            std::unique_lock<std::mutex> lk(_queueMutex);
-            _stop = true;
-            _taskCondition.notify_all();
-        }
-
-        for (auto&& worker : _workers) {
-            worker.join();
-        }
-    }
-
-private:
-    void threadFunc()
-    {
-        while (true) {
-            std::function<void()> task = nullptr;
-            {
-                std::unique_lock<std::mutex> lk(_queueMutex);
-                if (_stop)
-                {
-                    break;
-                }
-                if (!_taskQueue.empty())
-                {
-                    task = std::move(_taskQueue.front());
-                    _taskQueue.pop();
-                }
-                else
-                {
-                    _taskCondition.wait(lk);
-                    continue;
-                }
-            }
-
-            task();
-        }
-    }
-
-    std::vector<std::thread>  _workers;
-    std::queue< std::function<void()> > _taskQueue;
-
-    std::mutex _queueMutex;
-    std::condition_variable _taskCondition;
-    bool _stop;
-};
+std::vector<JobSystem::JobHandle> AudioEngine::s_tasks;
 
 void AudioEngine::end()
 {
-    if (s_threadPool)
+    // the tasks use the caches of _audioEngineImpl
+    for (auto& task : s_tasks)
     {
-        delete s_threadPool;
-        s_threadPool = nullptr;
+        task->cancel();
+        if (!task->isFinished())
+            JobSystem::getInstance()->wait(task);
     }
+    s_tasks.clear();
 
     delete _audioEngineImpl;
     _audioEngineImpl = nullptr;
@@ -160,13 +96,6 @@ bool AudioEngine::lazyInit()
         }
     }
 
-#if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
-    if (_audioEngineImpl && s_threadPool == nullptr)
-    {
-        s_threadPool = new (std::nothrow) AudioEngineThreadPool();
-    }
-#endif
-
     return true;
 }
 
@@ -530,8 +459,14 @@ void AudioEngine::addTask(const std::function<void()>& task)
 {
     lazyInit();
 
-    if (_audioEngineImpl && s_threadPool)
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
+    if (_audioEngineImpl)
     {
-        s_threadPool->addTask(task);
+        // a sound is usually preloaded to be played soon
+        s_tasks.erase(std::remove_if(s_tasks.begin(), s_tasks.end(), [](const JobSystem::JobHandle& job) {
+            return job->isFinished();
+        }), s_tasks.end());
+        s_tasks.push_back(JobSystem::getInstance()->schedule(task, JobSystem::Priority::HIGH));
     }
+#endif
 }
@@ -31,8 +31,10 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/CCJobSystem.h"
 #include "audio/include/Export.h"
 
 #ifdef ERROR
@@ -347,8 +349,8 @@ protected:
     
     static AudioEngineImpl* _audioEngineImpl;
 
-    class AudioEngineThreadPool;
-    static AudioEngineThreadPool* s_threadPool;
+    // the jobs of addTask(), waited for by end()
+    static std::vector<JobSystem::JobHandle> s_tasks;
     
     friend class AudioEngineImpl;
 };
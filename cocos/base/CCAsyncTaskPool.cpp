@@ -25,6 +25,8 @@ THE SOFTWARE.
 
 #include "base/CCAsyncTaskPool.h"
 
+#include <algorithm>
+
 NS_CC_BEGIN
 
 AsyncTaskPool* AsyncTaskPool::s_asyncTaskPool = nullptr;
@@ -46,10 +48,45 @@ void AsyncTaskPool::destroyInstance()
 
 AsyncTaskPool::AsyncTaskPool()
 {
+    for (auto& stopCount : _stopCounts)
+    {
+        stopCount = 0;
+    }
 }
 
 AsyncTaskPool::~AsyncTaskPool()
 {
+    for (int type = 0; type < int(TaskType::TASK_MAX_TYPE); ++type)
+    {
+        stopTasks((TaskType)type);
+    }
+}
+
+void AsyncTaskPool::stopTasks(TaskType type)
+{
+    std::lock_guard<std::mutex> lock(_jobsMutex);
+    for (auto& job : _jobs[(int)type])
+    {
+        job->cancel();
+    }
+    _jobs[(int)type].clear();
+    ++_stopCounts[(int)type];
+}
+
+unsigned int AsyncTaskPool::getStopCount(TaskType type)
+{
+    std::lock_guard<std::mutex> lock(_jobsMutex);
+    return _stopCounts[(int)type];
+}
+
+void AsyncTaskPool::addJob(TaskType type, const JobSystem::JobHandle& job)
+{
+    std::lock_guard<std::mutex> lock(_jobsMutex);
+    auto& jobs = _jobs[(int)type];
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const JobSystem::JobHandle& job) {
+        return job->isFinished();
+    }), jobs.end());
+    jobs.push_back(job);
 }
 
 NS_CC_END
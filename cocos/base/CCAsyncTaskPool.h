@@ -28,15 +28,11 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCJobSystem.h"
 #include <vector>
-#include <queue>
 #include <memory>
-#include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <future>
 #include <functional>
-#include <stdexcept>
 
 /**
 * @addtogroup base
@@ -48,6 +44,8 @@ NS_CC_BEGIN
 /**
  * @class AsyncTaskPool
  * @brief This class allows to perform background operations without having to manipulate threads.
+ *
+ * The tasks run on the JobSystem, tasks of the same type may run concurrently.
  * @js NA
  */
 class CC_DLL AsyncTaskPool
@@ -77,143 +75,61 @@ public:
     CC_DEPRECATED_ATTRIBUTE static void destoryInstance() { return destroyInstance(); }
     
     /**
-     * Stop tasks.
+     * Stop tasks. The tasks which didn't start yet are dropped, without calling their callback.
      *
      * @param type Task type you want to stop.
      */
     void stopTasks(TaskType type);
+
+    /**
+     * Returns how many times stopTasks() was called for a type. Work continuing a task in several steps, e.g. in
+     * its callback, compares it with the count when the task was enqueued to know if it was stopped.
+     *
+     * @param type Task type.
+     */
+    unsigned int getStopCount(TaskType type);
     
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, network tasks run after the others.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param f task can be lambda function.
+     * @return The job of the task. Its callback doesn't run if the task is stopped, a continuation added with
+     * JobSystem::then() still runs.
      * @lua NA
      */
     template<class F>
-    inline void enqueue(TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f);
+    inline JobSystem::JobHandle enqueue(TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f);
     
 CC_CONSTRUCTOR_ACCESS:
     AsyncTaskPool();
     ~AsyncTaskPool();
     
 protected:
-    
-    // thread tasks internally used
-    class ThreadTasks {
-        struct AsyncTaskCallBack
-        {
-            TaskCallBack          callback;
-            void*                 callbackParam;
-        };
-    public:
-        ThreadTasks()
-        : _stop(false)
-        {
-            _thread = std::thread(
-                                  [this]
-                                  {
-                                      for(;;)
-                                      {
-                                          std::function<void()> task;
-                                          AsyncTaskCallBack callback;
-                                          {
-                                              std::unique_lock<std::mutex> lock(this->_queueMutex);
-                                              this->_condition.wait(lock,
-                                                                    [this]{ return this->_stop || !this->_tasks.empty(); });
-                                              if(this->_stop && this->_tasks.empty())
-                                                  return;
-                                              task = std::move(this->_tasks.front());
-                                              callback = std::move(this->_taskCallBacks.front());
-                                              this->_tasks.pop();
-                                              this->_taskCallBacks.pop();
-                                          }
-                                          
-                                          task();
-                                          Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
-                                      }
-                                  }
-                                  );
-        }
-        ~ThreadTasks()
-        {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-                
-                while(_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear()
-        {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while(_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
-        }
-        template<class F>
-        void enqueue(const TaskCallBack& callback, void* callbackParam, F&& f)
-        {
-            auto task = f;//std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-            
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                
-                // don't allow enqueueing after stopping the pool
-                if(_stop)
-                {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-                
-                AsyncTaskCallBack taskCallBack;
-                taskCallBack.callback = callback;
-                taskCallBack.callbackParam = callbackParam;
-                _tasks.emplace([task](){ task(); });
-                _taskCallBacks.emplace(taskCallBack);
-            }
-            _condition.notify_one();
-        }
-    private:
-        
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue< std::function<void()> > _tasks;
-        std::queue<AsyncTaskCallBack>            _taskCallBacks;
-        
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop;
-    };
-    
-    //tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    void addJob(TaskType type, const JobSystem::JobHandle& job);
+
+    // the jobs which may not have finished, per type, for stopTasks()
+    std::vector<JobSystem::JobHandle> _jobs[int(TaskType::TASK_MAX_TYPE)];
+    unsigned int _stopCounts[int(TaskType::TASK_MAX_TYPE)];
+    std::mutex _jobsMutex;
     
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
-inline void AsyncTaskPool::stopTasks(TaskType type)
-{
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
-}
-
 template<class F>
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f)
+inline JobSystem::JobHandle AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f)
 {
-    auto& threadTask = _threadTasks[(int)type];
-    
-    threadTask.enqueue(callback, callbackParam, f);
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->createJob(std::forward<F>(f), type == TaskType::TASK_NETWORK ? JobSystem::Priority::LOW : JobSystem::Priority::NORMAL);
+    if (callback)
+    {
+        jobSystem->setCompletionCallback(job, [callback, callbackParam]{ callback(callbackParam); });
+    }
+    addJob(type, job);
+    jobSystem->submit(job);
+    return job;
 }
 
 
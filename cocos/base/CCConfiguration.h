@@ -170,6 +170,24 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not glMapBufferRange() is supported.
+     *
+     * On Windows and Linux it checks for the extension `GL_ARB_map_buffer_range`.
+     * On other platforms it returns `false`.
+     *
+     * @return Whether or not `glMapBufferRange()` is supported.
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not instanced drawing (glDrawElementsInstanced() and glVertexAttribDivisor()) is supported.
+     *
+     * On Windows and Linux it checks for the extensions `GL_ARB_instanced_arrays` and `GL_ARB_draw_instanced`.
+     * On other platforms it returns `false`.
+     *
+     * @return Whether or not instanced drawing is supported.
+     */
+    bool supportsInstancedArrays() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -258,6 +276,8 @@ protected:
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
     bool            _supportsOESMapBuffer;
+    bool            _supportsMapBufferRange;
+    bool            _supportsInstancedArrays;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
     
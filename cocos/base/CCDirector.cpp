@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
+#include "2d/CCParticleSystem.h"
+#include "3d/CCSkeleton3D.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
@@ -60,6 +62,8 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCWorkerPool.h"
+#include "base/CCJobSystem.h"
 #include "platform/CCApplication.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -143,6 +147,8 @@ bool Director::init(void)
     // invalid ?
     _invalid = false;
 
+    _matrixStackPushedOnVisit = true;
+
     _winSizeInPoints = Size::ZERO;
 
     _openGLView = nullptr;
@@ -275,6 +281,10 @@ void Director::drawScene()
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
+        // the particle systems queued during the update, see ParticleSystem::setParallelUpdateEnabled()
+        ParticleSystem::runParallelUpdates();
+        // the skeletons animated during the update, see Skeleton3D::setParallelUpdateEnabled()
+        Skeleton3D::runParallelUpdates();
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
@@ -315,6 +325,7 @@ void Director::drawScene()
         showStats();
     }
     _renderer->render();
+    _renderer->endFrame();
 
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
@@ -442,6 +453,13 @@ void Director::setNextDeltaTimeZero(bool nextDeltaTimeZero)
 // MUST BE moved outside.
 // Why the Director must have this code ?
 //
+std::stack<Mat4>& Director::getModelViewMatrixStack()
+{
+    // subtrees visited by Renderer::recordInParallel use the modelview stack of their recording
+    auto recording = Renderer::getCurrentRecording();
+    return recording ? recording->modelViewMatrixStack : _modelViewMatrixStack;
+}
+
 void Director::initMatrixStack()
 {
     while (!_modelViewMatrixStack.empty())
@@ -486,7 +504,7 @@ void Director::popMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.pop();
+        getModelViewMatrixStack().pop();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -511,7 +529,7 @@ void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() = Mat4::IDENTITY;
+        getModelViewMatrixStack().top() = Mat4::IDENTITY;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -536,7 +554,7 @@ void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() = mat;
+        getModelViewMatrixStack().top() = mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -561,7 +579,7 @@ void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() *= mat;
+        getModelViewMatrixStack().top() *= mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -586,7 +604,8 @@ void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
     if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
     {
-        _modelViewMatrixStack.push(_modelViewMatrixStack.top());
+        auto& modelViewMatrixStack = getModelViewMatrixStack();
+        modelViewMatrixStack.push(modelViewMatrixStack.top());
     }
     else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
     {
@@ -611,7 +630,8 @@ const Mat4& Director::getMatrix(MATRIX_STACK_TYPE type) const
 {
     if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
     {
-        return _modelViewMatrixStack.top();
+        auto recording = Renderer::getCurrentRecording();
+        return recording ? recording->modelViewMatrixStack.top() : _modelViewMatrixStack.top();
     }
     else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
     {
@@ -1087,6 +1107,7 @@ void Director::reset()
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    WorkerPool::destroyInstance();
     
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -1096,6 +1117,9 @@ void Director::reset()
     RenderState::finalize();
     
     destroyTextureCache();
+
+    // after the texture cache, which waits for its loading job
+    JobSystem::destroyInstance();
 }
 
 void Director::purgeDirector()
@@ -469,6 +469,19 @@ public:
      */
     void popMatrix(MATRIX_STACK_TYPE type);
 
+    /** Sets whether the nodes push their modelview transform on the deprecated modelview matrix stack when they are visited.
+     * Disabling it saves two matrix copies per visited node. Then `getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)`
+     * returns the transform the scene is visited with, instead of the one of the node being drawn.
+     * Nodes relying on the stack, like ClippingNode or RenderTexture, always push it. It is enabled by default.
+     * @js NA
+     */
+    void setMatrixStackPushedOnVisit(bool pushed) { _matrixStackPushedOnVisit = pushed; }
+
+    /** Whether the nodes push their modelview transform on the deprecated modelview matrix stack when they are visited.
+     * @js NA
+     */
+    bool isMatrixStackPushedOnVisit() const { return _matrixStackPushedOnVisit; }
+
     /** Pops the top matrix of the projection matrix stack.
      * @param index The index of projection matrix stack.
      * @js NA
@@ -589,8 +602,10 @@ protected:
     void destroyTextureCache();
 
     void initMatrixStack();
+    std::stack<Mat4>& getModelViewMatrixStack();
 
     std::stack<Mat4> _modelViewMatrixStack;
+    bool _matrixStackPushedOnVisit;
     /** In order to support GL MultiView features, we need to use the matrix array,
         but we don't know the number of MultiView, so using the vector instead.
      */
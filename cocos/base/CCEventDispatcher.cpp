@@ -23,6 +23,7 @@
  ****************************************************************************/
 #include "base/CCEventDispatcher.h"
 #include <algorithm>
+#include <cfloat>
 
 #include "base/CCEventCustom.h"
 #include "base/CCEventListenerTouch.h"
@@ -197,11 +198,279 @@ void EventDispatcher::EventListenerVector::clear()
     clearFixedListeners();
 }
 
+static bool s_touchHitTestIndexEnabled = false;
+
+// the size of a cell of the hit-test index, in points
+static const float HIT_TEST_CELL_SIZE = 128.0f;
+// nodes covering more cells than this are always candidates, like in SpatialIndex
+static const int HIT_TEST_MAX_CELLS_PER_NODE = 64;
+// keeps the cell coordinates far from the limits of int
+static const float HIT_TEST_MAX_CELL_COORD = 1 << 30;
+
+class EventDispatcher::TouchHitTestIndex
+{
+public:
+    void insert(Node* node);
+    void remove(Node* node);
+
+    /** Recomputes the bounding boxes of the nodes whose transform or content size changed during the last visit. */
+    void update();
+
+    /** Appends to result the nodes whose bounding box contains point, plus the nodes which aren't in the grid. */
+    void query(const Vec2& point, std::vector<Node*>& result) const;
+
+private:
+    struct Entry
+    {
+        Node* node;
+        Rect bounds;
+        int minX, minY, maxX, maxY;
+        int unboundedIndex;
+        bool inGrid;
+    };
+
+    static uint64_t cellKey(int x, int y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+    static int cellCoord(float value) { return (int)floorf(clampf(value / HIT_TEST_CELL_SIZE, -HIT_TEST_MAX_CELL_COORD, HIT_TEST_MAX_CELL_COORD)); }
+    bool computeBounds(Node* node, Rect* bounds) const;
+    void addToGrid(int slot);
+    void removeFromGrid(int slot);
+    void addToUnbounded(int slot);
+    void removeFromUnbounded(int slot);
+
+    std::vector<Entry> _entries;
+    std::vector<int> _freeSlots;
+    std::unordered_map<Node*, int> _slots;
+    std::unordered_map<uint64_t, std::vector<int>> _cells;
+    std::vector<int> _unbounded;
+    // scratch of update()
+    std::vector<Node*> _dirtyNodes;
+};
+
+void EventDispatcher::TouchHitTestIndex::insert(Node* node)
+{
+    if (_slots.find(node) != _slots.end())
+        return;
+
+    int slot;
+    if (_freeSlots.empty())
+    {
+        slot = (int)_entries.size();
+        _entries.emplace_back();
+    }
+    else
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+
+    auto& entry = _entries[slot];
+    entry.node = node;
+    entry.unboundedIndex = -1;
+    entry.inGrid = false;
+    // computed by the next update, until then the node is always a candidate
+    addToUnbounded(slot);
+    node->_hitTestBoundsDirty = true;
+
+    _slots.emplace(node, slot);
+}
+
+void EventDispatcher::TouchHitTestIndex::remove(Node* node)
+{
+    auto found = _slots.find(node);
+    if (found == _slots.end())
+        return;
+
+    int slot = found->second;
+    removeFromGrid(slot);
+    removeFromUnbounded(slot);
+    _entries[slot].node = nullptr;
+    _freeSlots.push_back(slot);
+    _slots.erase(found);
+}
+
+void EventDispatcher::TouchHitTestIndex::update()
+{
+    // the setters mark only the node they change, so a node is also stale when one of its ancestors moved since the
+    // last update. The flags are cleared once every node was checked, an indexed node may be the ancestor of another
+    _dirtyNodes.clear();
+    for (int slot = 0, count = (int)_entries.size(); slot < count; ++slot)
+    {
+        Node* node = _entries[slot].node;
+        if (node == nullptr)
+            continue;
+
+        bool dirty = false;
+        for (Node* ancestor = node; ancestor != nullptr; ancestor = ancestor->getParent())
+        {
+            if (ancestor->_hitTestBoundsDirty)
+            {
+                dirty = true;
+                _dirtyNodes.push_back(ancestor);
+            }
+        }
+        if (!dirty)
+            continue;
+
+        removeFromGrid(slot);
+        removeFromUnbounded(slot);
+
+        if (computeBounds(node, &_entries[slot].bounds))
+            addToGrid(slot);
+        else
+            addToUnbounded(slot);
+    }
+
+    for (auto node : _dirtyNodes)
+    {
+        node->_hitTestBoundsDirty = false;
+    }
+}
+
+bool EventDispatcher::TouchHitTestIndex::computeBounds(Node* node, Rect* bounds) const
+{
+    // empty containers usually test their children, the hit test of a 3D transform depends on the camera
+    auto& size = node->getContentSize();
+    if (size.width <= 0 || size.height <= 0)
+        return false;
+
+    Mat4 nodeToWorld = node->getNodeToWorldTransform();
+    const float cornerX[4] = { 0, size.width, 0, size.width };
+    const float cornerY[4] = { 0, 0, size.height, size.height };
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec3 corner(cornerX[i], cornerY[i], 0);
+        nodeToWorld.transformPoint(&corner);
+        if (fabsf(corner.z) > 0.001f)
+            return false;
+
+        minX = std::min(minX, corner.x);
+        minY = std::min(minY, corner.y);
+        maxX = std::max(maxX, corner.x);
+        maxY = std::max(maxY, corner.y);
+    }
+
+    bounds->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
+void EventDispatcher::TouchHitTestIndex::addToGrid(int slot)
+{
+    auto& entry = _entries[slot];
+    entry.minX = cellCoord(entry.bounds.getMinX());
+    entry.minY = cellCoord(entry.bounds.getMinY());
+    entry.maxX = cellCoord(entry.bounds.getMaxX());
+    entry.maxY = cellCoord(entry.bounds.getMaxY());
+
+    if ((int64_t)(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) > HIT_TEST_MAX_CELLS_PER_NODE)
+    {
+        addToUnbounded(slot);
+        return;
+    }
+
+    for (int y = entry.minY; y <= entry.maxY; ++y)
+    {
+        for (int x = entry.minX; x <= entry.maxX; ++x)
+            _cells[cellKey(x, y)].push_back(slot);
+    }
+    entry.inGrid = true;
+}
+
+void EventDispatcher::TouchHitTestIndex::removeFromGrid(int slot)
+{
+    auto& entry = _entries[slot];
+    if (!entry.inGrid)
+        return;
+
+    for (int y = entry.minY; y <= entry.maxY; ++y)
+    {
+        for (int x = entry.minX; x <= entry.maxX; ++x)
+        {
+            auto cell = _cells.find(cellKey(x, y));
+            CCASSERT(cell != _cells.end(), "TouchHitTestIndex: missing cell");
+            auto& slots = cell->second;
+            auto it = std::find(slots.begin(), slots.end(), slot);
+            *it = slots.back();
+            slots.pop_back();
+            if (slots.empty())
+                _cells.erase(cell);
+        }
+    }
+    entry.inGrid = false;
+}
+
+void EventDispatcher::TouchHitTestIndex::addToUnbounded(int slot)
+{
+    _entries[slot].unboundedIndex = (int)_unbounded.size();
+    _unbounded.push_back(slot);
+}
+
+void EventDispatcher::TouchHitTestIndex::removeFromUnbounded(int slot)
+{
+    int index = _entries[slot].unboundedIndex;
+    if (index < 0)
+        return;
+
+    int last = _unbounded.back();
+    _unbounded[index] = last;
+    _entries[last].unboundedIndex = index;
+    _unbounded.pop_back();
+    _entries[slot].unboundedIndex = -1;
+}
+
+void EventDispatcher::TouchHitTestIndex::query(const Vec2& point, std::vector<Node*>& result) const
+{
+    // a node is listed once per cell, so a point only finds it once
+    auto cell = _cells.find(cellKey(cellCoord(point.x), cellCoord(point.y)));
+    if (cell != _cells.end())
+    {
+        for (int slot : cell->second)
+        {
+            if (_entries[slot].bounds.containsPoint(point))
+                result.push_back(_entries[slot].node);
+        }
+    }
+
+    for (int slot : _unbounded)
+        result.push_back(_entries[slot].node);
+}
+
+/** Intersects the ray of a location on the screen with the plane z = 0 of the world. */
+static bool getWorldPointOfLocation(const Camera* camera, const Vec2& location, Vec2* point)
+{
+    Mat4 clipToWorld = camera->getViewProjectionMatrix();
+    if (!clipToWorld.inverse())
+        return false;
+
+    auto& winSize = Director::getInstance()->getWinSize();
+    float ndcX = location.x / winSize.width * 2 - 1;
+    float ndcY = location.y / winSize.height * 2 - 1;
+    Vec4 nearPoint, farPoint;
+    clipToWorld.transformVector(Vec4(ndcX, ndcY, -1, 1), &nearPoint);
+    clipToWorld.transformVector(Vec4(ndcX, ndcY, 1, 1), &farPoint);
+    if (nearPoint.w == 0 || farPoint.w == 0)
+        return false;
+
+    Vec3 from(nearPoint.x / nearPoint.w, nearPoint.y / nearPoint.w, nearPoint.z / nearPoint.w);
+    Vec3 to(farPoint.x / farPoint.w, farPoint.y / farPoint.w, farPoint.z / farPoint.w);
+    float dz = from.z - to.z;
+    if (fabsf(dz) < FLT_EPSILON)
+        return false;
+    float t = from.z / dz;
+    if (t < 0 || t > 1)
+        return false;
+
+    point->set(from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t);
+    return true;
+}
+
 
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _touchHitTestIndex(nullptr)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -219,6 +488,7 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_touchHitTestIndex);
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -414,6 +684,9 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     {
         listeners = new (std::nothrow) std::vector<EventListener*>();
         _nodeListenersMap.emplace(node, listeners);
+
+        if (_touchHitTestIndex)
+            _touchHitTestIndex->insert(node);
     }
     
     listeners->push_back(listener);
@@ -436,6 +709,9 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         {
             _nodeListenersMap.erase(found);
             delete listeners;
+
+            if (_touchHitTestIndex)
+                _touchHitTestIndex->remove(node);
         }
     }
 }
@@ -800,7 +1076,8 @@ void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, c
     }
 }
 
-void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent,
+                                                    const std::vector<EventListener*>* hitTestListeners/* = nullptr */)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -827,7 +1104,30 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
     }
     
     auto scene = Director::getInstance()->getRunningScene();
-    if (scene && sceneGraphPriorityListeners)
+    if (scene && sceneGraphPriorityListeners && hitTestListeners)
+    {
+        if (!shouldStopPropagation)
+        {
+            // priority == 0, scene graph priority, already hit-tested and sorted for the default camera
+            Camera* camera = scene->getDefaultCamera();
+            Camera::_visitingCamera = camera;
+            auto cameraFlag = (unsigned short)camera->getCameraFlag();
+            for (auto& l : *hitTestListeners)
+            {
+                if (nullptr == l->getAssociatedNode() || 0 == (l->getAssociatedNode()->getCameraMask() & cameraFlag))
+                {
+                    continue;
+                }
+                if (onEvent(l))
+                {
+                    shouldStopPropagation = true;
+                    break;
+                }
+            }
+            Camera::_visitingCamera = nullptr;
+        }
+    }
+    else if (scene && sceneGraphPriorityListeners)
     {
         if (!shouldStopPropagation)
         {
@@ -917,10 +1217,6 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     sortEventListeners(listenerID);
     
-    auto pfnDispatchEventToListeners = &EventDispatcher::dispatchEventToListeners;
-    if (event->getType() == Event::Type::MOUSE) {
-        pfnDispatchEventToListeners = &EventDispatcher::dispatchTouchEventToListeners;
-    }
     auto iter = _listenerMap.find(listenerID);
     if (iter != _listenerMap.end())
     {
@@ -932,7 +1228,14 @@ void EventDispatcher::dispatchEvent(Event* event)
             return event->isStopped();
         };
         
-        (this->*pfnDispatchEventToListeners)(listeners, onEvent);
+        if (event->getType() == Event::Type::MOUSE)
+        {
+            dispatchTouchEventToListeners(listeners, onEvent);
+        }
+        else
+        {
+            dispatchEventToListeners(listeners, onEvent);
+        }
     }
     
     updateListeners(event);
@@ -950,9 +1253,144 @@ bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listener
     return getListeners(listenerID) != nullptr;
 }
 
+bool EventDispatcher::canUseTouchHitTestIndex(Scene* scene) const
+{
+    if (!s_touchHitTestIndexEnabled || scene == nullptr)
+        return false;
+
+    // the touches are located on the plane z = 0 seen by the default camera
+    auto defaultCamera = scene->getDefaultCamera();
+    if (defaultCamera == nullptr || !defaultCamera->isVisible())
+        return false;
+
+    for (const auto& camera : scene->getCameras())
+    {
+        if (camera != defaultCamera && camera->isVisible())
+            return false;
+    }
+    return true;
+}
+
+bool EventDispatcher::collectHitTestListeners(EventListenerVector* listeners, Scene* scene, Touch* touch, bool isBegan, std::vector<EventListener*>& result)
+{
+    result.clear();
+
+    if (isBegan)
+    {
+        Vec2 point;
+        if (!getWorldPointOfLocation(scene->getDefaultCamera(), touch->getLocation(), &point))
+            return false;
+
+        if (_touchHitTestIndex == nullptr)
+        {
+            _touchHitTestIndex = new (std::nothrow) TouchHitTestIndex();
+            for (const auto& e : _nodeListenersMap)
+            {
+                _touchHitTestIndex->insert(e.first);
+            }
+        }
+
+        _touchHitTestIndex->update();
+
+        std::vector<Node*> nodes;
+        _touchHitTestIndex->query(point, nodes);
+        for (auto node : nodes)
+        {
+            // the listeners of a node are in the order they were added, like in the sorted vector
+            for (auto l : *_nodeListenersMap[node])
+            {
+                if (l->getListenerID() == EventListenerTouchOneByOne::LISTENER_ID
+                    && l->isEnabled() && !l->isPaused() && l->isRegistered())
+                {
+                    result.push_back(l);
+                }
+            }
+        }
+    }
+    else if (listeners->getSceneGraphPriorityListeners())
+    {
+        for (auto l : *listeners->getSceneGraphPriorityListeners())
+        {
+            auto& claimedTouches = static_cast<EventListenerTouchOneByOne*>(l)->_claimedTouches;
+            if (l->isEnabled() && !l->isPaused() && l->isRegistered()
+                && std::find(claimedTouches.begin(), claimedTouches.end(), touch) != claimedTouches.end())
+            {
+                result.push_back(l);
+            }
+        }
+    }
+
+    sortListenersByDrawOrder(scene, result);
+    return true;
+}
+
+void EventDispatcher::sortListenersByDrawOrder(Scene* scene, std::vector<EventListener*>& listeners)
+{
+    if (listeners.size() < 2)
+        return;
+
+    // the path from the scene to the node of each listener, the listeners outside of the scene go last
+    struct DrawOrder
+    {
+        EventListener* listener;
+        float globalZOrder;
+        std::vector<Node*> path;
+    };
+
+    std::vector<DrawOrder> orders(listeners.size());
+    for (size_t i = 0, count = listeners.size(); i < count; ++i)
+    {
+        auto& order = orders[i];
+        order.listener = listeners[i];
+        Node* node = listeners[i]->getAssociatedNode();
+        order.globalZOrder = node->getGlobalZOrder();
+        for (; node; node = node->getParent())
+        {
+            order.path.push_back(node);
+        }
+        std::reverse(order.path.begin(), order.path.end());
+        if (order.path.front() != scene)
+        {
+            order.path.clear();
+        }
+    }
+
+    // same order as visitTarget: higher global Z order first, then the nodes drawn last first
+    std::stable_sort(orders.begin(), orders.end(), [](const DrawOrder& o1, const DrawOrder& o2) {
+        if (o1.path.empty() || o2.path.empty())
+            return !o1.path.empty() && o2.path.empty();
+        if (o1.globalZOrder != o2.globalZOrder)
+            return o1.globalZOrder > o2.globalZOrder;
+
+        size_t size1 = o1.path.size();
+        size_t size2 = o2.path.size();
+        size_t i = 1;
+        while (i < size1 && i < size2 && o1.path[i] == o2.path[i])
+            ++i;
+
+        if (i == size1 && i == size2)
+            return false;
+        // a node is visited after its children with a negative local Z order, and before the other ones
+        if (i == size1)
+            return o2.path[i]->getLocalZOrder() < 0;
+        if (i == size2)
+            return o1.path[i]->getLocalZOrder() >= 0;
+        return o1.path[i]->_localZOrderAndArrival > o2.path[i]->_localZOrderAndArrival;
+    });
+
+    for (size_t i = 0, count = listeners.size(); i < count; ++i)
+    {
+        listeners[i] = orders[i].listener;
+    }
+}
+
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
+    auto scene = Director::getInstance()->getRunningScene();
+    bool useHitTestIndex = canUseTouchHitTestIndex(scene);
+
+    // with the hit-test index, the scene graph listeners are only sorted when a touch hits them
+    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID, useHitTestIndex ? DirtyFlag::FIXED_PRIORITY : DirtyFlag::ALL);
     sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
     
     auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
@@ -974,6 +1412,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     if (oneByOneListeners)
     {
         auto mutableTouchesIter = mutableTouches.begin();
+        std::vector<EventListener*> hitTestListeners;
         
         for (auto& touches : originalTouches)
         {
@@ -1067,7 +1506,16 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
             };
             
             //
-            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            if (useHitTestIndex
+                && collectHitTestListeners(oneByOneListeners, scene, touches, event->getEventCode() == EventTouch::EventCode::BEGAN, hitTestListeners))
+            {
+                dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent, &hitTestListeners);
+            }
+            else
+            {
+                sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
+                dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            }
             if (event->isStopped())
             {
                 return;
@@ -1275,7 +1723,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
-void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID, DirtyFlag flags/* = DirtyFlag::ALL */)
 {
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
     
@@ -1285,10 +1733,12 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
         dirtyFlag = dirtyIter->second;
     }
     
+    // the priorities which aren't sorted now stay dirty
+    dirtyFlag = (DirtyFlag)((int)dirtyFlag & (int)flags);
     if (dirtyFlag != DirtyFlag::NONE)
     {
         // Clear the dirty flag first, if `rootNode` is nullptr, then set its dirty flag of scene graph priority
-        dirtyIter->second = DirtyFlag::NONE;
+        dirtyIter->second = (DirtyFlag)((int)dirtyIter->second & ~(int)dirtyFlag);
 
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
@@ -1304,7 +1754,7 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
             }
             else
             {
-                dirtyIter->second = DirtyFlag::SCENE_GRAPH_PRIORITY;
+                dirtyIter->second = (DirtyFlag)((int)dirtyIter->second | (int)DirtyFlag::SCENE_GRAPH_PRIORITY);
             }
         }
     }
@@ -1526,6 +1976,16 @@ bool EventDispatcher::isEnabled() const
     return _isEnabled;
 }
 
+void EventDispatcher::setTouchHitTestIndexEnabled(bool enabled)
+{
+    s_touchHitTestIndexEnabled = enabled;
+}
+
+bool EventDispatcher::isTouchHitTestIndexEnabled()
+{
+    return s_touchHitTestIndexEnabled;
+}
+
 void EventDispatcher::setDirtyForNode(Node* node)
 {
     // Mark the node dirty only when there is an eventlistener associated with it. 
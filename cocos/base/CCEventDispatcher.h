@@ -45,7 +45,9 @@ NS_CC_BEGIN
 
 class Event;
 class EventTouch;
+class Touch;
 class Node;
+class Scene;
 class EventCustom;
 class EventListenerCustom;
 
@@ -185,6 +187,27 @@ public:
      */
     bool hasEventListener(const EventListener::ListenerID& listenerID) const;
 
+    /////////////////////////////////////////////
+
+    /** Sets whether the touches are hit-tested against an index of the bounding boxes of the nodes.
+     *
+     * When enabled, a began touch is only dispatched to the EventListenerTouchOneByOne listeners with scene graph priority
+     * whose node's world bounding box contains it. The bounding boxes are kept in a uniform grid and are only recomputed for
+     * the nodes whose transform or content size changed during the last visit. The order of the listeners is computed for
+     * the few candidates only, so the changes of the scene graph no longer sort all the listeners of the scene.
+     * Nodes with an empty content size or a 3D transform are always candidates. The moved, ended and cancelled touches go
+     * to the listeners which claimed them, like before.
+     *
+     * The index is only used when the default camera is the only visible camera of the running scene; otherwise, and for
+     * the EventListenerTouchAllAtOnce listeners, the touches are dispatched as usual.
+     *
+     * @param enabled True to hit-test the touches against the index.
+     */
+    static void setTouchHitTestIndexEnabled(bool enabled);
+
+    /** Whether the touches are hit-tested against an index of the bounding boxes of the nodes. */
+    static bool isTouchHitTestIndexEnabled();
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher.
@@ -207,6 +230,15 @@ public:
 protected:
     friend class Node;
     
+    /// Priority dirty flag
+    enum class DirtyFlag
+    {
+        NONE = 0,
+        FIXED_PRIORITY = 1 << 0,
+        SCENE_GRAPH_PRIORITY = 1 << 1,
+        ALL = FIXED_PRIORITY | SCENE_GRAPH_PRIORITY
+    };
+    
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
     
@@ -257,8 +289,8 @@ protected:
     /** Removes all listeners with the same event listener ID */
     void removeEventListenersForListenerID(const EventListener::ListenerID& listenerID);
     
-    /** Sort event listener */
-    void sortEventListeners(const EventListener::ListenerID& listenerID);
+    /** Sort event listener, only for the priorities in flags */
+    void sortEventListeners(const EventListener::ListenerID& listenerID, DirtyFlag flags = DirtyFlag::ALL);
     
     /** Sorts the listeners of specified type by scene graph priority */
     void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
@@ -291,20 +323,27 @@ protected:
      *      order by viewport/camera first, because the touch location convert
      *      to 3D world space is different by different camera.
      *  When listener process touch event, can get current camera by Camera::getVisitingCamera().
+     *
+     *  @param hitTestListeners If not nullptr, the scene graph listeners to dispatch to instead of all of them, in order,
+     *         with the default camera only. See collectHitTestListeners.
+     */
+    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent,
+                                       const std::vector<EventListener*>* hitTestListeners = nullptr);
+
+    /** Whether the touches can be dispatched with the hit-test index in the scene. */
+    bool canUseTouchHitTestIndex(Scene* scene) const;
+
+    /** Collects the enabled scene graph listeners of the touch, from the hit-test index when it begins or from the
+     *  listeners which claimed it otherwise, sorted like sortEventListenersOfSceneGraphPriority would.
+     *  Returns false if the touch can't be located in the scene.
      */
-    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    bool collectHitTestListeners(EventListenerVector* listeners, Scene* scene, Touch* touch, bool isBegan, std::vector<EventListener*>& result);
+
+    /** Sorts scene graph listeners by the draw order of their nodes, only walking up from the nodes. */
+    void sortListenersByDrawOrder(Scene* scene, std::vector<EventListener*>& listeners);
     
     void releaseListener(EventListener* listener);
     
-    /// Priority dirty flag
-    enum class DirtyFlag
-    {
-        NONE = 0,
-        FIXED_PRIORITY = 1 << 0,
-        SCENE_GRAPH_PRIORITY = 1 << 1,
-        ALL = FIXED_PRIORITY | SCENE_GRAPH_PRIORITY
-    };
-    
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
@@ -314,6 +353,9 @@ protected:
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
 
+    /** Uniform grid of the world bounding boxes of the nodes with listeners */
+    class TouchHitTestIndex;
+
     /** Listeners map */
     std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
     
@@ -347,6 +389,9 @@ protected:
     int _nodePriorityIndex;
     
     std::set<std::string> _internalCustomListenerIDs;
+
+    /** The hit-test index of the nodes, created the first time it is used */
+    TouchHitTestIndex* _touchHitTestIndex;
 };
 
 
@@ -0,0 +1,358 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCJobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/ccMacros.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+JobSystem* JobSystem::s_jobSystem = nullptr;
+
+// the job system and the queue of the current thread, the queues are picked in turn by the other threads
+static thread_local JobSystem* s_currentJobSystem = nullptr;
+static thread_local int s_currentQueue = -1;
+
+// jobs may block on IO, so keep a couple of threads even on a single core
+static const int MIN_THREAD_COUNT = 2;
+
+JobSystem::Job::Job(const std::function<void()>& work, Priority priority)
+: _work(work)
+, _priority(priority)
+, _submitted(false)
+, _pendingCount(1)
+, _finished(false)
+, _canceled(false)
+{
+}
+
+JobSystem* JobSystem::getInstance()
+{
+    if (s_jobSystem == nullptr)
+    {
+        s_jobSystem = new (std::nothrow) JobSystem();
+    }
+    return s_jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    delete s_jobSystem;
+    s_jobSystem = nullptr;
+}
+
+bool JobSystem::isWorkerThread()
+{
+    return s_currentJobSystem != nullptr;
+}
+
+JobSystem::JobSystem()
+: _queuedCount(0)
+, _nextQueue(0)
+, _waiterCount(0)
+, _stop(false)
+{
+    int threadCount = std::max((int)std::thread::hardware_concurrency() - 1, MIN_THREAD_COUNT);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _queues.emplace_back(new WorkQueue());
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+
+    // cancel what is left, finishing a job may release others
+    JobHandle job;
+    while (takeJob(-1, job))
+    {
+        job->cancel();
+        finish(job);
+    }
+}
+
+JobSystem::JobHandle JobSystem::createJob(const std::function<void()>& work, Priority priority)
+{
+    return JobHandle(new (std::nothrow) Job(work, priority));
+}
+
+void JobSystem::addDependency(const JobHandle& job, const JobHandle& dependency)
+{
+    CCASSERT(!job->_submitted, "JobSystem: dependencies must be added before submitting the job");
+
+    std::lock_guard<std::mutex> lock(dependency->_mutex);
+    if (!dependency->_finished.load(std::memory_order_relaxed))
+    {
+        ++job->_pendingCount;
+        dependency->_continuations.push_back(job);
+        job->_dependencies.push_back(dependency);
+    }
+}
+
+void JobSystem::setCompletionCallback(const JobHandle& job, const std::function<void()>& callback)
+{
+    CCASSERT(!job->_submitted, "JobSystem: the completion callback must be set before submitting the job");
+    job->_completionCallback = callback;
+}
+
+void JobSystem::submit(const JobHandle& job)
+{
+    CCASSERT(!job->_submitted, "JobSystem: the job was already submitted");
+    job->_submitted = true;
+    if (--job->_pendingCount == 0)
+        enqueue(job);
+}
+
+JobSystem::JobHandle JobSystem::schedule(const std::function<void()>& work, Priority priority,
+                                         const std::function<void()>& completionCallback)
+{
+    auto job = createJob(work, priority);
+    job->_completionCallback = completionCallback;
+    submit(job);
+    return job;
+}
+
+JobSystem::JobHandle JobSystem::then(const JobHandle& job, const std::function<void()>& work, Priority priority,
+                                     const std::function<void()>& completionCallback)
+{
+    auto continuation = createJob(work, priority);
+    continuation->_completionCallback = completionCallback;
+    addDependency(continuation, job);
+    submit(continuation);
+    return continuation;
+}
+
+void JobSystem::enqueue(const JobHandle& job)
+{
+    // a thread of the pool keeps the jobs it releases, the others are spread over the queues
+    int index = s_currentJobSystem == this ? s_currentQueue : (int)(_nextQueue++ % _queues.size());
+    auto& queue = *_queues[index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs[(int)job->_priority].push_back(job);
+    }
+    ++_queuedCount;
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+bool JobSystem::takeJob(int index, JobHandle& job)
+{
+    if (_queuedCount.load(std::memory_order_acquire) <= 0)
+        return false;
+
+    int queueCount = (int)_queues.size();
+    for (int priority = 0; priority < PRIORITY_COUNT; ++priority)
+    {
+        // the newest job of its own queue is likely still in cache
+        if (index >= 0)
+        {
+            auto& queue = *_queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& jobs = queue.jobs[priority];
+            if (!jobs.empty())
+            {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+                --_queuedCount;
+                return true;
+            }
+        }
+
+        // steal the oldest job of another queue
+        for (int i = 1; i <= queueCount; ++i)
+        {
+            int other = (std::max(index, 0) + i) % queueCount;
+            if (other == index)
+                continue;
+
+            auto& queue = *_queues[other];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& jobs = queue.jobs[priority];
+            if (!jobs.empty())
+            {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                --_queuedCount;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool JobSystem::takeQueuedJob(const JobHandle& job)
+{
+    if (_queuedCount.load(std::memory_order_acquire) <= 0)
+        return false;
+
+    for (auto& queue : _queues)
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        auto& jobs = queue->jobs[(int)job->_priority];
+        auto iter = std::find(jobs.begin(), jobs.end(), job);
+        if (iter != jobs.end())
+        {
+            jobs.erase(iter);
+            --_queuedCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::takeJobOrDependency(const JobHandle& job, JobHandle& taken)
+{
+    if (job->isFinished())
+        return false;
+
+    if (takeQueuedJob(job))
+    {
+        taken = job;
+        return true;
+    }
+
+    // the dependencies don't change once the job is submitted
+    for (const auto& weakDependency : job->_dependencies)
+    {
+        auto dependency = weakDependency.lock();
+        if (dependency && takeJobOrDependency(dependency, taken))
+            return true;
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(int index)
+{
+    s_currentJobSystem = this;
+    s_currentQueue = index;
+
+    for (;;)
+    {
+        // once stopping, the queued jobs are left to the destructor to cancel
+        if (_stop.load())
+            break;
+
+        JobHandle job;
+        if (takeJob(index, job))
+        {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this]{ return _stop.load() || _queuedCount.load() > 0; });
+    }
+
+    s_currentJobSystem = nullptr;
+    s_currentQueue = -1;
+}
+
+void JobSystem::run(const JobHandle& job)
+{
+    if (!job->isCanceled())
+    {
+        job->_work();
+        if (job->_completionCallback)
+        {
+            auto callback = std::move(job->_completionCallback);
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([job, callback]{
+                if (!job->isCanceled())
+                    callback();
+            });
+        }
+    }
+    finish(job);
+}
+
+void JobSystem::finish(const JobHandle& job)
+{
+    // release what the work captured
+    job->_work = nullptr;
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->_mutex);
+        job->_finished.store(true, std::memory_order_release);
+        continuations.swap(job->_continuations);
+    }
+
+    for (auto& continuation : continuations)
+    {
+        if (--continuation->_pendingCount == 0)
+            enqueue(continuation);
+    }
+
+    if (_waiterCount.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(_waitMutex);
+        _finishedCondition.notify_all();
+    }
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+    while (!job->isFinished())
+    {
+        // only help with what is waited for, running any job could block this thread on unrelated work
+        JobHandle awaited;
+        if (takeJobOrDependency(job, awaited))
+        {
+            run(awaited);
+            continue;
+        }
+
+        // the job runs on another thread, or waits for one; wake up now and then for newly released jobs
+        ++_waiterCount;
+        {
+            std::unique_lock<std::mutex> lock(_waitMutex);
+            _finishedCondition.wait_for(lock, std::chrono::milliseconds(1), [&]{ return job->isFinished(); });
+        }
+        --_waiterCount;
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,232 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_JOB_SYSTEM_H_
+#define __CC_JOB_SYSTEM_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+/**
+* @addtogroup base
+* @{
+*/
+NS_CC_BEGIN
+
+/**
+ * @class JobSystem
+ * @brief Runs background jobs on a pool of threads sized to the hardware.
+ *
+ * Each thread has its own queues and takes the jobs of the other threads when its queues are empty, so a burst
+ * of jobs (e.g. texture decodes) is spread over all the threads. Jobs have a priority, can wait for other jobs
+ * to finish before starting, and can have a callback called in the cocos thread once they finished.
+ *
+ * AsyncTaskPool, FileUtils, TextureCache and AudioEngine run their background work on this pool.
+ * Unlike WorkerPool, the submitted jobs aren't waited for; jobs may block on IO.
+ * @js NA
+ */
+class CC_DLL JobSystem
+{
+public:
+    /** The priority of a job. Queued jobs of a higher priority start first. */
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    /**
+     * @brief A job of the JobSystem, created by JobSystem::createJob().
+     */
+    class CC_DLL Job
+    {
+    public:
+        /** Returns true once the job ran or was canceled, and its dependent jobs were released. */
+        bool isFinished() const { return _finished.load(std::memory_order_acquire); }
+        /** Returns true if the job was canceled. */
+        bool isCanceled() const { return _canceled.load(std::memory_order_acquire); }
+        /**
+         * Cancels the job. If it didn't start yet, neither its work nor its completion callback will run.
+         * The jobs depending on it are still released once it is finished.
+         */
+        void cancel() { _canceled.store(true, std::memory_order_release); }
+        /** Returns the priority of the job. */
+        Priority getPriority() const { return _priority; }
+
+    protected:
+        friend class JobSystem;
+
+        Job(const std::function<void()>& work, Priority priority);
+
+        std::function<void()> _work;
+        std::function<void()> _completionCallback;
+        Priority _priority;
+        bool _submitted;
+        // the submission and the dependencies which didn't finish yet
+        std::atomic<int> _pendingCount;
+        std::atomic<bool> _finished;
+        std::atomic<bool> _canceled;
+        // guards _continuations and the transition to finished
+        std::mutex _mutex;
+        std::vector<std::shared_ptr<Job>> _continuations;
+        // the dependencies which didn't finish when they were added, for wait()
+        std::vector<std::weak_ptr<Job>> _dependencies;
+    };
+
+    typedef std::shared_ptr<Job> JobHandle;
+
+    /**
+     * Returns the shared instance of the job system.
+     */
+    static JobSystem* getInstance();
+
+    /**
+     * Destroys the job system. The queued jobs are canceled, the running ones are waited for.
+     */
+    static void destroyInstance();
+
+    /**
+     * Returns the number of threads running the jobs.
+     */
+    int getThreadCount() const { return (int)_threads.size(); }
+
+    /**
+     * Creates a job. It won't run before it is submitted.
+     *
+     * @param work The work of the job, called on a thread of the job system.
+     * @param priority The priority of the job.
+     * @return The job.
+     */
+    JobHandle createJob(const std::function<void()>& work, Priority priority = Priority::NORMAL);
+
+    /**
+     * Makes a job wait for another one to finish before starting. Must be called before the job is submitted.
+     *
+     * @param job The job which waits.
+     * @param dependency The job to wait for.
+     */
+    void addDependency(const JobHandle& job, const JobHandle& dependency);
+
+    /**
+     * Sets a callback called in the cocos thread, through Scheduler::performFunctionInCocosThread(), once the work
+     * of the job finished. It isn't called if the job is canceled before the callback runs. Must be called before
+     * the job is submitted.
+     *
+     * @param job The job.
+     * @param callback The callback.
+     */
+    void setCompletionCallback(const JobHandle& job, const std::function<void()>& callback);
+
+    /**
+     * Submits a job. It runs as soon as its dependencies finished and a thread is free.
+     *
+     * @param job The job.
+     */
+    void submit(const JobHandle& job);
+
+    /**
+     * Creates and submits a job.
+     *
+     * @param work The work of the job, called on a thread of the job system.
+     * @param priority The priority of the job.
+     * @param completionCallback Optional callback called in the cocos thread once the work finished.
+     * @return The job.
+     */
+    JobHandle schedule(const std::function<void()>& work, Priority priority = Priority::NORMAL,
+                       const std::function<void()>& completionCallback = nullptr);
+
+    /**
+     * Creates and submits a job which starts once another job finished.
+     *
+     * @param job The job to wait for.
+     * @param work The work of the continuation.
+     * @param priority The priority of the continuation.
+     * @param completionCallback Optional callback called in the cocos thread once the work finished.
+     * @return The continuation.
+     */
+    JobHandle then(const JobHandle& job, const std::function<void()>& work, Priority priority = Priority::NORMAL,
+                   const std::function<void()>& completionCallback = nullptr);
+
+    /**
+     * Waits for a job to finish. If the job or one of the jobs it depends on is queued meanwhile, the calling thread
+     * runs it, other jobs are left to the threads of the job system.
+     *
+     * @param job The job to wait for.
+     */
+    void wait(const JobHandle& job);
+
+    /**
+     * Returns true if the calling thread is a thread of the job system.
+     */
+    static bool isWorkerThread();
+
+CC_CONSTRUCTOR_ACCESS:
+    JobSystem();
+    ~JobSystem();
+
+protected:
+    static const int PRIORITY_COUNT = 3;
+
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs[PRIORITY_COUNT];
+    };
+
+    void workerLoop(int index);
+    void enqueue(const JobHandle& job);
+    bool takeJob(int index, JobHandle& job);
+    bool takeQueuedJob(const JobHandle& job);
+    bool takeJobOrDependency(const JobHandle& job, JobHandle& taken);
+    void run(const JobHandle& job);
+    void finish(const JobHandle& job);
+
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    std::atomic<int> _queuedCount;
+    std::atomic<unsigned int> _nextQueue;
+    std::atomic<int> _waiterCount;
+    std::atomic<bool> _stop;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::mutex _waitMutex;
+    std::condition_variable _finishedCondition;
+
+    static JobSystem* s_jobSystem;
+};
+
+NS_CC_END
+// end group
+/// @}
+#endif //__CC_JOB_SYSTEM_H_
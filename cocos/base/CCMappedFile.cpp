@@ -0,0 +1,177 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCMappedFile.h"
+
+#include "platform/CCFileUtils.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#elif CC_TARGET_PLATFORM != CC_PLATFORM_WINRT
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+NS_CC_BEGIN
+
+MappedFile::MappedFile()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+, _fileHandle(nullptr)
+, _mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& fullPath)
+{
+    close();
+
+    if (map(fullPath))
+    {
+        _mapped = true;
+        return true;
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    ssize_t size = 0;
+    if (fileUtils->getFileView(fullPath, &_bytes, &size))
+    {
+        _size = (size_t)size;
+        return true;
+    }
+
+    // e.g. a file inside the APK
+    _data = fileUtils->getDataFromFile(fullPath);
+    if (_data.isNull())
+        return false;
+    _bytes = _data.getBytes();
+    _size = (size_t)_data.getSize();
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_mapped)
+        unmap();
+    _mapped = false;
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+
+bool MappedFile::map(const std::string& fullPath)
+{
+    int length = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &widePath[0], length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _bytes = (const unsigned char*)view;
+    _size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    UnmapViewOfFile(_bytes);
+    CloseHandle(_mappingHandle);
+    CloseHandle(_fileHandle);
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+}
+
+#elif CC_TARGET_PLATFORM != CC_PLATFORM_WINRT
+
+bool MappedFile::map(const std::string& fullPath)
+{
+    int fd = ::open(FileUtils::getInstance()->getSuitableFOpen(fullPath).c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat statBuf;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &statBuf) == 0 && statBuf.st_size > 0)
+        view = mmap(nullptr, (size_t)statBuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the file is closed
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    _bytes = (const unsigned char*)view;
+    _size = (size_t)statBuf.st_size;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    munmap((void*)_bytes, _size);
+}
+
+#else
+
+bool MappedFile::map(const std::string& fullPath)
+{
+    return false;
+}
+
+void MappedFile::unmap()
+{
+}
+
+#endif
+
+NS_CC_END
@@ -0,0 +1,95 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_MAPPED_FILE_H__
+#define __CC_MAPPED_FILE_H__
+
+#include <string>
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+#include "base/CCData.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * @class MappedFile
+ * @brief The read-only contents of a file, mapped in memory when possible.
+ *
+ * The file is mapped with mmap, or a file mapping on win32. A file stored without compression in an archive
+ * added with FileUtils::addSearchArchive() is read in place from the archive. Otherwise, e.g. for a file inside
+ * the APK, it is read into memory.
+ * @js NA
+ */
+class CC_DLL MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /**
+     * Maps a file.
+     *
+     * @param fullPath The full path of the file.
+     * @return True if the file could be mapped or read.
+     */
+    bool open(const std::string& fullPath);
+
+    /** Unmaps the file. The bytes returned by getBytes() become invalid. */
+    void close();
+
+    bool isOpen() const { return _bytes != nullptr; }
+
+    const unsigned char* getBytes() const { return _bytes; }
+
+    size_t getSize() const { return _size; }
+
+protected:
+    bool map(const std::string& fullPath);
+    void unmap();
+
+    const unsigned char* _bytes;
+    size_t _size;
+    bool _mapped;
+    // the file when it couldn't be mapped nor viewed in an archive
+    Data _data;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#endif
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+NS_CC_END
+
+/** @} */
+
+#endif // __CC_MAPPED_FILE_H__
@@ -0,0 +1,239 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCMappedZipFile.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+// zip format, see APPNOTE.TXT
+static const uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+static const uint32_t CENTRAL_DIRECTORY_SIGNATURE = 0x02014b50;
+static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+static const size_t CENTRAL_DIRECTORY_HEADER_SIZE = 46;
+static const size_t LOCAL_HEADER_SIZE = 30;
+static const size_t MAX_COMMENT_SIZE = 0xffff;
+static const uint16_t METHOD_STORED = 0;
+static const uint16_t METHOD_DEFLATED = 8;
+static const uint16_t FLAG_ENCRYPTED = 1;
+
+static uint16_t readUInt16(const unsigned char* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readUInt32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+MappedZipFile::MappedZipFile()
+: _bytes(nullptr)
+, _size(0)
+{
+}
+
+MappedZipFile::~MappedZipFile()
+{
+    close();
+}
+
+bool MappedZipFile::open(const std::string& fullPath, const std::string& filter)
+{
+    close();
+
+    if (!_file.open(fullPath))
+        return false;
+    _bytes = _file.getBytes();
+    _size = _file.getSize();
+
+    _path = fullPath;
+    if (!readCentralDirectory(filter))
+    {
+        CCLOG("MappedZipFile: %s isn't a supported zip archive", fullPath.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedZipFile::close()
+{
+    _file.close();
+    _bytes = nullptr;
+    _size = 0;
+    _entries.clear();
+    _path.clear();
+}
+
+bool MappedZipFile::readCentralDirectory(const std::string& filter)
+{
+    if (_size < END_OF_CENTRAL_DIRECTORY_SIZE)
+        return false;
+
+    // the end of central directory record is followed by a comment of up to 64KB
+    const unsigned char* end = nullptr;
+    size_t lowest = _size > END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE ? _size - END_OF_CENTRAL_DIRECTORY_SIZE - MAX_COMMENT_SIZE : 0;
+    for (size_t offset = _size - END_OF_CENTRAL_DIRECTORY_SIZE + 1; offset-- > lowest;)
+    {
+        if (readUInt32(_bytes + offset) == END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+        {
+            end = _bytes + offset;
+            break;
+        }
+    }
+    if (!end)
+        return false;
+
+    uint16_t entryCount = readUInt16(end + 10);
+    uint32_t directorySize = readUInt32(end + 12);
+    uint32_t directoryOffset = readUInt32(end + 16);
+    // zip64 archives put 0xffffffff here
+    if ((size_t)directoryOffset + directorySize > (size_t)(end - _bytes))
+        return false;
+
+    _entries.reserve(entryCount);
+    const unsigned char* p = _bytes + directoryOffset;
+    const unsigned char* directoryEnd = p + directorySize;
+    while (p + CENTRAL_DIRECTORY_HEADER_SIZE <= directoryEnd && readUInt32(p) == CENTRAL_DIRECTORY_SIGNATURE)
+    {
+        uint16_t flags = readUInt16(p + 8);
+        uint16_t nameLength = readUInt16(p + 28);
+        uint16_t extraLength = readUInt16(p + 30);
+        uint16_t commentLength = readUInt16(p + 32);
+        const char* name = (const char*)(p + CENTRAL_DIRECTORY_HEADER_SIZE);
+        if ((const unsigned char*)name + nameLength > directoryEnd)
+            return false;
+
+        Entry entry;
+        entry.method = readUInt16(p + 10);
+        entry.compressedSize = readUInt32(p + 20);
+        entry.uncompressedSize = readUInt32(p + 24);
+        entry.localHeaderOffset = readUInt32(p + 42);
+        // the bytes of a stored entry are read up to its uncompressed size, only its compressed size is bounds checked
+        if (entry.method == METHOD_STORED && entry.compressedSize != entry.uncompressedSize)
+            return false;
+
+        // skip the directories and what can't be read
+        bool isDirectory = nameLength > 0 && name[nameLength - 1] == '/';
+        bool supported = !(flags & FLAG_ENCRYPTED) && (entry.method == METHOD_STORED || entry.method == METHOD_DEFLATED);
+        if (!isDirectory && supported && nameLength > filter.size() && filter.compare(0, filter.size(), name, filter.size()) == 0)
+        {
+            _entries.emplace(std::string(name + filter.size(), nameLength - filter.size()), entry);
+        }
+
+        p += CENTRAL_DIRECTORY_HEADER_SIZE + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+const unsigned char* MappedZipFile::getEntryData(const Entry& entry) const
+{
+    // the extra field of the local header may differ from the one of the central directory
+    size_t offset = entry.localHeaderOffset;
+    if (offset + LOCAL_HEADER_SIZE > _size || readUInt32(_bytes + offset) != LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    offset += LOCAL_HEADER_SIZE + readUInt16(_bytes + offset + 26) + readUInt16(_bytes + offset + 28);
+    if (offset + entry.compressedSize > _size)
+        return nullptr;
+    return _bytes + offset;
+}
+
+bool MappedZipFile::fileExists(const std::string& fileName) const
+{
+    return _entries.find(fileName) != _entries.end();
+}
+
+ssize_t MappedZipFile::getFileSize(const std::string& fileName) const
+{
+    auto it = _entries.find(fileName);
+    return it != _entries.end() ? (ssize_t)it->second.uncompressedSize : -1;
+}
+
+bool MappedZipFile::getFileView(const std::string& fileName, const unsigned char** data, ssize_t* size) const
+{
+    auto it = _entries.find(fileName);
+    if (it == _entries.end() || it->second.method != METHOD_STORED)
+        return false;
+
+    auto bytes = getEntryData(it->second);
+    if (!bytes)
+        return false;
+
+    *data = bytes;
+    *size = (ssize_t)it->second.uncompressedSize;
+    return true;
+}
+
+bool MappedZipFile::getFileData(const std::string& fileName, ResizableBuffer* buffer) const
+{
+    auto it = _entries.find(fileName);
+    if (it == _entries.end())
+        return false;
+
+    const Entry& entry = it->second;
+    auto bytes = getEntryData(entry);
+    if (!bytes)
+        return false;
+
+    buffer->resize(entry.uncompressedSize);
+    if (entry.uncompressedSize == 0)
+        return true;
+
+    if (entry.method == METHOD_STORED)
+    {
+        memcpy(buffer->buffer(), bytes, entry.uncompressedSize);
+        return true;
+    }
+
+    // raw deflate, each call has its own stream so files can be inflated concurrently
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    stream.next_in = (Bytef*)bytes;
+    stream.avail_in = entry.compressedSize;
+    stream.next_out = (Bytef*)buffer->buffer();
+    stream.avail_out = entry.uncompressedSize;
+    int ret = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+
+    if (ret != Z_STREAM_END || stream.total_out != entry.uncompressedSize)
+    {
+        CCLOG("MappedZipFile: failed to inflate %s in %s", fileName.c_str(), _path.c_str());
+        return false;
+    }
+    return true;
+}
+
+NS_CC_END
@@ -0,0 +1,137 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_MAPPED_ZIP_FILE_H__
+#define __CC_MAPPED_ZIP_FILE_H__
+
+#include <string>
+#include <unordered_map>
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+#include "base/CCMappedFile.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class ResizableBuffer;
+
+/**
+ * @class MappedZipFile
+ * @brief A read-only zip archive mapped in memory, like a resource pack or an Android OBB.
+ *
+ * The central directory is read once at open into a hash table, so looking a file up doesn't scan the archive.
+ * The files stored without compression are read in place (see getFileView()), the deflated ones are inflated
+ * straight into the destination buffer. Once open, all the methods are const and can be called from any thread
+ * concurrently.
+ *
+ * If the archive can't be mapped (e.g. it is inside the APK), it is read into memory instead.
+ * Encrypted entries and zip64 archives aren't supported.
+ * FileUtils::addSearchArchive() makes the files of an archive reachable through the search paths.
+ * @js NA
+ */
+class CC_DLL MappedZipFile
+{
+public:
+    MappedZipFile();
+    ~MappedZipFile();
+
+    /**
+     * Maps an archive and indexes its files.
+     *
+     * @param fullPath The full path of the archive.
+     * @param filter Only the files whose name starts with it are indexed, without it. For example "assets/".
+     * @return True if the archive was opened.
+     */
+    bool open(const std::string& fullPath, const std::string& filter = std::string());
+
+    /** Unmaps the archive. The views returned by getFileView() become invalid. */
+    void close();
+
+    /** Returns the full path of the archive. */
+    const std::string& getPath() const { return _path; }
+
+    /** Returns the number of indexed files. */
+    ssize_t getFileCount() const { return (ssize_t)_entries.size(); }
+
+    /**
+     * Checks whether a file is in the archive.
+     *
+     * @param fileName The name of the file in the archive, without the filter.
+     * @return True if the file exists.
+     */
+    bool fileExists(const std::string& fileName) const;
+
+    /**
+     * Returns the uncompressed size of a file, or -1 if it isn't in the archive.
+     */
+    ssize_t getFileSize(const std::string& fileName) const;
+
+    /**
+     * Returns the bytes of a file stored without compression, in place. They stay valid until the archive is closed.
+     *
+     * @param fileName The name of the file in the archive.
+     * @param[out] data The bytes of the file.
+     * @param[out] size The size of the file.
+     * @return False if the file doesn't exist or is compressed.
+     */
+    bool getFileView(const std::string& fileName, const unsigned char** data, ssize_t* size) const;
+
+    /**
+     * Reads a file into a buffer, inflating it if it is compressed.
+     *
+     * @param fileName The name of the file in the archive.
+     * @param buffer The buffer receiving the file.
+     * @return True if the file was read.
+     */
+    bool getFileData(const std::string& fileName, ResizableBuffer* buffer) const;
+
+protected:
+    struct Entry
+    {
+        uint32_t localHeaderOffset;
+        uint32_t compressedSize;
+        uint32_t uncompressedSize;
+        uint16_t method;
+    };
+
+    bool readCentralDirectory(const std::string& filter);
+    const unsigned char* getEntryData(const Entry& entry) const;
+
+    std::string _path;
+    MappedFile _file;
+    const unsigned char* _bytes;
+    size_t _size;
+    std::unordered_map<std::string, Entry> _entries;
+};
+
+NS_CC_END
+
+/** @} */
+
+#endif // __CC_MAPPED_ZIP_FILE_H__
@@ -28,45 +28,12 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
-NS_CC_BEGIN
-
-// data structures
+#include <algorithm>
+#include <cmath>
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
-{
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
-{
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
+NS_CC_BEGIN
 
 // implementation Timer
 
@@ -243,16 +210,37 @@ const int Scheduler::PRIORITY_SYSTEM = INT_MIN;
 // Minimum priority level for user scheduling.
 const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
+// the wheel has 64 slots a level, and ticks 128 times a second, 4 levels span 36 hours
+const int Scheduler::TIMER_WHEEL_LEVELS;
+const int Scheduler::TIMER_WHEEL_SLOT_BITS;
+const int Scheduler::TIMER_WHEEL_SLOTS;
+static const double TIMER_WHEEL_TICKS_PER_SECOND = 128.0;
+
+// the lists of the update entries, and the values of UpdateSlot::list for the staged and the free slots
+enum
+{
+    UPDATE_LIST_NEGATIVE,
+    UPDATE_LIST_ZERO,
+    UPDATE_LIST_POSITIVE,
+    UPDATE_STAGED,
+    UPDATE_FREE,
+};
+
+static int getUpdateList(int priority)
+{
+    return priority < 0 ? UPDATE_LIST_NEGATIVE : (priority == 0 ? UPDATE_LIST_ZERO : UPDATE_LIST_POSITIVE);
+}
+
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
-, _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
-, _updateHashLocked(false)
+, _freeUpdateSlot(-1)
+, _hasRemovedUpdates(false)
+, _timerOrder(0)
+, _timerWheelTick(0)
+, _timerClock(0.0)
+, _currentTimer(-1)
+, _currentTimerSalvaged(false)
+, _currentTimerIndex(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
@@ -266,206 +254,552 @@ Scheduler::~Scheduler(void)
     unscheduleAll();
 }
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element)
+Scheduler::UpdateEntry& Scheduler::getUpdateEntry(int slot)
 {
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+    const auto& updateSlot = _updateSlots[slot];
+    if (updateSlot.list == UPDATE_STAGED)
+    {
+        return _stagedUpdates[updateSlot.index];
+    }
+    return _updateLists[updateSlot.list][updateSlot.index];
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+void Scheduler::applyStagedUpdates()
 {
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+    // remove the unscheduled entries, keeping the order of the others
+    if (_hasRemovedUpdates)
+    {
+        _hasRemovedUpdates = false;
+        for (auto& list : _updateLists)
+        {
+            size_t kept = 0;
+            for (size_t i = 0, size = list.size(); i < size; ++i)
+            {
+                if (list[i].markedForDeletion)
+                {
+                    _updateSlots[list[i].slot] = { UPDATE_FREE, _freeUpdateSlot };
+                    _freeUpdateSlot = list[i].slot;
+                    continue;
+                }
+                if (kept != i)
+                {
+                    list[kept] = std::move(list[i]);
+                    _updateSlots[list[kept].slot].index = (int)kept;
+                }
+                ++kept;
+            }
+            list.erase(list.begin() + kept, list.end());
+        }
+    }
+
+    if (_stagedUpdates.empty())
+    {
+        return;
+    }
+
+    // append the staged entries, the lists they don't keep sorted are sorted again
+    bool unsorted[UPDATE_STAGED] = { false, false, false };
+    for (auto& entry : _stagedUpdates)
+    {
+        if (entry.markedForDeletion)
+        {
+            _updateSlots[entry.slot] = { UPDATE_FREE, _freeUpdateSlot };
+            _freeUpdateSlot = entry.slot;
+            continue;
+        }
+
+        int listIndex = getUpdateList(entry.priority);
+        auto& list = _updateLists[listIndex];
+        if (!list.empty() && entry.priority < list.back().priority)
+        {
+            unsorted[listIndex] = true;
+        }
+        _updateSlots[entry.slot] = { listIndex, (int)list.size() };
+        list.push_back(std::move(entry));
+    }
+    _stagedUpdates.clear();
+
+    for (int listIndex = 0; listIndex < UPDATE_STAGED; ++listIndex)
+    {
+        if (!unsorted[listIndex])
+        {
+            continue;
+        }
+
+        // stable, the entries of a priority are called in the order they were scheduled
+        auto& list = _updateLists[listIndex];
+        std::stable_sort(list.begin(), list.end(), [](const UpdateEntry& a, const UpdateEntry& b) {
+            return a.priority < b.priority;
+        });
+        for (size_t i = 0, size = list.size(); i < size; ++i)
+        {
+            _updateSlots[list[i].slot].index = (int)i;
+        }
+    }
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+int Scheduler::findTimer(void* target, const std::string& key, SEL_SCHEDULE selector)
 {
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
+    auto element = _timerTargets.find(target);
+    if (element == _timerTargets.end())
+    {
+        return -1;
+    }
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    for (int slot : element->second.timers)
+    {
+        const auto& timer = _timers[slot];
+        if (selector ? timer.selector == selector : (timer.selector == nullptr && timer.key == key))
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
 
-    if (! element)
+void Scheduler::addTimer(const ccSchedulerFunc& callback, SEL_SCHEDULE selector, void* target, const std::string& key,
+                         float interval, unsigned int repeat, float delay, bool paused)
+{
+    auto inserted = _timerTargets.emplace(target, TimerTarget());
+    auto& element = inserted.first->second;
+    if (inserted.second)
+    {
+        // Is this the 1st element ? Then set the pause level to all the selectors of this target
+        element.order = _timerOrder++;
+        element.paused = paused;
+    }
+    else
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+        CCASSERT(element.paused == paused, "element's paused should be paused!");
+    }
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
+    int slot;
+    if (_freeTimers.empty())
+    {
+        slot = (int)_timers.size();
+        _timers.emplace_back();
+    }
+    else
+    {
+        slot = _freeTimers.back();
+        _freeTimers.pop_back();
+    }
 
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+    auto& timer = _timers[slot];
+    timer.callback = callback;
+    timer.selector = selector;
+    timer.key = key;
+    timer.target = target;
+    timer.base = 0.0;
+    timer.elapsed = 0.0f;
+    timer.interval = interval;
+    timer.delay = delay;
+    timer.repeat = repeat;
+    timer.timesExecuted = 0;
+    timer.order = _timerOrder++;
+    timer.targetOrder = element.order;
+    timer.runForever = (repeat == CC_REPEAT_FOREVER);
+    timer.useDelay = (delay > 0.0f);
+    timer.started = false;
+    timer.used = true;
+
+    element.timers.push_back(slot);
+
+    // a timer added to a target the tick already went past, or before the current timer in its target,
+    // starts at the end of the next tick
+    bool skipped = false;
+    if (_currentTimer >= 0)
+    {
+        unsigned int currentOrder = _timers[_currentTimer].targetOrder;
+        skipped = element.order < currentOrder || (element.order == currentOrder && (int)element.timers.size() - 1 <= _currentTimerIndex);
+    }
+    double skippedTicks = skipped ? 1.0 : 0.0;
+    _startingTimers.push_back({ skippedTicks, 0, slot, timer.generation });
+}
+
+void Scheduler::setTimerInterval(int slot, float interval)
+{
+    auto& timer = _timers[slot];
+    timer.interval = interval;
+
+    // move the timer to its new due time, the current timer is pushed once its callback returns
+    if (timer.started && !timer.useDelay && slot != _currentTimer && !_timerTargets[timer.target].paused)
+    {
+        ++timer.generation;
+        pushTimer(slot);
+    }
+}
+
+void Scheduler::removeTimer(int slot)
+{
+    auto element = _timerTargets.find(_timers[slot].target);
+    auto& timers = element->second.timers;
+    auto position = std::find(timers.begin(), timers.end(), slot);
+    if (_currentTimer >= 0 && _timers[_currentTimer].target == element->first && position - timers.begin() <= _currentTimerIndex)
+    {
+        --_currentTimerIndex;
+    }
+    timers.erase(position);
+
+    // the target of the current timer keeps its order until the callback returns, in case it schedules again
+    if (timers.empty() && (_currentTimer < 0 || _timers[_currentTimer].target != element->first))
+    {
+        _timerTargets.erase(element);
+    }
+
+    if (slot == _currentTimer)
+    {
+        // To prevent the timer from deallocating its callback before it returns, it is freed after
+        _currentTimerSalvaged = true;
     }
     else
     {
-        CCASSERT(element->paused == paused, "element's paused should be paused!");
+        freeTimer(slot);
     }
+}
+
+void Scheduler::freeTimer(int slot)
+{
+    auto& timer = _timers[slot];
+    // the handles of the timer in the wheel become stale
+    ++timer.generation;
+    timer.used = false;
+    timer.callback = nullptr;
+    timer.key.clear();
+    timer.target = nullptr;
+    _freeTimers.push_back(slot);
+}
 
-    if (element->timers == nullptr)
+void Scheduler::pushTimer(int slot)
+{
+    const auto& timer = _timers[slot];
+    float wait = timer.useDelay ? timer.delay : timer.interval;
+    TimerHandle handle = { timer.base + std::max(wait, 0.0f), ((unsigned long long)timer.targetOrder << 32) | timer.order, slot, timer.generation };
+    if (handle.due <= _timerClock)
     {
-        element->timers = ccArrayNew(10);
+        _lateTimers.push_back(handle);
     }
-    else 
+    else
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        insertTimer(handle);
+    }
+}
+
+void Scheduler::insertTimer(const TimerHandle& handle)
+{
+    // the level is the first one whose slots span the wait, the slot is given by the due tick
+    long long tick = (long long)std::floor(handle.due * TIMER_WHEEL_TICKS_PER_SECOND);
+    long long wait = std::max(tick - _timerWheelTick, 0LL);
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && wait >= (1LL << (TIMER_WHEEL_SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    // beyond the wheel, it is inserted again when its slot of the top level is cascaded
+    const long long wheelTicks = 1LL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS);
+    if (wait >= wheelTicks)
+    {
+        tick = _timerWheelTick + wheelTicks - 1;
+    }
+
+    _timerWheel[level][(tick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1)].push_back(handle);
+}
+
+void Scheduler::collectDueTimers(std::vector<TimerHandle>& wheelSlot)
+{
+    size_t kept = 0;
+    for (const auto& handle : wheelSlot)
+    {
+        if (_timers[handle.slot].generation != handle.generation)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+            continue;
+        }
 
-            if (timer && key == timer->getKey())
-            {
-                CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
-                return;
-            }        
+        if (handle.due <= _timerClock)
+        {
+            _dueTimers.push_back(handle);
+        }
+        else
+        {
+            wheelSlot[kept++] = handle;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
-
-    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
-    timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    wheelSlot.resize(kept);
 }
 
-void Scheduler::unschedule(const std::string &key, void *target)
+void Scheduler::pauseTimers(void* target, bool paused)
 {
-    // explicit handle nil arguments when removing an object
-    if (target == nullptr || key.empty())
+    auto element = _timerTargets.find(target);
+    if (element == _timerTargets.end() || element->second.paused == paused)
     {
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
+    element->second.paused = paused;
+    for (int slot : element->second.timers)
+    {
+        // the current timer keeps its elapsed time or is pushed once its callback returns
+        auto& timer = _timers[slot];
+        if (!timer.started || slot == _currentTimer)
+        {
+            continue;
+        }
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+        if (paused)
+        {
+            timer.elapsed = (float)(_timerClock - timer.base);
+            ++timer.generation;
+        }
+        else
+        {
+            timer.base = _timerClock - timer.elapsed;
+            pushTimer(slot);
+        }
+    }
+}
 
-    if (element)
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+void Scheduler::runTimer(int slot)
+{
+    _currentTimer = slot;
+    _currentTimerSalvaged = false;
+
+    // the deque doesn't move the timer when its callback schedules other timers
+    auto& timer = _timers[slot];
+    const auto& targetTimers = _timerTargets[timer.target].timers;
+    _currentTimerIndex = (int)(std::find(targetTimers.begin(), targetTimers.end(), slot) - targetTimers.begin());
+    auto trigger = [&timer](float dt) {
+        if (timer.selector)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+            (static_cast<Ref*>(timer.target)->*timer.selector)(dt);
+        }
+        else if (timer.callback)
+        {
+            timer.callback(dt);
+        }
+    };
 
-            if (timer && key == timer->getKey())
+    // the same steps as Timer::update(), with the time elapsed since the base of the timer
+    float elapsed = (float)(_timerClock - timer.base);
+
+    // deal with delay
+    if (timer.useDelay && elapsed >= timer.delay)
+    {
+        trigger(timer.delay);
+        if (!_currentTimerSalvaged)
+        {
+            elapsed = elapsed - timer.delay;
+            timer.timesExecuted += 1;
+            timer.useDelay = false;
+            // after delay, the rest time should compare with interval
+            if (!timer.runForever && timer.timesExecuted > timer.repeat)
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
+                removeTimer(slot);
+            }
+        }
+    }
 
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
+    if (!timer.useDelay && !_currentTimerSalvaged)
+    {
+        // if interval == 0, should trigger once every frame
+        float interval = (timer.interval > 0) ? timer.interval : elapsed;
+        while (elapsed >= interval)
+        {
+            trigger(interval);
+            if (_currentTimerSalvaged)
+            {
+                break;
+            }
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
+            elapsed -= interval;
+            timer.timesExecuted += 1;
 
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
+            if (!timer.runForever && timer.timesExecuted > timer.repeat)
+            {
+                removeTimer(slot);
+                break;
+            }
 
-                return;
+            if (elapsed <= 0.f)
+            {
+                break;
             }
         }
     }
-}
-
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
-{
-    tListEntry *listElement = new (std::nothrow) tListEntry();
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+    _currentTimer = -1;
+    auto element = _timerTargets.find(timer.target);
+    if (_currentTimerSalvaged)
+    {
+        // The timer was unscheduled, now that its step is done it's safe to free it.
+        if (element->second.timers.empty())
+        {
+            _timerTargets.erase(element);
+        }
+        freeTimer(slot);
+        return;
+    }
 
-    // empty list ?
-    if (! *list)
+    timer.base = _timerClock - elapsed;
+    if (element->second.paused)
     {
-        DL_APPEND(*list, listElement);
+        // paused by its callback
+        timer.elapsed = elapsed;
     }
     else
     {
-        bool added = false;
+        pushTimer(slot);
+    }
+}
+
+void Scheduler::updateTimers(float dt)
+{
+    _timerClock += dt;
+
+    // the slots of the ticks the clock went past, the handles of the unscheduled and paused timers are stale
+    long long tick = (long long)std::floor(_timerClock * TIMER_WHEEL_TICKS_PER_SECOND);
+    collectDueTimers(_timerWheel[0][_timerWheelTick & (TIMER_WHEEL_SLOTS - 1)]);
+    while (_timerWheelTick < tick)
+    {
+        ++_timerWheelTick;
 
-        for (tListEntry *element = *list; element; element = element->next)
+        // a slot of an upper level is cascaded to the levels below when the wheel reaches its ticks, top level first
+        int level = 0;
+        while (level < TIMER_WHEEL_LEVELS - 1 && (_timerWheelTick & ((1LL << (TIMER_WHEEL_SLOT_BITS * (level + 1))) - 1)) == 0)
         {
-            if (priority < element->priority)
+            ++level;
+        }
+        for (; level > 0; --level)
+        {
+            _cascadedTimers.swap(_timerWheel[level][(_timerWheelTick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1)]);
+            for (const auto& handle : _cascadedTimers)
             {
-                if (element == *list)
+                if (_timers[handle.slot].generation == handle.generation)
                 {
-                    DL_PREPEND(*list, listElement);
+                    insertTimer(handle);
                 }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+            }
+            _cascadedTimers.clear();
+        }
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
-                }
+        collectDueTimers(_timerWheel[0][_timerWheelTick & (TIMER_WHEEL_SLOTS - 1)]);
+    }
 
-                added = true;
-                break;
+    for (const auto& handle : _lateTimers)
+    {
+        if (_timers[handle.slot].generation == handle.generation)
+        {
+            _dueTimers.push_back(handle);
+        }
+    }
+    _lateTimers.clear();
+
+    // the timers are fired in the order of their targets, then in the order they were scheduled
+    auto firedBefore = [](const TimerHandle& a, const TimerHandle& b) {
+        return a.order < b.order;
+    };
+    std::sort(_dueTimers.begin(), _dueTimers.end(), firedBefore);
+
+    for (size_t i = 0; i < _dueTimers.size(); ++i)
+    {
+        // the callbacks of the previous timers may have unscheduled or paused it
+        auto handle = _dueTimers[i];
+        if (_timers[handle.slot].generation == handle.generation)
+        {
+            runTimer(handle.slot);
+        }
+
+        // the timers the callback made due are fired by this tick if it didn't go past them yet, else by the next one
+        for (const auto& due : _lateTimers)
+        {
+            if (_timers[due.slot].generation != due.generation)
+            {
+                continue;
             }
+
+            if (firedBefore(handle, due))
+            {
+                _dueTimers.insert(std::upper_bound(_dueTimers.begin() + i + 1, _dueTimers.end(), due, firedBefore), due);
+            }
+            else
+            {
+                _passedTimers.push_back(due);
+            }
+        }
+        _lateTimers.clear();
+    }
+    _dueTimers.clear();
+    _lateTimers.swap(_passedTimers);
+
+    // the timers scheduled since the last tick start counting their time, unless their target is paused
+    size_t kept = 0;
+    for (size_t i = 0, size = _startingTimers.size(); i < size; ++i)
+    {
+        auto handle = _startingTimers[i];
+        auto& timer = _timers[handle.slot];
+        if (timer.generation != handle.generation)
+        {
+            continue;
         }
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+        if (handle.due > 0.0 || _timerTargets[timer.target].paused)
         {
-            DL_APPEND(*list, listElement);
+            handle.due = 0.0;
+            _startingTimers[kept++] = handle;
+            continue;
         }
+
+        timer.started = true;
+        timer.base = _timerClock;
+        pushTimer(handle.slot);
     }
+    _startingTimers.resize(kept);
+}
 
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
-
-    DL_APPEND(*list, listElement);
-
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
+
+    int slot = findTimer(target, key, nullptr);
+    if (slot >= 0)
+    {
+        CCASSERT(_timerTargets[target].paused == paused, "element's paused should be paused!");
+        CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", _timers[slot].interval, interval);
+        setTimerInterval(slot, interval);
+        return;
+    }
+
+    addTimer(callback, nullptr, target, key, interval, repeat, delay, paused);
+}
+
+void Scheduler::unschedule(const std::string &key, void *target)
+{
+    // explicit handle nil arguments when removing an object
+    if (target == nullptr || key.empty())
+    {
+        return;
+    }
+
+    int slot = findTimer(target, key, nullptr);
+    if (slot >= 0)
+    {
+        removeTimer(slot);
+    }
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    auto found = _updateSlotsByTarget.find(target);
+    if (found != _updateSlotsByTarget.end())
     {
         // change priority: should unschedule it first
-        if (hashElement->entry->priority != priority)
+        if (getUpdateEntry(found->second).priority != priority)
         {
             unscheduleUpdate(target);
         }
@@ -477,79 +811,29 @@ void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target,
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
+    int slot = _freeUpdateSlot;
+    if (slot >= 0)
     {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
-    {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
+        _freeUpdateSlot = _updateSlots[slot].index;
     }
     else
     {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
+        slot = (int)_updateSlots.size();
+        _updateSlots.push_back(UpdateSlot());
     }
+
+    // added to its list at the start of the next tick, the lists don't change while they are ticked
+    _updateSlots[slot] = { UPDATE_STAGED, (int)_stagedUpdates.size() };
+    _stagedUpdates.push_back({ callback, target, priority, slot, paused, false });
+    _updateSlotsByTarget[target] = slot;
 }
 
 bool Scheduler::isScheduled(const std::string& key, void *target)
 {
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
-    {
-        return false;
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-            
-            if (timer && key == timer->getKey())
-            {
-                return true;
-            }
-        }
-        
-        return false;
-    }
-    
-    return false;  // should never get here
-}
-
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        if (!_updateHashLocked)
-            CC_SAFE_DELETE(element->entry);
-        else
-        {
-            element->entry->markedForDeletion = true;
-            _updateDeleteVector.push_back(element->entry);
-        }
 
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
-    }
+    return findTimer(target, key, nullptr) >= 0;
 }
 
 void Scheduler::unscheduleUpdate(void *target)
@@ -559,10 +843,14 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
-        this->removeUpdateFromHash(element->entry);
+    auto found = _updateSlotsByTarget.find(target);
+    if (found != _updateSlotsByTarget.end())
+    {
+        // removed from its list at the start of the next tick
+        getUpdateEntry(found->second).markedForDeletion = true;
+        _hasRemovedUpdates = true;
+        _updateSlotsByTarget.erase(found);
+    }
 }
 
 void Scheduler::unscheduleAll(void)
@@ -573,45 +861,32 @@ void Scheduler::unscheduleAll(void)
 void Scheduler::unscheduleAllWithMinPriority(int minPriority)
 {
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    tHashTimerEntry *nextElement = nullptr;
-    for (element = _hashForTimers; element != nullptr;)
+    std::vector<void*> timerTargets;
+    timerTargets.reserve(_timerTargets.size());
+    for (const auto& element : _timerTargets)
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
-
-        element = nextElement;
+        timerTargets.push_back(element.first);
+    }
+    for (auto target : timerTargets)
+    {
+        unscheduleAllForTarget(target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
-    {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    auto unscheduleEntries = [this, minPriority](std::vector<UpdateEntry>& entries) {
+        for (const auto& entry : entries)
         {
-            if(entry->priority >= minPriority)
+            if (!entry.markedForDeletion && entry.priority >= minPriority)
             {
-                unscheduleUpdate(entry->target);
+                unscheduleUpdate(entry.target);
             }
         }
-    }
-
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    };
+    for (auto& list : _updateLists)
     {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        unscheduleEntries(list);
     }
+    unscheduleEntries(_stagedUpdates);
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
 #endif
@@ -626,27 +901,17 @@ void Scheduler::unscheduleAllForTarget(void *target)
     }
 
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto element = _timerTargets.find(target);
+    if (element != _timerTargets.end())
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
-        {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
+        // the timers added back by the current callback start after the index of the current timer
+        int currentTimerIndex = _currentTimerIndex;
+        auto timers = element->second.timers;
+        for (int slot : timers)
         {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
+            removeTimer(slot);
         }
+        _currentTimerIndex = currentTimerIndex;
     }
 
     // update selector
@@ -681,20 +946,13 @@ void Scheduler::resumeTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
-    {
-        element->paused = false;
-    }
+    pauseTimers(target, false);
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    auto found = _updateSlotsByTarget.find(target);
+    if (found != _updateSlotsByTarget.end())
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        getUpdateEntry(found->second).paused = false;
     }
 }
 
@@ -703,20 +961,13 @@ void Scheduler::pauseTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
-    {
-        element->paused = true;
-    }
+    pauseTimers(target, true);
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    auto found = _updateSlotsByTarget.find(target);
+    if (found != _updateSlotsByTarget.end())
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        getUpdateEntry(found->second).paused = true;
     }
 }
 
@@ -725,21 +976,19 @@ bool Scheduler::isTargetPaused(void *target)
     CCASSERT( target != nullptr, "target must be non nil" );
 
     // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
+    auto element = _timerTargets.find(target);
+    if (element != _timerTargets.end())
     {
-        return element->paused;
+        return element->second.paused;
     }
-    
+
     // We should check update selectors if target does not have custom selectors
-	tHashUpdateEntry *elementUpdate = nullptr;
-	HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-	if ( elementUpdate )
+    auto found = _updateSlotsByTarget.find(target);
+    if (found != _updateSlotsByTarget.end())
     {
-		return elementUpdate->entry->paused;
+        return getUpdateEntry(found->second).paused;
     }
-    
+
     return false;  // should never get here
 }
 
@@ -753,44 +1002,31 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     std::set<void*> idsWithSelectors;
 
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (const auto& element : _timerTargets)
     {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+        idsWithSelectors.insert(element.first);
+    }
+    for (auto target : idsWithSelectors)
+    {
+        pauseTimers(target, true);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
-    {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+    auto pauseEntries = [&idsWithSelectors, minPriority](std::vector<UpdateEntry>& entries) {
+        for (auto& entry : entries)
         {
-            if(entry->priority >= minPriority)
+            if (!entry.markedForDeletion && entry.priority >= minPriority)
             {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
+                entry.paused = true;
+                idsWithSelectors.insert(entry.target);
             }
         }
-    }
-
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
+    };
+    for (auto& list : _updateLists)
     {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
+        pauseEntries(list);
     }
+    pauseEntries(_stagedUpdates);
 
     return idsWithSelectors;
 }
@@ -820,8 +1056,6 @@ void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 // main loop
 void Scheduler::update(float dt)
 {
-    _updateHashLocked = true;
-
     if (_timeScale != 1.0f)
     {
         dt *= _timeScale;
@@ -831,83 +1065,23 @@ void Scheduler::update(float dt)
     // Selector callbacks
     //
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
-
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
+    // add and remove the updates scheduled and unscheduled since the last tick
+    applyStagedUpdates();
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // Iterate over all the Updates' selectors, with priority < 0, == 0 and > 0
+    for (auto& list : _updateLists)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        for (auto& entry : list)
         {
-            entry->callback(dt);
-        }
-    }
-
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            if ((! entry.paused) && (! entry.markedForDeletion))
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
+                entry.callback(dt);
             }
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
     }
- 
-    // delete all updates that are removed in update
-    for (auto &e : _updateDeleteVector)
-        delete e;
-
-    _updateDeleteVector.clear();
 
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
+    // Fire the due custom selectors
+    updateTimers(dt);
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -953,49 +1127,17 @@ void Scheduler::update(float dt)
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
 {
     CCASSERT(target, "Argument target must be non-nullptr");
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (! element)
-    {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-        
-        HASH_ADD_PTR(_hashForTimers, target, element);
-        
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
-    }
-    else
-    {
-        CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
-    
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
+
+    int slot = findTimer(target, "", selector);
+    if (slot >= 0)
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
-            {
-                CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
-                return;
-            }
-        }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
+        CCASSERT(_timerTargets[target].paused == paused, "element's paused should be paused.");
+        CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", _timers[slot].interval, interval);
+        setTimerInterval(slot, interval);
+        return;
     }
-    
-    TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
-    timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+
+    addTimer(nullptr, selector, target, "", interval, repeat, delay, paused);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1007,35 +1149,8 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, Ref *target)
 {
     CCASSERT(selector, "Argument selector must be non-nullptr");
     CCASSERT(target, "Argument target must be non-nullptr");
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
-    {
-        return false;
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
-            {
-                return true;
-            }
-        }
-        
-        return false;
-    }
-    
-    return false;  // should never get here
+
+    return findTimer(target, "", selector) >= 0;
 }
 
 void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
@@ -1045,50 +1160,11 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
     {
         return;
     }
-    
-    //CCASSERT(target);
-    //CCASSERT(selector);
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (element)
+
+    int slot = findTimer(target, "", selector);
+    if (slot >= 0)
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
-            {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-                
-                return;
-            }
-        }
+        removeTimer(slot);
     }
 }
 
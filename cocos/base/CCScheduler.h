@@ -31,6 +31,9 @@ THE SOFTWARE.
 #include <functional>
 #include <mutex>
 #include <set>
+#include <deque>
+#include <vector>
+#include <unordered_map>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
@@ -141,10 +144,6 @@ private:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
 #endif
@@ -159,6 +158,10 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+The update selectors are stored contiguously, sorted by priority, and the timers of the custom selectors are kept
+in a hierarchical timing wheel, so a frame only visits the timers which fire. The update selectors
+scheduled while the scheduler is ticking are first called in the next frame.
+
 */
 class CC_DLL Scheduler : public Ref
 {
@@ -508,32 +511,116 @@ protected:
      */
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
-
-    // update specific
-
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    // an update selector, in a list sorted by priority
+    struct UpdateEntry
+    {
+        ccSchedulerFunc callback;
+        void* target;
+        int priority;
+        int slot;                   // index in _updateSlots
+        bool paused;
+        bool markedForDeletion;     // not called anymore, removed from its list at the start of the next tick
+    };
+
+    // where the update entry of a target is, the slots are stable while the entries move in their lists
+    struct UpdateSlot
+    {
+        int list;                   // index in _updateLists, UPDATE_STAGED if in _stagedUpdates, or UPDATE_FREE
+        int index;                  // index in the list, or next free slot
+    };
 
+    // a timer of a custom selector, in a slot of _timers
+    struct TimerEntry
+    {
+        ccSchedulerFunc callback;
+        SEL_SCHEDULE selector;      // used instead of callback if not null, target is then a Ref
+        std::string key;
+        void* target;
+        double base;                // the value of _timerClock when the elapsed time of the timer was 0
+        float elapsed;              // the elapsed time, while the timer is paused
+        float interval;
+        float delay;
+        unsigned int repeat;
+        unsigned int timesExecuted;
+        unsigned int generation;    // incremented when the timer is freed, paused or moved in the wheel
+        unsigned int order;         // order of creation, the due timers are fired in the order of their targets, then of creation
+        unsigned int targetOrder;
+        bool runForever;
+        bool useDelay;
+        bool started;               // false until the first tick after it was scheduled, which starts counting its time
+        bool used;
+    };
+
+    // a generation handle of a timer, stale once the generation of the timer changed
+    struct TimerHandle
+    {
+        double due;                 // in _startingTimers, the ticks to skip before starting the timer
+        unsigned long long order;   // order of the target in the high bits, of the timer in the low ones
+        int slot;
+        unsigned int generation;
+    };
+
+    // the timers of a target, in the order they were scheduled
+    struct TimerTarget
+    {
+        std::vector<int> timers;
+        unsigned int order;
+        bool paused;
+    };
+
+    void applyStagedUpdates();
+    UpdateEntry& getUpdateEntry(int slot);
+
+    int findTimer(void* target, const std::string& key, SEL_SCHEDULE selector);
+    void addTimer(const ccSchedulerFunc& callback, SEL_SCHEDULE selector, void* target, const std::string& key,
+                  float interval, unsigned int repeat, float delay, bool paused);
+    void setTimerInterval(int slot, float interval);
+    void removeTimer(int slot);
+    void freeTimer(int slot);
+    void pushTimer(int slot);
+    void insertTimer(const TimerHandle& handle);
+    void collectDueTimers(std::vector<TimerHandle>& wheelSlot);
+    void pauseTimers(void* target, bool paused);
+    void runTimer(int slot);
+    void updateTimers(float dt);
 
     float _timeScale;
 
-    //
-    // "updates with priority" stuff
-    //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
-    std::vector<struct _listEntry *> _updateDeleteVector; // the vector holds list entries that needs to be deleted after update
-
-    // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
-    bool _updateHashLocked;
+    // update selectors with priority < 0, == 0 and > 0, most of them are 0 and are only appended
+    std::vector<UpdateEntry> _updateLists[3];
+    // update selectors scheduled since the last tick, added to their list at the start of the next one
+    std::vector<UpdateEntry> _stagedUpdates;
+    std::vector<UpdateSlot> _updateSlots;
+    int _freeUpdateSlot;
+    std::unordered_map<void*, int> _updateSlotsByTarget;
+    bool _hasRemovedUpdates;
+
+    // the timers, in a deque so that a timer isn't moved while its callback runs
+    std::deque<TimerEntry> _timers;
+    std::vector<int> _freeTimers;
+    std::unordered_map<void*, TimerTarget> _timerTargets;
+    unsigned int _timerOrder;
+    // the started and not paused timers, in the slots of a hierarchical timing wheel by due tick
+    static const int TIMER_WHEEL_LEVELS = 4;
+    static const int TIMER_WHEEL_SLOT_BITS = 6;
+    static const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+    std::vector<TimerHandle> _timerWheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    std::vector<TimerHandle> _cascadedTimers;
+    long long _timerWheelTick;
+    // the timers already due when pushed, fired by the next tick
+    std::vector<TimerHandle> _lateTimers;
+    // the timers scheduled and not started yet
+    std::vector<TimerHandle> _startingTimers;
+    // the timers fired by the tick, and the ones that became due after the tick went past them
+    std::vector<TimerHandle> _dueTimers;
+    std::vector<TimerHandle> _passedTimers;
+    // sum of the time scaled dt of the ticks
+    double _timerClock;
+    // the timer whose callback runs, freed once it returns if unscheduled by it
+    int _currentTimer;
+    bool _currentTimerSalvaged;
+    // index of the current timer in the timers of its target, the timers added before it start next tick
+    int _currentTimerIndex;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
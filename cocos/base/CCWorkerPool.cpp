@@ -0,0 +1,175 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCWorkerPool.h"
+
+#include <algorithm>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+WorkerPool* WorkerPool::s_workerPool = nullptr;
+
+// true while the current thread runs a task, nested parallelFor() calls run serially
+static thread_local bool s_isRunningTask = false;
+
+WorkerPool* WorkerPool::getInstance()
+{
+    if (s_workerPool == nullptr)
+    {
+        s_workerPool = new (std::nothrow) WorkerPool();
+    }
+    return s_workerPool;
+}
+
+void WorkerPool::destroyInstance()
+{
+    delete s_workerPool;
+    s_workerPool = nullptr;
+}
+
+bool WorkerPool::isRunningTask()
+{
+    return s_isRunningTask;
+}
+
+WorkerPool::WorkerPool()
+: _batchGeneration(0)
+, _stop(false)
+{
+    int threadCount = (int)std::thread::hardware_concurrency();
+    startThreads(std::max(threadCount, 1) - 1);
+}
+
+WorkerPool::~WorkerPool()
+{
+    stopThreads();
+}
+
+void WorkerPool::setThreadCount(int threadCount)
+{
+    CCASSERT(!s_isRunningTask, "Can't change the thread count from a task");
+    std::lock_guard<std::mutex> dispatchLock(_dispatchMutex);
+
+    threadCount = std::max(threadCount, 1);
+    if (threadCount == getThreadCount())
+        return;
+
+    stopThreads();
+    startThreads(threadCount - 1);
+}
+
+void WorkerPool::startThreads(int workerCount)
+{
+    _stop = false;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        _threads.emplace_back([this]{
+            unsigned int generation = 0;
+            for (;;)
+            {
+                std::shared_ptr<Batch> batch;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _wakeCondition.wait(lock, [&]{ return _stop || _batchGeneration != generation; });
+                    if (_stop)
+                        return;
+                    generation = _batchGeneration;
+                    batch = _batch;
+                }
+                if (batch)
+                    runBatch(batch.get());
+            }
+        });
+    }
+}
+
+void WorkerPool::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void WorkerPool::runBatch(Batch* batch)
+{
+    s_isRunningTask = true;
+    for (int index = batch->next++; index < batch->count; index = batch->next++)
+    {
+        (*batch->task)(index);
+        if (--batch->pending == 0)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _doneCondition.notify_all();
+        }
+    }
+    s_isRunningTask = false;
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0)
+        return;
+
+    if (count == 1 || _threads.empty() || s_isRunningTask)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(_dispatchMutex);
+
+    auto batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->count = count;
+    batch->next = 0;
+    batch->pending = count;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _batch = batch;
+        ++_batchGeneration;
+    }
+    _wakeCondition.notify_all();
+
+    runBatch(batch.get());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [&]{ return batch->pending == 0; });
+    // workers which did not wake up yet will find no index left in this batch
+    _batch = nullptr;
+}
+
+NS_CC_END
@@ -0,0 +1,126 @@
+/****************************************************************************
+Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_WORKER_POOL_H_
+#define __CC_WORKER_POOL_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+/**
+* @addtogroup base
+* @{
+*/
+NS_CC_BEGIN
+
+/**
+ * @class WorkerPool
+ * @brief A pool of threads used to split per-frame work (e.g. visiting independent subtrees) across cores.
+ *
+ * Unlike AsyncTaskPool, the work submitted to the pool is waited for: parallelFor() returns when all the
+ * tasks have finished, and the calling thread takes part in running them.
+ * @js NA
+ */
+class CC_DLL WorkerPool
+{
+public:
+    /**
+     * Returns the shared instance of the worker pool.
+     */
+    static WorkerPool* getInstance();
+
+    /**
+     * Destroys the worker pool.
+     */
+    static void destroyInstance();
+
+    /**
+     * Returns the number of threads running the tasks of parallelFor(), including the calling thread.
+     */
+    int getThreadCount() const { return (int)_threads.size() + 1; }
+
+    /**
+     * Sets the number of threads running the tasks of parallelFor(), including the calling thread.
+     * By default it is the number of hardware threads. Must not be called from a task.
+     *
+     * @param threadCount Number of threads, 1 runs every task on the calling thread.
+     */
+    void setThreadCount(int threadCount);
+
+    /**
+     * Runs `task(index)` for every index in [0, count) and returns when all of them have finished.
+     * Tasks may run concurrently and in any order. Calling parallelFor() from a task runs the nested tasks serially.
+     *
+     * @param count Number of tasks.
+     * @param task The task, called with the index of the task.
+     */
+    void parallelFor(int count, const std::function<void(int)>& task);
+
+    /**
+     * Returns true if the calling thread is running a task of parallelFor().
+     */
+    static bool isRunningTask();
+
+CC_CONSTRUCTOR_ACCESS:
+    WorkerPool();
+    ~WorkerPool();
+
+protected:
+    struct Batch
+    {
+        const std::function<void(int)>* task;
+        int count;
+        std::atomic<int> next;
+        std::atomic<int> pending;
+    };
+
+    void startThreads(int workerCount);
+    void stopThreads();
+    void runBatch(Batch* batch);
+
+    std::vector<std::thread> _threads;
+    std::shared_ptr<Batch> _batch;
+    unsigned int _batchGeneration;
+    bool _stop;
+
+    // serializes the callers of parallelFor()
+    std::mutex _dispatchMutex;
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _doneCondition;
+
+    static WorkerPool* s_workerPool;
+};
+
+NS_CC_END
+// end group
+/// @}
+#endif //__CC_WORKER_POOL_H_
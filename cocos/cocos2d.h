@@ -39,6 +39,10 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
+#include "base/CCMappedFile.h"
+#include "base/CCMappedZipFile.h"
+#include "base/CCWorkerPool.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -113,6 +117,7 @@ THE SOFTWARE.
 #include "2d/CCClippingRectangleNode.h"
 #include "2d/CCDrawNode.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCFontBaked.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCLabel.h"
 #include "2d/CCLabelAtlas.h"
@@ -126,6 +131,7 @@ THE SOFTWARE.
 #include "2d/CCNodeGrid.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleExamples.h"
+#include "2d/CCParticleKernels.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleSystemQuad.h"
 #include "2d/CCProgressTimer.h"
@@ -168,6 +174,8 @@ THE SOFTWARE.
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCVertexAttribBinding.h"
 #include "renderer/CCVertexIndexBuffer.h"
+#include "renderer/CCStreamBuffer.h"
+#include "renderer/CCInstanceBuffer.h"
 #include "renderer/CCVertexIndexData.h"
 #include "renderer/CCFrameBuffer.h"
 #include "renderer/ccGLStateCache.h"
@@ -256,6 +264,7 @@ THE SOFTWARE.
 #include "2d/CCAnimation.h"
 #include "2d/CCAnimationCache.h"
 #include "2d/CCSprite.h"
+#include "2d/CCSpatialIndex.h"
 #include "2d/CCAutoPolygon.h"
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
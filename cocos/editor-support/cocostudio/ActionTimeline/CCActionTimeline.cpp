@@ -25,6 +25,8 @@ THE SOFTWARE.
 #include "editor-support/cocostudio/ActionTimeline/CCActionTimeline.h"
 
 #include "editor-support/cocostudio/CCComExtensionData.h"
+#include <algorithm>
+#include <typeinfo>
 
 USING_NS_CC;
 
@@ -434,11 +436,83 @@ void ActionTimeline::gotoFrame(int frameIndex)
 
 void ActionTimeline::stepToFrame(int frameIndex)
 {
+    // The exact bulk easing is tweenTo() one by one, so the frames ease themselves. Otherwise the
+    // frames sharing a curve are eased ahead in bulk, and Frame::tweenPercent() picks them up.
+    if (tweenfunc::getEasingPrecision() != tweenfunc::EasingPrecision::EXACT)
+    {
+        easeSteppedKeyFrames(frameIndex);
+    }
+
     ssize_t size = _timelineList.size();
     for(ssize_t i = 0; i < size; i++)
     {      
         _timelineList.at(i)->stepToFrame(frameIndex);
     }
+
+    // in case an apply() override did not ease its percent
+    for (auto frame : _easedFrames)
+    {
+        frame->_hasEasedPercent = false;
+    }
+    _easedFrames.clear();
+}
+
+void ActionTimeline::easeSteppedKeyFrames(int frameIndex)
+{
+    _easedFrames.clear();
+
+    // only the timelines staying on their key frame, the others enter frames while stepping
+    ssize_t size = _timelineList.size();
+    for (ssize_t i = 0; i < size; i++)
+    {
+        Timeline* timeline = _timelineList.at(i);
+        if (typeid(*timeline) != typeid(Timeline))
+            continue;
+
+        Frame* frame = timeline->getSteppedKeyFrame(frameIndex);
+        if (frame == nullptr || !frame->isTween())
+            continue;
+
+        auto tweenType = frame->getTweenType();
+        if (tweenType == tweenfunc::TWEEN_EASING_MAX || tweenType == tweenfunc::Linear)
+            continue;
+
+        frame->_easedFrom = timeline->getCurrentKeyFramePercent(frameIndex);
+        _easedFrames.push_back(frame);
+    }
+
+    std::sort(_easedFrames.begin(), _easedFrames.end(), [](Frame* a, Frame* b) {
+        if (a->getTweenType() != b->getTweenType())
+            return a->getTweenType() < b->getTweenType();
+        return a->getEasingParams() < b->getEasingParams();
+    });
+
+    size_t easedCount = _easedFrames.size();
+    size_t first = 0;
+    while (first < easedCount)
+    {
+        auto tweenType = _easedFrames[first]->getTweenType();
+        const std::vector<float>& easingParams = _easedFrames[first]->getEasingParams();
+        size_t last = first + 1;
+        while (last < easedCount
+            && _easedFrames[last]->getTweenType() == tweenType
+            && _easedFrames[last]->getEasingParams() == easingParams)
+        {
+            ++last;
+        }
+
+        _easedPercents.resize(last - first);
+        for (size_t k = first; k < last; ++k)
+            _easedPercents[k - first] = _easedFrames[k]->_easedFrom;
+        tweenfunc::tweenTo(_easedPercents.data(), _easedPercents.data(), _easedPercents.size(), tweenType, const_cast<float*>(easingParams.data()));
+        for (size_t k = first; k < last; ++k)
+        {
+            _easedFrames[k]->_easedPercent = _easedPercents[k - first];
+            _easedFrames[k]->_hasEasedPercent = true;
+        }
+
+        first = last;
+    }
 }
 
 void ActionTimeline::start()
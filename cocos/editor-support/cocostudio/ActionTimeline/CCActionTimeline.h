@@ -207,6 +207,8 @@ public:
 protected:
     virtual void gotoFrame(int frameIndex);
     virtual void stepToFrame(int frameIndex);
+    // eases ahead the key frames stepToFrame stays on, in bulk for the ones sharing a curve
+    void easeSteppedKeyFrames(int frameIndex);
 
     // emit call back after frameIndex played
     virtual void emitFrameEndCallFuncs(int frameIndex);
@@ -231,6 +233,10 @@ protected:
     std::function<void()> _lastFrameListener;
     std::map<int, std::map<std::string, std::function<void()> > > _frameEndCallFuncs;
     std::map<std::string, AnimationInfo> _animationInfos;
+
+    // the key frames eased in bulk by stepToFrame, sorted by easing, with their percents
+    std::vector<Frame*> _easedFrames;
+    std::vector<float> _easedPercents;
 };
 
 NS_TIMELINE_END
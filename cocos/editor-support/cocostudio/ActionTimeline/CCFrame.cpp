@@ -39,6 +39,9 @@ Frame::Frame()
     : _frameIndex(0)
     , _tween(true)
     , _enterWhenPassed(false)
+    , _hasEasedPercent(false)
+    , _easedFrom(0)
+    , _easedPercent(0)
     , _tweenType(tweenfunc::TweenType::Linear)
     , _timeline(nullptr)
     , _node(nullptr)
@@ -83,6 +86,12 @@ void Frame::apply(float percent)
 
 float Frame::tweenPercent(float percent)
 {
+    if (_hasEasedPercent)
+    {
+        _hasEasedPercent = false;
+        if (percent == _easedFrom)
+            return _easedPercent;
+    }
     return tweenfunc::tweenTo(percent, _tweenType, _easingParam.data());
 }
 
@@ -83,11 +83,17 @@ protected:
     unsigned int    _frameIndex;
     bool            _tween;
     bool            _enterWhenPassed;
+    // the next tweenPercent() of _easedFrom returns _easedPercent, eased in bulk by the ActionTimeline
+    bool            _hasEasedPercent;
+    float           _easedFrom;
+    float           _easedPercent;
     
     cocos2d::tweenfunc::TweenType _tweenType;
     std::vector<float>   _easingParam;
     Timeline* _timeline;
     cocos2d::Node*  _node;
+
+    friend class ActionTimeline;
 };
 
 
@@ -124,11 +124,24 @@ void Timeline::apply(unsigned int frameIndex)
 {
     if (_currentKeyFrame)
     {
-        float currentPercent = _betweenDuration == 0 ? 0 : (frameIndex - _currentKeyFrameIndex) / (float)_betweenDuration;
-        _currentKeyFrame->apply(currentPercent);
+        _currentKeyFrame->apply(getCurrentKeyFramePercent(frameIndex));
     }
 }
 
+float Timeline::getCurrentKeyFramePercent(unsigned int frameIndex) const
+{
+    return _betweenDuration == 0 ? 0 : (frameIndex - _currentKeyFrameIndex) / (float)_betweenDuration;
+}
+
+Frame* Timeline::getSteppedKeyFrame(unsigned int frameIndex) const
+{
+    // as updateCurrentKeyFrame() leaves the key frame alone
+    if (_frames.size() == 0 || frameIndex < _currentKeyFrameIndex || frameIndex >= _currentKeyFrameIndex + _betweenDuration)
+        return nullptr;
+
+    return _currentKeyFrame;
+}
+
 void Timeline::binarySearchKeyFrame(unsigned int frameIndex)
 {
     Frame *from = nullptr;
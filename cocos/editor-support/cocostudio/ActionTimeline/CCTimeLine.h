@@ -63,6 +63,9 @@ public:
 
 protected:
     virtual void apply(unsigned int frameIndex);
+    float getCurrentKeyFramePercent(unsigned int frameIndex) const;
+    // the current key frame, when stepping to frameIndex stays on it and does not enter any frame
+    Frame* getSteppedKeyFrame(unsigned int frameIndex) const;
 
     virtual void binarySearchKeyFrame (unsigned int frameIndex);
     virtual void updateCurrentKeyFrame(unsigned int frameIndex);
@@ -78,6 +81,8 @@ protected:
 
     ActionTimeline*  _ActionTimeline;
     cocos2d::Node* _node;
+
+    friend class ActionTimeline;
 };
 
 NS_TIMELINE_END
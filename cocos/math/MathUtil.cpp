@@ -19,6 +19,7 @@ This file was modified to fit the cocos2d-x project
 */
 
 #include "math/MathUtil.h"
+#include <string.h>
 #include "base/ccMacros.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -275,4 +276,68 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::transformVec3Array(const float* m, float* positions, size_t stride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVec3Array(m, positions, stride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVec3Array(m, positions, stride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVec3Array(m, positions, stride, count);
+    else MathUtilC::transformVec3Array(m, positions, stride, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformVec3Array(m, positions, stride, count);
+#else
+    MathUtilC::transformVec3Array(m, positions, stride, count);
+#endif
+}
+
+void MathUtil::transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVec3Array(m, src, dst, stride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVec3Array(m, src, dst, stride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVec3Array(m, src, dst, stride, count);
+    else MathUtilC::transformVec3Array(m, src, dst, stride, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformVec3Array(m, src, dst, stride, count);
+#else
+    MathUtilC::transformVec3Array(m, src, dst, stride, count);
+#endif
+}
+
+void MathUtil::rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::rebaseIndices(src, offset, count, dst);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::rebaseIndices(src, offset, count, dst);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::rebaseIndices(src, offset, count, dst);
+    else MathUtilC::rebaseIndices(src, offset, count, dst);
+#elif defined (USE_SSE)
+    MathUtilSSE::rebaseIndices(src, offset, count, dst);
+#else
+    MathUtilC::rebaseIndices(src, offset, count, dst);
+#endif
+}
+
+void MathUtil::multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::multiplyMatrixArray(m, src, count, dst);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::multiplyMatrixArray(m, src, count, dst);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::multiplyMatrixArray(m, src, count, dst);
+    else MathUtilC::multiplyMatrixArray(m, src, count, dst);
+#elif defined (USE_SSE)
+    MathUtilSSE::multiplyMatrixArray(m, src, count, dst);
+#else
+    MathUtilC::multiplyMatrixArray(m, src, count, dst);
+#endif
+}
+
 NS_CC_MATH_END
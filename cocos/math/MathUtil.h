@@ -87,6 +87,57 @@ public:
      * @return interpolated float value
      */
     static float lerp(float from, float to, float alpha);
+
+    /**
+     * Transforms a strided stream of 3D points in place by the given matrix,
+     * treating each point as (x, y, z, 1).
+     *
+     * This is used to transform batched vertices (e.g. V3F_C4B_T2F) in bulk.
+     *
+     * @param m the column major matrix to transform with.
+     * @param positions pointer to the x component of the first point.
+     * @param stride distance in bytes between two consecutive points.
+     * @param count number of points to transform.
+     */
+    static void transformVec3Array(const float* m, float* positions, size_t stride, size_t count);
+
+    /**
+     * Copies a strided stream of 3D points, transforming them by the given matrix,
+     * treating each point as (x, y, z, 1). The bytes following each point in its
+     * stride are copied unchanged, and dst is only written to.
+     *
+     * This is used to write batched vertices into memory that must not be read back,
+     * like a mapped buffer object.
+     *
+     * @param m the column major matrix to transform with.
+     * @param src pointer to the x component of the first point to copy.
+     * @param dst pointer to the x component of the first point written, which must not overlap src.
+     * @param stride distance in bytes between two consecutive points, at least 3 floats.
+     * @param count number of points to copy.
+     */
+    static void transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count);
+
+    /**
+     * Copies an array of indices, adding the same offset to each of them.
+     *
+     * @param src the indices to copy.
+     * @param offset the value added to every index.
+     * @param count number of indices to copy.
+     * @param dst the destination array, which may be the same as src.
+     */
+    static void rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst);
+
+    /**
+     * Multiplies the same matrix by each matrix of an array, dst[i] = m * src[i].
+     *
+     * This is used to compute the transforms of many nodes sharing a parent in one pass.
+     *
+     * @param m the column major matrix on the left of the products.
+     * @param src the array of column major matrices, 16 floats each.
+     * @param count number of matrices in src.
+     * @param dst the array receiving the products, which must not overlap src.
+     */
+    static void multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -42,6 +42,14 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformVec3Array(const float* m, float* positions, size_t stride, size_t count);
+
+    inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count);
+
+    inline static void rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst);
+
+    inline static void multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +223,55 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::transformVec3Array(const float* m, float* positions, size_t stride, size_t count)
+{
+    unsigned char* p = reinterpret_cast<unsigned char*>(positions);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* v = reinterpret_cast<float*>(p);
+        float x = v[0];
+        float y = v[1];
+        float z = v[2];
+
+        v[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        v[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        v[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+}
+
+inline void MathUtilC::transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+    unsigned char* d = reinterpret_cast<unsigned char*>(dst);
+    for (size_t i = 0; i < count; ++i, s += stride, d += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(s);
+        float* r = reinterpret_cast<float*>(d);
+        float x = v[0];
+        float y = v[1];
+        float z = v[2];
+
+        r[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        r[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        r[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+        memcpy(d + sizeof(float) * 3, s + sizeof(float) * 3, stride - sizeof(float) * 3);
+    }
+}
+
+inline void MathUtilC::rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilC::multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        multiplyMatrix(m, src + i * 16, dst + i * 16);
+    }
+}
+
 NS_CC_MATH_END
@@ -18,6 +18,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon64
@@ -42,6 +44,14 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformVec3Array(const float* m, float* positions, size_t stride, size_t count);
+
+    inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count);
+
+    inline static void rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst);
+
+    inline static void multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst);
 };
 
 inline void MathUtilNeon64::addMatrix(const float* m, float scalar, float* dst)
@@ -262,4 +272,70 @@ inline void MathUtilNeon64::crossVec3(const float* v1, const float* v2, float* d
     );
 }
 
+inline void MathUtilNeon64::transformVec3Array(const float* m, float* positions, size_t stride, size_t count)
+{
+    const float32x4_t c0 = vld1q_f32(m);
+    const float32x4_t c1 = vld1q_f32(m + 4);
+    const float32x4_t c2 = vld1q_f32(m + 8);
+    const float32x4_t c3 = vld1q_f32(m + 12);
+
+    unsigned char* p = reinterpret_cast<unsigned char*>(positions);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* v = reinterpret_cast<float*>(p);
+        float32x4_t r = vmlaq_n_f32(c3, c0, v[0]);   // M[m12-m15] + M[m0-m3] * V[x]
+        r = vmlaq_n_f32(r, c1, v[1]);                 // += M[m4-m7] * V[y]
+        r = vmlaq_n_f32(r, c2, v[2]);                 // += M[m8-m11] * V[z]
+
+        vst1_f32(v, vget_low_f32(r));                 // V[x, y]
+        vst1q_lane_f32(v + 2, r, 2);                  // V[z]
+    }
+}
+
+inline void MathUtilNeon64::transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+    const float32x4_t c0 = vld1q_f32(m);
+    const float32x4_t c1 = vld1q_f32(m + 4);
+    const float32x4_t c2 = vld1q_f32(m + 8);
+    const float32x4_t c3 = vld1q_f32(m + 12);
+
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+    unsigned char* d = reinterpret_cast<unsigned char*>(dst);
+    for (size_t i = 0; i < count; ++i, s += stride, d += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(s);
+        float* w = reinterpret_cast<float*>(d);
+        float32x4_t r = vmlaq_n_f32(c3, c0, v[0]);   // M[m12-m15] + M[m0-m3] * V[x]
+        r = vmlaq_n_f32(r, c1, v[1]);                 // += M[m4-m7] * V[y]
+        r = vmlaq_n_f32(r, c2, v[2]);                 // += M[m8-m11] * V[z]
+
+        vst1_f32(w, vget_low_f32(r));                 // W[x, y]
+        vst1q_lane_f32(w + 2, r, 2);                  // W[z]
+        memcpy(d + sizeof(float) * 3, s + sizeof(float) * 3, stride - sizeof(float) * 3);
+    }
+}
+
+inline void MathUtilNeon64::rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst)
+{
+    const uint16x8_t o = vdupq_n_u16(offset);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), o));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilNeon64::multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        multiplyMatrix(m, src + i * 16, dst + i * 16);
+    }
+}
+
 NS_CC_MATH_END
@@ -1,3 +1,7 @@
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
 #ifdef __SSE__
@@ -151,6 +155,102 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+class MathUtilSSE
+{
+public:
+    inline static void transformVec3Array(const float* m, float* positions, size_t stride, size_t count);
+
+    inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count);
+
+    inline static void rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst);
+
+    inline static void multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst);
+};
+
+inline void MathUtilSSE::transformVec3Array(const float* m, float* positions, size_t stride, size_t count)
+{
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+
+    unsigned char* p = reinterpret_cast<unsigned char*>(positions);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* v = reinterpret_cast<float*>(p);
+
+        // only x, y and z are loaded, the point may be followed by other attributes
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(c0, _mm_load1_ps(v)), _mm_mul_ps(c1, _mm_load1_ps(v + 1))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_load1_ps(v + 2)), c3)
+                              );
+
+        _mm_storel_pi(reinterpret_cast<__m64*>(v), r);
+        _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+    }
+}
+
+inline void MathUtilSSE::transformVec3Array(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+    unsigned char* d = reinterpret_cast<unsigned char*>(dst);
+    for (size_t i = 0; i < count; ++i, s += stride, d += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(s);
+        float* w = reinterpret_cast<float*>(d);
+
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(c0, _mm_load1_ps(v)), _mm_mul_ps(c1, _mm_load1_ps(v + 1))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_load1_ps(v + 2)), c3)
+                              );
+
+        _mm_storel_pi(reinterpret_cast<__m64*>(w), r);
+        _mm_store_ss(w + 2, _mm_movehl_ps(r, r));
+        memcpy(d + sizeof(float) * 3, s + sizeof(float) * 3, stride - sizeof(float) * 3);
+    }
+}
+
+inline void MathUtilSSE::rebaseIndices(const unsigned short* src, unsigned short offset, size_t count, unsigned short* dst)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i o = _mm_set1_epi16(static_cast<short>(offset));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi16(v, o));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilSSE::multiplyMatrixArray(const float* m, const float* src, size_t count, float* dst)
+{
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+
+    for (size_t i = 0; i < count * 16; i += 4)
+    {
+        // each column of the product is m transforming the column of src
+        const float* s = src + i;
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(c0, _mm_load1_ps(s)), _mm_mul_ps(c1, _mm_load1_ps(s + 1))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_load1_ps(s + 2)), _mm_mul_ps(c3, _mm_load1_ps(s + 3)))
+                              );
+        _mm_storeu_ps(dst + i, r);
+    }
+}
+
 #endif
 
 
@@ -26,10 +26,12 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include <stack>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCMappedZipFile.h"
 #include "platform/CCSAXParser.h"
 //#include "base/ccUtils.h"
 
@@ -663,6 +665,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    Status status;
+    if (fs->getContentsFromArchive(fullPath, buffer, &status))
+        return status;
+
     FILE *fp = fopen(fs->getSuitableFOpen(fullPath).c_str(), "rb");
     if (!fp)
         return Status::OpenFailed;
@@ -799,6 +805,19 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     path += file_path;
     path += resolutionDirectory;
 
+    if (!_searchArchives.empty())
+    {
+        std::string fullPath = path;
+        if (!fullPath.empty() && fullPath[fullPath.size()-1] != '/')
+            fullPath += '/';
+        fullPath += file;
+
+        std::string name;
+        auto archive = findArchive(fullPath, &name);
+        if (archive)
+            return archive->fileExists(name) ? fullPath : "";
+    }
+
     path = getFullPathForDirectoryAndFilename(path, file);
 
     return path;
@@ -969,6 +988,94 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     }
 }
 
+bool FileUtils::addSearchArchive(const std::string& archivePath, const std::string& filter, bool front)
+{
+    for (const auto& searchArchive : _searchArchives)
+    {
+        if (searchArchive.path == archivePath)
+            return true;
+    }
+
+    std::string fullPath = fullPathForFilename(archivePath);
+    if (fullPath.empty())
+        return false;
+
+    auto archive = std::make_shared<MappedZipFile>();
+    if (!archive->open(fullPath, filter))
+        return false;
+
+    SearchArchive searchArchive;
+    searchArchive.path = archivePath;
+    searchArchive.root = fullPath + "/";
+    searchArchive.archive = archive;
+    _searchArchives.push_back(searchArchive);
+
+    _fullPathCache.clear();
+    if (front) {
+        _searchPathArray.insert(_searchPathArray.begin(), searchArchive.root);
+    } else {
+        _searchPathArray.push_back(searchArchive.root);
+    }
+    return true;
+}
+
+void FileUtils::removeSearchArchive(const std::string& archivePath)
+{
+    for (auto it = _searchArchives.begin(); it != _searchArchives.end(); ++it)
+    {
+        if (it->path == archivePath)
+        {
+            auto root = std::find(_searchPathArray.begin(), _searchPathArray.end(), it->root);
+            if (root != _searchPathArray.end())
+                _searchPathArray.erase(root);
+            _searchArchives.erase(it);
+            _fullPathCache.clear();
+            return;
+        }
+    }
+}
+
+bool FileUtils::getFileView(const std::string& filename, const unsigned char** data, ssize_t* size) const
+{
+    if (_searchArchives.empty() || filename.empty())
+        return false;
+
+    std::string name;
+    auto archive = findArchive(fullPathForFilename(filename), &name);
+    return archive && archive->getFileView(name, data, size);
+}
+
+MappedZipFile* FileUtils::findArchive(const std::string& fullPath, std::string* name) const
+{
+    for (const auto& searchArchive : _searchArchives)
+    {
+        const std::string& root = searchArchive.root;
+        if (fullPath.size() > root.size() && fullPath.compare(0, root.size(), root) == 0)
+        {
+            name->assign(fullPath, root.size(), std::string::npos);
+            return searchArchive.archive.get();
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::getContentsFromArchive(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const
+{
+    if (_searchArchives.empty())
+        return false;
+
+    std::string name;
+    auto archive = findArchive(fullPath, &name);
+    if (!archive)
+        return false;
+
+    if (archive->getFileData(name, buffer))
+        *status = Status::OK;
+    else
+        *status = archive->fileExists(name) ? Status::ReadFailed : Status::NotExists;
+    return true;
+}
+
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
     _fullPathCache.clear();
@@ -1015,6 +1122,10 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::string name;
+        auto archive = findArchive(filename, &name);
+        if (archive)
+            return archive->fileExists(name);
         return isFileExistInternal(filename);
     }
     else
@@ -1317,6 +1428,11 @@ long FileUtils::getFileSize(const std::string &filepath)
             return 0;
     }
 
+    std::string name;
+    auto archive = findArchive(fullpath, &name);
+    if (archive)
+        return archive->getFileSize(name);
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
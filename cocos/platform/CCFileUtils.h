@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <memory>
 #include <type_traits>
 
 #include "platform/CCPlatformMacros.h"
@@ -40,6 +41,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class MappedZipFile;
+
 /**
  * @addtogroup platform
  * @{
@@ -454,6 +457,42 @@ public:
       */
     void addSearchPath(const std::string & path, const bool front=false);
 
+    /**
+     * Add a zip archive as a search path.
+     *
+     * The archive is memory mapped and its central directory is read once, so looking up a file in it
+     * is a hash lookup and files stored without compression are read straight from the mapping.
+     * Files in the archive are addressed as "<archive full path>/<name>", which is what fullPathForFilename returns for them.
+     *
+     * @note Mount and unmount archives on the cocos thread while no file is being loaded from them.
+     *       setSearchPaths() removes the archive from the search paths, call addSearchArchive() again afterwards.
+     * @param archivePath The path of the zip archive, it could be a relative or absolute path.
+     * @param filter Only the entries starting with this prefix are added, with the prefix stripped, e.g. "assets/".
+     * @param front Whether the archive is searched before the other search paths.
+     * @return True if the archive was opened.
+     */
+    bool addSearchArchive(const std::string& archivePath, const std::string& filter = "", bool front = false);
+
+    /**
+     * Remove a zip archive added by addSearchArchive and unmap it.
+     *
+     * @param archivePath The path that was passed to addSearchArchive.
+     */
+    void removeSearchArchive(const std::string& archivePath);
+
+    /**
+     * Get the bytes of a file without copying them.
+     *
+     * Only files stored without compression in an archive added by addSearchArchive can be viewed.
+     * The bytes stay valid until the archive is removed.
+     *
+     * @param filename The path of the file, it could be a relative or absolute path.
+     * @param data Set to the first byte of the file.
+     * @param size Set to the size of the file.
+     * @return True if the file could be viewed, use getContents otherwise.
+     */
+    bool getFileView(const std::string& filename, const unsigned char** data, ssize_t* size) const;
+
     /**
      *  Gets the array of search paths.
      *
@@ -852,6 +891,25 @@ protected:
      */
     virtual std::string getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename) const;
 
+    /**
+     *  Finds the archive added by addSearchArchive that contains a full path.
+     *
+     *  @param fullPath The full path of the file.
+     *  @param name Set to the name of the file in the archive.
+     *  @return The archive, or nullptr if the full path isn't in an archive.
+     */
+    MappedZipFile* findArchive(const std::string& fullPath, std::string* name) const;
+
+    /**
+     *  Reads a file from the archives added by addSearchArchive.
+     *
+     *  @param fullPath The full path of the file.
+     *  @param buffer The buffer the file is read to.
+     *  @param status Set to the result of the read if the full path is in an archive.
+     *  @return True if the full path is in an archive, false if the file should be read from the file system.
+     */
+    bool getContentsFromArchive(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const;
+
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
      *
@@ -873,6 +931,18 @@ protected:
      */
     std::vector<std::string> _searchPathArray;
 
+    struct SearchArchive
+    {
+        std::string path;
+        std::string root;
+        std::shared_ptr<MappedZipFile> archive;
+    };
+
+    /**
+     * The archives added by addSearchArchive, their roots are in _searchPathArray too.
+     */
+    std::vector<SearchArchive> _searchArchives;
+
     /**
      *  The default root path of resources.
      *  If the default root path of resources needs to be changed, do it in the `init` method of FileUtils's subclass.
@@ -271,6 +271,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
         relativePath = fullPath;
     }
     
+    FileUtils::Status status;
+    if (getContentsFromArchive(fullPath, buffer, &status))
+        return status;
+
     if (obbfile)
     {
         if (obbfile->getFileData(relativePath, buffer))
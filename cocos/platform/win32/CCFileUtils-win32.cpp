@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "platform/win32/CCFileUtils-win32.h"
 #include "platform/win32/CCUtils-win32.h"
+#include "base/CCMappedZipFile.h"
 #include "platform/CCCommon.h"
 #include <Shlobj.h>
 #include <cstdlib>
@@ -121,6 +122,14 @@ std::string FileUtilsWin32::getSuitableFOpen(const std::string& filenameUtf8) co
 
 long FileUtilsWin32::getFileSize(const std::string &filepath)
 {
+    if (!_searchArchives.empty())
+    {
+        std::string name;
+        auto archive = findArchive(isAbsolutePath(filepath) ? filepath : fullPathForFilename(filepath), &name);
+        if (archive)
+            return archive->getFileSize(name);
+    }
+
     WIN32_FILE_ATTRIBUTE_DATA fad;
     if (!GetFileAttributesEx(StringUtf8ToWideChar(filepath).c_str(), GetFileExInfoStandard, &fad))
     {
@@ -171,6 +180,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    FileUtils::Status status;
+    if (getContentsFromArchive(fullPath, buffer, &status))
+        return status;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <regex>
 #include "platform/winrt/CCWinRTUtils.h"
 #include "platform/CCCommon.h"
+#include "base/CCMappedZipFile.h"
 using namespace std;
 
 NS_CC_BEGIN
@@ -131,6 +132,14 @@ std::string CCFileUtilsWinRT::getSuitableFOpen(const std::string& filenameUtf8)
 
 long CCFileUtilsWinRT::getFileSize(const std::string &filepath)
 {
+    if (!_searchArchives.empty())
+    {
+        std::string name;
+        auto archive = findArchive(isAbsolutePath(filepath) ? filepath : fullPathForFilename(filepath), &name);
+        if (archive)
+            return archive->getFileSize(name);
+    }
+
     WIN32_FILE_ATTRIBUTE_DATA fad;
     if (!GetFileAttributesEx(StringUtf8ToWideChar(filepath).c_str(), GetFileExInfoStandard, &fad))
     {
@@ -150,6 +159,10 @@ FileUtils::Status CCFileUtilsWinRT::getContents(const std::string& filename, Res
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    FileUtils::Status status;
+    if (getContentsFromArchive(fullPath, buffer, &status))
+        return status;
+
     HANDLE fileHandle = ::CreateFile2(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
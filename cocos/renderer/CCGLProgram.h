@@ -215,11 +215,17 @@ public:
     static const char* SHADER_NAME_LABEL_OUTLINE;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_GLOW;
+    static const char* SHADER_NAME_LABEL_MSDF_NORMAL;
+    static const char* SHADER_NAME_LABEL_MSDF_GLOW;
 
     /**Built in shader used for 3D, support Position vertex attribute, with color specified by a uniform.*/
     static const char* SHADER_3D_POSITION;
     /**Built in shader used for 3D, support Position and Texture vertex attribute, with color specified by a uniform.*/
     static const char* SHADER_3D_POSITION_TEXTURE;
+    /**Built in shader used for 3D instancing, support Position vertex attribute, with a transform and a color per instance.*/
+    static const char* SHADER_3D_POSITION_INSTANCED;
+    /**Built in shader used for 3D instancing, support Position and Texture vertex attribute, with a transform and a color per instance.*/
+    static const char* SHADER_3D_POSITION_TEXTURE_INSTANCED;
     /**
     Built in shader used for 3D, support Position (Skeletal animation by hardware skin) and Texture vertex attribute,
     with color specified by a uniform.
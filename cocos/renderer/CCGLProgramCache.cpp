@@ -52,11 +52,15 @@ enum {
     kShaderType_PositionLengthTextureColor,
     kShaderType_LabelDistanceFieldNormal,
     kShaderType_LabelDistanceFieldGlow,
+    kShaderType_LabelMSDFNormal,
+    kShaderType_LabelMSDFGlow,
     kShaderType_UIGrayScale,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
+    kShaderType_3DPositionInstanced,
+    kShaderType_3DPositionTexInstanced,
     kShaderType_3DSkinPositionTex,
     kShaderType_3DPositionNormal,
     kShaderType_3DPositionNormalTex,
@@ -219,6 +223,14 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
     _programs.emplace(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelMSDFNormal);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_MSDF_NORMAL, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelMSDFGlow);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_MSDF_GLOW, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_UIGrayScale);
     _programs.emplace(GLProgram::SHADER_NAME_POSITION_GRAYSCALE, p);
@@ -239,6 +251,14 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_3DPositionTex);
     _programs.emplace(GLProgram::SHADER_3D_POSITION_TEXTURE, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_3DPositionInstanced);
+    _programs.emplace(GLProgram::SHADER_3D_POSITION_INSTANCED, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+    _programs.emplace(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
     _programs.emplace(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p);
@@ -386,6 +406,14 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_MSDF_NORMAL);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelMSDFNormal);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_MSDF_GLOW);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelMSDFGlow);
+
     p = getGLProgram(GLProgram::SHADER_NAME_POSITION_GRAYSCALE);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_UIGrayScale);
@@ -406,6 +434,14 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DPositionTex);
 
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionInstanced);
+
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+
     p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
@@ -538,6 +574,12 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LabelDistanceFieldGlow:
             p->initWithByteArrays(ccLabel_vert, ccLabelDistanceFieldGlow_frag);
             break;
+        case kShaderType_LabelMSDFNormal:
+            p->initWithByteArrays(ccLabel_vert, ccLabelMSDFNormal_frag);
+            break;
+        case kShaderType_LabelMSDFGlow:
+            p->initWithByteArrays(ccLabel_vert, ccLabelMSDFGlow_frag);
+            break;
         case kShaderType_UIGrayScale:
             p->initWithByteArrays(ccPositionTextureColor_noMVP_vert,
                                   ccPositionTexture_GrayScale_frag);
@@ -554,6 +596,12 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_3DPositionTex:
             p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_ColorTex_frag);
             break;
+        case kShaderType_3DPositionInstanced:
+            p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_Color_frag, "USE_INSTANCING");
+            break;
+        case kShaderType_3DPositionTexInstanced:
+            p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_ColorTex_frag, "USE_INSTANCING");
+            break;
         case kShaderType_3DSkinPositionTex:
             p->initWithByteArrays(cc3D_SkinPositionTex_vert, cc3D_ColorTex_frag);
             break;
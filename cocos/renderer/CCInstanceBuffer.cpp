@@ -0,0 +1,140 @@
+/****************************************************************************
+ Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+
+#include "renderer/CCInstanceBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/CCWorkerPool.h"
+
+NS_CC_BEGIN
+
+namespace {
+
+// the number of instances packed by a task of the WorkerPool
+const ssize_t INSTANCES_PER_TASK = 1024;
+
+}
+
+bool InstanceBuffer::BatchKey::operator==(const BatchKey& other) const
+{
+    return program == other.program && textureID == other.textureID
+        && vertexBuffer == other.vertexBuffer && indexBuffer == other.indexBuffer
+        && primitive == other.primitive && indexFormat == other.indexFormat && indexCount == other.indexCount;
+}
+
+size_t InstanceBuffer::BatchKeyHash::operator()(const BatchKey& key) const
+{
+    size_t hash = key.program;
+    hash = hash * 31 + key.textureID;
+    hash = hash * 31 + key.vertexBuffer;
+    hash = hash * 31 + key.indexBuffer;
+    hash = hash * 31 + key.primitive;
+    hash = hash * 31 + key.indexFormat;
+    hash = hash * 31 + (size_t)key.indexCount;
+    return hash;
+}
+
+InstanceBuffer::InstanceBuffer()
+{
+}
+
+int InstanceBuffer::add(const BatchKey& key, const Mat4& transform, const Vec4& color, bool* isNewBatch)
+{
+    int batch;
+    auto it = _batchesByKey.find(key);
+    if (it != _batchesByKey.end())
+    {
+        batch = it->second;
+    }
+    else
+    {
+        batch = (int)_batches.size();
+        Batch newBatch = { key, 0, 0 };
+        _batches.push_back(newBatch);
+        _batchesByKey.emplace(key, batch);
+    }
+    if (isNewBatch)
+        *isNewBatch = (_batches[batch].size == 0);
+
+    _instanceBatches.push_back(batch);
+    _instanceRanks.push_back(_batches[batch].size++);
+    _transforms.push_back(transform);
+    _colors.push_back(color);
+    return batch;
+}
+
+void InstanceBuffer::build(float* data, bool parallel)
+{
+    ssize_t offset = 0;
+    for (auto& batch : _batches)
+    {
+        batch.offset = offset;
+        offset += batch.size;
+    }
+
+    // every instance knows where it goes, so the instances can be packed in any order
+    ssize_t count = getInstanceCount();
+    if (parallel && count > INSTANCES_PER_TASK)
+    {
+        int taskCount = (int)((count + INSTANCES_PER_TASK - 1) / INSTANCES_PER_TASK);
+        WorkerPool::getInstance()->parallelFor(taskCount, [this, data, count](int task) {
+            ssize_t first = task * INSTANCES_PER_TASK;
+            pack(data, first, std::min(first + INSTANCES_PER_TASK, count));
+        });
+    }
+    else
+    {
+        pack(data, 0, count);
+    }
+}
+
+void InstanceBuffer::pack(float* data, ssize_t first, ssize_t last) const
+{
+    for (ssize_t i = first; i < last; ++i)
+    {
+        float* dst = data + (_batches[_instanceBatches[i]].offset + _instanceRanks[i]) * FLOATS_PER_INSTANCE;
+        memcpy(dst, _transforms[i].m, sizeof(float) * 16);
+        const Vec4& color = _colors[i];
+        dst[16] = color.x;
+        dst[17] = color.y;
+        dst[18] = color.z;
+        dst[19] = color.w;
+    }
+}
+
+void InstanceBuffer::clear()
+{
+    _batches.clear();
+    _batchesByKey.clear();
+    _instanceBatches.clear();
+    _instanceRanks.clear();
+    _transforms.clear();
+    _colors.clear();
+}
+
+NS_CC_END
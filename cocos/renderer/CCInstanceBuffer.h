@@ -0,0 +1,131 @@
+/****************************************************************************
+ Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+
+#ifndef __CC_INSTANCE_BUFFER_H__
+#define __CC_INSTANCE_BUFFER_H__
+
+#include <unordered_map>
+#include <vector>
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCGL.h"
+#include "math/CCMath.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+InstanceBuffer gathers the instances of the meshes drawn with instancing, grouped by batch: the instances of a batch
+share their buffers, texture and program, so they can be drawn by a single instanced draw call.
+The transforms and colors of the instances are packed into one buffer, where the instances of each batch are contiguous.
+It doesn't call GL, the packed data is uploaded by the `Renderer`.
+*@js NA
+*/
+class CC_DLL InstanceBuffer
+{
+public:
+    /**The number of floats of an instance in the packed data: its transform (16 floats, column major) then its color (4 floats).*/
+    static const int FLOATS_PER_INSTANCE = 20;
+
+    /**What the instances of a batch share.*/
+    struct BatchKey
+    {
+        GLuint program;
+        GLuint textureID;
+        GLuint vertexBuffer;
+        GLuint indexBuffer;
+        GLenum primitive;
+        GLenum indexFormat;
+        ssize_t indexCount;
+
+        bool operator==(const BatchKey& other) const;
+    };
+
+    /**Constructor.*/
+    InstanceBuffer();
+
+    /**
+    Adds an instance.
+    @param isNewBatch Set to whether the instance is the first one of its batch, can be nullptr.
+    @return The index of the batch of the instance.
+    */
+    int add(const BatchKey& key, const Mat4& transform, const Vec4& color, bool* isNewBatch = nullptr);
+    /**
+    Packs the instances added since the last `clear` into `data`, FLOATS_PER_INSTANCE floats per instance.
+    The batches are in the order of their first instance, and the instances of a batch in the order they were added.
+    The data is only written, so it can be a mapped GL buffer.
+    @param parallel Whether to pack the instances on the `WorkerPool`.
+    */
+    void build(float* data, bool parallel);
+    /**Removes all the instances and batches.*/
+    void clear();
+
+    /**Get the number of instances.*/
+    ssize_t getInstanceCount() const { return (ssize_t)_instanceBatches.size(); }
+    /**Get the number of batches.*/
+    int getBatchCount() const { return (int)_batches.size(); }
+    /**Get the key of a batch.*/
+    const BatchKey& getBatchKey(int batch) const { return _batches[batch].key; }
+    /**Get the number of instances of a batch.*/
+    ssize_t getBatchSize(int batch) const { return _batches[batch].size; }
+    /**Get the index of the first instance of a batch in the packed data, valid once built.*/
+    ssize_t getBatchOffset(int batch) const { return _batches[batch].offset; }
+
+protected:
+    struct Batch
+    {
+        BatchKey key;
+        ssize_t size;
+        ssize_t offset;
+    };
+    struct BatchKeyHash
+    {
+        size_t operator()(const BatchKey& key) const;
+    };
+
+    /**Packs the instances [first, last).*/
+    void pack(float* data, ssize_t first, ssize_t last) const;
+
+    std::vector<Batch> _batches;
+    std::unordered_map<BatchKey, int, BatchKeyHash> _batchesByKey;
+
+    // the instances, in the order they were added
+    std::vector<int> _instanceBatches;
+    std::vector<ssize_t> _instanceRanks; // index of the instance within its batch
+    std::vector<Mat4> _transforms;
+    std::vector<Vec4> _colors;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif /* __CC_INSTANCE_BUFFER_H__ */
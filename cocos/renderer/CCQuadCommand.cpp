@@ -25,6 +25,8 @@
 
 #include "renderer/CCQuadCommand.h"
 
+#include <mutex>
+
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCMaterial.h"
@@ -37,6 +39,8 @@ NS_CC_BEGIN
 
 int QuadCommand::__indexCapacity = -1;
 GLushort* QuadCommand::__indices = nullptr;
+// the shared indices can be resized by commands initialized from different threads
+static std::mutex __indicesMutex;
 
 QuadCommand::QuadCommand():
 _indexSize(-1),
@@ -58,13 +62,15 @@ void QuadCommand::init(float globalOrder, GLuint textureID, GLProgramState* glPr
     CCASSERT(glProgramState, "Invalid GLProgramState");
     CCASSERT(glProgramState->getVertexAttribsFlags() == 0, "No custom attributes are supported in QuadCommand");
 
-    if (quadCount * 6 > _indexSize)
-        reIndex((int)quadCount*6);
-
     Triangles triangles;
+    {
+        std::lock_guard<std::mutex> lock(__indicesMutex);
+        if (quadCount * 6 > _indexSize)
+            reIndex((int)quadCount*6);
+        triangles.indices = __indices;
+    }
     triangles.verts = &quads->tl;
     triangles.vertCount = (int)quadCount * 4;
-    triangles.indices = __indices;
     triangles.indexCount = (int)quadCount * 6;
     TrianglesCommand::init(globalOrder, textureID, glProgramState, blendType, triangles, mv, flags);
 }
@@ -26,74 +26,185 @@
 #define __CC_RENDERCOMMANDPOOL_H__
 /// @cond DO_NOT_SHOW
 
-#include <list>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdint.h>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/ccMacros.h"
 
 NS_CC_BEGIN
 
+/** Pool of render commands of type T, which can be used from several threads at once.
+
+ The commands live in blocks of growing size which are only freed with the pool, and the free commands
+ are linked by a header placed before each of them, so generating and pushing back a command is a
+ lock-free O(1) operation that doesn't allocate once the pool holds enough commands.
+ A command is constructed when its block is allocated, and is reused as it was pushed back.
+ */
 template <class T>
 class RenderCommandPool
 {
 public:
     RenderCommandPool()
+    : _freeHead(NIL_ID)
+    , _blockCount(0)
+    , _capacity(0)
+    , _usedCount(0)
+    , _highWaterMark(0)
     {
     }
     ~RenderCommandPool()
     {
-//        if( 0 != _usedPool.size())
+//        if( 0 != _usedCount)
 //        {
 //            CCLOG("All RenderCommand should not be used when Pool is released!");
 //        }
-        _freePool.clear();
-        for (auto& allocatedPoolBlock : _allocatedPoolBlocks)
+        for (int block = 0; block < _blockCount; ++block)
         {
-            delete[] allocatedPoolBlock;
-            allocatedPoolBlock = nullptr;
+            for (uint32_t index = 0; index < blockSize(block); ++index)
+            {
+                getCommand(getHeader(makeID(block, index)))->~T();
+            }
+            ::operator delete(_blocks[block].memory);
         }
-        _allocatedPoolBlocks.clear();
     }
 
     T* generateCommand()
     {
-        T* result = nullptr;
-        if(_freePool.empty())
+        uint64_t head = _freeHead.load(std::memory_order_acquire);
+        for (;;)
         {
-            AllocateCommands();
+            uint32_t id = (uint32_t)head;
+            if (id == NIL_ID)
+            {
+                allocateCommands();
+                head = _freeHead.load(std::memory_order_acquire);
+                continue;
+            }
+            // the tag in the high bits changes with every update of the head, it avoids the ABA problem
+            Header* header = getHeader(id);
+            uint64_t next = nextHead(head, header->next.load(std::memory_order_relaxed));
+            if (_freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                updateHighWaterMark(_usedCount.fetch_add(1, std::memory_order_relaxed) + 1);
+                return getCommand(header);
+            }
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
-        return result;
     }
     
     void pushBackCommand(T* ptr)
     {
-//        if(_usedPool.find(ptr) == _usedPool.end())
-//        {
-//            CCLOG("push Back Wrong command!");
-//            return;
-//        }
-        
-        _freePool.push_back(ptr);
-        //_usedPool.erase(ptr);
-        
+        Header* header = reinterpret_cast<Header*>(reinterpret_cast<char*>(ptr) - commandOffset());
+        pushFree(header->id, header);
+        _usedCount.fetch_sub(1, std::memory_order_relaxed);
     }
+
+    /** Returns the number of commands allocated by the pool. */
+    int getCapacity() const { return _capacity.load(std::memory_order_relaxed); }
+    /** Returns the number of generated commands which were not pushed back. */
+    int getUsedCount() const { return _usedCount.load(std::memory_order_relaxed); }
+    /** Returns the max number of commands used at once since the creation of the pool or the last reset. */
+    int getHighWaterMark() const { return _highWaterMark.load(std::memory_order_relaxed); }
+    /** Restarts the high water mark from the number of commands used now. */
+    void resetHighWaterMark() { _highWaterMark.store(getUsedCount(), std::memory_order_relaxed); }
+
 private:
-    void AllocateCommands()
+    // an id is the block number in the high 8 bits, and the index in the block in the low 24 bits
+    static const uint32_t NIL_ID = 0xffffffff;
+    static const int MAX_BLOCKS = 19;
+    static const uint32_t FIRST_BLOCK_SIZE = 64;
+
+    struct Header
+    {
+        std::atomic<uint32_t> next;
+        uint32_t id;
+    };
+
+    struct Block
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
-        T* commands = new (std::nothrow) T[COMMANDS_ALLOCATE_BLOCK_SIZE];
-        _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        void* memory;
+        char* slots;
+    };
+
+    static uint32_t makeID(int block, uint32_t index) { return ((uint32_t)block << 24) | index; }
+    static uint32_t blockSize(int block) { return FIRST_BLOCK_SIZE << block; }
+    static uint64_t nextHead(uint64_t head, uint32_t id) { return (((head >> 32) + 1) << 32) | id; }
+
+    // the command follows its header, aligned as T requires
+    static size_t commandOffset() { return (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T); }
+    static size_t slotSize()
+    {
+        const size_t alignment = alignof(T) > alignof(Header) ? alignof(T) : alignof(Header);
+        return (commandOffset() + sizeof(T) + alignment - 1) / alignment * alignment;
+    }
+
+    Header* getHeader(uint32_t id) const
+    {
+        return reinterpret_cast<Header*>(_blocks[id >> 24].slots + (id & 0xffffff) * slotSize());
+    }
+    static T* getCommand(Header* header)
+    {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(header) + commandOffset());
+    }
+
+    // pushes the chain of free commands from first to last
+    void pushFree(uint32_t first, Header* last)
+    {
+        uint64_t head = _freeHead.load(std::memory_order_relaxed);
+        do
+        {
+            last->next.store((uint32_t)head, std::memory_order_relaxed);
+        } while (!_freeHead.compare_exchange_weak(head, nextHead(head, first), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void updateHighWaterMark(int used)
+    {
+        int highWaterMark = _highWaterMark.load(std::memory_order_relaxed);
+        while (used > highWaterMark && !_highWaterMark.compare_exchange_weak(highWaterMark, used, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void allocateCommands()
+    {
+        // only the growth of the pool locks
+        std::lock_guard<std::mutex> lock(_allocateMutex);
+        if ((uint32_t)_freeHead.load(std::memory_order_acquire) != NIL_ID)
+            return;
+
+        const int block = _blockCount;
+        CCASSERT(block < MAX_BLOCKS, "RenderCommandPool: too many commands");
+        const uint32_t size = blockSize(block);
+        const size_t alignment = alignof(T) > alignof(Header) ? alignof(T) : alignof(Header);
+
+        void* memory = ::operator new(slotSize() * size + alignment);
+        _blocks[block].memory = memory;
+        _blocks[block].slots = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(memory) + alignment - 1) / alignment * alignment);
+
+        for (uint32_t index = 0; index < size; ++index)
         {
-            _freePool.push_back(commands+index);
+            Header* header = new (_blocks[block].slots + index * slotSize()) Header;
+            header->id = makeID(block, index);
+            header->next.store(index + 1 < size ? makeID(block, index + 1) : NIL_ID, std::memory_order_relaxed);
+            new (getCommand(header)) T();
         }
+        _blockCount = block + 1;
+        _capacity.fetch_add(size, std::memory_order_relaxed);
+
+        pushFree(makeID(block, 0), getHeader(makeID(block, size - 1)));
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    //std::set<T*> _usedPool;
+    // low 32 bits: id of the first free command, high 32 bits: tag
+    std::atomic<uint64_t> _freeHead;
+    Block _blocks[MAX_BLOCKS];
+    int _blockCount;
+    std::mutex _allocateMutex;
+
+    std::atomic<int> _capacity;
+    std::atomic<int> _usedCount;
+    std::atomic<int> _highWaterMark;
 };
 
 NS_CC_END
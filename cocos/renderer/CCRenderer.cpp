@@ -37,27 +37,45 @@
 #include "renderer/CCTechnique.h"
 #include "renderer/CCPass.h"
 #include "renderer/CCRenderState.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCVertexAttribBinding.h"
 #include "renderer/ccGLStateCache.h"
 
+#include "math/MathUtil.h"
+
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCWorkerPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// Maps a float to an unsigned integer with the same order, so that keys can be radix sorted.
+static inline uint32_t floatToSortKey(float value)
+{
+    // -0.0f and 0.0f compare equal, they must get the same key
+    if (value == 0.0f)
+        value = 0.0f;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+static inline uint32_t globalOrderSortKey(const RenderCommand* command)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    return floatToSortKey(command->getGlobalOrder());
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+static inline uint32_t depthSortKey(const RenderCommand* command)
 {
-    return  a->getDepth() > b->getDepth();
+    // farther transparent 3D commands are drawn first
+    return ~floatToSortKey(command->getDepth());
 }
 
 // queue
@@ -72,10 +90,12 @@ void RenderQueue::push_back(RenderCommand* command)
     if(z < 0)
     {
         _commands[QUEUE_GROUP::GLOBALZ_NEG].push_back(command);
+        _sortKeys[QUEUE_GROUP::GLOBALZ_NEG].push_back(floatToSortKey(z));
     }
     else if(z > 0)
     {
         _commands[QUEUE_GROUP::GLOBALZ_POS].push_back(command);
+        _sortKeys[QUEUE_GROUP::GLOBALZ_POS].push_back(floatToSortKey(z));
     }
     else
     {
@@ -84,6 +104,7 @@ void RenderQueue::push_back(RenderCommand* command)
             if(command->isTransparent())
             {
                 _commands[QUEUE_GROUP::TRANSPARENT_3D].push_back(command);
+                _sortKeys[QUEUE_GROUP::TRANSPARENT_3D].push_back(depthSortKey(command));
             }
             else
             {
@@ -111,9 +132,92 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    sortSubQueue(QUEUE_GROUP::TRANSPARENT_3D);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_NEG);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_POS);
+}
+
+void RenderQueue::sortSubQueue(QUEUE_GROUP group)
+{
+    auto& commands = _commands[group];
+    auto& keys = _sortKeys[group];
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    // the commands were added to the sub queue without going through push_back()
+    if (keys.size() != count)
+    {
+        keys.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            keys[i] = (group == QUEUE_GROUP::TRANSPARENT_3D) ? depthSortKey(commands[i]) : globalOrderSortKey(commands[i]);
+        }
+    }
+
+    // records are (key, index) pairs: the index in the low bits makes every record unique,
+    // so any sort of the records is stable with respect to the keys
+    _sortRecords.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        _sortRecords[i] = ((uint64_t)keys[i] << 32) | (uint64_t)i;
+    }
+
+    static const size_t RADIX_SORT_THRESHOLD = 64;
+    if (count < RADIX_SORT_THRESHOLD)
+    {
+        std::sort(_sortRecords.begin(), _sortRecords.end());
+    }
+    else
+    {
+        // LSD radix sort on the 4 key bytes, skipping the bytes which are the same for every key
+        size_t histograms[4][256] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t key = keys[i];
+            ++histograms[0][key & 0xff];
+            ++histograms[1][(key >> 8) & 0xff];
+            ++histograms[2][(key >> 16) & 0xff];
+            ++histograms[3][key >> 24];
+        }
+
+        _sortRecordsTemp.resize(count);
+        uint64_t* src = _sortRecords.data();
+        uint64_t* dst = _sortRecordsTemp.data();
+        for (int pass = 0; pass < 4; ++pass)
+        {
+            size_t* histogram = histograms[pass];
+            const int shift = 32 + pass * 8;
+            if (histogram[(src[0] >> shift) & 0xff] == count)
+                continue;
+
+            size_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                size_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                dst[histogram[(src[i] >> shift) & 0xff]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        if (src != _sortRecords.data())
+        {
+            _sortRecords.swap(_sortRecordsTemp);
+        }
+    }
+
+    _sortedCommands.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t index = (uint32_t)(_sortRecords[i] & 0xffffffff);
+        _sortedCommands[i] = commands[index];
+        keys[i] = (uint32_t)(_sortRecords[i] >> 32);
+    }
+    commands.swap(_sortedCommands);
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -137,6 +241,7 @@ void RenderQueue::clear()
     for(int i = 0; i < QUEUE_COUNT; ++i)
     {
         _commands[i].clear();
+        _sortKeys[i].clear();
     }
 }
 
@@ -146,6 +251,16 @@ void RenderQueue::realloc(size_t reserveSize)
     {
         _commands[i] = std::vector<RenderCommand*>();
         _commands[i].reserve(reserveSize);
+        _sortKeys[i] = std::vector<uint32_t>();
+    }
+}
+
+void RenderQueue::append(const RenderQueue& other)
+{
+    for(int i = 0; i < QUEUE_COUNT; ++i)
+    {
+        _commands[i].insert(_commands[i].end(), other._commands[i].begin(), other._commands[i].end());
+        _sortKeys[i].insert(_sortKeys[i].end(), other._sortKeys[i].begin(), other._sortKeys[i].end());
     }
 }
 
@@ -188,19 +303,60 @@ void RenderQueue::restoreRenderState()
     CHECK_GL_ERROR_DEBUG();
 }
 
+//
+// recording
+//
+void RenderRecording::reset(int renderQueueID, const Mat4& modelView)
+{
+    for (auto& queue : queues)
+    {
+        queue.clear();
+    }
+
+    while (!groupStack.empty())
+        groupStack.pop();
+    groupStack.push(renderQueueID);
+
+    while (!modelViewMatrixStack.empty())
+        modelViewMatrixStack.pop();
+    modelViewMatrixStack.push(modelView);
+}
+
+RenderQueue& RenderRecording::getQueue(int renderQueueID)
+{
+    if (renderQueueID >= (int)queues.size())
+    {
+        queues.resize(renderQueueID + 1);
+    }
+    return queues[renderQueueID];
+}
+
+// the recording of the calling thread, nullptr when the commands go to the render queues
+static thread_local RenderRecording* s_currentRecording = nullptr;
+
 //
 //
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+// initial number of vertices and indices in the region of a frame of the stream buffers, they grow as needed
+static const int STREAM_VERTEX_COUNT = Renderer::VBO_SIZE / 8;
+static const int STREAM_INDEX_COUNT = Renderer::INDEX_VBO_SIZE / 8;
+
 //
 // constructors, destructor, init
 //
 Renderer::Renderer()
-:_lastBatchedMeshCommand(nullptr)
+:_meshInstancesOffset(0)
+,_lastBatchedMeshCommand(nullptr)
+,_vertexStream(GL_ARRAY_BUFFER)
+,_indexStream(GL_ELEMENT_ARRAY_BUFFER)
+,_verts(nullptr)
+,_indices(nullptr)
 ,_filledVertex(0)
 ,_filledIndex(0)
 ,_glViewAssigned(false)
+,_uploadedBytes(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
 ,_triBatchesToDraw(nullptr)
@@ -229,11 +385,15 @@ Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
-    
-    glDeleteBuffers(2, _buffersVBO);
 
     free(_triBatchesToDraw);
 
+    for (auto batch : _meshInstanceBatches)
+    {
+        CC_SAFE_RELEASE(batch->vertexAttribBinding);
+        delete batch;
+    }
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_buffersVAO);
@@ -274,41 +434,31 @@ void Renderer::setupBuffer()
 
 void Renderer::setupVBOAndVAO()
 {
-    //generate vbo and vao for trianglesCommand
+    setupVBO();
+
+    //generate vao for trianglesCommand, the attribute pointers are set when drawing
+    //since the vertices are at a different offset of the stream buffer every time
     glGenVertexArrays(1, &_buffersVAO);
     GL::bindVAO(_buffersVAO);
 
-    glGenBuffers(2, &_buffersVBO[0]);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
-
-    // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
-
-    // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
-
-    // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexStream.getBuffer());
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
 void Renderer::setupVBO()
 {
-    glGenBuffers(2, &_buffersVBO[0]);
+    // Avoid changing the element buffer for whatever VAO might be bound.
+    GL::bindVAO(0);
+
     // Issue #15652
     // Should not initialize VBO with a large size (VBO_SIZE=65536),
     // it may cause low FPS on some Android devices like LG G4 & Nexus 5X.
@@ -316,23 +466,11 @@ void Renderer::setupVBO()
     // copy the whole memory of VBO which initialized at the first time
     // once glBufferData/glBufferSubData is invoked.
     // For more discussion, please refer to https://github.com/cocos2d/cocos2d-x/issues/15652
-//    mapBuffers();
-}
-
-void Renderer::mapBuffers()
-{
-    // Avoid changing the element buffer for whatever VAO might be bound.
-    GL::bindVAO(0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
-    
+    // The stream buffers start small and grow when a frame needs more.
+    _vertexStream.setup(sizeof(V3F_C4B_T2F) * STREAM_VERTEX_COUNT);
+    _indexStream.setup(sizeof(GLushort) * STREAM_INDEX_COUNT);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
-
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
@@ -340,7 +478,7 @@ void Renderer::mapBuffers()
 
 void Renderer::addCommand(RenderCommand* command)
 {
-    int renderQueue =_commandGroupStack.top();
+    int renderQueue = s_currentRecording ? s_currentRecording->groupStack.top() : _commandGroupStack.top();
     addCommand(command, renderQueue);
 }
 
@@ -350,19 +488,31 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (s_currentRecording)
+    {
+        s_currentRecording->getQueue(renderQueue).push_back(command);
+        return;
+    }
+
     _renderGroups[renderQueue].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
-    _commandGroupStack.push(renderQueueID);
+    if (s_currentRecording)
+        s_currentRecording->groupStack.push(renderQueueID);
+    else
+        _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
-    _commandGroupStack.pop();
+    if (s_currentRecording)
+        s_currentRecording->groupStack.pop();
+    else
+        _commandGroupStack.pop();
 }
 
 int Renderer::createRenderQueue()
@@ -372,6 +522,49 @@ int Renderer::createRenderQueue()
     return (int)_renderGroups.size() - 1;
 }
 
+void Renderer::recordInParallel(int count, const std::function<void(int)>& record)
+{
+    CCASSERT(!_isRendering, "Cannot add command while rendering");
+    CCASSERT(s_currentRecording == nullptr, "Cannot record in parallel while recording");
+
+    if ((int)_recordings.size() < count)
+    {
+        _recordings.resize(count);
+    }
+
+    int renderQueueID = _commandGroupStack.top();
+    const Mat4& modelView = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    for (int i = 0; i < count; ++i)
+    {
+        _recordings[i].reset(renderQueueID, modelView);
+    }
+
+    WorkerPool::getInstance()->parallelFor(count, [&](int index) {
+        s_currentRecording = &_recordings[index];
+        record(index);
+        s_currentRecording = nullptr;
+    });
+}
+
+void Renderer::mergeRecordings(int first, int last)
+{
+    CCASSERT(first >= 0 && last <= (int)_recordings.size(), "Invalid recording range");
+
+    for (int i = first; i < last; ++i)
+    {
+        auto& queues = _recordings[i].queues;
+        for (size_t renderQueueID = 0, size = queues.size(); renderQueueID < size; ++renderQueueID)
+        {
+            _renderGroups[renderQueueID].append(queues[renderQueueID]);
+        }
+    }
+}
+
+RenderRecording* Renderer::getCurrentRecording()
+{
+    return s_currentRecording;
+}
+
 void Renderer::processRenderCommand(RenderCommand* command)
 {
     auto commandType = command->getType();
@@ -382,13 +575,8 @@ void Renderer::processRenderCommand(RenderCommand* command)
 
         auto cmd = static_cast<TrianglesCommand*>(command);
         
-        // flush own queue when buffer is full
-        if(_filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
-        {
-            CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
-            CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
-            drawBatchedTriangles();
-        }
+        // the stream buffers grow as needed, only the indices of a single command can't refer to more than VBO_SIZE vertices
+        CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
         
         // queue it
         _queuedTriangleCommands.push_back(cmd);
@@ -637,12 +825,123 @@ void Renderer::render()
         {
             renderqueue.sort();
         }
+        uploadMeshInstances();
         visitRenderQueue(_renderGroups[0]);
     }
     clean();
     _isRendering = false;
 }
 
+void Renderer::addMeshInstance(const InstanceBuffer::BatchKey& key, MeshIndexData* meshIndexData, GLProgram* glProgram,
+                               RenderState::StateBlock* stateBlock, const Mat4& transform, const Vec4& color, float globalZOrder, uint32_t flags)
+{
+    // subtrees may be visited in parallel
+    std::lock_guard<std::mutex> lock(_meshInstancesMutex);
+
+    bool isNewBatch = false;
+    int index = _meshInstances.add(key, transform, color, &isNewBatch);
+    if (!isNewBatch)
+        return;
+
+    if (index >= (int)_meshInstanceBatches.size())
+    {
+        auto newBatch = new (std::nothrow) MeshInstanceBatch();
+        newBatch->vertexAttribBinding = nullptr;
+        newBatch->command.func = [this, index]() { drawMeshInstances(index); };
+        _meshInstanceBatches.push_back(newBatch);
+    }
+    auto batch = _meshInstanceBatches[index];
+    batch->meshIndexData = meshIndexData;
+    batch->glProgram = glProgram;
+    batch->stateBlock = stateBlock;
+    batch->command.init(globalZOrder, transform, flags);
+    batch->command.set3D(true);
+    batch->command.setTransparent(false);
+    addCommand(&batch->command);
+}
+
+void Renderer::uploadMeshInstances()
+{
+    ssize_t count = _meshInstances.getInstanceCount();
+    if (count == 0)
+        return;
+
+    // the instances are packed on the worker threads, straight into the vertex stream
+    size_t size = sizeof(float) * InstanceBuffer::FLOATS_PER_INSTANCE * count;
+    _meshInstances.build(static_cast<float*>(_vertexStream.map(size)), true);
+    _meshInstancesOffset = _vertexStream.commit();
+    _uploadedBytes += size;
+}
+
+void Renderer::drawMeshInstances(int index)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    auto batch = _meshInstanceBatches[index];
+    const auto& key = _meshInstances.getBatchKey(index);
+    ssize_t instanceCount = _meshInstances.getBatchSize(index);
+
+    // the GL objects are only made here, on the GL thread
+    auto glProgramState = GLProgramState::getOrCreateWithGLProgram(batch->glProgram);
+    auto vertexAttribBinding = VertexAttribBinding::create(batch->meshIndexData, glProgramState);
+    if (vertexAttribBinding != batch->vertexAttribBinding)
+    {
+        CC_SAFE_RETAIN(vertexAttribBinding);
+        CC_SAFE_RELEASE(batch->vertexAttribBinding);
+        batch->vertexAttribBinding = vertexAttribBinding;
+    }
+
+    glProgramState->apply(Mat4::IDENTITY);
+    GL::bindTexture2D(key.textureID);
+    batch->stateBlock->bind();
+    vertexAttribBinding->bind();
+
+    // the transform (a mat4 takes 4 locations) and the color of the instances
+    auto transformAttrib = batch->glProgram->getVertexAttrib("a_instanceTransform");
+    auto colorAttrib = batch->glProgram->getVertexAttrib("a_instanceColor");
+    GLuint locations[5];
+    int locationCount = 0;
+    if (transformAttrib && colorAttrib)
+    {
+        for (int column = 0; column < 4; ++column)
+            locations[locationCount++] = transformAttrib->index + column;
+        locations[locationCount++] = colorAttrib->index;
+    }
+
+    const GLsizei stride = sizeof(float) * InstanceBuffer::FLOATS_PER_INSTANCE;
+    const size_t offset = _meshInstancesOffset + stride * _meshInstances.getBatchOffset(index);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream.getBuffer());
+    for (int i = 0; i < locationCount; ++i)
+    {
+        glEnableVertexAttribArray(locations[i]);
+        glVertexAttribPointer(locations[i], 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + sizeof(float) * 4 * i));
+        glVertexAttribDivisorARB(locations[i], 1);
+    }
+
+    glDrawElementsInstancedARB(key.primitive, (GLsizei)key.indexCount, key.indexFormat, 0, (GLsizei)instanceCount);
+    _drawnBatches++;
+    _drawnVertices += key.indexCount * instanceCount;
+
+    for (int i = 0; i < locationCount; ++i)
+    {
+        glVertexAttribDivisorARB(locations[i], 0);
+        glDisableVertexAttribArray(locations[i]);
+    }
+    vertexAttribBinding->unbind();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // the instance attributes were enabled behind the back of the state cache
+    GL::enableVertexAttribs(0);
+    RenderState::StateBlock::restore(0);
+    CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void Renderer::endFrame()
+{
+    _vertexStream.nextFrame();
+    _indexStream.nextFrame();
+}
+
 void Renderer::clean()
 {
     // Clear render group
@@ -661,6 +960,8 @@ void Renderer::clean()
     _filledVertex = 0;
     _filledIndex = 0;
     _lastBatchedMeshCommand = nullptr;
+
+    _meshInstances.clear();
 }
 
 void Renderer::clear()
@@ -698,26 +999,19 @@ void Renderer::setDepthTest(bool enable)
     CHECK_GL_ERROR_DEBUG();
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
+void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset)
 {
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    const ssize_t vertexCount = cmd->getVertexCount();
+    const ssize_t indexCount = cmd->getIndexCount();
 
-    // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
-    {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
-    }
+    // fill vertex, and convert them to world coordinates. _verts may be mapped from the GPU, it is only written to
+    MathUtil::transformVec3Array(cmd->getModelView().m, &cmd->getVertices()->vertices.x, &_verts[_filledVertex].vertices.x, sizeof(V3F_C4B_T2F), vertexCount);
 
-    // fill index
-    const unsigned short* indices = cmd->getIndices();
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
-    {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
-    }
+    // fill index, relative to the first vertex of the batch
+    MathUtil::rebaseIndices(cmd->getIndices(), _filledVertex - vertexBufferOffset, indexCount, &_indices[_filledIndex]);
 
-    _filledVertex += cmd->getVertexCount();
-    _filledIndex += cmd->getIndexCount();
+    _filledVertex += vertexCount;
+    _filledIndex += indexCount;
 }
 
 void Renderer::drawBatchedTriangles()
@@ -727,28 +1021,47 @@ void Renderer::drawBatchedTriangles()
 
     CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_TRIANGLES");
 
-    _filledVertex = 0;
-    _filledIndex = 0;
+    const bool useVAO = Configuration::getInstance()->supportsShareableVAO();
+    if (useVAO)
+    {
+        // Avoid changing the element buffer for whatever VAO might be bound.
+        GL::bindVAO(0);
+    }
 
     /************** 1: Setup up vertices/indices *************/
 
+    // _filledVertex and _filledIndex are the totals of the queued commands,
+    // which are written directly into the stream buffers
+    _verts = (V3F_C4B_T2F*) _vertexStream.map(sizeof(_verts[0]) * _filledVertex);
+    _indices = (GLushort*) _indexStream.map(sizeof(_indices[0]) * _filledIndex);
+
+    _filledVertex = 0;
+    _filledIndex = 0;
+
     _triBatchesToDraw[0].offset = 0;
     _triBatchesToDraw[0].indicesToDraw = 0;
+    _triBatchesToDraw[0].vertexOffset = 0;
     _triBatchesToDraw[0].cmd = nullptr;
 
     int batchesTotal = 0;
     int prevMaterialID = -1;
     bool firstCommand = true;
+    int vertexOffset = 0;
 
     for(const auto& cmd : _queuedTriangleCommands)
     {
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd);
+        // GLushort indices can't refer to more than VBO_SIZE vertices, the next batch starts at this command
+        const bool vertexRangeFull = _filledVertex - vertexOffset + cmd->getVertexCount() > VBO_SIZE;
+        if (vertexRangeFull)
+            vertexOffset = _filledVertex;
+
+        fillVerticesAndIndices(cmd, vertexOffset);
 
         // in the same batch ?
-        if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
+        if (batchable && !vertexRangeFull && (prevMaterialID == currentMaterialID || firstCommand))
         {
             CC_ASSERT(firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID() && "argh... error in logic");
             _triBatchesToDraw[batchesTotal].indicesToDraw += cmd->getIndexCount();
@@ -764,6 +1077,7 @@ void Renderer::drawBatchedTriangles()
 
             _triBatchesToDraw[batchesTotal].cmd = cmd;
             _triBatchesToDraw[batchesTotal].indicesToDraw = (int) cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].vertexOffset = vertexOffset;
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
@@ -781,79 +1095,64 @@ void Renderer::drawBatchedTriangles()
     }
     batchesTotal++;
 
-    /************** 2: Copy vertices/indices to GL objects *************/
-    auto conf = Configuration::getInstance();
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    /************** 2: Make vertices/indices available to GL *************/
+    const size_t vertexBufferOffset = _vertexStream.commit();
+    const size_t indexBufferOffset = _indexStream.commit();
+    _uploadedBytes += sizeof(_verts[0]) * _filledVertex + sizeof(_indices[0]) * _filledIndex;
+    _verts = nullptr;
+    _indices = nullptr;
+
+    if (useVAO)
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
-        //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // option 1: subdata
-//        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-
-        // option 2: data
-//        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, _verts, GL_STATIC_DRAW);
-
-        // option 3: orphaning + glMapBuffer
-        // FIXME: in order to work as fast as possible, it must "and the exact same size and usage hints it had before."
-        //  source: https://www.opengl.org/wiki/Buffer_Object_Streaming#Explicit_multiple_buffering
-        // so most probably we won't have any benefit of using it
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, nullptr, GL_STATIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _verts, sizeof(_verts[0]) * _filledVertex);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
     else
     {
-        // Client Side Arrays
-#define kQuadSize sizeof(_verts[0])
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
-
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
-
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexStream.getBuffer());
     }
 
     /************** 3: Draw *************/
+    int boundVertexOffset = -1;
     for (int i=0; i<batchesTotal; ++i)
     {
         CC_ASSERT(_triBatchesToDraw[i].cmd && "Invalid batch");
+
+        if (_triBatchesToDraw[i].vertexOffset != boundVertexOffset)
+        {
+            // the vertices of the batch are at a different offset of the stream buffer every time
+            boundVertexOffset = _triBatchesToDraw[i].vertexOffset;
+            const size_t offset = vertexBufferOffset + sizeof(_verts[0]) * boundVertexOffset;
+            glBindBuffer(GL_ARRAY_BUFFER, _vertexStream.getBuffer());
+
+            // vertices
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+
+            // colors
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+
+            // tex coords
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+        }
+
         _triBatchesToDraw[i].cmd->useMaterial();
-        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (_triBatchesToDraw[i].offset*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexBufferOffset + _triBatchesToDraw[i].offset*sizeof(GLushort)) );
         _drawnBatches++;
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
     }
 
     /************** 4: Cleanup *************/
-    if (Configuration::getInstance()->supportsShareableVAO())
+    if (useVAO)
     {
         //Unbind VAO
         GL::bindVAO(0);
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     _queuedTriangleCommands.clear();
     _filledVertex = 0;
@@ -28,10 +28,16 @@
 
 #include <vector>
 #include <stack>
+#include <functional>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCStreamBuffer.h"
+#include "renderer/CCInstanceBuffer.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCRenderState.h"
 #include "platform/CCGL.h"
 
 #if !defined(NDEBUG) && CC_TARGET_PLATFORM == CC_PLATFORM_IOS
@@ -61,11 +67,15 @@ NS_CC_BEGIN
 class EventListenerCustom;
 class TrianglesCommand;
 class MeshCommand;
+class MeshIndexData;
+class VertexAttribBinding;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
- are the ones that have `z < 0` and `z > 0`.
+ are the ones that have `z < 0` and `z > 0`, and the transparent 3D ones.
+ The sort key of a command is computed when it is pushed back, and kept next to it,
+ so sorting doesn't need to dereference the commands.
 */
 class RenderQueue {
 public:
@@ -102,6 +112,10 @@ public:
     void clear();
     /**Realloc command queues and reserve with given size. Note: this clears any existing commands.*/
     void realloc(size_t reserveSize);
+    /**Append the commands of another render queue, keeping their order within each queue group.*/
+    void append(const RenderQueue& other);
+    /**Get the sort keys of a sub group, only the sorted groups have keys.*/
+    const std::vector<uint32_t>& getSubQueueSortKeys(QUEUE_GROUP group) const { return _sortKeys[group]; }
     /**Get a sub group of the render queue.*/
     std::vector<RenderCommand*>& getSubQueue(QUEUE_GROUP group) { return _commands[group]; }
     /**Get the number of render commands contained in a subqueue.*/
@@ -113,8 +127,17 @@ public:
     void restoreRenderState();
     
 protected:
+    /**Stable sort of a sub group by its sort keys.*/
+    void sortSubQueue(QUEUE_GROUP group);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**The sort keys of the commands in the sorted groups.*/
+    std::vector<uint32_t> _sortKeys[QUEUE_COUNT];
+    /**Buffers reused by sortSubQueue.*/
+    std::vector<uint64_t> _sortRecords;
+    std::vector<uint64_t> _sortRecordsTemp;
+    std::vector<RenderCommand*> _sortedCommands;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -131,6 +154,22 @@ struct RenderStackElement
     ssize_t currentIndex;
 };
 
+/** Render commands recorded apart from the render queues of the `Renderer`, see `Renderer::recordInParallel`.
+ A recording has its own render group stack and modelview matrix stack, so it can be filled from any thread.
+*/
+struct RenderRecording
+{
+    /**Clear the recorded commands and restart the stacks from the given render queue and modelview matrix.*/
+    void reset(int renderQueueID, const Mat4& modelView);
+    /**Get the queue recording the commands of a render queue.*/
+    RenderQueue& getQueue(int renderQueueID);
+
+    /**The recorded commands, indexed by render queue ID.*/
+    std::vector<RenderQueue> queues;
+    std::stack<int> groupStack;
+    std::stack<Mat4> modelViewMatrixStack;
+};
+
 class GroupCommandManager;
 
 /* Class responsible for the rendering in.
@@ -140,9 +179,9 @@ Whenever possible prefer to use `TrianglesCommand` objects since the renderer wi
 class CC_DLL Renderer
 {
 public:
-    /**The max number of vertices in a vertex buffer object.*/
+    /**The max number of vertices that the GLushort indices of a batch can refer to.*/
     static const int VBO_SIZE = 65536;
-    /**The max number of indices in a index buffer.*/
+    /**The number of indices of VBO_SIZE vertices of quads.*/
     static const int INDEX_VBO_SIZE = VBO_SIZE * 6 / 4;
     /**The rendercommands which can be batched will be saved into a list, this is the reserved size of this list.*/
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
@@ -171,9 +210,36 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Calls `record(index)` for every index in [0, count) on the `WorkerPool`.
+     The commands added by each call are recorded apart instead of being added to the render queues,
+     use `mergeRecordings` to add them. Must not be called while recording.
+     */
+    void recordInParallel(int count, const std::function<void(int)>& record);
+
+    /** Adds the commands recorded by the calls [first, last) of the last `recordInParallel` to the render queues,
+     in index order, so the result is the same as if the calls had been made serially.
+     */
+    void mergeRecordings(int first, int last);
+
+    /** Returns the recording that the calling thread adds commands to, or nullptr if it adds them to the render queues */
+    static RenderRecording* getCurrentRecording();
+
+    /** Adds an instance of a mesh drawn with instancing, see `Sprite3D::setInstancedRenderingEnabled`.
+     The instances of a batch are drawn by a single instanced draw call, with a command added to the render queue
+     with the first instance of the batch, which also gives the render state of the batch.
+     Can be called while recording in parallel, no GL call is made before rendering. Requires `Configuration::supportsInstancedArrays`.
+     @param meshIndexData The vertices and indices of the mesh, the buffers of `key`.
+     @param glProgram An instanced program, such as `GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED`, the program of `key`.
+     */
+    void addMeshInstance(const InstanceBuffer::BatchKey& key, MeshIndexData* meshIndexData, GLProgram* glProgram,
+                         RenderState::StateBlock* stateBlock, const Mat4& transform, const Vec4& color, float globalZOrder, uint32_t flags);
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
+    /** Tells that the rendering of the frame is over, the next batched vertices are written into the regions of the next frame */
+    void endFrame();
+
     /** Cleans all `RenderCommand`s in the queue */
     void clean();
 
@@ -190,8 +256,10 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of bytes of batched vertices and indices uploaded in the last frame */
+    ssize_t getUploadedBytes() const { return _uploadedBytes; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _uploadedBytes = 0; }
 
     /**
      * Enable/Disable depth test
@@ -212,7 +280,6 @@ protected:
     void setupBuffer();
     void setupVBOAndVAO();
     void setupVBO();
-    void mapBuffers();
     void drawBatchedTriangles();
 
     //Draw the previews queued triangles and flush previous context
@@ -227,7 +294,11 @@ protected:
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd);
+    void fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset);
+
+    // packs the mesh instances into the vertex stream
+    void uploadMeshInstances();
+    void drawMeshInstances(int batch);
 
 
     /* clear color set outside be used in setGLDefaultValues() */
@@ -237,20 +308,40 @@ protected:
     
     std::vector<RenderQueue> _renderGroups;
 
+    // for recordInParallel
+    std::vector<RenderRecording> _recordings;
+
+    // for addMeshInstance, the batches are reused from one render to the next
+    struct MeshInstanceBatch
+    {
+        CustomCommand command;
+        MeshIndexData* meshIndexData; // weak ref
+        GLProgram* glProgram; // weak ref
+        RenderState::StateBlock* stateBlock; // weak ref
+        VertexAttribBinding* vertexAttribBinding; // the binding of the last draw, kept so it isn't rebuilt every frame
+    };
+    InstanceBuffer _meshInstances;
+    std::vector<MeshInstanceBatch*> _meshInstanceBatches;
+    // offset of the packed instances in the vertex stream
+    size_t _meshInstancesOffset;
+    std::mutex _meshInstancesMutex;
+
     MeshCommand* _lastBatchedMeshCommand;
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
-    //for TrianglesCommand
-    V3F_C4B_T2F _verts[VBO_SIZE];
-    GLushort _indices[INDEX_VBO_SIZE];
+    //for TrianglesCommand, the vertices and indices are written directly into the stream buffers
+    StreamBuffer _vertexStream;
+    StreamBuffer _indexStream;
+    V3F_C4B_T2F* _verts;
+    GLushort* _indices;
     GLuint _buffersVAO;
-    GLuint _buffersVBO[2]; //0: vertex  1: indices
 
     // Internal structure that has the information for the batches
     struct TriBatchToDraw {
         TrianglesCommand* cmd;  // needed for the Material
         GLsizei indicesToDraw;
         GLsizei offset;
+        GLsizei vertexOffset;   // first vertex the indices refer to
     };
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity;
@@ -265,6 +356,7 @@ protected:
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _uploadedBytes;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
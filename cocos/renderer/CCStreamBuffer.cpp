@@ -0,0 +1,260 @@
+/****************************************************************************
+ Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCStreamBuffer.h"
+
+#include <algorithm>
+
+#include "base/CCConfiguration.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace {
+
+// the data of each commit starts at an offset aligned to this, for the vertex attributes
+const size_t STREAM_BUFFER_ALIGNMENT = 16;
+
+class GLStreamBufferBackend : public StreamBuffer::Backend
+{
+public:
+    virtual GLuint createBuffer() override
+    {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        return buffer;
+    }
+
+    virtual void deleteBuffer(GLuint buffer) override
+    {
+        glDeleteBuffers(1, &buffer);
+    }
+
+    virtual void allocate(GLenum target, GLuint buffer, size_t size) override
+    {
+        glBindBuffer(target, buffer);
+        glBufferData(target, size, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    static bool supportsFences()
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        // loaded by GLEW, like glMapBufferRange
+        return glFenceSync != nullptr && glClientWaitSync != nullptr && glDeleteSync != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    virtual void* map(GLenum target, GLuint buffer, size_t offset, size_t size) override
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        if (Configuration::getInstance()->supportsMapBufferRange() && supportsFences())
+        {
+            // StreamBuffer waited for the fence of the region, no need to synchronize
+            glBindBuffer(target, buffer);
+            return glMapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        }
+#endif
+        return nullptr;
+    }
+
+    virtual void unmap(GLenum target, GLuint buffer) override
+    {
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+    }
+
+    virtual void upload(GLenum target, GLuint buffer, size_t offset, size_t size, const void* data) override
+    {
+        glBindBuffer(target, buffer);
+        glBufferSubData(target, offset, size, data);
+    }
+
+    virtual void* insertFence() override
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        if (Configuration::getInstance()->supportsMapBufferRange() && supportsFences())
+        {
+            return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+#endif
+        return nullptr;
+    }
+
+    virtual void waitFence(void* fence) override
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        GLsync sync = static_cast<GLsync>(fence);
+        // flush once so that the fence is reached, then wait in steps of 1 second
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        GLenum result;
+        do
+        {
+            result = glClientWaitSync(sync, flags, 1000000000ull);
+            flags = 0;
+        } while (result == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(sync);
+#endif
+    }
+
+    virtual void deleteFence(void* fence) override
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        glDeleteSync(static_cast<GLsync>(fence));
+#endif
+    }
+};
+
+}
+
+StreamBuffer::Backend* StreamBuffer::getGLBackend()
+{
+    static GLStreamBufferBackend backend;
+    return &backend;
+}
+
+StreamBuffer::StreamBuffer(GLenum target, Backend* backend/* = nullptr*/)
+: _backend(backend ? backend : getGLBackend())
+, _target(target)
+, _buffer(0)
+, _regionSize(0)
+, _frame(0)
+, _regionOffset(0)
+, _mappedOffset(0)
+, _mappedSize(0)
+, _mappedData(nullptr)
+, _frameUploadedBytes(0)
+{
+    std::fill(_fences, _fences + FRAME_COUNT, nullptr);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    deleteFences();
+    if (_buffer)
+    {
+        _backend->deleteBuffer(_buffer);
+    }
+}
+
+void StreamBuffer::deleteFences()
+{
+    for (auto& fence : _fences)
+    {
+        if (fence)
+        {
+            _backend->deleteFence(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void StreamBuffer::setup(size_t regionSize)
+{
+    CCASSERT(_mappedSize == 0, "StreamBuffer: can't setup while mapped");
+
+    // when the GL context was recreated, the previous buffer object and fences are already gone
+    std::fill(_fences, _fences + FRAME_COUNT, nullptr);
+    _buffer = _backend->createBuffer();
+    _regionSize = std::max(regionSize, _regionSize);
+    _regionSize = (_regionSize + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+    _regionOffset = 0;
+    _backend->allocate(_target, _buffer, _regionSize * FRAME_COUNT);
+}
+
+void* StreamBuffer::map(size_t size)
+{
+    CCASSERT(_buffer, "StreamBuffer: setup must be called first");
+    CCASSERT(_mappedSize == 0, "StreamBuffer: the previous data must be committed first");
+
+    size_t offset = (_regionOffset + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+    if (offset + size > _regionSize)
+    {
+        // Grow the regions. The previous storage is orphaned: the draws already issued keep using it,
+        // and the whole new storage is free.
+        _regionSize = std::max(_regionSize * 2, (size + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1));
+        _backend->allocate(_target, _buffer, _regionSize * FRAME_COUNT);
+        offset = 0;
+        deleteFences();
+    }
+
+    // the GPU may still read the region if it is FRAME_COUNT - 1 frames late
+    if (_fences[_frame])
+    {
+        _backend->waitFence(_fences[_frame]);
+        _fences[_frame] = nullptr;
+    }
+
+    _mappedOffset = _frame * _regionSize + offset;
+    _mappedSize = size;
+    _regionOffset = offset + size;
+
+    _mappedData = size ? _backend->map(_target, _buffer, _mappedOffset, size) : nullptr;
+    if (_mappedData)
+    {
+        return _mappedData;
+    }
+
+    if (_shadowCopy.size() < size)
+    {
+        _shadowCopy.resize(size);
+    }
+    return _shadowCopy.data();
+}
+
+size_t StreamBuffer::commit()
+{
+    if (_mappedData)
+    {
+        _backend->unmap(_target, _buffer);
+        _mappedData = nullptr;
+    }
+    else if (_mappedSize)
+    {
+        _backend->upload(_target, _buffer, _mappedOffset, _mappedSize, _shadowCopy.data());
+    }
+
+    _frameUploadedBytes += _mappedSize;
+    _mappedSize = 0;
+    return _mappedOffset;
+}
+
+void StreamBuffer::nextFrame()
+{
+    CCASSERT(_mappedSize == 0, "StreamBuffer: the data must be committed before the next frame");
+
+    if (_fences[_frame])
+    {
+        _backend->deleteFence(_fences[_frame]);
+    }
+    _fences[_frame] = _backend->insertFence();
+
+    _frame = (_frame + 1) % FRAME_COUNT;
+    _regionOffset = 0;
+    _frameUploadedBytes = 0;
+}
+
+NS_CC_END
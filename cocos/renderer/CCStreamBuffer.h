@@ -0,0 +1,161 @@
+/****************************************************************************
+ Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_STREAM_BUFFER_H__
+#define __CC_STREAM_BUFFER_H__
+
+#include <vector>
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCGL.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+StreamBuffer streams the data written by the CPU every frame to a GL buffer object.
+The buffer object is split into FRAME_COUNT regions used in turn, one per frame, so the data of a frame
+is not written over the data that the GPU may still be reading for the previous frames.
+The data is written directly into the buffer object when it can be mapped, otherwise it is written
+into a CPU side copy and uploaded with glBufferSubData. The regions grow as needed.
+The mapping doesn't synchronize with the GPU: a fence is inserted at the end of each frame, and is waited
+for before the region of that frame is mapped again, in case the GPU is more than FRAME_COUNT - 1 frames late.
+The GL backend only maps the buffer object when fences are supported.
+*@js NA
+*/
+class CC_DLL StreamBuffer
+{
+public:
+    /**The number of frames using a region of the buffer object in turn.*/
+    static const int FRAME_COUNT = 3;
+
+    /**
+    Backend doing the GL calls of a StreamBuffer.
+    The default backend calls GL, another one can be used to run a StreamBuffer without GL, or to record its uploads.
+    */
+    class CC_DLL Backend
+    {
+    public:
+        virtual ~Backend() {}
+        /**Creates a buffer object.*/
+        virtual GLuint createBuffer() = 0;
+        /**Deletes a buffer object.*/
+        virtual void deleteBuffer(GLuint buffer) = 0;
+        /**Creates a new storage of `size` bytes for a buffer object, discarding the previous one.*/
+        virtual void allocate(GLenum target, GLuint buffer, size_t size) = 0;
+        /**
+        Maps a range of a buffer object for writing, without waiting for the GPU.
+        A backend which maps must also insert fences.
+        @return The address to write the range to, or nullptr if the buffer object can't be mapped.
+        */
+        virtual void* map(GLenum target, GLuint buffer, size_t offset, size_t size) = 0;
+        /**Unmaps the range mapped by `map`.*/
+        virtual void unmap(GLenum target, GLuint buffer) = 0;
+        /**Copies `size` bytes of data to a range of a buffer object.*/
+        virtual void upload(GLenum target, GLuint buffer, size_t offset, size_t size, const void* data) = 0;
+        /**
+        Inserts a fence after the GL commands issued so far.
+        @return The fence, or nullptr if the backend doesn't need fences because it doesn't map.
+        */
+        virtual void* insertFence() { return nullptr; }
+        /**Waits until the GPU passed a fence, then deletes it.*/
+        virtual void waitFence(void* /*fence*/) {}
+        /**Deletes a fence without waiting for it.*/
+        virtual void deleteFence(void* /*fence*/) {}
+    };
+
+    /**Get the backend calling GL, which is used by default.*/
+    static Backend* getGLBackend();
+
+    /**
+    Constructor.
+    @param target The target the buffer object is bound to, GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+    @param backend The backend doing the GL calls, nullptr to use the GL backend.
+    */
+    explicit StreamBuffer(GLenum target, Backend* backend = nullptr);
+    /**Destructor, deletes the buffer object.*/
+    ~StreamBuffer();
+
+    /**
+    Creates the buffer object. It must be called again when the GL context is recreated.
+    @param regionSize The initial size in bytes of the region of each frame.
+    */
+    void setup(size_t regionSize);
+    /**
+    Get the address to write the next `size` bytes of the frame to, valid until `commit` is called.
+    The writes must not read the memory back, it may be mapped from the GPU.
+    */
+    void* map(size_t size);
+    /**
+    Makes the bytes written since `map` available to the GPU.
+    @return The offset in bytes of the data in the buffer object.
+    */
+    size_t commit();
+    /**Moves to the region of the next frame, after fencing the GL commands of the frame.*/
+    void nextFrame();
+
+    /**Get the buffer object.*/
+    GLuint getBuffer() const { return _buffer; }
+    /**Get the size in bytes of the region of each frame.*/
+    size_t getRegionSize() const { return _regionSize; }
+    /**Get the number of bytes committed since the last `nextFrame`.*/
+    size_t getFrameUploadedBytes() const { return _frameUploadedBytes; }
+
+protected:
+    Backend* _backend;
+    GLenum _target;
+    GLuint _buffer;
+    /**Size of the region of each frame.*/
+    size_t _regionSize;
+    /**The frame whose region is being written.*/
+    int _frame;
+    /**Offset of the first free byte in the region of the frame.*/
+    size_t _regionOffset;
+    /**The range being written between map and commit, in the buffer object.*/
+    size_t _mappedOffset;
+    size_t _mappedSize;
+    /**Address of the range in the buffer object when it is mapped, nullptr when it is written into `_shadowCopy`.*/
+    void* _mappedData;
+    std::vector<unsigned char> _shadowCopy;
+    size_t _frameUploadedBytes;
+    /**The fence of the last frame which used each region, nullptr once waited for.*/
+    void* _fences[FRAME_COUNT];
+
+    void deleteFences();
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(StreamBuffer);
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif /* __CC_STREAM_BUFFER_H__ */
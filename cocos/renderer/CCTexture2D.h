@@ -548,6 +548,7 @@ protected:
     friend class SpriteFrameCache;
     friend class TextureCache;
     friend class ui::Scale9Sprite;
+    friend class FontBaked;
 
     bool _valid;
     std::string _filePath;
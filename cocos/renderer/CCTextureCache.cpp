@@ -67,9 +67,8 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _needQuit(false)
-, _asyncRefCount(0)
+: _asyncRefCount(0)
+, _asyncUploadBudget(0)
 {
 }
 
@@ -79,8 +78,6 @@ TextureCache::~TextureCache()
 
     for (auto& texture : _textures)
         texture.second->release();
-
-    CC_SAFE_DELETE(_loadingThread);
 }
 
 void TextureCache::destroyInstance()
@@ -104,49 +101,64 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct
-    ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
-      : filename(fn), callback(f),callbackKey( key ),
+    enum State
+    {
+        PENDING,
+        DECODING,
+        CANCELED,
+    };
+
+    struct Callback
+    {
+        std::string key;
+        std::function<void(Texture2D*)> function;
+    };
+
+    AsyncStruct(const std::string& fn)
+      : filename(fn),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        loadSuccess(false), state(PENDING)
     {}
 
     std::string filename;
-    std::function<void(Texture2D*)> callback;
-    std::string callbackKey;
+    // the callbacks of all the requests of the file, in the order of the requests
+    std::vector<Callback> callbacks;
     Image image;
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
     bool loadSuccess;
+    // set by the decoding job or by a cancellation, whichever comes first
+    std::atomic<int> state;
+    JobSystem::JobHandle job;
 };
 
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not create an AsyncStruct and schedule a job decoding it (GL thread)
+ - the job loads res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (JobSystem threads)
+ - on schedule callback, get AsyncStructs from _responseQueue, convert images to textures within the upload budget,
+   then release the AsyncStructs (GL thread)
 
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
  - _responseQueue: locked by _responseMutex
+ - AsyncStruct::state: atomic, the job only decodes if it turns it from PENDING to DECODING, before touching the
+   TextureCache since a canceled struct may outlive it
 
  the object's life time:
- - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - AsyncStruct: construct in GL thread, shared by the job, _asyncStructs and _responseQueue
+ - image data: new in a JobSystem thread, delete in GL thread(by Image instance)
 
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all pending AsyncStruct referenced in _asyncStructs by file name, for unbind function use.
+ - the images are decoded concurrently, the responses are handled in the order they finish.
 
  How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
  - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
+ - If the image request is pending already, the callback is added to the pending request, the image is decoded once.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Uploading a big texture can take a few milliseconds, so the bytes uploaded per frame can be limited
+ with setAsyncUploadBudget().
 
  Call unbindImageAsync(path) to prevent the call to the callback when the
  texture is loaded.
@@ -157,31 +169,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 }
 
 /**
- The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
- 
- the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
- 
- the object's life time:
- - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
- 
- Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
- 
- How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
- - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
- 
- Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ See above for the logic of addImageAsync.
 
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
@@ -204,20 +192,20 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
+    // the image is being loaded already
+    auto pending = _asyncStructs.find(fullpath);
+    if (pending != _asyncStructs.end())
+    {
+        pending->second->callbacks.push_back({ callbackKey, callback });
+        return;
+    }
+
     // check if file exists
     if (fullpath.empty() || !FileUtils::getInstance()->isFileExist(fullpath)) {
         if (callback) callback(nullptr);
         return;
     }
 
-    // lazy init
-    if (_loadingThread == nullptr)
-    {
-        // create a new thread to load images
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
-        _needQuit = false;
-    }
-
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this, 0, false);
@@ -226,94 +214,98 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
-    
-    // add async struct into queue
-    _asyncStructQueue.push_back(data);
-    _requestMutex.lock();
-    _requestQueue.push_back(data);
-    _requestMutex.unlock();
-
-    _sleepCondition.notify_one();
-}
-
-void TextureCache::unbindImageAsync(const std::string& callbackKey)
-{
-    if (_asyncStructQueue.empty())
+    auto data = std::make_shared<AsyncStruct>(fullpath);
+    data->callbacks.push_back({ callbackKey, callback });
+    _asyncStructs.emplace(fullpath, data);
+
+    // the images are decoded concurrently on the JobSystem
+    data->job = JobSystem::getInstance()->schedule([this, data]{
+        int expected = AsyncStruct::PENDING;
+        if (data->state.compare_exchange_strong(expected, AsyncStruct::DECODING))
+            loadImage(data);
+    });
+    _asyncJobs.erase(std::remove_if(_asyncJobs.begin(), _asyncJobs.end(), [](const JobSystem::JobHandle& job) {
+        return job->isFinished();
+    }), _asyncJobs.end());
+    _asyncJobs.push_back(data->job);
+}
+
+bool TextureCache::cancelImageAsync(const std::shared_ptr<AsyncStruct>& asyncStruct)
+{
+    int expected = AsyncStruct::PENDING;
+    if (!asyncStruct->state.compare_exchange_strong(expected, AsyncStruct::CANCELED))
     {
-        return;
+        // already decoding, the response will come
+        return false;
     }
 
-    for (auto& asyncStruct : _asyncStructQueue)
+    asyncStruct->job->cancel();
+    --_asyncRefCount;
+    if (0 == _asyncRefCount)
     {
-        if (asyncStruct->callbackKey == callbackKey)
-        {
-            asyncStruct->callback = nullptr;
-        }
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
     }
+    return true;
 }
 
-void TextureCache::unbindAllImageAsync()
+void TextureCache::unbindImageAsync(const std::string& callbackKey)
 {
-    if (_asyncStructQueue.empty())
-    {
-        return;
-
-    }
-    for (auto& asyncStruct : _asyncStructQueue)
+    for (auto it = _asyncStructs.begin(); it != _asyncStructs.end();)
     {
-        asyncStruct->callback = nullptr;
+        auto& callbacks = it->second->callbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(), [&](const AsyncStruct::Callback& callback) {
+            return callback.key == callbackKey;
+        }), callbacks.end());
+
+        // nobody waits for the image any more, don't decode it if it didn't start
+        if (callbacks.empty() && cancelImageAsync(it->second))
+            it = _asyncStructs.erase(it);
+        else
+            ++it;
     }
 }
 
-void TextureCache::loadImage()
+void TextureCache::unbindAllImageAsync()
 {
-    AsyncStruct *asyncStruct = nullptr;
-    std::mutex signalMutex;
-    std::unique_lock<std::mutex> signal(signalMutex);
-    while (!_needQuit)
+    for (auto it = _asyncStructs.begin(); it != _asyncStructs.end();)
     {
-        // pop an AsyncStruct from request queue
-        _requestMutex.lock();
-        if (_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
+        it->second->callbacks.clear();
+        if (cancelImageAsync(it->second))
+            it = _asyncStructs.erase(it);
         else
-        {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
-        }
-        _requestMutex.unlock();
+            ++it;
+    }
+}
 
-        if (nullptr == asyncStruct) {
-            _sleepCondition.wait(signal);
-            continue;
-        }
+void TextureCache::setAsyncUploadBudget(size_t bytes)
+{
+    _asyncUploadBudget = bytes;
+}
 
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+void TextureCache::loadImage(const std::shared_ptr<AsyncStruct>& asyncStruct)
+{
+    // load image
+    asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
 
-        // ETC1 ALPHA supports.
-        if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
-        { // check whether alpha texture exists & load it
-            auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
-            if (FileUtils::getInstance()->isFileExist(alphaFile))
-                asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
-        }
-        // push the asyncStruct to response queue
-        _responseMutex.lock();
-        _responseQueue.push_back(asyncStruct);
-        _responseMutex.unlock();
+    // ETC1 ALPHA supports.
+    if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
+    { // check whether alpha texture exists & load it
+        auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
+        if (FileUtils::getInstance()->isFileExist(alphaFile))
+            asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
     }
+    // push the asyncStruct to response queue
+    _responseMutex.lock();
+    _responseQueue.push_back(asyncStruct);
+    _responseMutex.unlock();
 }
 
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
     Texture2D *texture = nullptr;
-    AsyncStruct *asyncStruct = nullptr;
-    while (true)
+    std::shared_ptr<AsyncStruct> asyncStruct;
+    size_t uploadedBytes = 0;
+    while (_asyncUploadBudget == 0 || uploadedBytes < _asyncUploadBudget)
     {
         // pop an AsyncStruct from response queue
         _responseMutex.lock();
@@ -323,12 +315,8 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         }
         else
         {
-            asyncStruct = _responseQueue.front();
+            asyncStruct = std::move(_responseQueue.front());
             _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
         }
         _responseMutex.unlock();
 
@@ -336,6 +324,8 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             break;
         }
 
+        _asyncStructs.erase(asyncStruct->filename);
+
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
         if (it != _textures.end())
@@ -352,6 +342,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 texture = new (std::nothrow) Texture2D();
 
                 texture->initWithImage(image, asyncStruct->pixelFormat);
+                uploadedBytes += image->getDataLen();
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -368,6 +359,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                     auto alphaTexture = new(std::nothrow) Texture2D();
                     if(alphaTexture != nullptr && alphaTexture->initWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat)) {
                         texture->setAlphaTexture(alphaTexture);
+                        uploadedBytes += asyncStruct->imageAlpha.getDataLen();
                     }
                     CC_SAFE_RELEASE(alphaTexture);
                 }
@@ -378,14 +370,13 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             }
         }
 
-        // call callback function
-        if (asyncStruct->callback)
+        // call callback functions, the AsyncStruct isn't pending any more so they may request it again
+        for (auto& callback : asyncStruct->callbacks)
         {
-            (asyncStruct->callback)(texture);
+            if (callback.function)
+                callback.function(texture);
         }
 
-        // release the asyncStruct
-        delete asyncStruct;
         --_asyncRefCount;
     }
 
@@ -659,10 +650,24 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // drop the images which aren't being decoded, wait for the others. The canceled jobs are waited for too, one
+    // may have been taken by a thread before being canceled
+    unbindAllImageAsync();
+    for (auto& job : _asyncJobs)
+    {
+        if (!job->isFinished())
+            JobSystem::getInstance()->wait(job);
+    }
+    _asyncJobs.clear();
+    _asyncStructs.clear();
+    _responseMutex.lock();
+    _responseQueue.clear();
+    _responseMutex.unlock();
+    if (_asyncRefCount > 0)
+    {
+        _asyncRefCount = 0;
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include <functional>
 
 #include "base/CCRef.h"
+#include "base/CCJobSystem.h"
 #include "renderer/CCTexture2D.h"
 #include "platform/CCImage.h"
 
@@ -129,16 +130,27 @@ public:
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
+     * If no other callback waits for the image and its decoding didn't start, the loading is canceled.
      * @param filename It's the related/absolute path of the file image.
      * @since v3.1
      */
     virtual void unbindImageAsync(const std::string &filename);
     
-    /** Unbind all bound image asynchronous load callbacks.
+    /** Unbind all bound image asynchronous load callbacks, and cancel the loadings which didn't start.
      * @since v3.1
      */
     virtual void unbindAllImageAsync();
 
+    /** Sets how many bytes of images loaded by addImageAsync() are uploaded to textures per frame, to keep the frames short
+     * while loading. At least one image is uploaded per frame. 0, the default, means no limit.
+     * @param bytes The number of bytes per frame.
+     */
+    void setAsyncUploadBudget(size_t bytes);
+
+    /** Returns how many bytes of images loaded by addImageAsync() are uploaded to textures per frame, 0 means no limit.
+     */
+    size_t getAsyncUploadBudget() const { return _asyncUploadBudget; }
+
     /** Returns a Texture2D object given an Image.
     * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image.
@@ -220,27 +232,26 @@ public:
 
 
 private:
+    struct AsyncStruct;
+
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void loadImage(const std::shared_ptr<AsyncStruct>& asyncStruct);
+    bool cancelImageAsync(const std::shared_ptr<AsyncStruct>& asyncStruct);
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
 public:
 protected:
-    struct AsyncStruct;
-    
-    std::thread* _loadingThread;
+    // the images being loaded, by full path
+    std::unordered_map<std::string, std::shared_ptr<AsyncStruct>> _asyncStructs;
+    // the decoded images, waiting to be uploaded
+    std::deque<std::shared_ptr<AsyncStruct>> _responseQueue;
 
-    std::deque<AsyncStruct*> _asyncStructQueue;
-    std::deque<AsyncStruct*> _requestQueue;
-    std::deque<AsyncStruct*> _responseQueue;
-
-    std::mutex _requestMutex;
     std::mutex _responseMutex;
-    
-    std::condition_variable _sleepCondition;
 
-    bool _needQuit;
+    // the decoding jobs which may not have finished, canceled ones included, for waitForQuit()
+    std::vector<JobSystem::JobHandle> _asyncJobs;
 
     int _asyncRefCount;
+    size_t _asyncUploadBudget;
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
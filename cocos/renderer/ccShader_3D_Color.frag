@@ -6,10 +6,18 @@ varying lowp vec4 DestinationColor;
 #else
 varying vec4 DestinationColor;
 #endif
+#ifdef USE_INSTANCING
+varying vec4 InstanceColorOut;
+#else
 uniform vec4 u_color;
+#endif
 
 void main(void)
 {
+#ifdef USE_INSTANCING
+    gl_FragColor = InstanceColorOut;
+#else
     gl_FragColor = u_color;
+#endif
 }
 )";
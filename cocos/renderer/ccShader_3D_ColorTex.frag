@@ -6,10 +6,18 @@ varying mediump vec2 TextureCoordOut;
 #else
 varying vec2 TextureCoordOut;
 #endif
+#ifdef USE_INSTANCING
+varying vec4 InstanceColorOut;
+#else
 uniform vec4 u_color;
+#endif
 
 void main(void)
 {
+#ifdef USE_INSTANCING
+    gl_FragColor = texture2D(CC_Texture0, TextureCoordOut) * InstanceColorOut;
+#else
     gl_FragColor = texture2D(CC_Texture0, TextureCoordOut) * u_color;
+#endif
 }
 )";
@@ -4,11 +4,22 @@ const char* cc3D_PositionTex_vert = R"(
 attribute vec4 a_position;
 attribute vec2 a_texCoord;
 
+#ifdef USE_INSTANCING
+attribute mat4 a_instanceTransform;
+attribute vec4 a_instanceColor;
+
+varying vec4 InstanceColorOut;
+#endif
 varying vec2 TextureCoordOut;
 
 void main(void)
 {
+#ifdef USE_INSTANCING
+    gl_Position = CC_PMatrix * a_instanceTransform * a_position;
+    InstanceColorOut = a_instanceColor;
+#else
     gl_Position = CC_MVPMatrix * a_position;
+#endif
     TextureCoordOut = a_texCoord;
     TextureCoordOut.y = 1.0 - TextureCoordOut.y;
 }
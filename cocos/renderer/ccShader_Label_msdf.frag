@@ -0,0 +1,27 @@
+const char* ccLabelMSDFNormal_frag = R"(
+
+#ifdef GL_ES
+precision lowp float;
+#endif
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+uniform vec4 u_textColor;
+
+float median(float r, float g, float b)
+{
+    return max(min(r, g), min(max(r, g), b));
+}
+
+void main()
+{
+    vec3 color = texture2D(CC_Texture0, v_texCoord).rgb;
+    // each channel is the distance to the edges of its color, the median keeps the corners sharp
+    float dist = median(color.r, color.g, color.b);
+    //assign width for constant will lead to a little bit fuzzy,it's temporary measure.
+    float width = 0.04;
+    float alpha = smoothstep(0.5-width, 0.5+width, dist) * u_textColor.a;
+    gl_FragColor = v_fragmentColor * vec4(u_textColor.rgb,alpha);
+}
+)";
@@ -0,0 +1,30 @@
+const char* ccLabelMSDFGlow_frag = R"(
+
+#ifdef GL_ES
+precision lowp float;
+#endif
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+uniform vec4 u_effectColor;
+uniform vec4 u_textColor;
+
+float median(float r, float g, float b)
+{
+    return max(min(r, g), min(max(r, g), b));
+}
+
+void main()
+{
+    vec3 field = texture2D(CC_Texture0, v_texCoord).rgb;
+    float dist = median(field.r, field.g, field.b);
+    //assign width for constant will lead to a little bit fuzzy,it's temporary measure.
+    float width = 0.04;
+    float alpha = smoothstep(0.5-width, 0.5+width, dist);
+    //glow
+    float mu = smoothstep(0.5, 1.0, sqrt(dist));
+    vec4 color = u_effectColor*(1.0-alpha) + u_textColor*alpha;
+    gl_FragColor = v_fragmentColor * vec4(color.rgb, max(alpha,mu)*color.a);
+}
+)";
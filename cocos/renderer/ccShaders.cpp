@@ -73,6 +73,8 @@ NS_CC_BEGIN
 #include "renderer/ccShader_Label.vert"
 #include "renderer/ccShader_Label_df.frag"
 #include "renderer/ccShader_Label_df_glow.frag"
+#include "renderer/ccShader_Label_msdf.frag"
+#include "renderer/ccShader_Label_msdf_glow.frag"
 #include "renderer/ccShader_Label_normal.frag"
 #include "renderer/ccShader_Label_outline.frag"
 
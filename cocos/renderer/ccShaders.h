@@ -70,6 +70,8 @@ extern CC_DLL const GLchar * ccPositionTexture_GrayScale_frag;
 
 extern CC_DLL const GLchar * ccLabelDistanceFieldNormal_frag;
 extern CC_DLL const GLchar * ccLabelDistanceFieldGlow_frag;
+extern CC_DLL const GLchar * ccLabelMSDFNormal_frag;
+extern CC_DLL const GLchar * ccLabelMSDFGlow_frag;
 extern CC_DLL const GLchar * ccLabelNormal_frag;
 extern CC_DLL const GLchar * ccLabelOutline_frag;
 
@@ -14,6 +14,7 @@ FileUtilsTests::FileUtilsTests()
     ADD_TEST_CASE(TextWritePlist);
     ADD_TEST_CASE(TestWriteString);
     ADD_TEST_CASE(TestGetContents);
+    ADD_TEST_CASE(TestSearchArchive);
     ADD_TEST_CASE(TestWriteData);
     ADD_TEST_CASE(TestWriteValueMap);
     ADD_TEST_CASE(TestWriteValueVector);
@@ -722,6 +723,124 @@ std::string TestGetContents::subtitle() const
     return "";
 }
 
+// TestSearchArchive
+
+void TestSearchArchive::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto fs = FileUtils::getInstance();
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto readResult = Label::createWithTTF("show readResult", "fonts/Thonburi.ttf", 16);
+    this->addChild(readResult);
+    readResult->setPosition(winSize.width / 2, winSize.height / 2);
+
+    // Misc/archive.zip holds stored.txt without compression and deflated.txt deflated
+    const std::string archive = "Misc/archive.zip";
+    const std::string storedText = "This file is stored without compression.\n";
+    std::string deflatedText;
+    for (int i = 0; i < 20; ++i)
+        deflatedText += "This file is deflated. ";
+    deflatedText += "\n";
+
+    // a copy cut in half loses its central directory, one with a broken local header keeps it
+    Data archiveData = fs->getDataFromFile(archive);
+    _truncatedArchive = fs->getWritablePath() + "truncated-archive.zip";
+    _corruptArchive = fs->getWritablePath() + "corrupt-archive.zip";
+    if (!archiveData.isNull())
+    {
+        Data truncated;
+        truncated.copy(archiveData.getBytes(), archiveData.getSize() / 2);
+        fs->writeDataToFile(truncated, _truncatedArchive);
+
+        // the local header of deflated.txt is the second one
+        std::string corrupt((const char*)archiveData.getBytes(), archiveData.getSize());
+        size_t localHeader = corrupt.find(std::string("PK\3\4", 4), 1);
+        if (localHeader != std::string::npos)
+            corrupt[localHeader] = 'X';
+        Data corruptData;
+        corruptData.copy((const unsigned char*)corrupt.data(), corrupt.size());
+        fs->writeDataToFile(corruptData, _corruptArchive);
+    }
+
+    auto runTests = [&]() {
+        if (archiveData.isNull())
+            return std::string("failed: " + archive + " is missing");
+
+        if (!fs->addSearchArchive(archive, "", true))
+            return std::string("failed: addSearchArchive");
+
+        std::string fullPath = fs->fullPathForFilename("stored.txt");
+        const std::string suffix = "archive.zip/stored.txt";
+        if (fullPath.size() < suffix.size() || fullPath.compare(fullPath.size() - suffix.size(), suffix.size(), suffix) != 0)
+            return std::string("failed: stored.txt resolves to " + fullPath);
+        if (!fs->isFileExist("deflated.txt") || fs->getFileSize("deflated.txt") != (long)deflatedText.size())
+            return std::string("failed: deflated.txt isn't found in the archive");
+
+        // the stored entry is viewed in the mapping, the deflated one can't be
+        const unsigned char* view = nullptr;
+        ssize_t viewSize = 0;
+        if (!fs->getFileView("stored.txt", &view, &viewSize) || viewSize != (ssize_t)storedText.size()
+            || memcmp(view, storedText.data(), storedText.size()) != 0)
+            return std::string("failed: getFileView of the stored file");
+        if (fs->getFileView("deflated.txt", &view, &viewSize))
+            return std::string("failed: getFileView of the deflated file");
+
+        std::string stored;
+        auto err = fs->getContents("stored.txt", &stored);
+        if (err != FileUtils::Status::OK || stored != storedText)
+            return std::string("failed: getContents of the stored file: " + FileErrors[(int)err]);
+        std::string deflated;
+        err = fs->getContents("deflated.txt", &deflated);
+        if (err != FileUtils::Status::OK || deflated != deflatedText)
+            return std::string("failed: getContents of the deflated file: " + FileErrors[(int)err]);
+
+        fs->removeSearchArchive(archive);
+        if (fs->isFileExist("stored.txt"))
+            return std::string("failed: removeSearchArchive");
+
+        if (fs->addSearchArchive(_truncatedArchive))
+        {
+            fs->removeSearchArchive(_truncatedArchive);
+            return std::string("failed: the truncated archive was added");
+        }
+
+        if (!fs->addSearchArchive(_corruptArchive, "", true))
+            return std::string("failed: addSearchArchive of the corrupt archive");
+        err = fs->getContents("deflated.txt", &deflated);
+        auto storedErr = fs->getContents("stored.txt", &stored);
+        fs->removeSearchArchive(_corruptArchive);
+        if (err != FileUtils::Status::ReadFailed)
+            return std::string("failed: the broken entry was read: " + FileErrors[(int)err]);
+        if (storedErr != FileUtils::Status::OK || stored != storedText)
+            return std::string("failed: the intact entry of the corrupt archive: " + FileErrors[(int)storedErr]);
+
+        return std::string("read success");
+    };
+    readResult->setString("FileUtils::addSearchArchive() " + runTests());
+}
+
+void TestSearchArchive::onExit()
+{
+    auto fs = FileUtils::getInstance();
+    fs->removeSearchArchive("Misc/archive.zip");
+    fs->removeFile(_truncatedArchive);
+    fs->removeFile(_corruptArchive);
+
+    FileUtilsDemo::onExit();
+}
+
+std::string TestSearchArchive::title() const
+{
+    return "FileUtils: TestSearchArchive";
+}
+
+std::string TestSearchArchive::subtitle() const
+{
+    return "A stored and a deflated file in a zip archive";
+}
+
 void TestWriteData::onEnter()
 {
     FileUtilsDemo::onEnter();
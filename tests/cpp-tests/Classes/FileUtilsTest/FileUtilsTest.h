@@ -126,6 +126,20 @@ private:
     std::string _generatedFile;
 };
 
+class TestSearchArchive : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestSearchArchive);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::string _truncatedArchive;
+    std::string _corruptArchive;
+};
+
 class TestWriteData : public FileUtilsDemo
 {
 public:
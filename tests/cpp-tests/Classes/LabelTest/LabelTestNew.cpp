@@ -2,6 +2,12 @@
 #include "../testResource.h"
 #include "renderer/CCRenderer.h"
 #include "2d/CCFontAtlasCache.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontBaked.h"
+#include "2d/CCFontFreeType.h"
+#include "2d/CCFontGlyphCache.h"
+
+#include <chrono>
 
 USING_NS_CC;
 using namespace ui;
@@ -113,6 +119,9 @@ NewLabelTests::NewLabelTests()
     ADD_TEST_CASE(LabelIssue16471);
     ADD_TEST_CASE(LabelIssue16717);
     ADD_TEST_CASE(LabelIssueLineGap);
+    ADD_TEST_CASE(LabelTTFMultiChannelDistanceField);
+    ADD_TEST_CASE(LabelTTFAsyncGlyphs);
+    ADD_TEST_CASE(LabelBakedFont);
 };
 
 LabelFNTColorAndOpacity::LabelFNTColorAndOpacity()
@@ -3398,3 +3407,150 @@ std::string LabelIssueLineGap::subtitle() const
 }
 
 
+
+//
+// LabelTTFMultiChannelDistanceField
+//
+LabelTTFMultiChannelDistanceField::LabelTTFMultiChannelDistanceField()
+{
+    auto size = Director::getInstance()->getWinSize();
+    TTFConfig ttfConfig("fonts/arial.ttf", 24, GlyphCollection::DYNAMIC, nullptr, true);
+
+    auto label1 = Label::createWithTTF(ttfConfig, "Single channel", TextHAlignment::CENTER, size.width);
+    label1->setPosition(Vec2(size.width / 2, size.height * 0.65f));
+    label1->setTextColor(Color4B::GREEN);
+    addChild(label1);
+
+    auto previous = FontFreeType::isMultiChannelDistanceFieldEnabled();
+    FontFreeType::setMultiChannelDistanceFieldEnabled(true);
+    auto label2 = Label::createWithTTF(ttfConfig, "Multi-channel", TextHAlignment::CENTER, size.width);
+    FontFreeType::setMultiChannelDistanceFieldEnabled(previous);
+    label2->setPosition(Vec2(size.width / 2, size.height * 0.35f));
+    label2->setTextColor(Color4B::GREEN);
+    addChild(label2);
+
+    for (auto label : { label1, label2 })
+    {
+        auto action = Sequence::create(
+            DelayTime::create(1.0f),
+            ScaleTo::create(6.0f, 4.0f, 4.0f),
+            ScaleTo::create(6.0f, 1.0f, 1.0f),
+            nullptr);
+        label->runAction(RepeatForever::create(action));
+    }
+}
+
+std::string LabelTTFMultiChannelDistanceField::title() const
+{
+    return "New Label + .TTF";
+}
+
+std::string LabelTTFMultiChannelDistanceField::subtitle() const
+{
+    return "The corners of the multi-channel distance field label should stay sharp";
+}
+
+//
+// LabelTTFAsyncGlyphs
+//
+LabelTTFAsyncGlyphs::LabelTTFAsyncGlyphs()
+: _label(nullptr)
+, _infoLabel(nullptr)
+, _firstChar(0x4E00)
+{
+}
+
+void LabelTTFAsyncGlyphs::onEnter()
+{
+    AtlasDemoNew::onEnter();
+
+    // the CJK ideographs are rendered on the job system and cached on the disk
+    FontAtlas::setAsyncRasterizationEnabled(true);
+    FontGlyphCache::setEnabled(true);
+
+    auto size = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/HKYuanMini.ttf", 24, Size(size.width * 0.8f, 0));
+    _label->setPosition(Vec2(size.width / 2, size.height / 2));
+    addChild(_label);
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _infoLabel->setPosition(Vec2(size.width / 2, size.height * 0.2f));
+    addChild(_infoLabel);
+
+    updateText(0);
+    schedule(CC_SCHEDULE_SELECTOR(LabelTTFAsyncGlyphs::updateText), 1.0f);
+}
+
+void LabelTTFAsyncGlyphs::onExit()
+{
+    FontAtlas::setAsyncRasterizationEnabled(false);
+    FontGlyphCache::setEnabled(false);
+    AtlasDemoNew::onExit();
+}
+
+void LabelTTFAsyncGlyphs::updateText(float dt)
+{
+    // 60 new characters every second
+    std::u32string text;
+    for (int i = 0; i < 60; ++i)
+    {
+        text.push_back(static_cast<char32_t>(_firstChar + i));
+    }
+    _firstChar += 60;
+
+    std::string utf8;
+    StringUtils::UTF32ToUTF8(text, utf8);
+    auto start = std::chrono::steady_clock::now();
+    _label->setString(utf8);
+    _label->getContentSize();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    _infoLabel->setString(StringUtils::format("setString + layout: %.2f ms", duration.count() / 1000.0f));
+}
+
+std::string LabelTTFAsyncGlyphs::title() const
+{
+    return "Asynchronous glyph rendering";
+}
+
+std::string LabelTTFAsyncGlyphs::subtitle() const
+{
+    return "New characters appear once rendered, without stalling the frame";
+}
+
+//
+// LabelBakedFont
+//
+LabelBakedFont::LabelBakedFont()
+{
+    auto size = Director::getInstance()->getWinSize();
+    auto writablePath = FileUtils::getInstance()->getWritablePath();
+    std::string text = "Baked fonts, AVAW Ty 0123";
+
+    // bake at runtime for the test, games bake them offline and ship the .cfa files
+    auto ttfPath = writablePath + "arial-24-df" + FontBaked::FILE_EXTENSION;
+    if (FontBaked::bakeFontFreeType("fonts/arial.ttf", 24, text, true, 0, ttfPath, 512))
+    {
+        auto label = Label::createWithTTF(text, ttfPath, 24);
+        label->setPosition(Vec2(size.width / 2, size.height * 0.65f));
+        label->setTextColor(Color4B::GREEN);
+        addChild(label);
+    }
+
+    auto fntPath = writablePath + "bitmapFontTest" + FontBaked::FILE_EXTENSION;
+    if (FontBaked::bakeFontFNT("fonts/bitmapFontTest.fnt", fntPath))
+    {
+        auto label = Label::createWithBMFont(fntPath, text);
+        label->setPosition(Vec2(size.width / 2, size.height * 0.35f));
+        addChild(label);
+    }
+}
+
+std::string LabelBakedFont::title() const
+{
+    return "Pre-baked font atlases";
+}
+
+std::string LabelBakedFont::subtitle() const
+{
+    return "Both labels use fonts loaded from baked .cfa files";
+}
@@ -916,4 +916,46 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class LabelTTFMultiChannelDistanceField : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTTFMultiChannelDistanceField);
+
+    LabelTTFMultiChannelDistanceField();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class LabelTTFAsyncGlyphs : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTTFAsyncGlyphs);
+
+    LabelTTFAsyncGlyphs();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void updateText(float dt);
+
+    cocos2d::Label* _label;
+    cocos2d::Label* _infoLabel;
+    int _firstChar;
+};
+
+class LabelBakedFont : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelBakedFont);
+
+    LabelBakedFont();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
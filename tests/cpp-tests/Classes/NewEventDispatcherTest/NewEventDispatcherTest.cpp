@@ -32,6 +32,7 @@ EventDispatcherTests::EventDispatcherTests()
     ADD_TEST_CASE(WindowEventsTest);
     ADD_TEST_CASE(Issue8194);
     ADD_TEST_CASE(Issue9898)
+    ADD_TEST_CASE(TouchHitTestIndexTest);
 }
 
 std::string EventDispatcherTestDemo::title() const
@@ -1510,3 +1511,146 @@ std::string Issue9898::subtitle() const
 {
     return  "Should not crash if dispatch event after remove\n event listener in callback";
 }
+
+// TouchHitTestIndexTest
+
+TouchHitTestIndexTest::TouchHitTestIndexTest()
+{
+    auto origin = Director::getInstance()->getVisibleOrigin();
+    auto size = Director::getInstance()->getVisibleSize();
+
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->onTouchBegan = [this](Touch* touch, Event* event){
+        auto target = event->getCurrentTarget();
+        Vec2 locationInNode = target->convertToNodeSpace(touch->getLocation());
+        Size s = target->getContentSize();
+        if (Rect(0, 0, s.width, s.height).containsPoint(locationInNode))
+            _hits.push_back(target->getTag());
+        // don't claim the touch, so that every listener sees it
+        return false;
+    };
+
+    // overlapping squares in a few levels, with negative local Z orders, a global Z order, rotations and scales
+    _root = Node::create();
+    _root->setPosition(origin.x + size.width / 4, origin.y + size.height / 4);
+    addChild(_root);
+
+    int tag = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        auto parent = LayerColor::create(Color4B(60 * i, 100, 200, 128), 120, 90);
+        parent->setPosition(i * 50.0f, i * 30.0f);
+        parent->setTag(++tag);
+        _root->addChild(parent, i % 2 ? -1 : i);
+        _eventDispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), parent);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            auto child = Sprite::create("Images/CyanSquare.png");
+            child->setPosition(20.0f + j * 35, 15.0f + j * 25);
+            child->setRotation(j * 30.0f);
+            child->setScale(0.5f + j * 0.25f);
+            child->setTag(++tag);
+            parent->addChild(child, j - 1);
+            _eventDispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), child);
+        }
+    }
+
+    auto onTop = Sprite::create("Images/YellowSquare.png");
+    onTop->setPosition(100, 80);
+    onTop->setGlobalZOrder(1);
+    onTop->setTag(++tag);
+    _root->addChild(onTop, -2);
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), onTop);
+
+    // no content size, so the index can't bound it and always tests it
+    auto empty = Node::create();
+    empty->setTag(++tag);
+    _root->addChild(empty);
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), empty);
+
+    _result = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _result->setPosition(origin.x + size.width / 2, origin.y + size.height - 80);
+    addChild(_result);
+}
+
+void TouchHitTestIndexTest::onEnterTransitionDidFinish()
+{
+    EventDispatcherTestDemo::onEnterTransitionDidFinish();
+
+    auto wasEnabled = EventDispatcher::isTouchHitTestIndexEnabled();
+    std::string result = compareHitTests("initial");
+
+    // moved without being visited in between, the index must not use the bounds it had
+    if (result.empty())
+    {
+        _root->setPosition(_root->getPosition() + Vec2(40, 20));
+        _root->getChildByTag(1)->setRotation(15);
+        _root->getChildByTag(5)->setScale(1.5f);
+        _root->getChildByTag(5)->getChildByTag(6)->setPosition(60, 60);
+        result = compareHitTests("moved");
+    }
+    if (result.empty())
+    {
+        _root->getChildByTag(9)->setVisible(false);
+        _root->getChildByTag(9)->setPosition(0, 0);
+        _root->getChildByTag(9)->setVisible(true);
+        _root->reorderChild(_root->getChildByTag(13), 5);
+        result = compareHitTests("reordered");
+    }
+
+    EventDispatcher::setTouchHitTestIndexEnabled(wasEnabled);
+    log("TouchHitTestIndexTest: %s", result.empty() ? "passed" : result.c_str());
+    _result->setString(result.empty() ? "passed" : result);
+}
+
+std::vector<int> TouchHitTestIndexTest::dispatchTouchBegan(const Vec2& location, bool useHitTestIndex)
+{
+    EventDispatcher::setTouchHitTestIndexEnabled(useHitTestIndex);
+
+    auto touch = new (std::nothrow) Touch();
+    Vec2 point = Director::getInstance()->convertToUI(location);
+    touch->setTouchInfo(0, point.x, point.y);
+
+    EventTouch event;
+    event.setEventCode(EventTouch::EventCode::BEGAN);
+    event.setTouches({ touch });
+    _hits.clear();
+    _eventDispatcher->dispatchEvent(&event);
+    touch->release();
+    return _hits;
+}
+
+std::string TouchHitTestIndexTest::compareHitTests(const std::string& stage)
+{
+    if (Director::getInstance()->getRunningScene() != this)
+        return "failed: the test scene isn't running";
+
+    auto origin = Director::getInstance()->getVisibleOrigin();
+    auto size = Director::getInstance()->getVisibleSize();
+    int hitCount = 0;
+    for (float y = origin.y; y < origin.y + size.height; y += 7)
+    {
+        for (float x = origin.x; x < origin.x + size.width; x += 9)
+        {
+            auto sorted = dispatchTouchBegan(Vec2(x, y), false);
+            auto indexed = dispatchTouchBegan(Vec2(x, y), true);
+            if (sorted != indexed)
+                return StringUtils::format("failed: %s, the listeners hit at (%.0f, %.0f) differ", stage.c_str(), x, y);
+            hitCount += (int)sorted.size();
+        }
+    }
+    if (hitCount == 0)
+        return "failed: " + stage + ", no listener was hit";
+    return "";
+}
+
+std::string TouchHitTestIndexTest::title() const
+{
+    return "Touch hit-test index";
+}
+
+std::string TouchHitTestIndexTest::subtitle() const
+{
+    return "The indexed and sorted dispatches should hit the same listeners in the same order";
+}
@@ -254,4 +254,24 @@ private:
     cocos2d::EventListenerCustom* _listener;
 };
 
+class TouchHitTestIndexTest : public EventDispatcherTestDemo
+{
+public:
+    CREATE_FUNC(TouchHitTestIndexTest);
+    TouchHitTestIndexTest();
+
+    virtual void onEnterTransitionDidFinish() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    std::vector<int> dispatchTouchBegan(const cocos2d::Vec2& location, bool useHitTestIndex);
+    std::string compareHitTests(const std::string& stage);
+
+    cocos2d::Node* _root;
+    cocos2d::Label* _result;
+    // the tags of the nodes hit by the last touch, in the order their listeners were called
+    std::vector<int> _hits;
+};
+
 #endif /* defined(__samples__NewEventDispatcherTest__) */
@@ -70,6 +70,8 @@ Sprite3DTests::Sprite3DTests()
     ADD_TEST_CASE(Sprite3DPropertyTest);
     ADD_TEST_CASE(Sprite3DNormalMappingTest);
     ADD_TEST_CASE(Issue16155Test);
+    ADD_TEST_CASE(Sprite3DSkinCrowdTest);
+    ADD_TEST_CASE(Sprite3DInstancingTest);
 };
 
 //------------------------------------------------------------------
@@ -834,11 +836,14 @@ AsyncLoadSprite3DTest::AsyncLoadSprite3DTest()
     TTFConfig ttfConfig("fonts/arial.ttf", 15);
     auto label1 = Label::createWithTTF(ttfConfig,"AsyncLoad Sprite3D");
     auto item1 = MenuItemLabel::create(label1,CC_CALLBACK_1(AsyncLoadSprite3DTest::menuCallback_asyncLoadSprite,this) );
+    auto label2 = Label::createWithTTF(ttfConfig,"Upload budget: none");
+    _budgetItem = MenuItemLabel::create(label2,CC_CALLBACK_1(AsyncLoadSprite3DTest::menuCallback_switchUploadBudget,this) );
     
     auto s = Director::getInstance()->getWinSize();
     item1->setPosition( s.width * .5f, s.height * .8f);
+    _budgetItem->setPosition( s.width * .5f, s.height * .8f - 20);
     
-    auto pMenu1 = Menu::create(item1, nullptr);
+    auto pMenu1 = Menu::create(item1, _budgetItem, nullptr);
     pMenu1->setPosition(Vec2(0,0));
     this->addChild(pMenu1, 10);
     
@@ -862,6 +867,28 @@ std::string AsyncLoadSprite3DTest::subtitle() const
     return "";
 }
 
+void AsyncLoadSprite3DTest::onExit()
+{
+    Sprite3D::setAsyncUploadBudget(0);
+    Sprite3DTestDemo::onExit();
+}
+
+void AsyncLoadSprite3DTest::menuCallback_switchUploadBudget(Ref* sender)
+{
+    // spread the buffer uploads of the loaded sprites over the frames
+    if (Sprite3D::getAsyncUploadBudget() == 0)
+    {
+        Sprite3D::setAsyncUploadBudget(64 * 1024);
+        _budgetItem->setString("Upload budget: 64 KB per frame");
+    }
+    else
+    {
+        Sprite3D::setAsyncUploadBudget(0);
+        _budgetItem->setString("Upload budget: none");
+    }
+    menuCallback_asyncLoadSprite(sender);
+}
+
 void AsyncLoadSprite3DTest::menuCallback_asyncLoadSprite(Ref* sender)
 {
     //Note that you must stop the tasks before leaving the scene.
@@ -2719,3 +2746,132 @@ std::string Issue16155Test::subtitle() const
 {
     return "Should not leak texture. See console";
 }
+
+Sprite3DSkinCrowdTest::Sprite3DSkinCrowdTest()
+: _isResampled(false)
+{
+    auto s = Director::getInstance()->getWinSize();
+    std::string fileName = "Sprite3DTest/orc.c3b";
+    auto animation = Animation3D::create(fileName);
+
+    // 200 orcs, every other row playing the animation at another speed
+    const int columns = 20, rows = 10;
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            auto sprite = Sprite3D::create(fileName);
+            sprite->setScale(1.5f);
+            sprite->setRotation3D(Vec3(0, 180, 0));
+            sprite->setPosition(Vec2(s.width * (column + 0.5f) / columns, s.height * (row + 0.5f) / (rows + 2)));
+            addChild(sprite);
+
+            if (animation)
+            {
+                auto animate = Animate3D::create(animation);
+                animate->setSpeed(row % 2 ? 1.0f : 0.5f);
+                sprite->runAction(RepeatForever::create(animate));
+            }
+        }
+    }
+
+    MenuItemFont::setFontName("fonts/arial.ttf");
+    MenuItemFont::setFontSize(15);
+    _parallelItem = MenuItemFont::create("Toggle parallel update", [this](Ref*) {
+        Skeleton3D::setParallelUpdateEnabled(!Skeleton3D::isParallelUpdateEnabled());
+        _sharingItem->setString(getSettingsMessage());
+    });
+    _sharingItem = MenuItemFont::create(getSettingsMessage(), [this](Ref*) {
+        Skeleton3D::setPoseSharingEnabled(!Skeleton3D::isPoseSharingEnabled());
+        _sharingItem->setString(getSettingsMessage());
+    });
+    auto resampleItem = MenuItemFont::create("Pre-sample the animation (30 fps)", [this, animation](Ref* sender) {
+        if (animation && !_isResampled)
+        {
+            animation->resample(30.0f);
+            _isResampled = true;
+            static_cast<MenuItemFont*>(sender)->setString("Animation pre-sampled");
+        }
+    });
+    auto menu = Menu::create(_parallelItem, _sharingItem, resampleItem, nullptr);
+    menu->alignItemsHorizontallyWithPadding(40);
+    menu->setPosition(Vec2(s.width / 2, VisibleRect::top().y - 70));
+    addChild(menu, 1);
+}
+
+void Sprite3DSkinCrowdTest::onExit()
+{
+    Skeleton3D::setParallelUpdateEnabled(false);
+    Skeleton3D::setPoseSharingEnabled(false);
+    // the other tests must not get the pre-sampled animation from the cache
+    if (_isResampled)
+        Animation3DCache::getInstance()->removeAllAnimations();
+    Sprite3DTestDemo::onExit();
+}
+
+std::string Sprite3DSkinCrowdTest::getSettingsMessage() const
+{
+    return StringUtils::format("Toggle pose sharing (parallel: %s, sharing: %s)",
+        Skeleton3D::isParallelUpdateEnabled() ? "on" : "off", Skeleton3D::isPoseSharingEnabled() ? "on" : "off");
+}
+
+std::string Sprite3DSkinCrowdTest::title() const
+{
+    return "Skinned Sprite3D crowd";
+}
+std::string Sprite3DSkinCrowdTest::subtitle() const
+{
+    return "Compare the frame time with the parallel update, the pose sharing and the pre-sampling";
+}
+
+Sprite3DInstancingTest::Sprite3DInstancingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // 400 ships sharing their mesh and texture, with different tints
+    const int columns = 25, rows = 16;
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            auto sprite = Sprite3D::create("Sprite3DTest/boss1.obj");
+            sprite->setTexture("Sprite3DTest/boss.png");
+            sprite->setScale(1.5f);
+            sprite->setColor(Color3B(155 + column * 4, 155 + row * 6, 255));
+            sprite->setPosition(Vec2(s.width * (column + 0.5f) / columns, s.height * (row + 0.5f) / (rows + 2)));
+            sprite->runAction(RepeatForever::create(RotateBy::create(2.0f + (row + column) % 5, Vec3(0, 360, 0))));
+            addChild(sprite);
+        }
+    }
+
+    MenuItemFont::setFontName("fonts/arial.ttf");
+    MenuItemFont::setFontSize(15);
+    _instancingItem = MenuItemFont::create(getSettingsMessage(), [this](Ref*) {
+        Sprite3D::setInstancedRenderingEnabled(!Sprite3D::isInstancedRenderingEnabled());
+        _instancingItem->setString(getSettingsMessage());
+    });
+    auto menu = Menu::create(_instancingItem, nullptr);
+    menu->setPosition(Vec2(s.width / 2, VisibleRect::top().y - 70));
+    addChild(menu, 1);
+}
+
+void Sprite3DInstancingTest::onExit()
+{
+    Sprite3D::setInstancedRenderingEnabled(false);
+    Sprite3DTestDemo::onExit();
+}
+
+std::string Sprite3DInstancingTest::getSettingsMessage() const
+{
+    return StringUtils::format("Toggle instancing (instancing: %s, supported: %s)",
+        Sprite3D::isInstancedRenderingEnabled() ? "on" : "off", Configuration::getInstance()->supportsInstancedArrays() ? "yes" : "no");
+}
+
+std::string Sprite3DInstancingTest::title() const
+{
+    return "Sprite3D instanced rendering";
+}
+std::string Sprite3DInstancingTest::subtitle() const
+{
+    return "The draw calls drop to one with instancing";
+}
@@ -206,12 +206,16 @@ public:
     virtual std::string title() const override;
     virtual std::string subtitle() const override;
     
+    virtual void onExit() override;
+    
     void menuCallback_asyncLoadSprite(cocos2d::Ref* sender);
+    void menuCallback_switchUploadBudget(cocos2d::Ref* sender);
     
     void asyncLoad_Callback(cocos2d::Sprite3D* sprite, void* param);
     
 protected:
     std::vector<std::string> _paths; //model paths to be loaded
+    cocos2d::MenuItemLabel* _budgetItem;
 };
 
 class Sprite3DWithSkinTest : public Sprite3DTestDemo
@@ -624,4 +628,34 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class Sprite3DSkinCrowdTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DSkinCrowdTest);
+    Sprite3DSkinCrowdTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    std::string getSettingsMessage() const;
+protected:
+    cocos2d::MenuItemFont* _parallelItem;
+    cocos2d::MenuItemFont* _sharingItem;
+    bool _isResampled;
+};
+
+class Sprite3DInstancingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DInstancingTest);
+    Sprite3DInstancingTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    std::string getSettingsMessage() const;
+protected:
+    cocos2d::MenuItemFont* _instancingItem;
+};
+
 #endif
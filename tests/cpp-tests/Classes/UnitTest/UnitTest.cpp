@@ -1,6 +1,7 @@
 #include "UnitTest.h"
 #include "RefPtrTest.h"
 #include "ui/UIHelper.h"
+#include "editor-support/cocostudio/ActionTimeline/CCActionTimeline.h"
 
 USING_NS_CC;
 
@@ -45,6 +46,10 @@ UnitTests::UnitTests()
     ADD_TEST_CASE(RefPtrTest);
     ADD_TEST_CASE(UTFConversionTest);
     ADD_TEST_CASE(UIHelperSubStringTest);
+    ADD_TEST_CASE(InstanceBufferTest);
+    ADD_TEST_CASE(TweenFunctionTest);
+    ADD_TEST_CASE(LabelRelayoutTest);
+    ADD_TEST_CASE(ActionTimelineEasingTest);
 #ifdef UNIT_TEST_FOR_OPTIMIZED_MATH_UTIL
     ADD_TEST_CASE(MathUtilTest);
 #endif
@@ -876,6 +881,293 @@ std::string UIHelperSubStringTest::subtitle() const
     return "ui::Helper::getSubStringOfUTF8String Test";
 }
 
+// InstanceBufferTest
+
+void InstanceBufferTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    InstanceBuffer::BatchKey treeKey = { 1, 2, 3, 4, GL_TRIANGLES, GL_UNSIGNED_SHORT, 36 };
+    InstanceBuffer::BatchKey rockKey = treeKey;
+    rockKey.textureID = 5;
+
+    InstanceBuffer instances;
+    {
+        // the batches are made in the order of their first instance
+        bool isNewBatch = false;
+        CC_ASSERT(instances.add(treeKey, Mat4::IDENTITY, Vec4(1, 1, 1, 1), &isNewBatch) == 0 && isNewBatch);
+        CC_ASSERT(instances.add(rockKey, Mat4::IDENTITY, Vec4(1, 1, 1, 1), &isNewBatch) == 1 && isNewBatch);
+        CC_ASSERT(instances.add(treeKey, Mat4::IDENTITY, Vec4(1, 1, 1, 1), &isNewBatch) == 0 && !isNewBatch);
+        CC_ASSERT(instances.getBatchCount() == 2);
+        CC_ASSERT(instances.getInstanceCount() == 3);
+        CC_ASSERT(instances.getBatchKey(1) == rockKey);
+        CC_ASSERT(instances.getBatchSize(0) == 2 && instances.getBatchSize(1) == 1);
+
+        instances.clear();
+        CC_ASSERT(instances.getBatchCount() == 0 && instances.getInstanceCount() == 0);
+    }
+
+    // enough interleaved instances to be packed by several tasks
+    const int count = 5000;
+    for (int i = 0; i < count; ++i)
+    {
+        Mat4 transform;
+        Mat4::createTranslation((float)i, 0, 0, &transform);
+        instances.add(i % 3 ? treeKey : rockKey, transform, Vec4((float)i, 0, 0, 1));
+    }
+    std::vector<float> serialData(count * InstanceBuffer::FLOATS_PER_INSTANCE);
+    std::vector<float> parallelData(count * InstanceBuffer::FLOATS_PER_INSTANCE);
+    instances.build(serialData.data(), false);
+    instances.build(parallelData.data(), true);
+    CC_ASSERT(serialData == parallelData);
+
+    // the instances of a batch are contiguous and in the order they were added
+    CC_ASSERT(instances.getBatchOffset(0) == 0);
+    CC_ASSERT(instances.getBatchOffset(1) == instances.getBatchSize(0));
+    CC_ASSERT(instances.getBatchSize(0) + instances.getBatchSize(1) == count);
+    for (int batch = 0; batch < instances.getBatchCount(); ++batch)
+    {
+        float previous = -1;
+        for (ssize_t i = 0; i < instances.getBatchSize(batch); ++i)
+        {
+            const float* instance = &serialData[(instances.getBatchOffset(batch) + i) * InstanceBuffer::FLOATS_PER_INSTANCE];
+            int index = (int)instance[16];
+            CC_ASSERT((index % 3 ? 1 : 0) == batch); // the first instance is a rock
+            CC_ASSERT(instance[16] > previous);
+            // the translation is in the last column of the transform
+            CC_ASSERT(instance[12] == instance[16] && instance[19] == 1);
+            previous = instance[16];
+        }
+    }
+}
+
+std::string InstanceBufferTest::subtitle() const
+{
+    return "InstanceBuffer";
+}
+
+// TweenFunctionTest
+
+void TweenFunctionTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // the ends, the middle and the times around them, then an even spread
+    std::vector<float> times = { 0.0f, 1e-6f, 0.001f, 0.499f, 0.5f, 0.501f, 0.999f, 0.999999f, 1.0f };
+    for (int i = 0; i <= 1000; ++i)
+    {
+        times.push_back(i / 1000.0f);
+    }
+    std::vector<float> results(times.size());
+
+    const tweenfunc::EasingPrecision precisions[] = {
+        tweenfunc::EasingPrecision::EXACT,
+        tweenfunc::EasingPrecision::POLYNOMIAL,
+        tweenfunc::EasingPrecision::TABLE,
+    };
+    auto previousPrecision = tweenfunc::getEasingPrecision();
+    for (auto precision : precisions)
+    {
+        tweenfunc::setEasingPrecision(precision);
+        for (int type = tweenfunc::CUSTOM_EASING; type <= tweenfunc::Rate_EaseInOut; ++type)
+        {
+            auto tweenType = (tweenfunc::TweenType)type;
+            // a bezier for the custom easing, a period for the elastic ones and a rate for the others
+            float easingParams[] = { 0, 0, 0.2f, 0.4f, 0.6f, 1.2f, 1, 1 };
+            if (tweenType >= tweenfunc::Elastic_EaseIn && tweenType <= tweenfunc::Elastic_EaseInOut)
+                easingParams[0] = 0.3f;
+            else if (tweenType >= tweenfunc::Rate_EaseIn)
+                easingParams[0] = 2.5f;
+
+            tweenfunc::tweenTo(times.data(), results.data(), times.size(), tweenType, easingParams);
+            for (size_t i = 0; i < times.size(); ++i)
+            {
+                float expected = tweenfunc::tweenTo(times[i], tweenType, easingParams);
+                switch (precision)
+                {
+                    case tweenfunc::EasingPrecision::EXACT:
+                        CCASSERT(memcmp(&results[i], &expected, sizeof(float)) == 0, "the exact easing differs from tweenTo()");
+                        break;
+                    case tweenfunc::EasingPrecision::POLYNOMIAL:
+                        CCASSERT(fabsf(results[i] - expected) < 1e-6f, "the polynomial easing is too far from tweenTo()");
+                        break;
+                    case tweenfunc::EasingPrecision::TABLE:
+                        CCASSERT(fabsf(results[i] - expected) < 1e-3f, "the table easing is too far from tweenTo()");
+                        break;
+                }
+            }
+        }
+    }
+
+    // in place, as ActionManager eases its tweens
+    tweenfunc::setEasingPrecision(tweenfunc::EasingPrecision::EXACT);
+    std::vector<float> eased = times;
+    float rate = 2.5f;
+    tweenfunc::tweenTo(eased.data(), eased.data(), eased.size(), tweenfunc::Rate_EaseInOut, &rate);
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        CCASSERT(eased[i] == tweenfunc::tweenTo(times[i], tweenfunc::Rate_EaseInOut, &rate), "the easing in place differs from tweenTo()");
+    }
+
+    tweenfunc::setEasingPrecision(previousPrecision);
+}
+
+std::string TweenFunctionTest::subtitle() const
+{
+    return "tweenfunc::tweenTo in bulk";
+}
+
+// LabelRelayoutTest
+
+void LabelRelayoutTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // wide enough for "hello wo" but not for "hello world"
+    auto measure = [](const std::string& text) {
+        auto label = Label::createWithTTF(text, "fonts/arial.ttf", 20);
+        return label->getContentSize().width;
+    };
+    float maxLineWidth = (measure("hello wo") + measure("hello world")) / 2;
+
+    // a label relaid out after each change must match one laid out from scratch
+    auto incremental = Label::createWithTTF("", "fonts/arial.ttf", 20, Size(maxLineWidth, 0));
+    addChild(incremental);
+    const std::string texts[] = {
+        "hello world",
+        "hello wo",        // the first word of the second line shrinks and fits on the first one
+        "hello world",     // and grows back
+        "hello w world",
+        "hello world hello world hello world",
+        "hello world hello wo hello world",
+        "hello world hello worldwide hello world",
+        "hi world hello world",
+    };
+    for (const auto& text : texts)
+    {
+        incremental->setString(text);
+        auto full = Label::createWithTTF(text, "fonts/arial.ttf", 20, Size(maxLineWidth, 0));
+        addChild(full);
+
+        CC_ASSERT(incremental->getStringNumLines() == full->getStringNumLines());
+        CC_ASSERT(incremental->getContentSize().equals(full->getContentSize()));
+        for (int i = 0; i < incremental->getStringLength(); ++i)
+        {
+            auto letter = incremental->getLetter(i);
+            auto fullLetter = full->getLetter(i);
+            CC_ASSERT((letter == nullptr) == (fullLetter == nullptr));
+            if (letter)
+                CC_ASSERT(letter->getPosition().equals(fullLetter->getPosition()));
+        }
+        full->removeFromParent();
+    }
+    incremental->removeFromParent();
+}
+
+std::string LabelRelayoutTest::subtitle() const
+{
+    return "Label relayout after a change of text";
+}
+
+// ActionTimelineEasingTest
+
+namespace {
+
+// counts the applies, which have to go through the overrides of apply() whatever the easing precision
+class CountingPositionFrame : public cocostudio::timeline::PositionFrame
+{
+public:
+    CountingPositionFrame() : applyCount(0) {}
+    virtual void apply(float percent) override
+    {
+        ++applyCount;
+        PositionFrame::apply(percent);
+    }
+    int applyCount;
+};
+
+}
+
+void ActionTimelineEasingTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    using namespace cocostudio::timeline;
+
+    // timelines sharing some easings, half of them with a key frame in the middle
+    const tweenfunc::TweenType tweenTypes[] = {
+        tweenfunc::Sine_EaseIn,
+        tweenfunc::Back_EaseOut,
+        tweenfunc::Elastic_EaseOut,
+        tweenfunc::Bounce_EaseOut,
+    };
+    const int duration = 60;
+    const int timelineCount = 16;
+    auto createAction = [&](Node* target, std::vector<CountingPositionFrame*>& frames) {
+        auto action = ActionTimeline::create();
+        action->setDuration(duration);
+        for (int i = 0; i < timelineCount; ++i)
+        {
+            auto node = Node::create();
+            target->addChild(node);
+
+            auto timeline = Timeline::create();
+            std::vector<int> frameIndices = { 0, duration };
+            if (i % 2)
+                frameIndices.insert(frameIndices.begin() + 1, duration / 3);
+            for (size_t k = 0; k < frameIndices.size(); ++k)
+            {
+                auto frame = new (std::nothrow) CountingPositionFrame();
+                frame->autorelease();
+                frame->setFrameIndex(frameIndices[k]);
+                frame->setPosition(Vec2(100.0f * k, 50.0f * i));
+                frame->setTweenType(tweenTypes[i % 4]);
+                timeline->addFrame(frame);
+                frames.push_back(frame);
+            }
+            timeline->setNode(node);
+            action->addTimeline(timeline);
+        }
+        action->startWithTarget(target);
+        action->gotoFrameAndPlay(0, duration, false);
+        return action;
+    };
+
+    auto exactTarget = Node::create();
+    auto bulkTarget = Node::create();
+    std::vector<CountingPositionFrame*> exactFrames;
+    std::vector<CountingPositionFrame*> bulkFrames;
+    auto exactAction = createAction(exactTarget, exactFrames);
+    auto bulkAction = createAction(bulkTarget, bulkFrames);
+
+    auto previousPrecision = tweenfunc::getEasingPrecision();
+    for (int step = 0; step < duration + 2; ++step)
+    {
+        tweenfunc::setEasingPrecision(tweenfunc::EasingPrecision::EXACT);
+        exactAction->step(1 / 60.0f);
+        tweenfunc::setEasingPrecision(tweenfunc::EasingPrecision::POLYNOMIAL);
+        bulkAction->step(1 / 60.0f);
+
+        for (int i = 0; i < timelineCount; ++i)
+        {
+            auto exactPosition = exactTarget->getChildren().at(i)->getPosition();
+            auto bulkPosition = bulkTarget->getChildren().at(i)->getPosition();
+            CCASSERT(exactPosition.fuzzyEquals(bulkPosition, 1e-3f), "the bulk easing of the timelines is too far from tweenTo()");
+        }
+    }
+    tweenfunc::setEasingPrecision(previousPrecision);
+
+    for (size_t i = 0; i < exactFrames.size(); ++i)
+    {
+        CCASSERT(exactFrames[i]->applyCount == bulkFrames[i]->applyCount, "the bulk easing of the timelines skipped Frame::apply()");
+    }
+}
+
+std::string ActionTimelineEasingTest::subtitle() const
+{
+    return "ActionTimeline frames eased in bulk";
+}
+
 // MathUtilTest
 
 namespace UnitTest {
@@ -56,6 +56,38 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class InstanceBufferTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(InstanceBufferTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class TweenFunctionTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(TweenFunctionTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class LabelRelayoutTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(LabelRelayoutTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ActionTimelineEasingTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ActionTimelineEasingTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 class MathUtilTest : public UnitTestDemo
 {
 public:
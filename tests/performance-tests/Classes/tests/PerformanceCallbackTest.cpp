@@ -40,6 +40,10 @@ PerformceCallbackTests::PerformceCallbackTests()
     ADD_TEST_CASE(SimulateNewSchedulerCallbackPerfTest);
     ADD_TEST_CASE(InvokeMemberFunctionPerfTest);
     ADD_TEST_CASE(InvokeStdFunctionPerfTest);
+    ADD_TEST_CASE(SchedulerUpdatePerfTest);
+    ADD_TEST_CASE(SchedulerTimerPerfTest);
+    ADD_TEST_CASE(ActionManagerTweenPerfTest);
+    ADD_TEST_CASE(ActionManagerBatchedTweenPerfTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -183,3 +187,166 @@ void InvokeStdFunctionPerfTest::onUpdate(float dt)
     }
     CC_PROFILER_STOP(_profileName.c_str());
 }
+
+// SchedulerUpdatePerfTest
+
+void SchedulerUpdatePerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "SchedulerUpdate";
+    _rescheduled = 0;
+
+    // the targets aren't in the scene, their updates are ticked by a scheduler of the test
+    _tickedScheduler = new (std::nothrow) Scheduler();
+    for (int i = 0; i < LOOP_COUNT; ++i)
+    {
+        auto target = Node::create();
+        _targets.pushBack(target);
+        _tickedScheduler->scheduleUpdate(target, i % 3 - 1, false);
+    }
+}
+
+void SchedulerUpdatePerfTest::onExit()
+{
+    CC_SAFE_DELETE(_tickedScheduler);
+    _targets.clear();
+    PerformanceCallbackScene::onExit();
+}
+
+std::string SchedulerUpdatePerfTest::title() const
+{
+    return "Scheduler update perf test";
+}
+
+std::string SchedulerUpdatePerfTest::subtitle() const
+{
+    return "Ticks 10000 updates, 100 of them rescheduled each frame. See console";
+}
+
+void SchedulerUpdatePerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    // like nodes leaving and entering the scene
+    for (int i = 0; i < 100; ++i)
+    {
+        auto target = _targets.at(_rescheduled);
+        _tickedScheduler->unscheduleUpdate(target);
+        _tickedScheduler->scheduleUpdate(target, _rescheduled % 3 - 1, false);
+        _rescheduled = (_rescheduled + 1) % LOOP_COUNT;
+    }
+    _tickedScheduler->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+// SchedulerTimerPerfTest
+
+void SchedulerTimerPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "SchedulerTimer";
+
+    // timers of 1 to 10 seconds, a few of them are due each frame
+    _tickedScheduler = new (std::nothrow) Scheduler();
+    for (int i = 0; i < LOOP_COUNT; ++i)
+    {
+        auto target = Node::create();
+        _targets.pushBack(target);
+        _tickedScheduler->schedule([this](float dt) {
+            _placeHolder = 300;
+        }, target, 1.0f + (i % 100) * 0.09f, false, "timer");
+    }
+}
+
+void SchedulerTimerPerfTest::onExit()
+{
+    CC_SAFE_DELETE(_tickedScheduler);
+    _targets.clear();
+    PerformanceCallbackScene::onExit();
+}
+
+std::string SchedulerTimerPerfTest::title() const
+{
+    return "Scheduler timer perf test";
+}
+
+std::string SchedulerTimerPerfTest::subtitle() const
+{
+    return "Ticks 10000 timers of 1 to 10 seconds. See console";
+}
+
+void SchedulerTimerPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    _tickedScheduler->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+// ActionManagerTweenPerfTest
+
+void ActionManagerTweenPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = isTweenBatchingEnabled() ? "ActionManagerBatchedTween" : "ActionManagerTween";
+
+    // the targets aren't in the scene, their actions are ticked by an action manager of the test
+    bool batchingEnabled = ActionManager::isTweenBatchingEnabled();
+    ActionManager::setTweenBatchingEnabled(isTweenBatchingEnabled());
+    _tickedActionManager = new (std::nothrow) ActionManager();
+    for (int i = 0; i < LOOP_COUNT; ++i)
+    {
+        auto target = Node::create();
+        _targets.pushBack(target);
+
+        // long enough to keep running during the test
+        float duration = 1000.0f + (i % 100);
+        ActionInterval* action = nullptr;
+        switch (i % 4)
+        {
+        case 0:
+            action = MoveBy::create(duration, Vec2(100, 50));
+            break;
+        case 1:
+            action = EaseSineInOut::create(ScaleTo::create(duration, 2.0f));
+            break;
+        case 2:
+            action = FadeTo::create(duration, 0);
+            break;
+        default:
+            action = EaseElasticOut::create(RotateBy::create(duration, 360.0f));
+            break;
+        }
+        _tickedActionManager->addAction(action, target, false);
+    }
+    ActionManager::setTweenBatchingEnabled(batchingEnabled);
+}
+
+void ActionManagerTweenPerfTest::onExit()
+{
+    CC_SAFE_RELEASE_NULL(_tickedActionManager);
+    _targets.clear();
+    PerformanceCallbackScene::onExit();
+}
+
+std::string ActionManagerTweenPerfTest::title() const
+{
+    return "ActionManager tween perf test";
+}
+
+std::string ActionManagerTweenPerfTest::subtitle() const
+{
+    return "Steps 10000 MoveBy, ScaleTo, FadeTo and RotateBy, half of them eased. See console";
+}
+
+void ActionManagerTweenPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    _tickedActionManager->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+// ActionManagerBatchedTweenPerfTest
+
+std::string ActionManagerBatchedTweenPerfTest::title() const
+{
+    return "ActionManager batched tween perf test";
+}
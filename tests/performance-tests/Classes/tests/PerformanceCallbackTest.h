@@ -90,4 +90,73 @@ private:
     std::function<void(float)> _callback;
 };
 
+// SchedulerUpdatePerfTest
+class SchedulerUpdatePerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerUpdatePerfTest);
+    
+    // overrides
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+    
+private:
+    cocos2d::Scheduler* _tickedScheduler;
+    cocos2d::Vector<cocos2d::Node*> _targets;
+    int _rescheduled;
+};
+
+// SchedulerTimerPerfTest
+class SchedulerTimerPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerTimerPerfTest);
+    
+    // overrides
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+    
+private:
+    cocos2d::Scheduler* _tickedScheduler;
+    cocos2d::Vector<cocos2d::Node*> _targets;
+};
+
+// ActionManagerTweenPerfTest
+class ActionManagerTweenPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(ActionManagerTweenPerfTest);
+    
+    // overrides
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+    
+protected:
+    virtual bool isTweenBatchingEnabled() const { return false; }
+
+    cocos2d::ActionManager* _tickedActionManager;
+    cocos2d::Vector<cocos2d::Node*> _targets;
+};
+
+// ActionManagerBatchedTweenPerfTest
+class ActionManagerBatchedTweenPerfTest : public ActionManagerTweenPerfTest
+{
+public:
+    CREATE_FUNC(ActionManagerBatchedTweenPerfTest);
+    
+    virtual std::string title() const override;
+    
+protected:
+    virtual bool isTweenBatchingEnabled() const override { return true; }
+};
+
 #endif /* __PERFORMANCE_CALLBACK_TEST_H__ */
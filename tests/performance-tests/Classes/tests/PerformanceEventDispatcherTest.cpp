@@ -38,6 +38,7 @@ USING_NS_CC;
 PerformceEventDispatcherTests::PerformceEventDispatcherTests()
 {
     ADD_TEST_CASE(TouchEventDispatchingPerfTest);
+    ADD_TEST_CASE(TouchHitTestIndexPerfTest);
     ADD_TEST_CASE(KeyboardEventDispatchingPerfTest);
     ADD_TEST_CASE(CustomEventDispatchingPerfTest);
 }
@@ -658,6 +659,93 @@ std::string TouchEventDispatchingPerfTest::subtitle() const
     return "Test 'OneByOne-scenegraph', See console";
 }
 
+////////////////////////////////////////////////////////
+//
+// TouchHitTestIndexPerfTest
+//
+////////////////////////////////////////////////////////
+
+void TouchHitTestIndexPerfTest::onExit()
+{
+    EventDispatcher::setTouchHitTestIndexEnabled(false);
+    PerformanceEventDispatcherScene::onExit();
+}
+
+void TouchHitTestIndexPerfTest::generateTestFunctions()
+{
+    // buttons tiling the screen, one of them is reordered before each touch like a highlighted button
+    auto dispatchToButtons = [=](bool indexed){
+        EventDispatcher::setTouchHitTestIndexEnabled(indexed);
+        
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        Size size = Director::getInstance()->getWinSize();
+        if (quantityOfNodes != _lastRenderedCount)
+        {
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->onTouchBegan = [](Touch* touch, Event* event){
+                auto target = event->getCurrentTarget();
+                Rect rect(Vec2::ZERO, target->getContentSize());
+                rect.containsPoint(target->convertToNodeSpace(touch->getLocation()));
+                return false;
+            };
+            
+            int columns = (int)ceilf(sqrtf(this->quantityOfNodes * size.width / size.height));
+            int rows = (this->quantityOfNodes + columns - 1) / columns;
+            Size buttonSize(size.width / columns, size.height / rows);
+            
+            for (int i = 0; i < this->quantityOfNodes; ++i)
+            {
+                auto node = Node::create();
+                node->setTag(1000 + i);
+                node->setContentSize(buttonSize);
+                node->setPosition((i % columns) * buttonSize.width, (i / columns) * buttonSize.height);
+                this->addChild(node);
+                this->_nodes.push_back(node);
+                dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+            }
+            
+            _lastRenderedCount = quantityOfNodes;
+        }
+        
+        auto node = _nodes[rand() % _nodes.size()];
+        node->setLocalZOrder(node->getLocalZOrder() == 0 ? 1 : 0);
+        
+        EventTouch touchEvent;
+        touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+        std::vector<Touch*> touches;
+        
+        Touch* touch = new (std::nothrow) Touch();
+        touch->autorelease();
+        touch->setTouchInfo(0, rand() % (int)size.width, rand() % (int)size.height);
+        touches.push_back(touch);
+        touchEvent.setTouches(touches);
+        
+        CC_PROFILER_START(this->profilerName());
+        dispatcher->dispatchEvent(&touchEvent);
+        CC_PROFILER_STOP(this->profilerName());
+    };
+    
+    TestFunction testFunctions[] = {
+        { "OneByOne-buttons",    [=](){ dispatchToButtons(false); } } ,
+        { "OneByOne-buttons-indexed",    [=](){ dispatchToButtons(true); } } ,
+    };
+    
+    for (const auto& func : testFunctions)
+    {
+        _testFunctions.push_back(func);
+    }
+}
+
+std::string TouchHitTestIndexPerfTest::title() const
+{
+    return "Touch Hit-Test Index Perf test";
+}
+
+std::string TouchHitTestIndexPerfTest::subtitle() const
+{
+    return "Test 'OneByOne-buttons', See console";
+}
+
 ////////////////////////////////////////////////////////
 //
 // KeyboardEventDispatchingPerfTest
@@ -74,6 +74,19 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TouchHitTestIndexPerfTest : public PerformanceEventDispatcherScene
+{
+public:
+    CREATE_FUNC(TouchHitTestIndexPerfTest);
+    
+    virtual void onExit() override;
+    
+    virtual void generateTestFunctions() override;
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class KeyboardEventDispatchingPerfTest : public PerformanceEventDispatcherScene
 {
 public:
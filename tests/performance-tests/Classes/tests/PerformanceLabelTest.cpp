@@ -25,6 +25,7 @@ enum {
     kCaseLabelUpdate,
     kCaseLabelBMFontBigLabels,
     kCaseLabelBigLabels,
+    kCaseLabelBigLabelsUpdate,
     
     kCaseCount
 };
@@ -46,6 +47,7 @@ PerformceLabelTests::PerformceLabelTests()
     addTestCase("Label Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("LabelBMFont large text Performance", [](){ return LabelMainScene::create(); });
     addTestCase("Label large text Performance", [](){ return LabelMainScene::create(); });
+    addTestCase("Label large text Update Performance", [](){ return LabelMainScene::create(); });
 }
 
 ////////////////////////////////////////////////////////
@@ -106,6 +108,8 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
         return "Testing Label Big Labels";
+    case kCaseLabelBigLabelsUpdate:
+        return "Testing Label Big Labels Update";
     default:
         break;
     }
@@ -182,6 +186,7 @@ void LabelMainScene::onIncrease(Ref* sender)
         }
         break;
     case kCaseLabelBigLabels:
+    case kCaseLabelBigLabelsUpdate:
         {
             TTFConfig ttfConfig("fonts/arial.ttf", 60, GlyphCollection::DYNAMIC);
             for( int i=0;i< kNodesIncrease;i++)
@@ -230,7 +235,7 @@ void LabelMainScene::updateText(float dt)
             minFrameRate = curFrameRate;
     }
 
-    if(_curTestCase > kCaseLabelUpdate)
+    if(_curTestCase > kCaseLabelUpdate && _curTestCase != kCaseLabelBigLabelsUpdate)
         return;
 
     _accumulativeTime += dt;
@@ -258,6 +263,16 @@ void LabelMainScene::updateText(float dt)
             label->setString(text);
         }
         break;
+    case kCaseLabelBigLabelsUpdate:
+        {
+            // only the end of the text changes, as in a score board
+            std::string bigText = std::string(LongSentencesExample) + text;
+            for(const auto &child : children) {
+                Label* label = (Label*)child;
+                label->setString(bigText);
+            }
+        }
+        break;
     default:
         break;
     }
@@ -341,6 +356,9 @@ void LabelMainScene::endStat(float dt)
         case kCaseLabelBigLabels:
             tf = "Label Big Labels";
             break;
+        case kCaseLabelBigLabelsUpdate:
+            tf = "Label Big Labels Update";
+            break;
         default:
             tf = "unknown";
             break;
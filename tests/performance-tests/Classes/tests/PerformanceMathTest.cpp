@@ -31,6 +31,7 @@ USING_NS_CC;
 #define CC_PROFILER_RESET_INSTANCE(__id__, __name__) do{ ProfilingResetTimingBlock( String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
 
 static const int K_INFO_LOOP_TAG = 1581;
+static const int K_INFO_THROUGHPUT_TAG = 1582;
 
 static int autoTestLoopCounts[] = {
     10000, 20000, 30000
@@ -40,6 +41,8 @@ PerformceMathTests::PerformceMathTests()
 {
     ADD_TEST_CASE(PerformanceMathLayer1);
     ADD_TEST_CASE(PerformanceMathLayer2);
+    ADD_TEST_CASE(PerformanceMathLayer3);
+    ADD_TEST_CASE(PerformanceMathLayer4);
 }
 
 void PerformanceMathLayer::onEnter()
@@ -164,3 +167,92 @@ void PerformanceMathLayer2::doPerformanceTest(float dt)
     CC_PROFILER_STOP(_profileName.c_str());
     
 }
+
+void PerformanceMathVertexLayer::onEnter()
+{
+    PerformanceMathLayer::onEnter();
+
+    Mat4::createRotation(Vec3(0,0,1), 0.3f, &_transform);
+    _transform.translate(100, 50, 0);
+
+    auto s = Director::getInstance()->getWinSize();
+    auto throughputLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 24);
+    throughputLabel->setColor(Color3B(0,200,20));
+    throughputLabel->setPosition(Vec2(s.width/2, s.height/2 - 60));
+    addChild(throughputLabel, 1, K_INFO_THROUGHPUT_TAG);
+}
+
+void PerformanceMathVertexLayer::prepareVertices()
+{
+    // _loopCount is the number of vertices, batched as quads like sprites do
+    size_t vertexCount = std::min(_loopCount, (int)Renderer::VBO_SIZE);
+    vertexCount -= vertexCount % 4;
+    if (_verts.size() == vertexCount)
+        return;
+
+    _verts.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        _verts[i].vertices.set((float)(i % 64), (float)(i / 64), 0);
+        _verts[i].colors = Color4B::WHITE;
+    }
+
+    _indices.resize(vertexCount / 4 * 6);
+    for (size_t i = 0; i < vertexCount / 4; ++i)
+    {
+        _indices[i * 6 + 0] = 0;
+        _indices[i * 6 + 1] = 1;
+        _indices[i * 6 + 2] = 2;
+        _indices[i * 6 + 3] = 3;
+        _indices[i * 6 + 4] = 2;
+        _indices[i * 6 + 5] = 1;
+    }
+    _batchedIndices.resize(_indices.size());
+}
+
+void PerformanceMathVertexLayer::updateThroughputLabel()
+{
+    auto timer = Profiler::getInstance()->_activeTimers.at(_profileName);
+    auto throughputLabel = (Label *) getChildByTag(K_INFO_THROUGHPUT_TAG);
+    if (!timer || !throughputLabel || timer->_averageTime2 <= 0)
+        return;
+
+    // _averageTime2 is in microseconds
+    double verticesPerSecond = (double)_verts.size() * 1000000.0 / timer->_averageTime2;
+    char str[64] = {0};
+    snprintf(str, sizeof(str), "%.2f M vertices/sec", verticesPerSecond / 1000000.0);
+    throughputLabel->setString(str);
+}
+
+void PerformanceMathLayer3::doPerformanceTest(float dt)
+{
+    prepareVertices();
+    CC_PROFILER_START(_profileName.c_str());
+    for (size_t i = 0, size = _verts.size(); i < size; ++i)
+    {
+        _transform.transformPoint(&_verts[i].vertices);
+    }
+    // rebase indices the way the renderer batches quads
+    for (size_t i = 0, size = _indices.size(); i < size; ++i)
+    {
+        _batchedIndices[i] = (unsigned short)((i / 6) * 4) + _indices[i];
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+    updateThroughputLabel();
+}
+
+void PerformanceMathLayer4::doPerformanceTest(float dt)
+{
+    prepareVertices();
+    if (_verts.empty())
+        return;
+
+    CC_PROFILER_START(_profileName.c_str());
+    MathUtil::transformVec3Array(_transform.m, &_verts[0].vertices.x, sizeof(V3F_C4B_T2F), _verts.size());
+    for (size_t i = 0, size = _indices.size() / 6; i < size; ++i)
+    {
+        MathUtil::rebaseIndices(&_indices[i * 6], (unsigned short)(i * 4), 6, &_batchedIndices[i * 6]);
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+    updateThroughputLabel();
+}
@@ -67,4 +67,49 @@ public:
     
 };
 
+class PerformanceMathVertexLayer : public PerformanceMathLayer
+{
+public:
+    virtual void onEnter() override;
+
+protected:
+    void prepareVertices();
+    void updateThroughputLabel();
+
+    std::vector<cocos2d::V3F_C4B_T2F> _verts;
+    std::vector<unsigned short> _indices;
+    std::vector<unsigned short> _batchedIndices;
+    cocos2d::Mat4 _transform;
+};
+
+class PerformanceMathLayer3 : public PerformanceMathVertexLayer
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer3);
+
+    PerformanceMathLayer3()
+    {
+        _profileName = "VerticesTransformPoint";
+    }
+
+    virtual void doPerformanceTest(float dt) override;
+
+    virtual std::string subtitle() const override{ return "Vertices: Mat4::transformPoint per vertex"; }
+};
+
+class PerformanceMathLayer4 : public PerformanceMathVertexLayer
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer4);
+
+    PerformanceMathLayer4()
+    {
+        _profileName = "VerticesTransformVec3Array";
+    }
+
+    virtual void doPerformanceTest(float dt) override;
+
+    virtual std::string subtitle() const override{ return "Vertices: MathUtil::transformVec3Array"; }
+};
+
 #endif //__PERFORMANCE_MATH_TEST_H__
@@ -45,6 +45,9 @@ PerformceNodeChildrenTests::PerformceNodeChildrenTests()
 //    ADD_TEST_CASE(ReorderSpriteSheet);
 //    ADD_TEST_CASE(SortAllChildrenSpriteSheet);
     ADD_TEST_CASE(VisitSceneGraph);
+    ADD_TEST_CASE(ParallelVisitSceneGraph);
+    ADD_TEST_CASE(TransformSceneGraph);
+    ADD_TEST_CASE(CullSceneGraph);
 }
 
 enum {
@@ -980,3 +983,351 @@ const char*  VisitSceneGraph::testName()
 {
     return "visit()";
 }
+
+////////////////////////////////////////////////////////
+//
+// ParallelVisitSceneGraph
+//
+////////////////////////////////////////////////////////
+// independent subtrees, like world / particles / HUD layers
+static const int kParallelVisitLayers = 8;
+
+ParallelVisitSceneGraph::ParallelVisitSceneGraph()
+: _layersParent(nullptr)
+, _threadCountLabel(nullptr)
+, _threadCount(WorkerPool::getInstance()->getThreadCount())
+{
+    _testName[0] = 0;
+}
+
+void ParallelVisitSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _layersParent = Node::create();
+    _layersParent->setParallelVisitEnabled(true);
+    addChild(_layersParent);
+    for (int i = 0; i < kParallelVisitLayers; ++i)
+    {
+        _layersParent->addChild(Node::create(), 0, i);
+    }
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(30);
+    auto threads = MenuItemFont::create("Change thread count", [&](Ref *sender) {
+        _threadCount = _threadCount % (int)std::max(std::thread::hardware_concurrency(), 1u) + 1;
+        updateThreadCountLabel();
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    });
+    auto menu = Menu::create(threads, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-80));
+    addChild(menu, 1);
+
+    _threadCountLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 24);
+    _threadCountLabel->setColor(Color3B(0,200,20));
+    _threadCountLabel->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(_threadCountLabel, 1);
+    updateThreadCountLabel();
+
+    scheduleUpdate();
+}
+
+void ParallelVisitSceneGraph::updateThreadCountLabel()
+{
+    WorkerPool::getInstance()->setThreadCount(_threadCount);
+    _threadCountLabel->setString(StringUtils::format("%d thread(s)", _threadCount));
+}
+
+void ParallelVisitSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        auto texture = Director::getInstance()->getTextureCache()->addImage("Images/spritesheet1.png");
+        for(int i = currentQuantityOfNodes; i < quantityOfNodes; i++)
+        {
+            auto sprite = Sprite::createWithTexture(texture, Rect(0, 0, 32, 32));
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            sprite->setTag(1000 + i);
+            _layersParent->getChildByTag(i % kParallelVisitLayers)->addChild(sprite);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = currentQuantityOfNodes - 1; i >= quantityOfNodes; i--)
+        {
+            _layersParent->getChildByTag(i % kParallelVisitLayers)->removeChildByTag(1000 + i);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void ParallelVisitSceneGraph::update(float dt)
+{
+    // measures the frame CPU time spent generating render commands
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    // Call `Renderer::clean` to prevent crash if current scene is destroyed.
+    // The render commands associated with current scene should be cleaned.
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string ParallelVisitSceneGraph::title() const
+{
+    return "Performance of visiting subtrees in parallel";
+}
+
+std::string ParallelVisitSceneGraph::subtitle() const
+{
+    return "visit() of 8 layers of sprites per thread count. See console";
+}
+
+const char*  ParallelVisitSceneGraph::testName()
+{
+    snprintf(_testName, sizeof(_testName), "parallel visit() %d thread(s)", _threadCount);
+    return _testName;
+}
+
+////////////////////////////////////////////////////////
+//
+// TransformSceneGraph
+//
+////////////////////////////////////////////////////////
+TransformSceneGraph::TransformSceneGraph()
+: _container(nullptr)
+, _modeLabel(nullptr)
+, _moving(true)
+, _pushMatrix(true)
+{
+    _testName[0] = 0;
+}
+
+void TransformSceneGraph::onExit()
+{
+    Director::getInstance()->setMatrixStackPushedOnVisit(true);
+    NodeChildrenMainScene::onExit();
+}
+
+void TransformSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    // all the nodes share a parent, like the widgets of a panel
+    _container = Node::create();
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(30);
+    auto moving = MenuItemFont::create("Toggle moving parent", [&](Ref *sender) {
+        _moving = !_moving;
+        updateModeLabel();
+    });
+    auto pushMatrix = MenuItemFont::create("Toggle matrix stack push", [&](Ref *sender) {
+        _pushMatrix = !_pushMatrix;
+        updateModeLabel();
+    });
+    auto menu = Menu::create(moving, pushMatrix, nullptr);
+    menu->alignItemsVertically();
+    menu->setPosition(Vec2(s.width/2, s.height/2-100));
+    addChild(menu, 1);
+
+    _modeLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 24);
+    _modeLabel->setColor(Color3B(0,200,20));
+    _modeLabel->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(_modeLabel, 1);
+    updateModeLabel();
+
+    scheduleUpdate();
+}
+
+void TransformSceneGraph::updateModeLabel()
+{
+    Director::getInstance()->setMatrixStackPushedOnVisit(_pushMatrix);
+    _modeLabel->setString(StringUtils::format("%s parent, matrix stack push %s", _moving ? "moving" : "static", _pushMatrix ? "on" : "off"));
+    updateProfilerName();
+    CC_PROFILER_PURGE_ALL();
+}
+
+void TransformSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        auto texture = Director::getInstance()->getTextureCache()->addImage("Images/spritesheet1.png");
+        for(int i = currentQuantityOfNodes; i < quantityOfNodes; i++)
+        {
+            auto sprite = Sprite::createWithTexture(texture, Rect(0, 0, 32, 32));
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            sprite->setTag(1000 + i);
+            _container->addChild(sprite);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = currentQuantityOfNodes - 1; i >= quantityOfNodes; i--)
+        {
+            _container->removeChildByTag(1000 + i);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void TransformSceneGraph::update(float dt)
+{
+    if (_moving)
+    {
+        // every child has to update its transform
+        _container->setPosition(Vec2(CCRANDOM_MINUS1_1() * 4, CCRANDOM_MINUS1_1() * 4));
+    }
+
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    // Call `Renderer::clean` to prevent crash if current scene is destroyed.
+    // The render commands associated with current scene should be cleaned.
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string TransformSceneGraph::title() const
+{
+    return "Performance of the node transforms";
+}
+
+std::string TransformSceneGraph::subtitle() const
+{
+    return "visit() of sprites sharing a parent. See console";
+}
+
+const char*  TransformSceneGraph::testName()
+{
+    snprintf(_testName, sizeof(_testName), "transforms %s, push %s", _moving ? "moving" : "static", _pushMatrix ? "on" : "off");
+    return _testName;
+}
+
+////////////////////////////////////////////////////////
+//
+// CullSceneGraph
+//
+////////////////////////////////////////////////////////
+
+// the map is MAP_SCREENS x MAP_SCREENS screens large
+static const int MAP_SCREENS = 8;
+
+CullSceneGraph::CullSceneGraph()
+: _map(nullptr)
+, _statsLabel(nullptr)
+, _scroll(0)
+{
+    _testName[0] = 0;
+}
+
+void CullSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _map = Node::create();
+    addChild(_map);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(30);
+    auto toggle = MenuItemFont::create("Toggle spatial index", [&](Ref *sender) {
+        _map->setSpatialIndexEnabled(!_map->isSpatialIndexEnabled());
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    });
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-80));
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 24);
+    _statsLabel->setColor(Color3B(0,200,20));
+    _statsLabel->setPosition(Vec2(s.width/2, s.height/2-40));
+    addChild(_statsLabel, 1);
+
+    _map->setSpatialIndexEnabled(true);
+    updateProfilerName();
+
+    scheduleUpdate();
+}
+
+void CullSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        auto texture = Director::getInstance()->getTextureCache()->addImage("Images/spritesheet1.png");
+        for(int i = currentQuantityOfNodes; i < quantityOfNodes; i++)
+        {
+            auto sprite = Sprite::createWithTexture(texture, Rect(0, 0, 32, 32));
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width * MAP_SCREENS, CCRANDOM_0_1() * s.height * MAP_SCREENS));
+            sprite->setTag(1000 + i);
+            _map->addChild(sprite);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = currentQuantityOfNodes - 1; i >= quantityOfNodes; i--)
+        {
+            _map->removeChildByTag(1000 + i);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void CullSceneGraph::update(float dt)
+{
+    // scroll along the diagonal of the map, back and forth
+    auto s = Director::getInstance()->getWinSize();
+    _scroll += dt * 0.05f;
+    float t = 1 - fabsf(fmodf(_scroll, 2.0f) - 1);
+    _map->setPosition(Vec2(-t * s.width * (MAP_SCREENS - 1), -t * s.height * (MAP_SCREENS - 1)));
+
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    // Call `Renderer::clean` to prevent crash if current scene is destroyed.
+    // The render commands associated with current scene should be cleaned.
+    Director::getInstance()->getRenderer()->clean();
+
+    auto index = _map->getSpatialIndex();
+    if (index)
+        _statsLabel->setString(StringUtils::format("visited: %d, culled: %d", index->getVisitedCount(), index->getCulledCount()));
+    else
+        _statsLabel->setString(StringUtils::format("visited: %d, culled: 0", (int)_map->getChildrenCount()));
+}
+
+std::string CullSceneGraph::title() const
+{
+    return "Performance of culling a big map";
+}
+
+std::string CullSceneGraph::subtitle() const
+{
+    return "visit() of a scrolling map of 8x8 screens. See console";
+}
+
+const char*  CullSceneGraph::testName()
+{
+    snprintf(_testName, sizeof(_testName), "cull, spatial index %s", _map && _map->isSpatialIndexEnabled() ? "on" : "off");
+    return _testName;
+}
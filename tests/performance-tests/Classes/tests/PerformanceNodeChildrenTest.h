@@ -218,4 +218,70 @@ public:
     virtual const char* testName() override;
 };
 
+class ParallelVisitSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(ParallelVisitSceneGraph);
+
+    ParallelVisitSceneGraph();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    void updateThreadCountLabel();
+
+    cocos2d::Node* _layersParent;
+    cocos2d::Label* _threadCountLabel;
+    int _threadCount;
+    char _testName[64];
+};
+
+class TransformSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(TransformSceneGraph);
+
+    TransformSceneGraph();
+    virtual void onExit() override;
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    void updateModeLabel();
+
+    cocos2d::Node* _container;
+    cocos2d::Label* _modeLabel;
+    bool _moving;
+    bool _pushMatrix;
+    char _testName[64];
+};
+
+class CullSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(CullSceneGraph);
+
+    CullSceneGraph();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    cocos2d::Node* _map;
+    cocos2d::Label* _statsLabel;
+    float _scroll;
+    char _testName[64];
+};
+
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
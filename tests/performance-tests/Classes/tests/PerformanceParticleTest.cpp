@@ -1,6 +1,8 @@
 #include "PerformanceParticleTest.h"
 #include "Profile.h"
 
+#include <chrono>
+
 USING_NS_CC;
 
 #define MAX_SUB_TEST_NUM        3
@@ -36,6 +38,7 @@ PerformceParticleTests::PerformceParticleTests()
     ADD_TEST_CASE(ParticlePerformTest2);
     ADD_TEST_CASE(ParticlePerformTest3);
     ADD_TEST_CASE(ParticlePerformTest4);
+    ADD_TEST_CASE(ParticleEmittersPerformTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -498,3 +501,184 @@ void ParticlePerformTest4::initWithSubTest(int subtest, int particles)
     particleSize = 64;
     ParticleMainScene::initWithSubTest(subtest, particles);
 }
+
+////////////////////////////////////////////////////////
+//
+// ParticleEmittersPerformTest
+//
+////////////////////////////////////////////////////////
+static const int EMITTER_COUNT = 32;
+static const int EMITTER_MAX_PARTICLES = 2000;
+// the update time is averaged over this number of frames
+static const int EMITTER_STAT_FRAMES = 60;
+
+ParticleEmittersPerformTest::ParticleEmittersPerformTest()
+: _infoLabel(nullptr)
+, _particlesPerEmitter(500)
+, _frameCount(0)
+, _updateTime(0)
+{
+}
+
+void ParticleEmittersPerformTest::onEnter()
+{
+    TestCase::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", [this](Ref*) {
+        _particlesPerEmitter = std::max(_particlesPerEmitter - 250, 250);
+        createEmitters();
+    });
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", [this](Ref*) {
+        _particlesPerEmitter = std::min(_particlesPerEmitter + 250, EMITTER_MAX_PARTICLES);
+        createEmitters();
+    });
+    increase->setColor(Color3B(0,200,20));
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemFont::create("Toggle SIMD kernels", [this](Ref*) {
+        ParticleKernels::setSimdEnabled(!ParticleKernels::isSimdEnabled());
+        _frameCount = 0;
+        _updateTime = 0;
+    });
+    auto parallel = MenuItemFont::create("Toggle parallel update", [this](Ref*) {
+        ParticleSystem::setParallelUpdateEnabled(!ParticleSystem::isParallelUpdateEnabled());
+        _frameCount = 0;
+        _updateTime = 0;
+    });
+
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2+15));
+    addChild(menu, 1);
+
+    auto toggleMenu = Menu::create(toggle, parallel, nullptr);
+    toggleMenu->alignItemsHorizontallyWithPadding(40);
+    toggleMenu->setPosition(Vec2(s.width/2, s.height/2-40));
+    addChild(toggleMenu, 1);
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setColor(Color3B(0,200,20));
+    _infoLabel->setPosition(Vec2(s.width/2, s.height - 90));
+    addChild(_infoLabel, 1);
+
+    createEmitters();
+    scheduleUpdate();
+}
+
+void ParticleEmittersPerformTest::onExit()
+{
+    ParticleKernels::setSimdEnabled(true);
+    ParticleSystem::setParallelUpdateEnabled(false);
+    _emitters.clear();
+    TestCase::onExit();
+}
+
+void ParticleEmittersPerformTest::createEmitters()
+{
+    for (auto emitter : _emitters)
+        emitter->removeFromParent();
+    _emitters.clear();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto texture = Director::getInstance()->getTextureCache()->addImage("Images/fire.png");
+
+    for (int i = 0; i < EMITTER_COUNT; ++i)
+    {
+        auto emitter = ParticleSystemQuad::createWithTotalParticles(_particlesPerEmitter);
+        emitter->setTexture(texture);
+        emitter->setDuration(-1);
+        emitter->setLife(2.0f);
+        emitter->setLifeVar(1);
+        emitter->setEmissionRate(emitter->getTotalParticles() / emitter->getLife());
+        emitter->setStartColor(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        emitter->setStartColorVar(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        emitter->setEndColor(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        emitter->setEndColorVar(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        emitter->setStartSize(8);
+        emitter->setEndSize(4);
+        emitter->setStartSpin(0);
+        emitter->setEndSpin(360);
+        emitter->setAngle(90);
+        emitter->setAngleVar(180);
+        emitter->setBlendAdditive(true);
+        // the same particles whether the emitters are updated serially or in parallel
+        emitter->setRandomSeed(i);
+
+        // every other emitter uses the radius mode
+        if (i % 2 == 0)
+        {
+            emitter->setEmitterMode(ParticleSystem::Mode::GRAVITY);
+            emitter->setGravity(Vec2(0,-90));
+            emitter->setSpeed(120);
+            emitter->setSpeedVar(50);
+            emitter->setRadialAccel(-20);
+            emitter->setTangentialAccel(30);
+        }
+        else
+        {
+            emitter->setEmitterMode(ParticleSystem::Mode::RADIUS);
+            emitter->setStartRadius(10);
+            emitter->setEndRadius(80);
+            emitter->setEndRadiusVar(20);
+            emitter->setRotatePerSecond(90);
+            emitter->setRotatePerSecondVar(30);
+        }
+
+        emitter->setPosition(Vec2(s.width * ((i % 8) + 0.5f) / 8, s.height * ((i / 8) + 0.5f) / 4));
+        addChild(emitter);
+        // the emitters are updated and timed by this test
+        emitter->unscheduleUpdate();
+        _emitters.pushBack(emitter);
+    }
+
+    _frameCount = 0;
+    _updateTime = 0;
+    updateInfoLabel();
+}
+
+void ParticleEmittersPerformTest::update(float dt)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (auto emitter : _emitters)
+        emitter->update(dt);
+    // simulates the emitters queued by update() when the parallel update is enabled
+    ParticleSystem::runParallelUpdates();
+    _updateTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (++_frameCount == EMITTER_STAT_FRAMES)
+    {
+        updateInfoLabel();
+        _frameCount = 0;
+        _updateTime = 0;
+    }
+}
+
+void ParticleEmittersPerformTest::updateInfoLabel()
+{
+    int particleCount = 0;
+    for (auto emitter : _emitters)
+        particleCount += emitter->getParticleCount();
+
+    auto text = StringUtils::format("%d emitters, %d particles, SIMD %s, parallel %s: %.3f ms per frame",
+                                    EMITTER_COUNT, particleCount,
+                                    ParticleKernels::isSimdEnabled() ? "on" : "off",
+                                    ParticleSystem::isParallelUpdateEnabled() ? "on" : "off",
+                                    _frameCount > 0 ? _updateTime / _frameCount : 0.0);
+    if (_frameCount > 0)
+        log("%s", text.c_str());
+    _infoLabel->setString(text);
+}
+
+std::string ParticleEmittersPerformTest::title() const
+{
+    return "Many Emitters";
+}
+
+std::string ParticleEmittersPerformTest::subtitle() const
+{
+    return "Update time of the emitters, see console for results";
+}
@@ -76,4 +76,27 @@ public:
     virtual void initWithSubTest(int subtest, int particles) override;
 };
 
+class ParticleEmittersPerformTest : public TestCase
+{
+public:
+    CREATE_FUNC(ParticleEmittersPerformTest);
+
+    ParticleEmittersPerformTest();
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void createEmitters();
+    void updateInfoLabel();
+
+    cocos2d::Vector<cocos2d::ParticleSystem*> _emitters;
+    cocos2d::Label* _infoLabel;
+    int _particlesPerEmitter;
+    int _frameCount;
+    double _updateTime;
+};
+
 #endif
@@ -0,0 +1,390 @@
+#include "PerformanceRendererTest.h"
+#include "Profile.h"
+
+USING_NS_CC;
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+#undef CC_PROFILER_RESET
+#define CC_PROFILER_RESET(__name__) ProfilingResetTimingBlock(__name__)
+
+#undef CC_PROFILER_START_CATEGORY
+#define CC_PROFILER_START_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilingBeginTimingBlock(__name__); } while(0)
+#undef CC_PROFILER_STOP_CATEGORY
+#define CC_PROFILER_STOP_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilingEndTimingBlock(__name__); } while(0)
+#undef CC_PROFILER_RESET_CATEGORY
+#define CC_PROFILER_RESET_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilingResetTimingBlock(__name__); } while(0)
+
+#undef CC_PROFILER_START_INSTANCE
+#define CC_PROFILER_START_INSTANCE(__id__, __name__) do{ ProfilingBeginTimingBlock( String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
+#undef CC_PROFILER_STOP_INSTANCE
+#define CC_PROFILER_STOP_INSTANCE(__id__, __name__) do{ ProfilingEndTimingBlock(    String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
+#undef CC_PROFILER_RESET_INSTANCE
+#define CC_PROFILER_RESET_INSTANCE(__id__, __name__) do{ ProfilingResetTimingBlock( String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
+
+static const int K_INFO_LOOP_TAG = 1581;
+static const int K_INFO_STATS_TAG = 1582;
+
+static int autoTestLoopCounts[] = {
+    10000, 20000, 30000
+};
+
+PerformceRendererTests::PerformceRendererTests()
+{
+    ADD_TEST_CASE(PerformanceRendererLayer1);
+    ADD_TEST_CASE(PerformanceRendererLayer2);
+    ADD_TEST_CASE(PerformanceRendererLayer3);
+    ADD_TEST_CASE(PerformanceRendererLayer4);
+    ADD_TEST_CASE(PerformanceRendererLayer5);
+}
+
+void PerformanceRendererLayer::onEnter()
+{
+    TestCase::onEnter();
+    
+    _loopCount = 10000;
+    _stepCount = 10000;
+    
+    CC_PROFILER_PURGE_ALL();
+    
+    if (isAutoTesting()) {
+        autoTestIndex = 0;
+        _loopCount = autoTestLoopCounts[autoTestIndex];
+        Profile::getInstance()->testCaseBegin("RendererTest",
+                                              genStrVector("Type", "LoopCount", nullptr),
+                                              genStrVector("Avg", "Min", "Max", nullptr));
+    }
+    
+    auto s = Director::getInstance()->getWinSize();
+    
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(PerformanceRendererLayer::subLoopCount, this));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(PerformanceRendererLayer::addLoopCount, this));
+    increase->setColor(Color3B(0,200,20));
+    
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(menu, 1);
+    
+    auto infoLabel = Label::createWithTTF("0", "fonts/Marker Felt.ttf", 30);
+    infoLabel->setColor(Color3B(0,200,20));
+    infoLabel->setPosition(Vec2(s.width/2, s.height/2 + 40));
+    addChild(infoLabel, 1, K_INFO_LOOP_TAG);
+    updateLoopLabel();
+    
+    getScheduler()->schedule(schedule_selector(PerformanceRendererLayer::doPerformanceTest), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceRendererLayer::dumpProfilerInfo), this, 2, false);
+    
+}
+
+void PerformanceRendererLayer::addLoopCount(Ref *sender)
+{
+    _loopCount += _stepCount;
+    CC_PROFILER_PURGE_ALL();
+    updateLoopLabel();
+}
+
+void PerformanceRendererLayer::subLoopCount(Ref *sender)
+{
+    _loopCount -= _stepCount;
+    _loopCount = std::max(_loopCount, 0);
+    CC_PROFILER_PURGE_ALL();
+    updateLoopLabel();
+}
+
+void PerformanceRendererLayer::updateLoopLabel()
+{
+    auto infoLabel = (Label *) getChildByTag(K_INFO_LOOP_TAG);
+    char str[16] = {0};
+    sprintf(str, "%u", _loopCount);
+    infoLabel->setString(str);
+    
+}
+
+void PerformanceRendererLayer::dumpProfilerInfo(float dt)
+{
+    CC_PROFILER_DISPLAY_TIMERS();
+    
+    if (this->isAutoTesting()) {
+        // record the test result to class Profile
+        auto timer = Profiler::getInstance()->_activeTimers.at(_profileName);
+        auto numStr = genStr("%d", _loopCount);
+        auto avgStr = genStr("%ldµ", timer->_averageTime2);
+        auto minStr = genStr("%ldµ", timer->minTime);
+        auto maxStr = genStr("%ldµ", timer->maxTime);
+        Profile::getInstance()->addTestResult(genStrVector(_profileName.c_str(), numStr.c_str(), nullptr),
+                                              genStrVector(avgStr.c_str(), minStr.c_str(), maxStr.c_str(), nullptr));
+
+        auto testsSize = sizeof(autoTestLoopCounts)/sizeof(int);
+        if (autoTestIndex >= (testsSize - 1)) {
+            this->setAutoTesting(false);
+            Profile::getInstance()->testCaseEnd();
+        }
+        else
+        {
+            // update the auto test index
+            autoTestIndex++;
+            _loopCount = autoTestLoopCounts[autoTestIndex];
+            updateLoopLabel();
+            CC_PROFILER_PURGE_ALL();
+        }
+    }
+}
+
+void PerformanceRendererSortLayer::prepareCommands()
+{
+    if (_commands.size() != (size_t)_loopCount)
+    {
+        _commands.resize(_loopCount);
+    }
+
+    std::srand(0);
+    for (int i = 0; i < _loopCount; ++i)
+    {
+        auto& command = _commands[i];
+        switch (i % 3)
+        {
+            case 0:
+                // GLOBALZ_NEG, few distinct values like real scenes
+                command.init(-(float)(std::rand() % 32 + 1));
+                command.set3D(false);
+                break;
+            case 1:
+                // GLOBALZ_POS
+                command.init((float)(std::rand() % 32 + 1));
+                command.set3D(false);
+                break;
+            default:
+                // TRANSPARENT_3D, sorted by depth
+                command.init(0);
+                command.set3D(true);
+                command.setTransparent(true);
+                command.setDepth(CCRANDOM_0_1() * 1000.0f);
+                break;
+        }
+    }
+}
+
+void PerformanceRendererLayer1::doPerformanceTest(float dt)
+{
+    prepareCommands();
+
+    std::vector<RenderCommand*> queues[3];
+    for (auto& command : _commands)
+    {
+        float z = command.getGlobalOrder();
+        queues[z < 0 ? 0 : (z > 0 ? 1 : 2)].push_back(&command);
+    }
+
+    CC_PROFILER_START(_profileName.c_str());
+    // the comparators RenderQueue::sort used before it sorted by keys
+    std::stable_sort(std::begin(queues[2]), std::end(queues[2]), [](RenderCommand* a, RenderCommand* b) {
+        return a->getDepth() > b->getDepth();
+    });
+    for (int i = 0; i < 2; ++i)
+    {
+        std::stable_sort(std::begin(queues[i]), std::end(queues[i]), [](RenderCommand* a, RenderCommand* b) {
+            return a->getGlobalOrder() < b->getGlobalOrder();
+        });
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+void PerformanceRendererLayer2::doPerformanceTest(float dt)
+{
+    prepareCommands();
+
+    RenderQueue queue;
+    for (auto& command : _commands)
+    {
+        queue.push_back(&command);
+    }
+
+    CC_PROFILER_START(_profileName.c_str());
+    queue.sort();
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+PerformanceRendererStreamLayer::RecordingBackend::RecordingBackend()
+: mappedSize(0)
+, frameUploadedBytes(0)
+, frameAllocatedBytes(0)
+, frameAllocations(0)
+{
+}
+
+void PerformanceRendererStreamLayer::RecordingBackend::allocate(GLenum target, GLuint buffer, size_t size)
+{
+    // a new storage, like glBufferData does
+    std::vector<unsigned char>(size).swap(storage);
+    frameAllocatedBytes += size;
+    ++frameAllocations;
+}
+
+void* PerformanceRendererStreamLayer::RecordingBackend::map(GLenum target, GLuint buffer, size_t offset, size_t size)
+{
+    mappedSize = size;
+    return &storage[offset];
+}
+
+void PerformanceRendererStreamLayer::RecordingBackend::unmap(GLenum target, GLuint buffer)
+{
+    frameUploadedBytes += mappedSize;
+    mappedSize = 0;
+}
+
+void PerformanceRendererStreamLayer::RecordingBackend::upload(GLenum target, GLuint buffer, size_t offset, size_t size, const void* data)
+{
+    memcpy(&storage[offset], data, size);
+    frameUploadedBytes += size;
+}
+
+void PerformanceRendererStreamLayer::RecordingBackend::resetFrameStats()
+{
+    frameUploadedBytes = 0;
+    frameAllocatedBytes = 0;
+    frameAllocations = 0;
+}
+
+PerformanceRendererStreamLayer::PerformanceRendererStreamLayer()
+: _stream(GL_ARRAY_BUFFER, &_backend)
+{
+}
+
+void PerformanceRendererStreamLayer::onEnter()
+{
+    PerformanceRendererLayer::onEnter();
+
+    _loopCount = 2000;
+    _stepCount = 2000;
+    if (isAutoTesting())
+    {
+        _loopCount = autoTestLoopCounts[autoTestIndex] / 5;
+    }
+    updateLoopLabel();
+
+    // starts as small as the renderer ones, to show the growth
+    _stream.setup(sizeof(V3F_C4B_T2F) * Renderer::VBO_SIZE / 8);
+
+    auto s = Director::getInstance()->getWinSize();
+    auto statsLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    statsLabel->setColor(Color3B(0,200,20));
+    statsLabel->setPosition(Vec2(s.width/2, s.height/2 - 40));
+    addChild(statsLabel, 1, K_INFO_STATS_TAG);
+}
+
+void PerformanceRendererStreamLayer::writeQuads(V3F_C4B_T2F* verts)
+{
+    if (_quads.size() != (size_t)_loopCount)
+    {
+        _quads.resize(_loopCount);
+        for (auto& quad : _quads)
+        {
+            quad.bl.vertices.set(CCRANDOM_0_1() * 100, CCRANDOM_0_1() * 100, 0);
+            quad.br.vertices = quad.bl.vertices + Vec3(10, 0, 0);
+            quad.tl.vertices = quad.bl.vertices + Vec3(0, 10, 0);
+            quad.tr.vertices = quad.bl.vertices + Vec3(10, 10, 0);
+        }
+    }
+
+    if (_loopCount > 0)
+    {
+        memcpy(verts, _quads.data(), sizeof(_quads[0]) * _loopCount);
+    }
+}
+
+void PerformanceRendererStreamLayer::updateStatsLabel()
+{
+    auto statsLabel = (Label *) getChildByTag(K_INFO_STATS_TAG);
+    char str[128] = {0};
+    sprintf(str, "uploaded: %d KB/frame, allocated: %d KB in %d storage(s)/frame",
+            (int)(_backend.frameUploadedBytes / 1024), (int)(_backend.frameAllocatedBytes / 1024), _backend.frameAllocations);
+    statsLabel->setString(str);
+}
+
+void PerformanceRendererLayer3::doPerformanceTest(float dt)
+{
+    _backend.resetFrameStats();
+    const size_t vertexCount = _loopCount * 4;
+    if (_staging.size() < vertexCount)
+    {
+        _staging.resize(vertexCount);
+    }
+
+    CC_PROFILER_START(_profileName.c_str());
+    // what Renderer::drawBatchedTriangles did before the stream buffers:
+    // fill a staging array, then orphan the buffer object and copy the array to it
+    writeQuads(_staging.data());
+    _backend.allocate(GL_ARRAY_BUFFER, 1, sizeof(_staging[0]) * vertexCount);
+    void* buf = _backend.map(GL_ARRAY_BUFFER, 1, 0, sizeof(_staging[0]) * vertexCount);
+    memcpy(buf, _staging.data(), sizeof(_staging[0]) * vertexCount);
+    _backend.unmap(GL_ARRAY_BUFFER, 1);
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    updateStatsLabel();
+}
+
+void PerformanceRendererLayer4::doPerformanceTest(float dt)
+{
+    _backend.resetFrameStats();
+    const size_t vertexCount = _loopCount * 4;
+
+    CC_PROFILER_START(_profileName.c_str());
+    auto verts = (V3F_C4B_T2F*) _stream.map(sizeof(V3F_C4B_T2F) * vertexCount);
+    writeQuads(verts);
+    _stream.commit();
+    _stream.nextFrame();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    updateStatsLabel();
+}
+
+void PerformanceRendererLayer5::onEnter()
+{
+    PerformanceRendererLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto statsLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    statsLabel->setColor(Color3B(0,200,20));
+    statsLabel->setPosition(Vec2(s.width/2, s.height/2 - 40));
+    addChild(statsLabel, 1, K_INFO_STATS_TAG);
+}
+
+void PerformanceRendererLayer5::doPerformanceTest(float dt)
+{
+    const int threadCount = WorkerPool::getInstance()->getThreadCount();
+    const int loopCount = _loopCount;
+
+    CC_PROFILER_START(_profileName.c_str());
+    // each thread generates its share of the commands, as if recording a subtree, then they are all pushed back
+    std::vector<std::vector<CustomCommand*>> commands(threadCount);
+    WorkerPool::getInstance()->parallelFor(threadCount, [&](int thread) {
+        auto& generated = commands[thread];
+        const int count = loopCount / threadCount + (thread < loopCount % threadCount ? 1 : 0);
+        generated.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            generated.push_back(_pool.generateCommand());
+        }
+        for (auto command : generated)
+        {
+            _pool.pushBackCommand(command);
+        }
+    });
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    auto statsLabel = (Label *) getChildByTag(K_INFO_STATS_TAG);
+    char str[128] = {0};
+    sprintf(str, "%d threads, pool capacity: %d, high water mark: %d", threadCount, _pool.getCapacity(), _pool.getHighWaterMark());
+    statsLabel->setString(str);
+}
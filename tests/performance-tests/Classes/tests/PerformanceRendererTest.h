@@ -0,0 +1,176 @@
+#ifndef __PERFORMANCE_RENDERER_TEST_H__
+#define __PERFORMANCE_RENDERER_TEST_H__
+
+#include "BaseTest.h"
+#include "renderer/CCRenderCommandPool.h"
+
+DEFINE_TEST_SUITE(PerformceRendererTests);
+
+class PerformanceRendererLayer : public TestCase
+{
+public:
+    PerformanceRendererLayer()
+    : _loopCount(1000)
+    , _stepCount(500)
+    , _profileName("")
+    {
+        
+    }
+    
+    virtual void onEnter() override;
+    
+    virtual std::string title() const override{ return "Renderer Performance Test"; }
+    virtual std::string subtitle() const override{ return "PerformanceRendererLayer subTitle"; }
+    
+    void addLoopCount(cocos2d::Ref* sender);
+    void subLoopCount(cocos2d::Ref* sender);
+protected:
+    virtual void doPerformanceTest(float dt) {};
+    
+    void dumpProfilerInfo(float dt);
+    void updateLoopLabel();
+protected:
+    int autoTestIndex;
+    int _loopCount;
+    int _stepCount;
+    std::string _profileName;
+};
+
+class PerformanceRendererSortLayer : public PerformanceRendererLayer
+{
+protected:
+    class SortCommand : public cocos2d::CustomCommand
+    {
+    public:
+        void setDepth(float depth) { _depth = depth; }
+    };
+
+    // _loopCount commands, a third of them in each of the sorted queue groups
+    void prepareCommands();
+
+    std::vector<SortCommand> _commands;
+};
+
+class PerformanceRendererLayer1 : public PerformanceRendererSortLayer
+{
+public:
+    CREATE_FUNC(PerformanceRendererLayer1);
+
+    PerformanceRendererLayer1()
+    {
+        _profileName = "SortStableSortComparator";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Sort commands: std::stable_sort with comparator"; }
+};
+
+class PerformanceRendererLayer2 : public PerformanceRendererSortLayer
+{
+public:
+    CREATE_FUNC(PerformanceRendererLayer2);
+
+    PerformanceRendererLayer2()
+    {
+        _profileName = "SortRenderQueue";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Sort commands: RenderQueue::sort"; }
+};
+
+class PerformanceRendererStreamLayer : public PerformanceRendererLayer
+{
+public:
+    PerformanceRendererStreamLayer();
+
+    virtual void onEnter() override;
+
+protected:
+    // Records the uploads and the storage allocations of the stream buffer instead of calling GL,
+    // the mapped memory is a CPU side vector.
+    class RecordingBackend : public cocos2d::StreamBuffer::Backend
+    {
+    public:
+        RecordingBackend();
+
+        virtual GLuint createBuffer() override { return 1; }
+        virtual void deleteBuffer(GLuint buffer) override {}
+        virtual void allocate(GLenum target, GLuint buffer, size_t size) override;
+        virtual void* map(GLenum target, GLuint buffer, size_t offset, size_t size) override;
+        virtual void unmap(GLenum target, GLuint buffer) override;
+        virtual void upload(GLenum target, GLuint buffer, size_t offset, size_t size, const void* data) override;
+
+        void resetFrameStats();
+
+        std::vector<unsigned char> storage;
+        size_t mappedSize;
+        size_t frameUploadedBytes;
+        size_t frameAllocatedBytes;
+        int frameAllocations;
+    };
+
+    // writes the _loopCount quads to the given address, as the renderer does for batched sprites
+    void writeQuads(cocos2d::V3F_C4B_T2F* verts);
+    void updateStatsLabel();
+
+    RecordingBackend _backend;
+    cocos2d::StreamBuffer _stream;
+    std::vector<cocos2d::V3F_C4B_T2F_Quad> _quads;
+};
+
+class PerformanceRendererLayer3 : public PerformanceRendererStreamLayer
+{
+public:
+    CREATE_FUNC(PerformanceRendererLayer3);
+
+    PerformanceRendererLayer3()
+    {
+        _profileName = "StreamStagingCopy";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Stream quads: staging array, orphaning + copy"; }
+
+protected:
+    std::vector<cocos2d::V3F_C4B_T2F> _staging;
+};
+
+class PerformanceRendererLayer4 : public PerformanceRendererStreamLayer
+{
+public:
+    CREATE_FUNC(PerformanceRendererLayer4);
+
+    PerformanceRendererLayer4()
+    {
+        _profileName = "StreamRingBuffer";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Stream quads: StreamBuffer ring"; }
+};
+
+class PerformanceRendererLayer5 : public PerformanceRendererLayer
+{
+public:
+    CREATE_FUNC(PerformanceRendererLayer5);
+
+    PerformanceRendererLayer5()
+    {
+        _profileName = "CommandPoolGenerate";
+    }
+
+    virtual void onEnter() override;
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Generate and push back commands on the WorkerPool threads"; }
+
+protected:
+    cocos2d::RenderCommandPool<cocos2d::CustomCommand> _pool;
+};
+
+#endif //__PERFORMANCE_RENDERER_TEST_H__
@@ -6,6 +6,7 @@ USING_NS_CC;
 PerformceTextureTests::PerformceTextureTests()
 {
     ADD_TEST_CASE(TexturePerformceTest);
+    ADD_TEST_CASE(TextureAsyncPerformceTest);
 }
 
 static float calculateDeltaTime( struct timeval *lastUpdate )
@@ -332,3 +333,125 @@ std::string TexturePerformceTest::subtitle() const
 {
     return "See console for results";
 }
+
+////////////////////////////////////////////////////////
+//
+// TextureAsyncPerformceTest
+//
+////////////////////////////////////////////////////////
+static const char* s_asyncImages[] = {
+    "Images/PlanetCute-1024x1024.png",
+    "Images/landscape-1024x1024.png",
+    "Images/texture1024x1024.png",
+    "Images/texture512x512.png",
+    "Images/grossini_dance_atlas.png",
+    "Images/grossinis_sister1_sp.png",
+    "Images/grossinis_sister2_sp.png",
+    "Images/grossini_polygon.png",
+    "Images/grossini_quad.png",
+    "Images/spritesheet1.png",
+    "Images/grossini.png",
+    "Images/grossinis_sister1.png",
+    "Images/grossinis_sister2.png",
+    "Images/grossini_dance_01.png",
+    "Images/grossini_dance_02.png",
+    "Images/grossini_dance_03.png",
+    "Images/grossini_dance_04.png",
+    "Images/grossini_dance_05.png",
+    "Images/grossini_dance_06.png",
+    "Images/grossini_dance_07.png",
+    "Images/grossini_dance_08.png",
+    "Images/grossini_dance_09.png",
+    "Images/grossini_dance_10.png",
+    "Images/test_image.png",
+};
+
+// 1 MB per frame is about a 512x512 RGBA8888 texture
+static const size_t ASYNC_UPLOAD_BUDGET = 1024 * 1024;
+
+TextureAsyncPerformceTest::TextureAsyncPerformceTest()
+: _resultLabel(nullptr)
+, _uploadBudget(0)
+, _pendingCount(0)
+, _longestFrame(0)
+{
+}
+
+void TextureAsyncPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemFont::create("Toggle upload budget and reload", [this](Ref*) {
+        if (_pendingCount > 0)
+            return;
+        _uploadBudget = _uploadBudget ? 0 : ASYNC_UPLOAD_BUDGET;
+        startLoading();
+    });
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height / 2 - 60));
+    addChild(menu);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_resultLabel);
+
+    startLoading();
+}
+
+void TextureAsyncPerformceTest::onExit()
+{
+    Director::getInstance()->getTextureCache()->unbindAllImageAsync();
+    Director::getInstance()->getTextureCache()->setAsyncUploadBudget(0);
+    TestCase::onExit();
+}
+
+void TextureAsyncPerformceTest::startLoading()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (auto image : s_asyncImages)
+        cache->removeTextureForKey(image);
+
+    cache->setAsyncUploadBudget(_uploadBudget);
+    _resultLabel->setString("Loading...");
+    _pendingCount = (int)(sizeof(s_asyncImages) / sizeof(s_asyncImages[0]));
+    _longestFrame = 0;
+
+    gettimeofday(&_startTime, nullptr);
+    _lastFrameTime = _startTime;
+    scheduleUpdate();
+
+    for (auto image : s_asyncImages)
+    {
+        cache->addImageAsync(image, [this](Texture2D*) {
+            if (--_pendingCount > 0)
+                return;
+
+            unscheduleUpdate();
+            auto total = calculateDeltaTime(&_startTime) * 1000;
+            auto text = StringUtils::format("%d images, budget %d KB: %.1f ms, longest frame %.1f ms",
+                                            (int)(sizeof(s_asyncImages) / sizeof(s_asyncImages[0])),
+                                            (int)(_uploadBudget / 1024), total, _longestFrame * 1000);
+            log("%s", text.c_str());
+            _resultLabel->setString(text);
+        }, "TextureAsyncPerformceTest");
+    }
+}
+
+void TextureAsyncPerformceTest::update(float dt)
+{
+    _longestFrame = std::max(_longestFrame, calculateDeltaTime(&_lastFrameTime));
+    gettimeofday(&_lastFrameTime, nullptr);
+}
+
+std::string TextureAsyncPerformceTest::title() const
+{
+    return "Async Texture Loading";
+}
+
+std::string TextureAsyncPerformceTest::subtitle() const
+{
+    return "Images decoded on all cores. See console for results";
+}
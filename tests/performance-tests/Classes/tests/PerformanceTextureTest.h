@@ -18,4 +18,27 @@ public:
     virtual void onEnter() override;
 };
 
+class TextureAsyncPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureAsyncPerformceTest);
+
+    TextureAsyncPerformceTest();
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void startLoading();
+
+    cocos2d::Label* _resultLabel;
+    size_t _uploadBudget;
+    int _pendingCount;
+    struct timeval _startTime;
+    struct timeval _lastFrameTime;
+    float _longestFrame;
+};
+
 #endif
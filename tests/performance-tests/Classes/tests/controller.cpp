@@ -32,6 +32,7 @@ public:
         addTest("Callback Tests", []() { return new PerformceCallbackTests(); });
         addTest("Math Tests", []() { return new PerformceMathTests(); });
         addTest("Container Tests", []() { return new PerformceContainerTests(); });
+        addTest("Renderer Tests", []() { return new PerformceRendererTests(); });
     }
 };
 
@@ -14,5 +14,6 @@
 #include "PerformanceCallbackTest.h"
 #include "PerformanceMathTest.h"
 #include "PerformanceContainerTest.h"
+#include "PerformanceRendererTest.h"
 
 #endif
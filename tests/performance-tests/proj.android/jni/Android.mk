@@ -24,6 +24,7 @@ LOCAL_SRC_FILES := hellocpp/main.cpp \
                    ../../Classes/tests/PerformanceLabelTest.cpp \
                    ../../Classes/tests/VisibleRect.cpp \
                    ../../Classes/tests/PerformanceMathTest.cpp \
+../../Classes/tests/PerformanceRendererTest.cpp \
                    ../../Classes/tests/controller.cpp \
                    ../../Classes/tests/PerformanceNodeChildrenTest.cpp
 